@@ -161,6 +161,53 @@ void checkStartEnd(float **signal, int channels, int nsamples, float normalizedD
     range[0] = firstSmpsPrevious != (nsamples - 1) ? firstSmpsPrevious : 0;
     range[1] = lastSmpsPrevious + 1;
 }
+/*
+* Energy decay truncation, the Schroeder backward integral over all channels gives the energy
+* still to come at every sample. The IR ends where that drops below floordB relative to the total
+* energy, the last 1/16 (at most 1024 samples) of what is kept fades out with a raised cosine.
+* Returns the energy of the removed and faded parts relative to the total energy in dB
+*/
+float energyDecayTruncate(float **signal, int channels, int nsamples, float floordB, int *length)
+{
+    int i, j;
+    double total = 0.0;
+    for (i = 0; i < channels; i++)
+        for (j = 0; j < nsamples; j++)
+            total += (double)signal[i][j] * signal[i][j];
+    *length = nsamples;
+    if (total <= 0.0)
+        return -999.0f;
+    const double floorEnergy = total * pow(10.0, floordB / 10.0);
+    double remaining = 0.0;
+    int cut = nsamples;
+    for (j = nsamples - 1; j > 0; j--)
+    {
+        double e = 0.0;
+        for (i = 0; i < channels; i++)
+            e += (double)signal[i][j] * signal[i][j];
+        if (remaining + e > floorEnergy)
+            break;
+        remaining += e;
+        cut = j;
+    }
+    int fade = cut >> 4;
+    if (fade > 1024)
+        fade = 1024;
+    double error = remaining;
+    for (j = 0; j < fade; j++)
+    {
+        const int idx = cut - fade + j;
+        const float w = 0.5f + 0.5f * cosf((float)M_PI * (float)(j + 1) / (float)(fade + 1));
+        for (i = 0; i < channels; i++)
+        {
+            const double d = (double)signal[i][idx] * (1.0 - w);
+            error += d * d;
+            signal[i][idx] *= w;
+        }
+    }
+    *length = cut;
+    return (float)(10.0 * log10(error / total + 1e-100));
+}
 #include "Effects/eel2/numericSys/libsamplerate/samplerate.h"
 //#define DRMP3_IMPLEMENTATION
 #include "Effects/eel2/dr_mp3.h"
@@ -378,8 +425,15 @@ float* ReadImpulseResponseToFloat
         int range[2];
         float startCutdB = javaAdvSetPtr[0];
         float endCutdB = javaAdvSetPtr[1];
+        float removeddB = 0.0f;
         if (convMode == 1)
             checkStartEnd(splittedBuffer, channels, frameCount, startCutdB, endCutdB, range);
+        else if (convMode == 3)
+        {
+            // Efficiency mode keeps the onset untouched and drops the tail under the noise floor
+            range[0] = 0;
+            removeddB = energyDecayTruncate(splittedBuffer, channels, frameCount, endCutdB, &range[1]);
+        }
         else
         {
             range[0] = 0;
@@ -387,9 +441,8 @@ float* ReadImpulseResponseToFloat
         }
         float *outPtr[4];
         int xLen = range[1] - range[0];
-        if (convMode == 1)
+        if (convMode != 2)
         {
-            checkStartEnd(splittedBuffer, channels, frameCount, startCutdB, endCutdB, range);
             for (i = 0; i < channels; i++)
             {
                 outPtr[i] = &splittedBuffer[i][range[0]];
@@ -439,6 +492,11 @@ float* ReadImpulseResponseToFloat
             }
         }
         unsigned int totalFrames = xLen * channels;
+        if (convMode == 3)
+        {
+            jImpInfo[2] = (int)frameCount;
+            jImpInfo[3] = (int)(removeddB * 100.0f);
+        }
         frameCount = xLen;
         pFrameBuffer = (float*)malloc(totalFrames * sizeof(float));
         channel_joinFloat(outPtr, channels, pFrameBuffer, xLen);
@@ -1,6 +1,10 @@
 #ifndef JDSPIMPRESTOOLBOX_H
 #define JDSPIMPRESTOOLBOX_H
 
+// convMode 0: original, 1: shrink, 2: minimum phase and shrink, 3: energy decay truncation at javaAdvSetPtr[1] dB
+// jImpInfo receives channels and frames, convMode 3 also writes the untruncated frame count and
+// the removed energy in 1/100 dB to jImpInfo[2] and jImpInfo[3]
+extern float energyDecayTruncate(float **signal, int channels, int nsamples, float floordB, int *length);
 extern float* ReadImpulseResponseToFloat(const char* mIRFileName, int targetSampleRate, int* jImpInfo, int convMode, int* javaAdvSetPtr);
 extern int ComputeEqResponse(const double* jfreq, double* jgain, int interpolationMode, int queryPts, double* dispFreq, float* response);
 
@@ -27,9 +27,11 @@ HEADERS += \
     $$BASEPATH/Effects/eel2/eel_matrix.h \
     $$BASEPATH/Effects/eel2/fft.h \
     $$BASEPATH/Effects/eel2/glue_port.h \
+    $$BASEPATH/Effects/eel2/glue_x86_64_jit.h \
     $$BASEPATH/Effects/eel2/ns-eel-int.h \
     $$BASEPATH/Effects/eel2/ns-eel.h \
     $$BASEPATH/Effects/eel2/numericSys/FFTConvolver.h \
+    $$BASEPATH/Effects/eel2/numericSys/FHTPlan.h \
     $$BASEPATH/Effects/eel2/numericSys/FilterDesign/fdesign.h \
     $$BASEPATH/Effects/eel2/numericSys/FilterDesign/polyphaseASRC.h \
     $$BASEPATH/Effects/eel2/numericSys/FilterDesign/polyphaseFilterbank.h \
@@ -45,6 +47,7 @@ HEADERS += \
     $$BASEPATH/Effects/eel2/stb_sprintf.h \
     $$BASEPATH/generalDSP/ArbFIRGen.h \
     $$BASEPATH/generalDSP/TwoStageFFTConvolver.h \
+    $$BASEPATH/generalDSP/HybridFIRConvolver.h \
     $$BASEPATH/generalDSP/digitalFilters.h \
     $$BASEPATH/generalDSP/interpolation.h \
     $$BASEPATH/generalDSP/spectralInterpolatorFloat.h \
@@ -64,6 +67,8 @@ SOURCES += \
     $$BASEPATH/Effects/eel2/nseel-compiler.c \
     $$BASEPATH/Effects/eel2/nseel-ram.c \
     $$BASEPATH/Effects/eel2/numericSys/FFTConvolver.c \
+    $$BASEPATH/Effects/eel2/numericSys/FHTPlan.c \
+    $$BASEPATH/Effects/eel2/numericSys/MixedRadixFHT.c \
     $$BASEPATH/Effects/eel2/numericSys/FilterDesign/cos_fib_paraunitary.c \
     $$BASEPATH/Effects/eel2/numericSys/FilterDesign/eqnerror.c \
     $$BASEPATH/Effects/eel2/numericSys/FilterDesign/firls.c \
@@ -93,6 +98,7 @@ SOURCES += \
     $$BASEPATH/binaryBlobs.c \
     $$BASEPATH/generalDSP/ArbFIRGen.c \
     $$BASEPATH/generalDSP/TwoStageFFTConvolver.c \
+    $$BASEPATH/generalDSP/HybridFIRConvolver.c \
     $$BASEPATH/generalDSP/digitalFilters.c \
     $$BASEPATH/generalDSP/generalProg.c \
     $$BASEPATH/generalDSP/interpolation.c \
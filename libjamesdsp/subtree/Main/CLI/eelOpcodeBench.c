@@ -0,0 +1,84 @@
+// EEL2 opcode throughput benchmark, a standalone tool next to the CLI host.
+// Each kernel is a short loop of the code shapes Liveprog scripts spend their time in, the best of many runs is
+// reported in nanoseconds per loop iteration.
+// Built by the EelOpcodeBench project of the CLI solution, or against the static library elsewhere,
+// e.g. gcc -O2 eelOpcodeBench.c libjamesdsp.a -lm -lpthread
+// Pass -nojit to time the bytecode interpreter instead of the native code translation
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../libjamesdsp/jni/jamesdsp/jdsp/Effects/eel2/ns-eel.h"
+#ifdef _WIN32
+#include <Windows.h>
+double get_wall_time()
+{
+	LARGE_INTEGER time, freq;
+	if (!QueryPerformanceFrequency(&freq))
+		return 0;
+	if (!QueryPerformanceCounter(&time))
+		return 0;
+	return (double)time.QuadPart / freq.QuadPart;
+}
+#else
+#include <time.h>
+double get_wall_time()
+{
+	struct timespec time;
+	if (clock_gettime(CLOCK_MONOTONIC, &time))
+		return 0;
+	return (double)time.tv_sec + (double)time.tv_nsec * .000000001;
+}
+#endif
+#define ITERATIONS 4096
+#define RUNS 200
+static const char *kernels[][2] =
+{
+	// Direct form biquad, variable loads and stores with arithmetic in between
+	{ "biquad", "loop(4096, y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2; x2 = x1; x1 = x; y2 = y1; y1 = y; x += 0.001;);" },
+	// Indexed RAM reads and writes
+	{ "buffer", "i = 0; loop(4096, buf[i] = buf[i + 1] * g + buf[i + 2]; i += 1;);" },
+	// Compare and branch
+	{ "branch", "loop(4096, x > t ? acc += x : acc -= x; x = x * 0.999 + 0.0013;);" },
+	// Compound assignments
+	{ "update", "loop(4096, s += x; p *= 0.9999; q -= x; x = p;);" },
+};
+int main(int argc, char *argv[])
+{
+	for (int i = 1; i < argc; i++)
+		if (!strcmp(argv[i], "-nojit"))
+			NSEEL_set_native_code(0);
+	NSEEL_start();
+	for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+	{
+		NSEEL_VMCTX vm = NSEEL_VM_alloc();
+		*NSEEL_VM_regvar(vm, "b0") = 0.2f;
+		*NSEEL_VM_regvar(vm, "b1") = 0.3f;
+		*NSEEL_VM_regvar(vm, "b2") = 0.2f;
+		*NSEEL_VM_regvar(vm, "a1") = -0.5f;
+		*NSEEL_VM_regvar(vm, "a2") = 0.2f;
+		*NSEEL_VM_regvar(vm, "g") = 0.5f;
+		*NSEEL_VM_regvar(vm, "t") = 0.5f;
+		*NSEEL_VM_regvar(vm, "p") = 1.0f;
+		NSEEL_CODEHANDLE code = NSEEL_code_compile(vm, kernels[k][1], 0);
+		if (!code)
+		{
+			printf("%s: %s\n", kernels[k][0], NSEEL_code_getcodeerror(vm));
+			NSEEL_VM_free(vm);
+			continue;
+		}
+		double best = 1e9;
+		for (int r = 0; r < RUNS; r++)
+		{
+			double t0 = get_wall_time();
+			NSEEL_code_execute(code);
+			double t = get_wall_time() - t0;
+			if (t < best)
+				best = t;
+		}
+		printf("%-8s %6.2f ns/iter\n", kernels[k][0], best / ITERATIONS * 1e9);
+		NSEEL_code_free(code);
+		NSEEL_VM_free(vm);
+	}
+	NSEEL_quit();
+	return 0;
+}
\ No newline at end of file
@@ -9,7 +9,10 @@ LOCAL_SRC_FILES := \
 	jdsp/Effects/eel2/numericSys/codelet.c \
 	jdsp/generalDSP/digitalFilters.c \
 	jdsp/Effects/eel2/numericSys/FFTConvolver.c \
+	jdsp/Effects/eel2/numericSys/FHTPlan.c \
+	jdsp/Effects/eel2/numericSys/MixedRadixFHT.c \
 	jdsp/generalDSP/TwoStageFFTConvolver.c \
+	jdsp/generalDSP/HybridFIRConvolver.c \
 	jdsp/generalDSP/interpolation.c \
 	jdsp/generalDSP/generalProg.c \
 	jdsp/Effects/vdc.c \
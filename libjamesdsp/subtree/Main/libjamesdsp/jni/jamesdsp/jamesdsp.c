@@ -214,6 +214,8 @@ int32_t EffectDSPMainCommand(EffectDSPMain *dspmain, uint32_t cmdCode, uint32_t
 	}
 	if (cmdCode == EFFECT_CMD_SET_PARAM)
 	{
+		// Parameter changes are the periodic control call on Android
+		JamesDSPReclaim(&dspmain->jdsp);
 		effect_param_t *cep = (effect_param_t *)pCmdData;
 		int32_t *replyData = (int32_t *)pReplyData;
 		if (cep->psize == 4 && cep->vsize == 2)
@@ -65,4 +65,60 @@ void BS2BProcess(t_bs2bdp *bs2bdp, double *sampleL, double *sampleR)
 	/* Bass boost cause allpass attenuation */
 	*sampleL *= bs2bdp->gain;
 	*sampleR *= bs2bdp->gain;
+}
+/* Block versions, both channels run side by side with coefficients and state kept in locals */
+void BS2BProcessBlock(t_bs2bdp *bs2bdp, float *x1, float *x2, size_t n)
+{
+	const double a0_lo = bs2bdp->a0_lo, b1_lo = bs2bdp->b1_lo;
+	const double a0_hi = bs2bdp->a0_hi, a1_hi = bs2bdp->a1_hi, b1_hi = bs2bdp->b1_hi;
+	const double gain = bs2bdp->gain;
+	double loL = bs2bdp->lfs.lo[0], loR = bs2bdp->lfs.lo[1];
+	double hiL = bs2bdp->lfs.hi[0], hiR = bs2bdp->lfs.hi[1];
+	double asisL = bs2bdp->lfs.asis[0], asisR = bs2bdp->lfs.asis[1];
+	for (size_t i = 0; i < n; i++)
+	{
+		const double inL = (double)x1[i], inR = (double)x2[i];
+		loL = a0_lo * inL + b1_lo * loL;
+		loR = a0_lo * inR + b1_lo * loR;
+		hiL = a0_hi * inL + a1_hi * asisL + b1_hi * hiL;
+		hiR = a0_hi * inR + a1_hi * asisR + b1_hi * hiR;
+		asisL = inL;
+		asisR = inR;
+		x1[i] = (float)((hiL + loR) * gain);
+		x2[i] = (float)((hiR + loL) * gain);
+	}
+	bs2bdp->lfs.lo[0] = loL;
+	bs2bdp->lfs.lo[1] = loR;
+	bs2bdp->lfs.hi[0] = hiL;
+	bs2bdp->lfs.hi[1] = hiR;
+	bs2bdp->lfs.asis[0] = asisL;
+	bs2bdp->lfs.asis[1] = asisR;
+}
+/* Single precision, the state is carried over in the same double fields */
+void BS2BProcessBlockFloat(t_bs2bdp *bs2bdp, float *x1, float *x2, size_t n)
+{
+	const float a0_lo = (float)bs2bdp->a0_lo, b1_lo = (float)bs2bdp->b1_lo;
+	const float a0_hi = (float)bs2bdp->a0_hi, a1_hi = (float)bs2bdp->a1_hi, b1_hi = (float)bs2bdp->b1_hi;
+	const float gain = (float)bs2bdp->gain;
+	float loL = (float)bs2bdp->lfs.lo[0], loR = (float)bs2bdp->lfs.lo[1];
+	float hiL = (float)bs2bdp->lfs.hi[0], hiR = (float)bs2bdp->lfs.hi[1];
+	float asisL = (float)bs2bdp->lfs.asis[0], asisR = (float)bs2bdp->lfs.asis[1];
+	for (size_t i = 0; i < n; i++)
+	{
+		const float inL = x1[i], inR = x2[i];
+		loL = a0_lo * inL + b1_lo * loL;
+		loR = a0_lo * inR + b1_lo * loR;
+		hiL = a0_hi * inL + a1_hi * asisL + b1_hi * hiL;
+		hiR = a0_hi * inR + a1_hi * asisR + b1_hi * hiR;
+		asisL = inL;
+		asisR = inR;
+		x1[i] = (hiL + loR) * gain;
+		x2[i] = (hiR + loL) * gain;
+	}
+	bs2bdp->lfs.lo[0] = loL;
+	bs2bdp->lfs.lo[1] = loR;
+	bs2bdp->lfs.hi[0] = hiL;
+	bs2bdp->lfs.hi[1] = hiR;
+	bs2bdp->lfs.asis[0] = asisL;
+	bs2bdp->lfs.asis[1] = asisR;
 }
\ No newline at end of file
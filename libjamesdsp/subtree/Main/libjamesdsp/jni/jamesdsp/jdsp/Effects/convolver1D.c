@@ -22,7 +22,7 @@ void Convolver1DDestructor(JamesDSPLib *jdsp, int reqUnlock)
 	jdsp_lock(jdsp);
 	if (jdsp->conv.conv1d2x2_S_S)
 	{
-		FFTConvolver2x2Free(jdsp->conv.conv1d2x2_S_S);
+		HybridFIRConvolver2x2Free(jdsp->conv.conv1d2x2_S_S);
 		free(jdsp->conv.conv1d2x2_S_S);
 	}
 	if (jdsp->conv.conv1d2x2_T_S)
@@ -43,9 +43,9 @@ void Convolver1DDestructor(JamesDSPLib *jdsp, int reqUnlock)
 	if (reqUnlock)
 		jdsp_unlock(jdsp);
 }
-void Convolver1DProcessFFTConvolver2x2(JamesDSPLib *jdsp, size_t n)
+void Convolver1DProcessHybridFIRConvolver2x2(JamesDSPLib *jdsp, size_t n)
 {
-	FFTConvolver2x2Process(jdsp->conv.conv1d2x2_S_S, jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], (unsigned int)n);
+	HybridFIRConvolver2x2Process(jdsp->conv.conv1d2x2_S_S, jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], (unsigned int)n);
 }
 void Convolver1DProcessTwoStageFFTConvolver2x2(JamesDSPLib *jdsp, size_t n)
 {
@@ -89,27 +89,27 @@ int Convolver1DLoadImpulseResponse(JamesDSPLib *jdsp, float *tempImpulseFloat, u
 	{
 		if (impChannels == 1)
 		{
-			jdsp->conv.conv1d2x2_S_S = (FFTConvolver2x2*)malloc(sizeof(FFTConvolver2x2));
+			jdsp->conv.conv1d2x2_S_S = (HybridFIRConvolver2x2*)malloc(sizeof(HybridFIRConvolver2x2));
 			if (!jdsp->conv.conv1d2x2_S_S)
 			{
 				jdsp_unlock(jdsp);
 				return -1;
 			}
-			FFTConvolver2x2Init(jdsp->conv.conv1d2x2_S_S);
-			FFTConvolver2x2LoadImpulseResponse(jdsp->conv.conv1d2x2_S_S, (unsigned int)jdsp->blockSize, finalImpulse[0], finalImpulse[0], impulseLengthActual);
-			jdsp->conv.process = Convolver1DProcessFFTConvolver2x2;
+			HybridFIRConvolver2x2Init(jdsp->conv.conv1d2x2_S_S);
+			HybridFIRConvolver2x2LoadImpulseResponse(jdsp->conv.conv1d2x2_S_S, (unsigned int)jdsp->blockSize, finalImpulse[0], finalImpulse[0], impulseLengthActual);
+			jdsp->conv.process = Convolver1DProcessHybridFIRConvolver2x2;
 		}
 		if (impChannels == 2)
 		{
-			jdsp->conv.conv1d2x2_S_S = (FFTConvolver2x2*)malloc(sizeof(FFTConvolver2x2));
+			jdsp->conv.conv1d2x2_S_S = (HybridFIRConvolver2x2*)malloc(sizeof(HybridFIRConvolver2x2));
 			if (!jdsp->conv.conv1d2x2_S_S)
 			{
 				jdsp_unlock(jdsp);
 				return -1;
 			}
-			FFTConvolver2x2Init(jdsp->conv.conv1d2x2_S_S);
-			FFTConvolver2x2LoadImpulseResponse(jdsp->conv.conv1d2x2_S_S, (unsigned int)jdsp->blockSize, finalImpulse[0], finalImpulse[1], impulseLengthActual);
-			jdsp->conv.process = Convolver1DProcessFFTConvolver2x2;
+			HybridFIRConvolver2x2Init(jdsp->conv.conv1d2x2_S_S);
+			HybridFIRConvolver2x2LoadImpulseResponse(jdsp->conv.conv1d2x2_S_S, (unsigned int)jdsp->blockSize, finalImpulse[0], finalImpulse[1], impulseLengthActual);
+			jdsp->conv.process = Convolver1DProcessHybridFIRConvolver2x2;
 		}
 		if (impChannels == 4)
 		{
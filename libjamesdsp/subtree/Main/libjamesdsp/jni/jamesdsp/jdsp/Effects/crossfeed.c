@@ -4,77 +4,172 @@
 #include <math.h>
 #include <float.h>
 #include "../jdsp_header.h"
+// Mode switches crossfade over this long
+#define CROSSFEED_FADE_MS 20
+#define CROSSFEED_FADE_CHUNK 256
+// HRTF engines of modes that have not run for this long are freed by CrossfeedReclaim
+#define CROSSFEED_GRACE_SECONDS 10
+// BS2B coefficient changes are spread over this many samples, in steps of constant coefficients
+#define CROSSFEED_BS2B_GLIDE 512
+#define CROSSFEED_BS2B_GLIDE_STEP 32
 void CrossfeedConstructor(JamesDSPLib *jdsp)
 {
 	memset(&jdsp->advXF, 0, sizeof(jdsp->advXF));
+	jdsp->advXF.bs2bLevel[0] = BS2B_DEFAULT_CLEVEL;
+	jdsp->advXF.bs2bLevel[1] = BS2B_JMEIER_CLEVEL;
 }
-void CrossfeedDestructor(JamesDSPLib *jdsp)
+// Modes 2 - 4 run conv[mode - 2], mode 5 the long convolver
+static void** CrossfeedEngineSlot(Crossfeed *xf, int mode)
 {
-	jdsp_lock(jdsp);
-	if (jdsp->advXF.conv[0])
+	return mode < 5 ? (void**)&xf->conv[mode - 2] : (void**)&xf->convLong;
+}
+static void CrossfeedFreeEngine(int mode, void *engine)
+{
+	if (!engine)
+		return;
+	if (mode < 5)
+		FFTConvolver2x4x2Free((FFTConvolver2x4x2*)engine);
+	else
+		TwoStageFFTConvolver2x4x2Free((TwoStageFFTConvolver2x4x2*)engine);
+	free(engine);
+}
+static void* CrossfeedBuildEngine(JamesDSPLib *jdsp, int mode)
+{
+	if (mode < 5)
+	{
+		const int i = mode - 2;
+		FFTConvolver2x4x2 *conv = (FFTConvolver2x4x2*)malloc(sizeof(FFTConvolver2x4x2));
+		if (!conv)
+			return 0;
+		FFTConvolver2x4x2Init(conv);
+		if (!FFTConvolver2x4x2LoadImpulseResponse(conv, (unsigned int)jdsp->blockSize, jdsp->blobsCh1[i], jdsp->blobsCh2[i], jdsp->blobsCh3[i], jdsp->blobsCh4[i], jdsp->blobsResampledLen))
+		{
+			CrossfeedFreeEngine(mode, conv);
+			return 0;
+		}
+		return conv;
+	}
+	TwoStageFFTConvolver2x4x2 *convLong = (TwoStageFFTConvolver2x4x2*)malloc(sizeof(TwoStageFFTConvolver2x4x2));
+	if (!convLong)
+		return 0;
+	TwoStageFFTConvolver2x4x2Init(convLong);
+	unsigned int seg1Len = (unsigned int)jdsp->blockSize;
+	unsigned int seg2Len = (jdsp->frameLenSVirResampled - seg1Len) / 4;
+	if (!TwoStageFFTConvolver2x4x2LoadImpulseResponse(convLong, seg1Len, seg2Len, jdsp->hrtfblobsResampled[0], jdsp->hrtfblobsResampled[1], jdsp->hrtfblobsResampled[2], jdsp->hrtfblobsResampled[3], jdsp->frameLenSVirResampled))
 	{
-		FFTConvolver2x4x2Free(jdsp->advXF.conv[0]);
-		FFTConvolver2x4x2Free(jdsp->advXF.conv[1]);
-		FFTConvolver2x4x2Free(jdsp->advXF.conv[2]);
-		free(jdsp->advXF.conv[0]);
-		free(jdsp->advXF.conv[1]);
-		free(jdsp->advXF.conv[2]);
+		CrossfeedFreeEngine(mode, convLong);
+		return 0;
 	}
-	if (jdsp->advXF.convLong)
+	return convLong;
+}
+// Must hold the lock. Takes the engines out of the modes that are neither running, fading out nor used within
+// the grace period, the caller frees them once the lock is released
+static void CrossfeedDetachIdle(JamesDSPLib *jdsp, void *stale[4])
+{
+	Crossfeed *xf = &jdsp->advXF;
+	const unsigned long long grace = (unsigned long long)(jdsp->fs * CROSSFEED_GRACE_SECONDS);
+	for (int m = 2; m < 6; m++)
 	{
-		TwoStageFFTConvolver2x4x2Free(jdsp->advXF.convLong);
-		free(jdsp->advXF.convLong);
+		void **slot = CrossfeedEngineSlot(xf, m);
+		if (!*slot || m == xf->mode || (m == xf->prevMode && xf->fadePos < xf->fadeLen) || xf->clock - xf->lastUsed[m - 2] < grace)
+			continue;
+		stale[m - 2] = *slot;
+		*slot = 0;
 	}
-	jdsp_unlock(jdsp);
 }
-void CrossfeedRefreshConv(JamesDSPLib *jdsp)
+/*
+* Switches to nMode. Its HRTF engine is built before the lock is taken, so processing only
+* waits for the pointer swap. Idle engines, or all of them after a sample rate change, are
+* detached under the lock and freed after it.
+* A switch while crossfeed is enabled crossfades from the old mode
+*/
+static void CrossfeedPrepare(JamesDSPLib *jdsp, int nMode)
 {
+	Crossfeed *xf = &jdsp->advXF;
+	void *stale[4] = { 0 };
+	void *engine = 0;
+	const int refresh = jdsp->crossfeedForceRefresh;
+	jdsp->crossfeedForceRefresh = 0;
+	if (nMode >= 2 && (refresh || !*CrossfeedEngineSlot(xf, nMode)))
+		engine = CrossfeedBuildEngine(jdsp, nMode);
 	jdsp_lock(jdsp);
-	if (jdsp->advXF.conv[0])
+	if (nMode >= 2)
+		xf->lastUsed[nMode - 2] = xf->clock;
+	if (refresh)
+	{
+		for (int m = 2; m < 6; m++)
+		{
+			void **slot = CrossfeedEngineSlot(xf, m);
+			stale[m - 2] = *slot;
+			*slot = 0;
+		}
+	}
+	else
 	{
-		FFTConvolver2x4x2Free(jdsp->advXF.conv[0]);
-		FFTConvolver2x4x2Free(jdsp->advXF.conv[1]);
-		FFTConvolver2x4x2Free(jdsp->advXF.conv[2]);
-		free(jdsp->advXF.conv[0]);
-		free(jdsp->advXF.conv[1]);
-		free(jdsp->advXF.conv[2]);
+		CrossfeedDetachIdle(jdsp, stale);
+		if (engine)
+		{
+			void **slot = CrossfeedEngineSlot(xf, nMode);
+			stale[nMode - 2] = *slot;
+			*slot = 0;
+		}
 	}
-	if (jdsp->advXF.convLong)
+	if (engine)
+		*CrossfeedEngineSlot(xf, nMode) = engine;
+	if (jdsp->crossfeedEnabled && nMode != xf->mode && (xf->mode < 2 || *CrossfeedEngineSlot(xf, xf->mode)) && (nMode < 2 || *CrossfeedEngineSlot(xf, nMode)))
 	{
-		TwoStageFFTConvolver2x4x2Free(jdsp->advXF.convLong);
-		free(jdsp->advXF.convLong);
+		xf->prevMode = xf->mode;
+		xf->fadePos = 0;
+		xf->fadeLen = (unsigned int)(jdsp->fs * CROSSFEED_FADE_MS / 1000);
 	}
-	jdsp->advXF.conv[0] = (FFTConvolver2x4x2*)malloc(sizeof(FFTConvolver2x4x2));
-	FFTConvolver2x4x2Init(jdsp->advXF.conv[0]);
-	FFTConvolver2x4x2LoadImpulseResponse(jdsp->advXF.conv[0], (unsigned int)jdsp->blockSize, jdsp->blobsCh1[0], jdsp->blobsCh2[0], jdsp->blobsCh3[0], jdsp->blobsCh4[0], jdsp->blobsResampledLen);
-	jdsp->advXF.conv[1] = (FFTConvolver2x4x2*)malloc(sizeof(FFTConvolver2x4x2));
-	FFTConvolver2x4x2Init(jdsp->advXF.conv[1]);
-	FFTConvolver2x4x2LoadImpulseResponse(jdsp->advXF.conv[1], (unsigned int)jdsp->blockSize, jdsp->blobsCh1[1], jdsp->blobsCh2[1], jdsp->blobsCh3[1], jdsp->blobsCh4[1], jdsp->blobsResampledLen);
-	jdsp->advXF.conv[2] = (FFTConvolver2x4x2*)malloc(sizeof(FFTConvolver2x4x2));
-	FFTConvolver2x4x2Init(jdsp->advXF.conv[2]);
-	FFTConvolver2x4x2LoadImpulseResponse(jdsp->advXF.conv[2], (unsigned int)jdsp->blockSize, jdsp->blobsCh1[2], jdsp->blobsCh2[2], jdsp->blobsCh3[2], jdsp->blobsCh4[2], jdsp->blobsResampledLen);
-	jdsp->advXF.convLong = (TwoStageFFTConvolver2x4x2*)malloc(sizeof(TwoStageFFTConvolver2x4x2));
-	TwoStageFFTConvolver2x4x2Init(jdsp->advXF.convLong);
-	unsigned int seg1Len = (unsigned int)jdsp->blockSize;
-	unsigned int seg2Len = (jdsp->frameLenSVirResampled - seg1Len) / 4;
-	TwoStageFFTConvolver2x4x2LoadImpulseResponse(jdsp->advXF.convLong, seg1Len, seg2Len, jdsp->hrtfblobsResampled[0], jdsp->hrtfblobsResampled[1], jdsp->hrtfblobsResampled[2], jdsp->hrtfblobsResampled[3], jdsp->frameLenSVirResampled);
+	else if (xf->fadePos < xf->fadeLen && xf->prevMode >= 2 && !*CrossfeedEngineSlot(xf, xf->prevMode))
+		xf->fadeLen = 0;
+	xf->mode = nMode;
+	jdsp_unlock(jdsp);
+	for (int m = 2; m < 6; m++)
+		CrossfeedFreeEngine(m, stale[m - 2]);
+}
+// Frees the HRTF engines that went idle, cheap enough for a periodic call from the control thread
+void CrossfeedReclaim(JamesDSPLib *jdsp)
+{
+	void *stale[4] = { 0 };
+	jdsp_lock(jdsp);
+	CrossfeedDetachIdle(jdsp, stale);
+	jdsp_unlock(jdsp);
+	for (int m = 2; m < 6; m++)
+		CrossfeedFreeEngine(m, stale[m - 2]);
+}
+void CrossfeedDestructor(JamesDSPLib *jdsp)
+{
+	jdsp_lock(jdsp);
+	for (int m = 2; m < 6; m++)
+	{
+		void **slot = CrossfeedEngineSlot(&jdsp->advXF, m);
+		CrossfeedFreeEngine(m, *slot);
+		*slot = 0;
+	}
+	jdsp->advXF.fadeLen = 0;
 	jdsp_unlock(jdsp);
 }
 void CrossfeedEnable(JamesDSPLib *jdsp)
 {
 	if (jdsp->advXF.mode >= 2)
 	{
-		if (jdsp->crossfeedForceRefresh || !jdsp->advXF.conv[0] || !jdsp->advXF.conv[1] || !jdsp->advXF.conv[2] || !jdsp->advXF.convLong)
-		{
-			CrossfeedRefreshConv(jdsp);
-			jdsp->crossfeedForceRefresh = 0;
-		}
+		if (jdsp->crossfeedForceRefresh || !*CrossfeedEngineSlot(&jdsp->advXF, jdsp->advXF.mode))
+			CrossfeedPrepare(jdsp, jdsp->advXF.mode);
 	}
 	if (jdsp->advXF.mode < 2)
 	{
-		memset(&jdsp->advXF.bs2b, 0, sizeof(jdsp->advXF.bs2b));
-		BS2BInit(&jdsp->advXF.bs2b[0], (unsigned int)jdsp->fs, BS2B_DEFAULT_CLEVEL);
-		BS2BInit(&jdsp->advXF.bs2b[1], (unsigned int)jdsp->fs, BS2B_JMEIER_CLEVEL);
+		if (!jdsp->crossfeedEnabled)
+		{
+			jdsp_lock(jdsp);
+			for (int m = 0; m < 2; m++)
+				memset(&jdsp->advXF.bs2b[m].lfs, 0, sizeof(jdsp->advXF.bs2b[m].lfs));
+			jdsp_unlock(jdsp);
+		}
+		// Sample rate may have changed since the levels were set
+		CrossfeedSetBS2BLevel(jdsp, 0, jdsp->advXF.bs2bLevel[0]);
+		CrossfeedSetBS2BLevel(jdsp, 1, jdsp->advXF.bs2bLevel[1]);
 	}
 	jdsp->crossfeedEnabled = 1;
 }
@@ -88,40 +183,125 @@ void CrossfeedChangeMode(JamesDSPLib *jdsp, int nMode)
 		nMode = 0;
 	if (nMode > 5)
 		nMode = 5;
-	if (nMode >= 2)
+	if (nMode < 2)
+		CrossfeedSetBS2BLevel(jdsp, nMode, !nMode ? BS2B_DEFAULT_CLEVEL : BS2B_JMEIER_CLEVEL);
+	CrossfeedPrepare(jdsp, nMode);
+}
+/*
+* Sets the BS2B level of mode 0 or 1. Coefficients are computed here, the lock is only held to
+* hand them over. The running filter keeps its state and glides to them, a slot that never ran
+* takes them right away
+*/
+void CrossfeedSetBS2BLevel(JamesDSPLib *jdsp, int nMode, int flevel)
+{
+	if (nMode < 0 || nMode > 1)
+		return;
+	t_bs2bdp target;
+	memset(&target, 0, sizeof(target));
+	BS2BInit(&target, (unsigned int)jdsp->fs, flevel);
+	jdsp_lock(jdsp);
+	Crossfeed *xf = &jdsp->advXF;
+	xf->bs2bLevel[nMode] = flevel;
+	xf->bs2bTarget[nMode] = target;
+	if (xf->bs2b[nMode].gain == 0.0)
 	{
-		if (jdsp->crossfeedForceRefresh || !jdsp->advXF.conv[0] || !jdsp->advXF.conv[1] || !jdsp->advXF.conv[2] || !jdsp->advXF.convLong)
-		{
-			CrossfeedRefreshConv(jdsp);
-			jdsp->crossfeedForceRefresh = 0;
-		}
+		xf->bs2b[nMode] = target;
+		xf->bs2bGlide[nMode] = 0;
 	}
-	if (nMode < 2)
+	else
+		xf->bs2bGlide[nMode] = CROSSFEED_BS2B_GLIDE;
+	jdsp_unlock(jdsp);
+}
+// BS2B modes in single or double precision, the filter state carries over
+void CrossfeedSetBS2BPrecision(JamesDSPLib *jdsp, int useFloat)
+{
+	jdsp_lock(jdsp);
+	jdsp->advXF.bs2bUseFloat = useFloat;
+	jdsp_unlock(jdsp);
+}
+static void CrossfeedRunBS2B(Crossfeed *xf, int mode, float *x1, float *x2, size_t n)
+{
+	t_bs2bdp *bs2b = &xf->bs2b[mode];
+	void (*process)(t_bs2bdp*, float*, float*, size_t) = xf->bs2bUseFloat ? BS2BProcessBlockFloat : BS2BProcessBlock;
+	while (xf->bs2bGlide[mode] && n)
 	{
-		memset(&jdsp->advXF.bs2b, 0, sizeof(jdsp->advXF.bs2b));
-		if (!nMode)
-			BS2BInit(&jdsp->advXF.bs2b[1], (unsigned int)jdsp->fs, BS2B_CMOY_CLEVEL);
+		const t_bs2bdp *target = &xf->bs2bTarget[mode];
+		const size_t len = min(min(n, CROSSFEED_BS2B_GLIDE_STEP), xf->bs2bGlide[mode]);
+		const double frac = (double)len / (double)xf->bs2bGlide[mode];
+		xf->bs2bGlide[mode] -= (unsigned int)len;
+		if (!xf->bs2bGlide[mode])
+		{
+			bs2b->a0_lo = target->a0_lo;
+			bs2b->b1_lo = target->b1_lo;
+			bs2b->a0_hi = target->a0_hi;
+			bs2b->a1_hi = target->a1_hi;
+			bs2b->b1_hi = target->b1_hi;
+			bs2b->gain = target->gain;
+		}
 		else
-			BS2BInit(&jdsp->advXF.bs2b[1], (unsigned int)jdsp->fs, BS2B_JMEIER_CLEVEL);
+		{
+			bs2b->a0_lo += (target->a0_lo - bs2b->a0_lo) * frac;
+			bs2b->b1_lo += (target->b1_lo - bs2b->b1_lo) * frac;
+			bs2b->a0_hi += (target->a0_hi - bs2b->a0_hi) * frac;
+			bs2b->a1_hi += (target->a1_hi - bs2b->a1_hi) * frac;
+			bs2b->b1_hi += (target->b1_hi - bs2b->b1_hi) * frac;
+			bs2b->gain += (target->gain - bs2b->gain) * frac;
+		}
+		process(bs2b, x1, x2, len);
+		x1 += len;
+		x2 += len;
+		n -= len;
 	}
-	jdsp->advXF.mode = nMode;
+	process(bs2b, x1, x2, n);
+}
+static void CrossfeedRun(JamesDSPLib *jdsp, int mode, float *x1, float *x2, size_t n)
+{
+	if (mode < 2)
+		CrossfeedRunBS2B(&jdsp->advXF, mode, x1, x2, n);
+	else if (!*CrossfeedEngineSlot(&jdsp->advXF, mode))
+		return;
+	else if (mode < 5)
+		FFTConvolver2x4x2Process(jdsp->advXF.conv[mode - 2], x1, x2, x1, x2, (unsigned int)n);
+	else
+		TwoStageFFTConvolver2x4x2Process(jdsp->advXF.convLong, x1, x2, x1, x2, (unsigned int)n);
 }
 void CrossfeedProcess(JamesDSPLib *jdsp, size_t n)
 {
-	if (jdsp->advXF.mode < 2)
+	Crossfeed *xf = &jdsp->advXF;
+	xf->clock += n;
+	if (xf->mode >= 2)
+		xf->lastUsed[xf->mode - 2] = xf->clock;
+	if (xf->fadePos >= xf->fadeLen)
+	{
+		CrossfeedRun(jdsp, xf->mode, jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], n);
+		return;
+	}
+	if (xf->prevMode >= 2)
+		xf->lastUsed[xf->prevMode - 2] = xf->clock;
+	// Old and new mode run side by side until the fade is done
+	float oldL[CROSSFEED_FADE_CHUNK], oldR[CROSSFEED_FADE_CHUNK];
+	for (size_t i = 0; i < n; i += CROSSFEED_FADE_CHUNK)
 	{
-		double tmpL, tmpR;
-		for (size_t i = 0; i < n; i++)
+		const size_t len = min(n - i, CROSSFEED_FADE_CHUNK);
+		float *x1 = jdsp->tmpBuffer[0] + i;
+		float *x2 = jdsp->tmpBuffer[1] + i;
+		if (xf->fadePos >= xf->fadeLen)
 		{
-			tmpL = (double)jdsp->tmpBuffer[0][i];
-			tmpR = (double)jdsp->tmpBuffer[1][i];
-			BS2BProcess(&jdsp->advXF.bs2b[jdsp->advXF.mode], &tmpL, &tmpR);
-			jdsp->tmpBuffer[0][i] = (float)tmpL;
-			jdsp->tmpBuffer[1][i] = (float)tmpR;
+			CrossfeedRun(jdsp, xf->mode, x1, x2, len);
+			continue;
+		}
+		memcpy(oldL, x1, len * sizeof(float));
+		memcpy(oldR, x2, len * sizeof(float));
+		CrossfeedRun(jdsp, xf->prevMode, oldL, oldR, len);
+		CrossfeedRun(jdsp, xf->mode, x1, x2, len);
+		const float step = 1.0f / (float)xf->fadeLen;
+		for (size_t j = 0; j < len; j++)
+		{
+			const float g = xf->fadePos < xf->fadeLen ? (float)xf->fadePos * step : 1.0f;
+			x1[j] = oldL[j] + g * (x1[j] - oldL[j]);
+			x2[j] = oldR[j] + g * (x2[j] - oldR[j]);
+			if (xf->fadePos < xf->fadeLen)
+				xf->fadePos++;
 		}
 	}
-	else if (jdsp->advXF.mode < 5)
-		FFTConvolver2x4x2Process(jdsp->advXF.conv[jdsp->advXF.mode - 2], jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], (unsigned int)n);
-	else
-		TwoStageFFTConvolver2x4x2Process(jdsp->advXF.convLong, jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], (unsigned int)n);
-}
\ No newline at end of file
+}
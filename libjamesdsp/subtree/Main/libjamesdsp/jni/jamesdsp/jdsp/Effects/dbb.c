@@ -320,44 +320,27 @@ static void DBBParam(DBB *dbb, double fs, float maxG)
 }
 static void DBBProcess(DBB *dbb, float *x1, float *x2, float *y1, float *y2, size_t n)
 {
+	// Analysis input in bit reversed order, so the FHT runs in place on the gathered frame
+	static const unsigned char bitReverse16[16] = { 0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15 };
 	int pos = dbb->downsamplerPos;
-	for (size_t framePos = 0; framePos < n; framePos++)
+	int hopped = 0;
+	double *buf = dbb->decimationBuf;
+	for (size_t offset = 0; offset < n; offset += DBB_BLOCK)
 	{
-		dbb->originalBuf[pos] = (x1[framePos] + x2[framePos]) * 0.5f;
-		pos++;
-		if (pos == dbb->downsampler.factor)
+		size_t len = n - offset < DBB_BLOCK ? n - offset : DBB_BLOCK;
+		for (size_t i = 0; i < len; i++)
+			buf[i] = (double)((x1[offset + i] + x2[offset + i]) * 0.5f);
+		iirSOSProcessorProcessBiquadBlock(&dbb->downsampler.lpfD, dbb->downsampler.coeffs, buf, len);
+		for (size_t i = 0; i < len; i++)
 		{
-			dbb->delayLine[15] = dbb->delayLine[14];
-			dbb->delayLine[14] = dbb->delayLine[13];
-			dbb->delayLine[13] = dbb->delayLine[12];
-			dbb->delayLine[12] = dbb->delayLine[11];
-			dbb->delayLine[11] = dbb->delayLine[10];
-			dbb->delayLine[10] = dbb->delayLine[9];
-			dbb->delayLine[9] = dbb->delayLine[8];
-			dbb->delayLine[8] = dbb->delayLine[7];
-			dbb->delayLine[7] = dbb->delayLine[6];
-			dbb->delayLine[6] = dbb->delayLine[5];
-			dbb->delayLine[5] = dbb->delayLine[4];
-			dbb->delayLine[4] = dbb->delayLine[3];
-			dbb->delayLine[3] = dbb->delayLine[2];
-			dbb->delayLine[2] = dbb->delayLine[1];
-			dbb->delayLine[1] = dbb->delayLine[0];
-			dbb->fftBuf[0] = dbb->delayLine[0] = oversample_stepdownSmpFloat(&dbb->downsampler, dbb->originalBuf);
-			dbb->fftBuf[8] = dbb->delayLine[1];
-			dbb->fftBuf[4] = dbb->delayLine[2];
-			dbb->fftBuf[12] = dbb->delayLine[3];
-			dbb->fftBuf[2] = dbb->delayLine[4];
-			dbb->fftBuf[10] = dbb->delayLine[5];
-			dbb->fftBuf[6] = dbb->delayLine[6];
-			dbb->fftBuf[14] = dbb->delayLine[7];
-			dbb->fftBuf[1] = dbb->delayLine[8];
-			dbb->fftBuf[9] = dbb->delayLine[9];
-			dbb->fftBuf[5] = dbb->delayLine[10];
-			dbb->fftBuf[13] = dbb->delayLine[11];
-			dbb->fftBuf[3] = dbb->delayLine[12];
-			dbb->fftBuf[11] = dbb->delayLine[13];
-			dbb->fftBuf[7] = dbb->delayLine[14];
-			dbb->fftBuf[15] = dbb->delayLine[15];
+			if (++pos != dbb->downsampler.factor)
+				continue;
+			pos = 0;
+			hopped = 1;
+			unsigned int newest = dbb->delayLinePos = (dbb->delayLinePos - 1) & 15;
+			dbb->delayLine[newest] = (float)(buf[i] * dbb->downsampler.gain);
+			for (int k = 0; k < 16; k++)
+				dbb->fftBuf[bitReverse16[k]] = dbb->delayLine[(newest + k) & 15];
 			fht16(dbb->fftBuf);
 			float peak1 = dbb->smoothFFTBuffer[0] = fabsf(dbb->fftBuf[0]);
 			float peak2 = fabsf(dbb->fftBuf[0]);
@@ -410,17 +393,63 @@ static void DBBProcess(DBB *dbb, float *x1, float *x2, float *y1, float *y2, siz
 				gainClamp = dbb->maxGain;
 			dbb->boostdB = gainClamp * dbb->gainSmoothingFactor + dbb->boostdB * dbb->minusgainSmoothingFactor;
 			dbb->smoothMaxFreq = currentMaxFreq * dbb->maxSmoothingFactor + dbb->smoothMaxFreq * dbb->minusmaxSmoothingFactor;
-			refreshStateVariable2ndOrder(&dbb->svf[0], dbb->fs, dbb->smoothMaxFreq, resonanceToQ(0.75), db2mag(dbb->boostdB));
 #ifdef DEBUG_DBB
 			fprintf(tele, "gain: %1.7f fc: %1.7f binNum: %d\n", dbb->boostdB, dbb->smoothMaxFreq, binNum + 1);
 #endif
-			pos = 0;
 		}
 	}
 	dbb->downsamplerPos = pos;
+	// Only the last hop's coefficients reach the filter below
+	if (hopped)
+		refreshStateVariable2ndOrder(&dbb->svf[0], dbb->fs, dbb->smoothMaxFreq, resonanceToQ(0.75), db2mag(dbb->boostdB));
 	const StateVariable2ndOrder *ptr[2] = { &dbb->svf[0], &dbb->svf[1] };
+	if (dbb->svf[0].filterType != SVFPeak)
+	{
+		for (size_t i = 0; i < n; i++)
+			ProcessStateVariable2ndOrderStereo(ptr, integerDelayLineProcess(&dbb->dL[0], x1[i]), integerDelayLineProcess(&dbb->dL[1], x2[i]), &y1[i], &y2[i]);
+		return;
+	}
+	// Both channels share the coefficients of svf[0], delay lines and filter states stay in locals
+	const StateVariable2ndOrder *svf = &dbb->svf[0];
+	const float c1 = svf->precomputeCoeff1, c2 = svf->precomputeCoeff2, c3 = svf->precomputeCoeff3, g = svf->gCoeff, K = svf->KCoeff;
+	float z1L = dbb->svf[0].z1_A, z2L = dbb->svf[0].z2_A, z1R = dbb->svf[1].z1_A, z2R = dbb->svf[1].z2_A;
+	integerDelayLine *dL = &dbb->dL[0], *dR = &dbb->dL[1];
+	int len = dL->allocateLen;
+	int inL = dL->inPoint, outL = dL->outPoint, inR = dR->inPoint, outR = dR->outPoint;
 	for (size_t i = 0; i < n; i++)
-		ProcessStateVariable2ndOrderStereo(ptr, integerDelayLineProcess(&dbb->dL[0], x1[i]), integerDelayLineProcess(&dbb->dL[1], x2[i]), &y1[i], &y2[i]);
+	{
+		dL->inputs[inL] = x1[i];
+		dR->inputs[inR] = x2[i];
+		if (++inL == len)
+			inL = 0;
+		if (++inR == len)
+			inR = 0;
+		const float xL = dL->inputs[outL], xR = dR->inputs[outR];
+		if (++outL >= len)
+			outL -= len;
+		if (++outR >= len)
+			outR -= len;
+		const float HPL = (xL - c1 * z1L - z2L) * c2;
+		const float HPR = (xR - c1 * z1R - z2R) * c2;
+		const float BPL = HPL * g + z1L;
+		const float BPR = HPR * g + z1R;
+		const float LPL = BPL * g + z2L;
+		const float LPR = BPR * g + z2R;
+		z1L = g * HPL + BPL;
+		z1R = g * HPR + BPR;
+		z2L = g * BPL + LPL;
+		z2R = g * BPR + LPR;
+		y1[i] = xL + c3 * BPL * K;
+		y2[i] = xR + c3 * BPR * K;
+	}
+	dL->inPoint = inL;
+	dL->outPoint = outL;
+	dR->inPoint = inR;
+	dR->outPoint = outR;
+	dbb->svf[0].z1_A = z1L;
+	dbb->svf[0].z2_A = z2L;
+	dbb->svf[1].z1_A = z1R;
+	dbb->svf[1].z2_A = z2R;
 }
 // Bass boost
 void BassBoostEnable(JamesDSPLib *jdsp)
@@ -441,6 +470,14 @@ void BassBoostSetParam(JamesDSPLib *jdsp, float maxG)
 {
 	DBBParam(&jdsp->dbb, jdsp->fs, maxG);
 }
+unsigned int BassBoostGetLatency(JamesDSPLib *jdsp)
+{
+	// The signal path waits for the gain detector through the delay line
+	integerDelayLine *dL = &jdsp->dbb.dL[0];
+	if (!dL->allocateLen)
+		return 0;
+	return (unsigned int)((dL->inPoint - dL->outPoint + dL->allocateLen) % dL->allocateLen);
+}
 void BassBoostProcess(JamesDSPLib *jdsp, size_t n)
 {
 	DBBProcess(&jdsp->dbb, jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], n);
@@ -17,7 +17,6 @@ void JLimiterInit(JamesDSPLib *jdsp)
 #include <string.h>
 #include <math.h>
 #include <float.h>
-#include "eel2/numericSys/codelet.h"
 #include "eel2/ns-eel.h"
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -49,38 +48,6 @@ static void getAsymmetricWindow(float *analysisWnd, float *synthesisWnd, int k,
 	for (i = 0; i < k - p; i++)
 		synthesisWnd[i] = synthesisWnd[i + p];
 }
-unsigned int LLIntegerLog2M(unsigned int v)
-{
-	unsigned int i = 0;
-	while (v > 1)
-	{
-		++i;
-		v >>= 1;
-	}
-	return i;
-}
-unsigned LLRevBitsM(unsigned int x, unsigned int bits)
-{
-	unsigned int y = 0;
-	while (bits--)
-	{
-		y = (y + y) + (x & 1);
-		x >>= 1;
-	}
-	return y;
-}
-void LLbitReversalTblM(unsigned *dst, unsigned int fftLen)
-{
-	unsigned int bits = LLIntegerLog2M(fftLen);
-	for (unsigned int i = 0; i < fftLen; ++i)
-		dst[i] = LLRevBitsM(i, bits);
-}
-void LLsinHalfTblFloatM(float *dst, unsigned int fftLen)
-{
-	const double twopi_over_n = 6.283185307179586476925286766559 / fftLen;
-	for (int i = 0; i < fftLen >> 1; ++i)
-		dst[i] = (float)sin(twopi_over_n * i);
-}
 #include "../generalDSP/spectralInterpolatorFloat.h"
 static size_t choose(float *a, float *b, size_t src1, size_t src2)
 {
@@ -145,11 +112,26 @@ static float lerp1DNoExtrapo(float val, float *x, float *y, int n)
 #define MAXRELEASETIME 800.0
 #define MINADAPTTIME (MAXRELEASETIME / 2.0)
 #define MAXADAPTTIME (MAXRELEASETIME * 2.0)
+#define AVGBW_DRS 1.00005
 #include <stdint.h>
+static void FFTCompressorUpdateCoefficients(FFTDynamicRangeSquasher *comp)
+{
+	// Attack and release coefficients
+	if (comp->metaMaxAttackTime < FLT_EPSILON)
+		comp->attackCoeff = 1.0f;
+	else
+		comp->attackCoeff = 1.0f - expf(-1.0f / (comp->metaMaxAttackTime * comp->spectralRate));
+	float trRel = comp->metaMaxReleaseTime - comp->metaMaxAttackTime;
+	if (trRel < FLT_EPSILON)
+		comp->releaseCoeff = 1.0f;
+	else
+		comp->releaseCoeff = 1.0f - expf(-1.0f / (trRel * comp->spectralRate));
+}
 void FFTCompressorSetSpectralFollowingRate(FFTDynamicRangeSquasher *comp, float fs, float fgt_facT)
 {
 	comp->spectralRate = fs / (float)comp->fftLen * (float)ANALYSIS_OVERLAP_DRS;
 	comp->fgt_fac = (float)(1.0 - exp(-1.0 / (fgt_facT / 1000.0 * comp->spectralRate)));
+	FFTCompressorUpdateCoefficients(comp);
 }
 void FFTCompressorSetParam(FFTDynamicRangeSquasher *comp, float fs, float maxAtk, float maxRel, float adapt)
 {
@@ -159,77 +141,258 @@ void FFTCompressorSetParam(FFTDynamicRangeSquasher *comp, float fs, float maxAtk
 	float metaAdaptTime = (float)adapt / 1000.0f;// 电平回复系数，回复对数电平到0dB
 	for (unsigned int i = 0; i < comp->procUpTo; i++)
 		comp->metaAdaptCoeff[i] = (float)(1.0 - exp(-1.0 / (metaAdaptTime * comp->spectralRate)));
+	FFTCompressorUpdateCoefficients(comp);
 }
-static float my_logf(float a)
+typedef union
 {
-	float m, r, s, t, i, f;
-	int32_t e;
-
-	if ((a > 0.0f) && (a <= 3.40e+38f)) { // 0x1.fffffep+127
-		m = frexpf(a, &e);
-		if (m < 0.666666667f) {
-			m = m + m;
-			e = e - 1;
-		}
-		i = (float)e;
-		/* m in [2/3, 4/3] */
-		f = m - 1.0f;
-		s = f * f;
+	float f;
+	int32_t i;
+} floatBits;
+// In place natural log of n magnitudes, anything below FLT_EPSILON reads as FLT_EPSILON
+// Branch free so the bin loop vectorises, error below 2 ulp
+static void spectralLog(float *x, unsigned int n)
+{
+	for (unsigned int k = 0; k < n; k++)
+	{
+		floatBits v;
+		v.f = MAX(x[k], FLT_EPSILON);
+		// Split into m * 2^e with m in [2/3, 4/3]
+		const int32_t e = (v.i - 0x3f2aaaab) & 0xff800000;
+		v.i -= e;
+		const float i = (float)(e >> 23);
+		const float f = v.f - 1.0f;
+		const float s = f * f;
 		/* Compute log1p(f) for f in [-1/3, 1/3] */
-		r = fmaf(-0.130187988f, f, 0.140889585f); // -0x1.0aa000p-3, 0x1.208ab8p-3
-		t = fmaf(-0.121489584f, f, 0.139809534f); // -0x1.f19f10p-4, 0x1.1e5476p-3
-		r = fmaf(r, s, t);
-		r = fmaf(r, f, -0.166845024f); // -0x1.55b2d8p-3
-		r = fmaf(r, f, 0.200121149f); //  0x1.99d91ep-3
-		r = fmaf(r, f, -0.249996364f); // -0x1.fffe18p-3
-		r = fmaf(r, f, 0.333331943f); //  0x1.5554f8p-2
-		r = fmaf(r, f, -0.500000000f); // -0x1.000000p-1
-		r = fmaf(r, s, f);
-		r = fmaf(i, 0.693147182f, r); //   0x1.62e430p-1 // log(2) 
-		return r;
+		float r = -0.130187988f * f + 0.140889585f; // -0x1.0aa000p-3, 0x1.208ab8p-3
+		const float t = -0.121489584f * f + 0.139809534f; // -0x1.f19f10p-4, 0x1.1e5476p-3
+		r = r * s + t;
+		r = r * f - 0.166845024f; // -0x1.55b2d8p-3
+		r = r * f + 0.200121149f; //  0x1.99d91ep-3
+		r = r * f - 0.249996364f; // -0x1.fffe18p-3
+		r = r * f + 0.333331943f; //  0x1.5554f8p-2
+		r = r * f - 0.500000000f; // -0x1.000000p-1
+		r = r * s + f;
+		x[k] = i * 0.693147182f + r; //   0x1.62e430p-1 // log(2)
 	}
-	return 0.0f;
 }
-static float processfftComp(FFTDynamicRangeSquasher *comp, unsigned int idx, float logIn)
+// In place exp of n log gains, Cody-Waite reduction to [-ln2 / 2, ln2 / 2] and a degree 6 polynomial
+static void spectralExp(float *x, unsigned int n)
 {
-	// Attack and release coefficients
-	float myAttackCoeff;
-	if (comp->metaMaxAttackTime < FLT_EPSILON)
-		myAttackCoeff = 1.0f;
-	else
-		myAttackCoeff = 1.0f - expf(-1.0f / (comp->metaMaxAttackTime * comp->spectralRate));
-	float trRel = comp->metaMaxReleaseTime - comp->metaMaxAttackTime;
-	float myReleaseCoeff;
-	if (trRel < FLT_EPSILON)
-		myReleaseCoeff = 1.0f;
-	else
-		myReleaseCoeff = 1.0f - expf(-1.0f / (trRel * comp->spectralRate));
-	float logOvershoot = logIn - comp->logThreshold[idx];
-	// Set estimate for average log gain
-	float logGainEstimate = comp->logThreshold[idx] * 0.5f;
-	// Set knee width
-	float myLogWidth = MAX(-(comp->smoothLogGain[idx] + logGainEstimate), 0.0f);
-	// Soft knee rectification
-	float logGain = 0.0f;
-	if (logOvershoot >= myLogWidth * 0.5f)
-		logGain = logOvershoot;
-	else if (logOvershoot > (-myLogWidth * 0.5f) && logOvershoot < (myLogWidth * 0.5f))
-		logGain = 1.0f / (2.0f * myLogWidth) * SQUARE(logOvershoot + (myLogWidth * 0.5f));
-	// 更新功率包络的上升沿、下降沿
-	comp->adaptiveRelease[idx] = MAX(logGain, MIX(logGain, comp->adaptiveRelease[idx], myReleaseCoeff));
-	comp->adaptiveAttack[idx] = MIX(comp->adaptiveRelease[idx], comp->adaptiveAttack[idx], myAttackCoeff);
-	// 反增益
-	logGain = -comp->adaptiveAttack[idx];
-	// 平滑增益
-	comp->smoothLogGain[idx] = MIX(logGain - logGainEstimate, comp->smoothLogGain[idx], comp->metaAdaptCoeff[idx]);
-	// 防止超越0dB
-	if (logIn + logGain - (comp->smoothLogGain[idx] + logGainEstimate) > 0.0f)
-		comp->smoothLogGain[idx] = logIn + logGain - logGainEstimate;
-	// Apply automatic gain
-	logGain -= comp->smoothLogGain[idx] + logGainEstimate;
-	// Update threshold to recent average
-	comp->logThreshold[idx] = comp->logThreshold[idx] + comp->fgt_fac * (logIn - comp->logThreshold[idx]);
-	return expf(logGain); // Convert to linear
+	for (unsigned int k = 0; k < n; k++)
+	{
+		const float a = CLAMP(x[k], -87.0f, 88.0f);
+		const float t = a * 1.44269504089f;
+		const int32_t e = (int32_t)(t + (t < 0.0f ? -0.5f : 0.5f));
+		const float fe = (float)e;
+		const float r = (a - fe * 0.693359375f) + fe * 2.12194440e-4f;
+		float p = 1.9875691500e-4f;
+		p = p * r + 1.3981999507e-3f;
+		p = p * r + 8.3334519073e-3f;
+		p = p * r + 4.1665795894e-2f;
+		p = p * r + 1.6666665459e-1f;
+		p = p * r + 5.0000001201e-1f;
+		p = p * r * r + r + 1.0f;
+		floatBits scale;
+		scale.i = (e + 127) << 23;
+		x[k] = p * scale.f;
+	}
+}
+// Gain computer of n subbands, logIn to log gain, every subband state is its own array
+static void processfftComp(FFTDynamicRangeSquasher *comp, const float *logIn, float *logGainOut, unsigned int n)
+{
+	const float myAttackCoeff = comp->attackCoeff;
+	const float myReleaseCoeff = comp->releaseCoeff;
+	const float fgt_fac = comp->fgt_fac;
+	float *adaptiveRelease = comp->adaptiveRelease;
+	float *adaptiveAttack = comp->adaptiveAttack;
+	float *smoothLogGain = comp->smoothLogGain;
+	float *logThreshold = comp->logThreshold;
+	const float *metaAdaptCoeff = comp->metaAdaptCoeff;
+	for (unsigned int idx = 0; idx < n; idx++)
+	{
+		float logOvershoot = logIn[idx] - logThreshold[idx];
+		// Set estimate for average log gain
+		float logGainEstimate = logThreshold[idx] * 0.5f;
+		// Set knee width
+		float myLogWidth = MAX(-(smoothLogGain[idx] + logGainEstimate), 0.0f);
+		float halfWidth = myLogWidth * 0.5f;
+		// Soft knee rectification
+		float knee = SQUARE(logOvershoot + halfWidth) / MAX(2.0f * myLogWidth, FLT_MIN);
+		float logGain = logOvershoot >= halfWidth ? logOvershoot : (logOvershoot > -halfWidth ? knee : 0.0f);
+		// 更新功率包络的上升沿、下降沿
+		adaptiveRelease[idx] = MAX(logGain, MIX(logGain, adaptiveRelease[idx], myReleaseCoeff));
+		adaptiveAttack[idx] = MIX(adaptiveRelease[idx], adaptiveAttack[idx], myAttackCoeff);
+		// 反增益
+		logGain = -adaptiveAttack[idx];
+		// 平滑增益
+		smoothLogGain[idx] = MIX(logGain - logGainEstimate, smoothLogGain[idx], metaAdaptCoeff[idx]);
+		// 防止超越0dB
+		smoothLogGain[idx] = MAX(smoothLogGain[idx], logIn[idx] + logGain - logGainEstimate);
+		// Apply automatic gain
+		logGainOut[idx] = logGain - (smoothLogGain[idx] + logGainEstimate);
+		// Update threshold to recent average
+		logThreshold[idx] = logThreshold[idx] + fgt_fac * (logIn[idx] - logThreshold[idx]);
+	}
+}
+// Stereo magnitude of bins [1, procUpTo), the larger of the two channels
+static void spectralMagnitude(FFTDynamicRangeSquasher *cm)
+{
+	const float *L = cm->mTempLBuffer;
+	const float *R = cm->mTempRBuffer;
+	for (unsigned int i = 1; i < cm->procUpTo; i++)
+	{
+		const unsigned int symIdx = cm->fftLen - i;
+		float lR = L[i] + L[symIdx];
+		float lI = L[i] - L[symIdx];
+		float rR = R[i] + R[symIdx];
+		float rI = R[i] - R[symIdx];
+		float absV1 = fabsf(lR);
+		float absV2 = fabsf(lI);
+		float leftMag = MAX((127.0f / 128.0f) * MAX(absV1, absV2) + (3.0f / 16.0f) * MIN(absV1, absV2), (27.0f / 32.0f) * MAX(absV1, absV2) + (71.0f / 128.0f) * MIN(absV1, absV2));
+		absV1 = fabsf(rR);
+		absV2 = fabsf(rI);
+		float rightMag = MAX((127.0f / 128.0f) * MAX(absV1, absV2) + (3.0f / 16.0f) * MIN(absV1, absV2), (27.0f / 32.0f) * MAX(absV1, absV2) + (71.0f / 128.0f) * MIN(absV1, absV2));
+		cm->mag[i] = MAX(leftMag, rightMag);
+	}
+}
+static void squasherFrameStage(FFTDynamicRangeSquasher *cm, unsigned int stage)
+{
+	unsigned int i, bitRevFwd, bitRevSym;
+	int symIdx;
+	float lR, rR, leftMag, rightMag, mask;
+	switch (stage)
+	{
+	case 0:
+		cm->fft(cm->mTempLBuffer, cm->mSineTab);
+		break;
+	case 1:
+		cm->fft(cm->mTempRBuffer, cm->mSineTab);
+		break;
+	case 2:
+		// Spectral analysis, log conversion, gain computer and back to linear, one pass each over all subbands
+		if (!cm->noGridDownsampling)
+		{
+			leftMag = fabsf(cm->mTempLBuffer[0] * 2.0f);
+			rightMag = fabsf(cm->mTempRBuffer[0] * 2.0f);
+			cm->mag[0] = leftMag > rightMag ? leftMag : rightMag;
+			spectralMagnitude(cm);
+			ShrinkGridSpectralInterpolator(cm->octaveSmooth, cm->procUpTo, cm->mag, cm->aheight);
+			spectralLog(cm->aheight, cm->smallGridSize);
+			processfftComp(cm, cm->aheight, cm->finalGain, cm->smallGridSize);
+			spectralExp(cm->finalGain, cm->smallGridSize);
+		}
+		else
+		{
+			leftMag = fabsf(cm->mTempLBuffer[0]);
+			rightMag = fabsf(cm->mTempRBuffer[0]);
+			cm->mag[0] = leftMag > rightMag ? leftMag : rightMag;
+			spectralMagnitude(cm);
+			spectralLog(cm->mag, cm->procUpTo);
+			processfftComp(cm, cm->mag, cm->finalGain, cm->procUpTo);
+			spectralExp(cm->finalGain, cm->procUpTo);
+		}
+		break;
+	case 3:
+		// Apply the gains
+		if (!cm->noGridDownsampling)
+		{
+			float reciprocal = *((float*)(cm->octaveSmooth + sizeof(unsigned int)));
+			unsigned int lpLen = *((unsigned int*)(cm->octaveSmooth + sizeof(unsigned int) + sizeof(float)));
+			float *lv1 = (float*)(cm->octaveSmooth + sizeof(unsigned int) + sizeof(float) + sizeof(unsigned int) + (lpLen << 1) * sizeof(unsigned int) + lpLen * sizeof(float));
+			float *lv2 = (float*)(cm->octaveSmooth + sizeof(unsigned int) + sizeof(float) + sizeof(unsigned int) + (lpLen << 1) * sizeof(unsigned int) + lpLen * sizeof(float) + (lpLen + 3) * sizeof(float));
+			cm->timeDomainOut[0][0] = cm->mTempLBuffer[0] * 2.0f * cm->bandWeight[0];
+			cm->timeDomainOut[1][0] = cm->mTempRBuffer[0] * 2.0f * cm->bandWeight[0];
+			// Bin positions grow monotonically on the grid, walk the segment instead of searching it
+			const unsigned int gridLen = lpLen + 3;
+			size_t j = 1;
+			for (i = 1; i < cm->procUpTo; i++)
+			{
+				symIdx = cm->fftLen - i;
+				bitRevFwd = cm->mBitRev[i];
+				bitRevSym = cm->mBitRev[symIdx];
+				float val = i * reciprocal;
+				if (val <= lv1[0])
+					mask = cm->finalGain[0];
+				else if (val >= lv1[gridLen - 1])
+					mask = cm->finalGain[gridLen - 1];
+				else
+				{
+					while (lv1[j] <= val)
+						j++;
+					mask = ((val - lv1[j - 1]) * lv2[j - 1]) * (cm->finalGain[j] - cm->finalGain[j - 1]) + cm->finalGain[j - 1];
+				}
+				mask *= cm->bandWeight[i];
+				lR = cm->mTempLBuffer[i] + cm->mTempLBuffer[symIdx];
+				float lI = cm->mTempLBuffer[i] - cm->mTempLBuffer[symIdx];
+				rR = cm->mTempRBuffer[i] + cm->mTempRBuffer[symIdx];
+				float rI = cm->mTempRBuffer[i] - cm->mTempRBuffer[symIdx];
+				cm->timeDomainOut[0][bitRevFwd] = (lR + lI) * mask;
+				cm->timeDomainOut[0][bitRevSym] = (lR - lI) * mask;
+				cm->timeDomainOut[1][bitRevFwd] = (rR + rI) * mask;
+				cm->timeDomainOut[1][bitRevSym] = (rR - rI) * mask;
+			}
+		}
+		else
+		{
+			cm->timeDomainOut[0][0] = cm->mTempLBuffer[0] * cm->finalGain[0] * cm->bandWeight[0];
+			cm->timeDomainOut[1][0] = cm->mTempRBuffer[0] * cm->finalGain[0] * cm->bandWeight[0];
+			for (i = 1; i < cm->procUpTo; i++)
+			{
+				symIdx = cm->fftLen - i;
+				bitRevFwd = cm->mBitRev[i];
+				bitRevSym = cm->mBitRev[symIdx];
+				mask = cm->finalGain[i] * cm->bandWeight[i];
+				lR = cm->mTempLBuffer[i] + cm->mTempLBuffer[symIdx];
+				float lI = cm->mTempLBuffer[i] - cm->mTempLBuffer[symIdx];
+				rR = cm->mTempRBuffer[i] + cm->mTempRBuffer[symIdx];
+				float rI = cm->mTempRBuffer[i] - cm->mTempRBuffer[symIdx];
+				cm->timeDomainOut[0][bitRevFwd] = (lR + lI) * mask;
+				cm->timeDomainOut[0][bitRevSym] = (lR - lI) * mask;
+				cm->timeDomainOut[1][bitRevFwd] = (rR + rI) * mask;
+				cm->timeDomainOut[1][bitRevSym] = (rR - rI) * mask;
+			}
+		}
+		for (i = cm->procUpTo; i < cm->halfLen; i++)
+		{
+			symIdx = cm->fftLen - i;
+			bitRevFwd = cm->mBitRev[i];
+			bitRevSym = cm->mBitRev[symIdx];
+			lR = cm->mTempLBuffer[i] + cm->mTempLBuffer[symIdx];
+			float lI = cm->mTempLBuffer[i] - cm->mTempLBuffer[symIdx];
+			rR = cm->mTempRBuffer[i] + cm->mTempRBuffer[symIdx];
+			float rI = cm->mTempRBuffer[i] - cm->mTempRBuffer[symIdx];
+			mask = cm->bandWeight[i];
+			cm->timeDomainOut[0][bitRevFwd] = (lR + lI) * mask;
+			cm->timeDomainOut[0][bitRevSym] = (lR - lI) * mask;
+			cm->timeDomainOut[1][bitRevFwd] = (rR + rI) * mask;
+			cm->timeDomainOut[1][bitRevSym] = (rR - rI) * mask;
+		}
+		break;
+	case 4:
+		// reconstitute left/right channels
+		cm->fft(cm->timeDomainOut[0], cm->mSineTab);
+		break;
+	case 5:
+		cm->fft(cm->timeDomainOut[1], cm->mSineTab);
+		break;
+	default:
+	{
+		// Reader stalled, drop the frame rather than overrun the queue
+		if (cm->mOutputBufferCount >= MAX_OUTPUT_BUFFERS_DRS)
+			break;
+		float *outBuffer = cm->mOutputBuffer[cm->mOutputBufferCount++];
+		for (i = 0; i < cm->ovpLen; ++i)
+		{
+			outBuffer[0] = cm->mOverlapStage2dash[0][i] + (cm->timeDomainOut[0][i + cm->smpShift] * cm->synthesisWnd[i]);
+			outBuffer[1] = cm->mOverlapStage2dash[1][i] + (cm->timeDomainOut[1][i + cm->smpShift] * cm->synthesisWnd[i]);
+			outBuffer += 2;
+			// overlapping
+			cm->mOverlapStage2dash[0][i] = (cm->timeDomainOut[0][cm->smpShift + cm->ovpLen + i] * cm->synthesisWnd[i + cm->ovpLen]);
+			cm->mOverlapStage2dash[1][i] = (cm->timeDomainOut[1][cm->smpShift + cm->ovpLen + i] * cm->synthesisWnd[i + cm->ovpLen]);
+		}
+		break;
+	}
+	}
 }
 int FFTDynamicRangeSquasherProcessSamples(FFTDynamicRangeSquasher *cm, const float *inLeft, const float *inRight, unsigned int inSampleCount, float *outL, float *outR)
 {
@@ -254,10 +417,17 @@ int FFTDynamicRangeSquasherProcessSamples(FFTDynamicRangeSquasher *cm, const flo
 		inSampleCount -= copyCount;
 		cm->mInputPos = (cm->mInputPos + copyCount) & cm->minus_fftLen;
 		cm->mInputSamplesNeeded -= copyCount;
+		// Pending frame keeps pace with the hop now filling in, it is complete by the time that hop is
+		if (cm->frameStage < FRAME_STAGES_DRS)
+		{
+			const unsigned int due = ((cm->ovpLen - cm->mInputSamplesNeeded) * FRAME_STAGES_DRS + cm->ovpLen - 1) / cm->ovpLen;
+			while (cm->frameStage < due)
+				squasherFrameStage(cm, cm->frameStage++);
+		}
 		if (cm->mInputSamplesNeeded == 0)
 		{
 			unsigned int i;
-			// copy to temporary buffer and FHT
+			// copy to temporary buffer, the ring is overwritten by the next hop
 			for (i = 0; i < cm->fftLen; ++i)
 			{
 				const unsigned int k = (i + cm->mInputPos) & cm->minus_fftLen;
@@ -265,157 +435,12 @@ int FFTDynamicRangeSquasherProcessSamples(FFTDynamicRangeSquasher *cm, const flo
 				cm->mTempLBuffer[cm->mBitRev[i]] = (cm->mInput[0][k] * w);
 				cm->mTempRBuffer[cm->mBitRev[i]] = (cm->mInput[1][k] * w);
 			}
-			cm->fft(cm->mTempLBuffer, cm->mSineTab);
-			cm->fft(cm->mTempRBuffer, cm->mSineTab);
-			// Spectral analysis
-			int symIdx;
-			float lR = cm->mTempLBuffer[0] * 2.0f;
-			float rR = cm->mTempRBuffer[0] * 2.0f;
-			float leftMag, rightMag, currentMagnitude, mask;
-			cm->timeDomainOut[0][0] = lR;
-			cm->timeDomainOut[1][0] = rR;
-			unsigned int bitRevFwd, bitRevSym;
-			//idxFrame++;
-			unsigned int specLen = *((unsigned int*)(cm->octaveSmooth));
-			float reciprocal = *((float*)(cm->octaveSmooth + sizeof(unsigned int)));
-			unsigned int lpLen = *((unsigned int*)(cm->octaveSmooth + sizeof(unsigned int) + sizeof(float)));
-			float *lv1 = (float*)(cm->octaveSmooth + sizeof(unsigned int) + sizeof(float) + sizeof(unsigned int) + (lpLen << 1) * sizeof(unsigned int) + lpLen * sizeof(float));
-			float *lv2 = (float*)(cm->octaveSmooth + sizeof(unsigned int) + sizeof(float) + sizeof(unsigned int) + (lpLen << 1) * sizeof(unsigned int) + lpLen * sizeof(float) + (lpLen + 3) * sizeof(float));
-			if (!cm->noGridDownsampling)
-			{
-				leftMag = fabsf(lR);
-				rightMag = fabsf(rR);
-				cm->mag[0] = leftMag > rightMag ? leftMag : rightMag;
-				for (i = 1; i < cm->procUpTo; i++)
-				{
-					symIdx = cm->fftLen - i;
-					bitRevFwd = cm->mBitRev[i];
-					bitRevSym = cm->mBitRev[symIdx];
-					lR = cm->mTempLBuffer[i] + cm->mTempLBuffer[symIdx];
-					float lI = cm->mTempLBuffer[i] - cm->mTempLBuffer[symIdx];
-					rR = cm->mTempRBuffer[i] + cm->mTempRBuffer[symIdx];
-					float rI = cm->mTempRBuffer[i] - cm->mTempRBuffer[symIdx];
-					float absV1 = fabsf(lR);
-					float absV2 = fabsf(lI);
-					leftMag = max((127.0f / 128.0f) * max(absV1, absV2) + (3.0f / 16.0f) * min(absV1, absV2), (27.0f / 32.0f) * max(absV1, absV2) + (71.0f / 128.0f) * min(absV1, absV2));
-					absV1 = fabsf(rR);
-					absV2 = fabsf(rI);
-					rightMag = max((127.0f / 128.0f) * max(absV1, absV2) + (3.0f / 16.0f) * min(absV1, absV2), (27.0f / 32.0f) * max(absV1, absV2) + (71.0f / 128.0f) * min(absV1, absV2));
-					currentMagnitude = leftMag > rightMag ? leftMag : rightMag;
-					cm->mag[i] = currentMagnitude;
-				}
-				ShrinkGridSpectralInterpolator(cm->octaveSmooth, cm->procUpTo, cm->mag, cm->aheight);
-				for (i = 0; i < cm->smallGridSize; i++)
-				{
-					float magNormalized = cm->aheight[i];
-					// Log conversion
-					float logIn;
-					if (magNormalized <= FLT_EPSILON)
-						logIn = -15.942385152f;
-					else
-						logIn = my_logf(magNormalized);
-					float mask = processfftComp(cm, i, logIn);
-					cm->finalGain[i] = mask;
-				}
-				for (i = 1; i < cm->procUpTo; i++)
-				{
-					symIdx = cm->fftLen - i;
-					bitRevFwd = cm->mBitRev[i];
-					bitRevSym = cm->mBitRev[symIdx];
-					float val = i * reciprocal;
-					if (val <= lv1[0])
-						mask = cm->finalGain[0];
-					else if (val >= lv1[lpLen + 3 - 1])
-						mask = cm->finalGain[lpLen + 3 - 1];
-					else
-					{
-						size_t j = fast_upper_bound4(lv1, lpLen + 3, &val);
-						mask = ((val - lv1[j - 1]) * lv2[j - 1]) * (cm->finalGain[j] - cm->finalGain[j - 1]) + cm->finalGain[j - 1];
-					}
-					lR = cm->mTempLBuffer[i] + cm->mTempLBuffer[symIdx];
-					float lI = cm->mTempLBuffer[i] - cm->mTempLBuffer[symIdx];
-					rR = cm->mTempRBuffer[i] + cm->mTempRBuffer[symIdx];
-					float rI = cm->mTempRBuffer[i] - cm->mTempRBuffer[symIdx];
-					cm->timeDomainOut[0][bitRevFwd] = (lR + lI) * mask;
-					cm->timeDomainOut[0][bitRevSym] = (lR - lI) * mask;
-					cm->timeDomainOut[1][bitRevFwd] = (rR + rI) * mask;
-					cm->timeDomainOut[1][bitRevSym] = (rR - rI) * mask;
-				}
-				//printf("\n");
-			}
+			if (cm->amortise)
+				cm->frameStage = 0;
 			else
 			{
-				leftMag = fabsf(cm->mTempLBuffer[0]);
-				rightMag = fabsf(cm->mTempRBuffer[0]);
-				currentMagnitude = leftMag > rightMag ? leftMag : rightMag;
-				float magNormalized = currentMagnitude;
-				// Log conversion
-				float logIn;
-				if (magNormalized <= FLT_EPSILON)
-					logIn = -15.942385152f;
-				else
-					logIn = my_logf(magNormalized);
-				float mask = processfftComp(cm, 0, logIn);
-				cm->timeDomainOut[0][0] = cm->mTempLBuffer[0] * mask;
-				cm->timeDomainOut[1][0] = cm->mTempRBuffer[0] * mask;
-				for (i = 1; i < cm->procUpTo; i++)
-				{
-					symIdx = cm->fftLen - i;
-					bitRevFwd = cm->mBitRev[i];
-					bitRevSym = cm->mBitRev[symIdx];
-					lR = cm->mTempLBuffer[i] + cm->mTempLBuffer[symIdx];
-					float lI = cm->mTempLBuffer[i] - cm->mTempLBuffer[symIdx];
-					rR = cm->mTempRBuffer[i] + cm->mTempRBuffer[symIdx];
-					float rI = cm->mTempRBuffer[i] - cm->mTempRBuffer[symIdx];
-					float absV1 = fabsf(lR);
-					float absV2 = fabsf(lI);
-					leftMag = max((127.0f / 128.0f) * max(absV1, absV2) + (3.0f / 16.0f) * min(absV1, absV2), (27.0f / 32.0f) * max(absV1, absV2) + (71.0f / 128.0f) * min(absV1, absV2));
-					absV1 = fabsf(rR);
-					absV2 = fabsf(rI);
-					rightMag = max((127.0f / 128.0f) * max(absV1, absV2) + (3.0f / 16.0f) * min(absV1, absV2), (27.0f / 32.0f) * max(absV1, absV2) + (71.0f / 128.0f) * min(absV1, absV2));
-					currentMagnitude = leftMag > rightMag ? leftMag : rightMag;
-					magNormalized = currentMagnitude;
-					// Log conversion
-					if (magNormalized <= FLT_EPSILON)
-						logIn = -15.942385152f;
-					else
-						logIn = my_logf(magNormalized);
-					mask = processfftComp(cm, i, logIn);
-					cm->timeDomainOut[0][bitRevFwd] = (lR + lI) * mask;
-					cm->timeDomainOut[0][bitRevSym] = (lR - lI) * mask;
-					cm->timeDomainOut[1][bitRevFwd] = (rR + rI) * mask;
-					cm->timeDomainOut[1][bitRevSym] = (rR - rI) * mask;
-				}
-			}
-			for (i = cm->procUpTo; i < cm->halfLen; i++)
-			{
-				symIdx = cm->fftLen - i;
-				bitRevFwd = cm->mBitRev[i];
-				bitRevSym = cm->mBitRev[symIdx];
-				lR = cm->mTempLBuffer[i] + cm->mTempLBuffer[symIdx];
-				float lI = cm->mTempLBuffer[i] - cm->mTempLBuffer[symIdx];
-				rR = cm->mTempRBuffer[i] + cm->mTempRBuffer[symIdx];
-				float rI = cm->mTempRBuffer[i] - cm->mTempRBuffer[symIdx];
-				cm->timeDomainOut[0][bitRevFwd] = lR + lI;
-				cm->timeDomainOut[0][bitRevSym] = lR - lI;
-				cm->timeDomainOut[1][bitRevFwd] = rR + rI;
-				cm->timeDomainOut[1][bitRevSym] = rR - rI;
-			}
-			// reconstitute left/right channels
-			cm->fft(cm->timeDomainOut[0], cm->mSineTab);
-			cm->fft(cm->timeDomainOut[1], cm->mSineTab);
-			cm->mOutputBufferCount++;
-			if (cm->mOutputBufferCount > 2)
-				continue;
-			float *outBuffer = cm->mOutputBuffer[cm->mOutputBufferCount - 1];
-			for (i = 0; i < cm->ovpLen; ++i)
-			{
-				outBuffer[0] = cm->mOverlapStage2dash[0][i] + (cm->timeDomainOut[0][i + cm->smpShift] * cm->synthesisWnd[i]);
-				outBuffer[1] = cm->mOverlapStage2dash[1][i] + (cm->timeDomainOut[1][i + cm->smpShift] * cm->synthesisWnd[i]);
-				outBuffer += 2;
-				// overlapping
-				cm->mOverlapStage2dash[0][i] = (cm->timeDomainOut[0][cm->smpShift + cm->ovpLen + i] * cm->synthesisWnd[i + cm->ovpLen]);
-				cm->mOverlapStage2dash[1][i] = (cm->timeDomainOut[1][cm->smpShift + cm->ovpLen + i] * cm->synthesisWnd[i + cm->ovpLen]);
+				for (i = 0; i < FRAME_STAGES_DRS; i++)
+					squasherFrameStage(cm, i);
 			}
 			cm->mInputSamplesNeeded = cm->ovpLen;
 		}
@@ -480,37 +505,25 @@ void FFTDynamicRangeSquasherSetavgBW(FFTDynamicRangeSquasher *cm, double avgBW)
 			//cm->ratioOld[i] = cm->ratio[i] = cm->ratio2[i] = 1.0f;
 	}
 }
-void FFTDynamicRangeSquasherInit(FFTDynamicRangeSquasher *cm, float fs)
+void FFTDynamicRangeSquasherInit(FFTDynamicRangeSquasher *cm, float fs, unsigned int fftLen, int amortise)
 {
+	FHTPlanRelease(cm->plan);
 	memset(cm, 0, sizeof(FFTDynamicRangeSquasher));
 	unsigned int i;
 	const float oX[10] = { 750, 1500, 3000, 6000, 12000, 24000, 48000, 96000, 192000, 256000 };
 	const float oY[10] = { 24, 48, 96, 192, 384, 768, 1536, 3072, 6144, 8192 };
 	const float oX2[6] = { 0.0f, 0.25f, 0.4f, 0.5f, 0.75f, 1.0f };
 	const float oY2[6] = { 9.0f, 7.0f, 4.5f, 4.0f, 2.0f, 1.0f };
-	float frameLen = lerp1DNoExtrapo(fs, oX, oY, 10);
+	// Requested lengths keep the window shape the automatic choice has at 48 kHz
+	float frameLen = fftLen ? (float)fftLen * 0.75f : lerp1DNoExtrapo(fs, oX, oY, 10);
 	float nextPwr2 = powf(2.0f, ceilf(logf(frameLen) / logf(2.0f)));
 	float paddingRatio = map(frameLen / nextPwr2, 0.5f, 1.0f, 0.0f, 1.0f);
 	float wndBeta = lerp1DNoExtrapo(paddingRatio, oX2, oY2, 6);
 	cm->fftLen = (unsigned int)nextPwr2;
-	if (cm->fftLen == 32)
-		cm->fft = DFT32;
-	else if (cm->fftLen == 64)
-		cm->fft = DFT64;
-	else if (cm->fftLen == 128)
-		cm->fft = DFT128;
-	else if (cm->fftLen == 256)
-		cm->fft = DFT256;
-	else if (cm->fftLen == 512)
-		cm->fft = DFT512;
-	else if (cm->fftLen == 1024)
-		cm->fft = DFT1024;
-	else if (cm->fftLen == 2048)
-		cm->fft = DFT2048;
-	else if (cm->fftLen == 4096)
-		cm->fft = DFT4096;
-	else
-		cm->fft = DFT8192;
+	cm->plan = FHTPlanAcquire(cm->fftLen);
+	cm->fft = cm->plan->fft;
+	cm->mBitRev = cm->plan->bit;
+	cm->mSineTab = cm->plan->sine;
 	cm->minus_fftLen = cm->fftLen - 1;
 	cm->ovpLen = cm->fftLen / ANALYSIS_OVERLAP_DRS;
 	cm->halfLen = (cm->fftLen >> 1) + 1;
@@ -521,13 +534,15 @@ void FFTDynamicRangeSquasherInit(FFTDynamicRangeSquasher *cm, float fs)
 		cm->procUpTo = cm->halfLen;
 	else
 		cm->procUpTo = idx;
-	LLbitReversalTblM(cm->mBitRev, cm->fftLen);
-	LLsinHalfTblFloatM(cm->mSineTab, cm->fftLen);
 	for (i = 0; i < MAX_OUTPUT_BUFFERS_DRS; i++)
 		cm->mOutputBuffer[i] = cm->buffer[i];
 	cm->mInputSamplesNeeded = cm->ovpLen;
 	cm->mInputPos = 0;
-	cm->mOutputBufferCount = 0;
+	// One silent hop queued up front, output never runs dry whatever the host block size,
+	// amortised frames are only complete a hop later and need one more
+	cm->amortise = amortise ? 1 : 0;
+	cm->frameStage = FRAME_STAGES_DRS;
+	cm->mOutputBufferCount = 1 + cm->amortise;
 	cm->mOutputReadSampleOffset = 0;
 	getAsymmetricWindow(cm->analysisWnd, cm->synthesisWnd, cm->fftLen, cm->ovpLen, cm->smpShift, wndBeta);
 	for (i = 0; i < cm->fftLen; i++)
@@ -537,7 +552,9 @@ void FFTDynamicRangeSquasherInit(FFTDynamicRangeSquasher *cm, float fs)
 		sum += cm->analysisWnd[i];
 	cm->spectralRate = fs / (float)cm->fftLen * (float)ANALYSIS_OVERLAP_DRS;
 	float fgt_facT = 30.0f; // Adaptive threshold
-	double avgBW = 1.00005;
+	double avgBW = AVGBW_DRS;
+	for (i = 0; i < cm->halfLen; i++)
+		cm->bandWeight[i] = 1.0f;
 	for (unsigned int i = 0; i < cm->procUpTo; i++)
 	{
 		cm->metaAdaptCoeff[i] = 0.0f;
@@ -550,6 +567,39 @@ void FFTDynamicRangeSquasherInit(FFTDynamicRangeSquasher *cm, float fs)
 	FFTCompressorSetSpectralFollowingRate(cm, fs, fgt_facT);
 	FFTCompressorSetParam(cm, fs, 100.0, 500.0, 800.0);
 }
+unsigned int FFTDynamicRangeSquasherGetLatency(FFTDynamicRangeSquasher *cm)
+{
+	return (2 + cm->amortise) * cm->ovpLen;
+}
+void FFTDynamicRangeSquasherSetBand(FFTDynamicRangeSquasher *cm, float fs, float crossover, int upper)
+{
+	// Raised cosine over the octave centred on the crossover
+	const float lo = crossover * 0.70710678f;
+	const float hi = crossover * 1.41421356f;
+	unsigned int i, lastBin = cm->halfLen;
+	for (i = 0; i < cm->halfLen; i++)
+	{
+		const float freq = (float)i * fs / (float)cm->fftLen;
+		float w;
+		if (freq <= lo)
+			w = 0.0f;
+		else if (freq >= hi)
+		{
+			w = 1.0f;
+			if (lastBin == cm->halfLen)
+				lastBin = i + 1;
+		}
+		else
+			w = 0.5f - 0.5f * cosf((float)M_PI * log2f(freq / lo));
+		cm->bandWeight[i] = upper ? w : 1.0f - w;
+	}
+	// Nothing above the transition leaves the lower band, skip its gain computation
+	if (!upper && lastBin < cm->procUpTo)
+	{
+		cm->procUpTo = lastBin;
+		FFTDynamicRangeSquasherSetavgBW(cm, AVGBW_DRS);
+	}
+}
 void CompressorEnable(JamesDSPLib *jdsp)
 {
 	jdsp->compEnabled = 1;
@@ -558,21 +608,114 @@ void CompressorDisable(JamesDSPLib *jdsp)
 {
 	jdsp->compEnabled = 0;
 }
+static void CompressorHighBandFree(CompressorHighBand *hb)
+{
+	if (!hb)
+		return;
+	FHTPlanRelease(hb->comp.plan);
+	free(hb);
+}
+static CompressorHighBand *CompressorHighBandBuild(JamesDSPLib *jdsp)
+{
+	const unsigned int fftLen = jdsp->comp.fftLen >> 2;
+	if (fftLen < 256)
+		return 0;
+	CompressorHighBand *hb = (CompressorHighBand*)calloc(1, sizeof(CompressorHighBand));
+	if (!hb)
+		return 0;
+	FFTDynamicRangeSquasherInit(&hb->comp, jdsp->fs, fftLen, jdsp->compAmortise);
+	FFTDynamicRangeSquasherSetBand(&hb->comp, jdsp->fs, COMP_MULTIRES_CROSSOVER, 1);
+	FFTCompressorSetParam(&hb->comp, jdsp->fs, jdsp->compParam[0], jdsp->compParam[1], jdsp->compParam[2]);
+	hb->delayLen = FFTDynamicRangeSquasherGetLatency(&jdsp->comp) - FFTDynamicRangeSquasherGetLatency(&hb->comp);
+	hb->delayPos = 0;
+	return hb;
+}
+void CompressorConstructor(JamesDSPLib *jdsp)
+{
+	jdsp->compHigh = 0;
+	jdsp->compResolution = 0;
+	jdsp->compMultiRes = 0;
+	jdsp->compAmortise = 0;
+	jdsp->compParam[0] = 100.0f;
+	jdsp->compParam[1] = 500.0f;
+	jdsp->compParam[2] = 800.0f;
+	CompressorReset(jdsp);
+}
 void CompressorReset(JamesDSPLib *jdsp)
 {
-	FFTDynamicRangeSquasherInit(&jdsp->comp, jdsp->fs);
+	CompressorHighBandFree(jdsp->compHigh);
+	jdsp->compHigh = 0;
+	FFTDynamicRangeSquasherInit(&jdsp->comp, jdsp->fs, jdsp->compResolution, jdsp->compAmortise);
+	if (jdsp->compMultiRes)
+	{
+		jdsp->compHigh = CompressorHighBandBuild(jdsp);
+		if (jdsp->compHigh)
+			FFTDynamicRangeSquasherSetBand(&jdsp->comp, jdsp->fs, COMP_MULTIRES_CROSSOVER, 0);
+	}
+	FFTCompressorSetParam(&jdsp->comp, jdsp->fs, jdsp->compParam[0], jdsp->compParam[1], jdsp->compParam[2]);
+}
+void CompressorSetResolution(JamesDSPLib *jdsp, unsigned int fftLen, int multiRes, int amortise)
+{
+	if (fftLen)
+	{
+		if (fftLen < 256)
+			fftLen = 256;
+		if (fftLen > FFTSIZE_DRS)
+			fftLen = FFTSIZE_DRS;
+		fftLen = upper_power_of_two(fftLen);
+	}
+	jdsp_lock(jdsp);
+	jdsp->compResolution = fftLen;
+	jdsp->compMultiRes = multiRes;
+	jdsp->compAmortise = amortise;
+	CompressorReset(jdsp);
+	jdsp_unlock(jdsp);
+}
+unsigned int CompressorGetLatency(JamesDSPLib *jdsp)
+{
+	return FFTDynamicRangeSquasherGetLatency(&jdsp->comp);
+}
+void CompressorDestructor(JamesDSPLib *jdsp)
+{
+	FHTPlanRelease(jdsp->comp.plan);
+	jdsp->comp.plan = 0;
+	CompressorHighBandFree(jdsp->compHigh);
+	jdsp->compHigh = 0;
 }
 void CompressorSetParam(JamesDSPLib *jdsp, float maxAtk, float maxRel, float adapt)
 {
+	jdsp->compParam[0] = maxAtk;
+	jdsp->compParam[1] = maxRel;
+	jdsp->compParam[2] = adapt;
 	FFTCompressorSetParam(&jdsp->comp, jdsp->fs, maxAtk, maxRel, adapt);
+	if (jdsp->compHigh)
+		FFTCompressorSetParam(&jdsp->compHigh->comp, jdsp->fs, maxAtk, maxRel, adapt);
 }
 void CompressorProcess(JamesDSPLib *jdsp, size_t n)
 {
+	CompressorHighBand *hb = jdsp->compHigh;
+	const unsigned int hop = hb ? hb->comp.ovpLen : jdsp->comp.ovpLen;
 	unsigned int offset = 0;
 	while (offset < n)
 	{
-		const unsigned int processing = min(n - offset, jdsp->comp.ovpLen);
-		FFTDynamicRangeSquasherProcessSamples(&jdsp->comp, jdsp->tmpBuffer[0] + offset, jdsp->tmpBuffer[1] + offset, processing, jdsp->tmpBuffer[0] + offset, jdsp->tmpBuffer[1] + offset);
+		const unsigned int processing = min(n - offset, hop);
+		float *y1 = jdsp->tmpBuffer[0] + offset;
+		float *y2 = jdsp->tmpBuffer[1] + offset;
+		if (hb)
+			FFTDynamicRangeSquasherProcessSamples(&hb->comp, y1, y2, processing, hb->out[0], hb->out[1]);
+		FFTDynamicRangeSquasherProcessSamples(&jdsp->comp, y1, y2, processing, y1, y2);
+		if (hb)
+		{
+			for (unsigned int i = 0; i < processing; i++)
+			{
+				y1[i] += hb->delay[0][hb->delayPos];
+				y2[i] += hb->delay[1][hb->delayPos];
+				hb->delay[0][hb->delayPos] = hb->out[0][i];
+				hb->delay[1][hb->delayPos] = hb->out[1][i];
+				if (++hb->delayPos == hb->delayLen)
+					hb->delayPos = 0;
+			}
+		}
 		offset += processing;
 	}
-}
\ No newline at end of file
+}
@@ -5,111 +5,143 @@
 #define GLUE_JMP_SET_OFFSET(endOfInstruction,offset) (((GLUE_JMP_TYPE *)(endOfInstruction))[-1] = (offset))
 #define GLUE_HAS_FXCH 
 #define GLUE_MAX_FPSTACK_SIZE 64
+#if defined(__GNUC__)
+#define EEL_BC_THREADED // labels as values, other compilers keep the switch
+#endif
 #define BIF_FPSTACKUSE(x) (0) // fp stack is not used within functions
 #define BIF_GETFPSTACKUSE(x) (1)
+#define EEL_BC_OPCODE_LIST(X) \
+  X(NOP) \
+  X(RET) \
+  X(JMP_NC) /* followed by GLUE_JMP_TYPE */ \
+  X(JMP_IF_P1_Z) \
+  X(JMP_IF_P1_NZ) \
+  X(MOV_FPTOP_DV) \
+  X(MOV_P1_DV) /* followed by INT_PTR ptr */ \
+  X(MOV_P2_DV) \
+  X(MOV_P3_DV) \
+  X(_RESET_WTP) \
+  X(PUSH_P1) \
+  X(PUSH_P1PTR_AS_VALUE) \
+  X(POP_P1) \
+  X(POP_P2) \
+  X(POP_P3) \
+  X(POP_VALUE_TO_ADDR) \
+  X(MOVE_STACK) \
+  X(STORE_P1_TO_STACK_AT_OFFS) \
+  X(MOVE_STACKPTR_TO_P1) \
+  X(MOVE_STACKPTR_TO_P2) \
+  X(MOVE_STACKPTR_TO_P3) \
+  X(SET_P2_FROM_P1) \
+  X(SET_P3_FROM_P1) \
+  X(COPY_VALUE_AT_P1_TO_ADDR) \
+  X(SET_P1_FROM_WTP) \
+  X(SET_P2_FROM_WTP) \
+  X(SET_P3_FROM_WTP) \
+  X(POP_FPSTACK_TO_PTR) \
+  X(POP_FPSTACK_TOSTACK) \
+  X(PUSH_VAL_AT_P1_TO_FPSTACK) \
+  X(PUSH_VAL_AT_P2_TO_FPSTACK) \
+  X(PUSH_VAL_AT_P3_TO_FPSTACK) \
+  X(POP_FPSTACK_TO_WTP) \
+  X(SET_P1_Z) \
+  X(SET_P1_NZ) \
+  X(LOOP_LOADCNT) \
+  X(LOOP_END) \
+  X(WHILE_SETUP) \
+  X(WHILE_BEGIN) \
+  X(WHILE_END) \
+  X(WHILE_CHECK_RV) \
+  X(BNOT) \
+  X(BNOTNOT) \
+  X(EQUAL) \
+  X(EQUAL_EXACT) \
+  X(NOTEQUAL) \
+  X(NOTEQUAL_EXACT) \
+  X(ABOVE) \
+  X(BELOWEQ) \
+  X(ADD) \
+  X(SUB) \
+  X(MUL) \
+  X(DIV) \
+  X(AND) \
+  X(OR) \
+  X(OR0) \
+  X(XOR) \
+  X(ADD_OP) \
+  X(SUB_OP) \
+  X(ADD_OP_FAST) \
+  X(SUB_OP_FAST) \
+  X(MUL_OP) \
+  X(DIV_OP) \
+  X(MUL_OP_FAST) \
+  X(DIV_OP_FAST) \
+  X(AND_OP) \
+  X(OR_OP) \
+  X(XOR_OP) \
+  X(UMINUS) \
+  X(ASSIGN) \
+  X(ASSIGN_FAST) \
+  X(ASSIGN_FAST_FROMFP) \
+  X(ASSIGN_FROMFP) \
+  X(MOD) \
+  X(MOD_OP) \
+  X(SHR) \
+  X(SHL) \
+  X(SQR) \
+  X(MIN) \
+  X(MAX) \
+  X(MIN_FP) \
+  X(MAX_FP) \
+  X(ABS) \
+  X(SIGN) \
+  X(INVSQRT) \
+  X(FXCH) \
+  X(POP_FPSTACK) \
+  X(FCALL) \
+  X(BOOLTOFP) \
+  X(FPTOBOOL) \
+  X(FPTOBOOL_REV) \
+  X(CFUNC_1PDD) \
+  X(CFUNC_2PDD) \
+  X(CFUNC_2PDDS) \
+  X(MEGABUF) \
+  X(GENERIC1PARM) \
+  X(GENERIC2PARM) \
+  X(GENERIC3PARM) \
+  X(GENERIC1PARM_RETD) \
+  X(GENERIC2PARM_RETD) \
+  X(GENERIC3PARM_RETD) \
+  /* Superinstructions written over the first opcode of a common sequence by the peephole pass, the rest of the sequence stays in place */ \
+  X(DV_ADD) /* MOV_FPTOP_DV, ADD */ \
+  X(DV_SUB) \
+  X(DV_MUL) \
+  X(DV_DIV) \
+  X(DV_DV) /* MOV_FPTOP_DV, MOV_FPTOP_DV */ \
+  X(DV_DV_ADD) /* MOV_FPTOP_DV, MOV_FPTOP_DV, ADD */ \
+  X(DV_DV_SUB) \
+  X(DV_DV_MUL) \
+  X(DV_DV_DIV) \
+  X(ADD_MEGABUF) /* ADD, MEGABUF */ \
+  X(ADD_MEGABUF_PUSH) /* ADD, MEGABUF, PUSH_VAL_AT_P1_TO_FPSTACK */ \
+  X(MEGABUF_PUSH) /* MEGABUF, PUSH_VAL_AT_P1_TO_FPSTACK */ \
+  X(ASSIGN_FROMFP_DV) /* MOV_P2_DV, ASSIGN_FROMFP or ASSIGN_FAST_FROMFP */ \
+  X(ADD_OP_DV) /* MOV_P2_DV, ADD_OP or ADD_OP_FAST */ \
+  X(SUB_OP_DV) \
+  X(MUL_OP_DV) \
+  X(DIV_OP_DV) \
+  X(COPY_DV) /* MOV_P1_DV, COPY_VALUE_AT_P1_TO_ADDR */ \
+  X(EQUAL_JZ) /* EQUAL, JMP_IF_P1_Z */ \
+  X(NOTEQUAL_JZ) \
+  X(ABOVE_JZ) \
+  X(BELOWEQ_JZ)
+#define EEL_BC_ENUM(x) EEL_BC_##x,
 enum {
-  EEL_BC_NOP=1,
-  EEL_BC_RET,
-  EEL_BC_JMP_NC, // followed by GLUE_JMP_TYPE
-  EEL_BC_JMP_IF_P1_Z,
-  EEL_BC_JMP_IF_P1_NZ,
-  EEL_BC_MOV_FPTOP_DV,
-  EEL_BC_MOV_P1_DV, // followed by INT_PTR ptr
-  EEL_BC_MOV_P2_DV,
-  EEL_BC_MOV_P3_DV,
-  EEL_BC__RESET_WTP,
-  EEL_BC_PUSH_P1,
-  EEL_BC_PUSH_P1PTR_AS_VALUE,
-  EEL_BC_POP_P1,
-  EEL_BC_POP_P2,
-  EEL_BC_POP_P3,
-  EEL_BC_POP_VALUE_TO_ADDR,
-  EEL_BC_MOVE_STACK,
-  EEL_BC_STORE_P1_TO_STACK_AT_OFFS,
-  EEL_BC_MOVE_STACKPTR_TO_P1,
-  EEL_BC_MOVE_STACKPTR_TO_P2,
-  EEL_BC_MOVE_STACKPTR_TO_P3,
-  EEL_BC_SET_P2_FROM_P1,
-  EEL_BC_SET_P3_FROM_P1,
-  EEL_BC_COPY_VALUE_AT_P1_TO_ADDR,
-  EEL_BC_SET_P1_FROM_WTP,
-  EEL_BC_SET_P2_FROM_WTP,
-  EEL_BC_SET_P3_FROM_WTP,
-  EEL_BC_POP_FPSTACK_TO_PTR,
-  EEL_BC_POP_FPSTACK_TOSTACK,
-  EEL_BC_PUSH_VAL_AT_P1_TO_FPSTACK, 
-  EEL_BC_PUSH_VAL_AT_P2_TO_FPSTACK, 
-  EEL_BC_PUSH_VAL_AT_P3_TO_FPSTACK, 
-  EEL_BC_POP_FPSTACK_TO_WTP,
-  EEL_BC_SET_P1_Z,
-  EEL_BC_SET_P1_NZ,
-  EEL_BC_LOOP_LOADCNT,
-  EEL_BC_LOOP_END,
-  EEL_BC_WHILE_SETUP,
-  EEL_BC_WHILE_BEGIN,
-  EEL_BC_WHILE_END,
-  EEL_BC_WHILE_CHECK_RV,
-  EEL_BC_BNOT,
-  EEL_BC_BNOTNOT,
-  EEL_BC_EQUAL,
-  EEL_BC_EQUAL_EXACT,
-  EEL_BC_NOTEQUAL,
-  EEL_BC_NOTEQUAL_EXACT,
-  EEL_BC_ABOVE,
-  EEL_BC_BELOWEQ,
-  EEL_BC_ADD,
-  EEL_BC_SUB,
-  EEL_BC_MUL,
-  EEL_BC_DIV,
-  EEL_BC_AND,
-  EEL_BC_OR,
-  EEL_BC_OR0,
-  EEL_BC_XOR,
-  EEL_BC_ADD_OP,
-  EEL_BC_SUB_OP,
-  EEL_BC_ADD_OP_FAST,
-  EEL_BC_SUB_OP_FAST,
-  EEL_BC_MUL_OP,
-  EEL_BC_DIV_OP,
-  EEL_BC_MUL_OP_FAST,
-  EEL_BC_DIV_OP_FAST,
-  EEL_BC_AND_OP,
-  EEL_BC_OR_OP,
-  EEL_BC_XOR_OP,
-  EEL_BC_UMINUS,
-  EEL_BC_ASSIGN,
-  EEL_BC_ASSIGN_FAST,
-  EEL_BC_ASSIGN_FAST_FROMFP,
-  EEL_BC_ASSIGN_FROMFP,
-  EEL_BC_MOD,
-  EEL_BC_MOD_OP,
-  EEL_BC_SHR,
-  EEL_BC_SHL,
-  EEL_BC_SQR,
-  EEL_BC_MIN,
-  EEL_BC_MAX,
-  EEL_BC_MIN_FP,
-  EEL_BC_MAX_FP,
-  EEL_BC_ABS,
-  EEL_BC_SIGN,
-  EEL_BC_INVSQRT,
-  EEL_BC_FXCH,
-  EEL_BC_POP_FPSTACK,
-  EEL_BC_FCALL,
-  EEL_BC_BOOLTOFP,
-  EEL_BC_FPTOBOOL,
-  EEL_BC_FPTOBOOL_REV,
-  EEL_BC_CFUNC_1PDD,
-  EEL_BC_CFUNC_2PDD,
-  EEL_BC_CFUNC_2PDDS,
-  EEL_BC_MEGABUF,
-  EEL_BC_GENERIC1PARM,
-  EEL_BC_GENERIC2PARM,
-  EEL_BC_GENERIC3PARM,
-  EEL_BC_GENERIC1PARM_RETD,
-  EEL_BC_GENERIC2PARM_RETD,
-  EEL_BC_GENERIC3PARM_RETD,
+  EEL_BC_INVALID, // opcodes start at 1
+  EEL_BC_OPCODE_LIST(EEL_BC_ENUM)
+  EEL_BC_NUM_OPCODES
 };
+#undef EEL_BC_ENUM
 #define BC_DECL(x) static const EEL_BC_TYPE GLUE_##x[] = { EEL_BC_##x };
 #define BC_DECL_JMP(x) static const EEL_BC_TYPE GLUE_##x[1 + sizeof(GLUE_JMP_TYPE) / sizeof(EEL_BC_TYPE)] = { EEL_BC_##x };
 BC_DECL_JMP(JMP_NC)
@@ -407,6 +439,170 @@ static void *GLUE_realAddress(void *fn, void *fn_e, int32_t *size)
 #define EEL_BC_STACK_PUSH(type, val) (*(type *)(stackptr -= EEL_BC_STACK_POP_SIZE)) = (val)
 #define EEL_BC_STACK_POP() (stackptr += EEL_BC_STACK_POP_SIZE)
 #define EEL_BC_TRUE ((float*)(INT_PTR)1)
+// Opcode a superinstruction was written over, which is also what decides its operand size and control flow
+static EEL_BC_TYPE nseel_bc_base_op(EEL_BC_TYPE op)
+{
+  switch (op)
+  {
+    case EEL_BC_DV_ADD: case EEL_BC_DV_SUB: case EEL_BC_DV_MUL: case EEL_BC_DV_DIV:
+    case EEL_BC_DV_DV: case EEL_BC_DV_DV_ADD: case EEL_BC_DV_DV_SUB: case EEL_BC_DV_DV_MUL: case EEL_BC_DV_DV_DIV:
+      return EEL_BC_MOV_FPTOP_DV;
+    case EEL_BC_ADD_MEGABUF: case EEL_BC_ADD_MEGABUF_PUSH: return EEL_BC_ADD;
+    case EEL_BC_MEGABUF_PUSH: return EEL_BC_MEGABUF;
+    case EEL_BC_ASSIGN_FROMFP_DV: case EEL_BC_ADD_OP_DV: case EEL_BC_SUB_OP_DV: case EEL_BC_MUL_OP_DV: case EEL_BC_DIV_OP_DV:
+      return EEL_BC_MOV_P2_DV;
+    case EEL_BC_COPY_DV: return EEL_BC_MOV_P1_DV;
+    case EEL_BC_EQUAL_JZ: return EEL_BC_EQUAL;
+    case EEL_BC_NOTEQUAL_JZ: return EEL_BC_NOTEQUAL;
+    case EEL_BC_ABOVE_JZ: return EEL_BC_ABOVE;
+    case EEL_BC_BELOWEQ_JZ: return EEL_BC_BELOWEQ;
+  }
+  return op;
+}
+// Bytes taken by an opcode and its operands, 0 if it is not a known opcode
+static int32_t nseel_bc_insn_size(EEL_BC_TYPE op)
+{
+  switch (nseel_bc_base_op(op))
+  {
+    case EEL_BC_JMP_NC: case EEL_BC_JMP_IF_P1_Z: case EEL_BC_JMP_IF_P1_NZ: case EEL_BC_LOOP_LOADCNT: case EEL_BC_LOOP_END:
+    case EEL_BC_WHILE_END: case EEL_BC_WHILE_CHECK_RV:
+      return sizeof(EEL_BC_TYPE) + sizeof(GLUE_JMP_TYPE);
+    case EEL_BC_MOVE_STACK: case EEL_BC_STORE_P1_TO_STACK_AT_OFFS:
+      return sizeof(EEL_BC_TYPE) + sizeof(int32_t);
+    case EEL_BC_MOV_FPTOP_DV: case EEL_BC_MOV_P1_DV: case EEL_BC_MOV_P2_DV: case EEL_BC_MOV_P3_DV: case EEL_BC__RESET_WTP:
+    case EEL_BC_POP_VALUE_TO_ADDR: case EEL_BC_COPY_VALUE_AT_P1_TO_ADDR: case EEL_BC_POP_FPSTACK_TO_PTR: case EEL_BC_FCALL:
+    case EEL_BC_CFUNC_1PDD: case EEL_BC_CFUNC_2PDD: case EEL_BC_CFUNC_2PDDS:
+      return sizeof(EEL_BC_TYPE) + sizeof(void *);
+    case EEL_BC_GENERIC1PARM: case EEL_BC_GENERIC2PARM: case EEL_BC_GENERIC3PARM:
+    case EEL_BC_GENERIC1PARM_RETD: case EEL_BC_GENERIC2PARM_RETD: case EEL_BC_GENERIC3PARM_RETD:
+      return sizeof(EEL_BC_TYPE) + sizeof(void *) * 2;
+  }
+  return (op >= EEL_BC_NOP && op < EEL_BC_NUM_OPCODES) ? sizeof(EEL_BC_TYPE) : 0;
+}
+// Where the opcode at ip may continue besides the next opcode, a jump or function target, or 0
+static char *nseel_bc_branch_target(char *ip)
+{
+  switch (nseel_bc_base_op(*(EEL_BC_TYPE *)ip))
+  {
+    case EEL_BC_JMP_NC: case EEL_BC_JMP_IF_P1_Z: case EEL_BC_JMP_IF_P1_NZ: case EEL_BC_LOOP_LOADCNT: case EEL_BC_LOOP_END:
+    case EEL_BC_WHILE_END: case EEL_BC_WHILE_CHECK_RV:
+      {
+        GLUE_JMP_TYPE offs;
+        memcpy(&offs, ip + sizeof(EEL_BC_TYPE), sizeof(offs));
+        return ip + sizeof(EEL_BC_TYPE) + sizeof(GLUE_JMP_TYPE) + offs;
+      }
+    case EEL_BC_FCALL:
+      {
+        char *target;
+        memcpy(&target, ip + sizeof(EEL_BC_TYPE), sizeof(target));
+        return target;
+      }
+  }
+  return 0;
+}
+// Every opcode reachable from entry, following jumps and function calls, sorted by address. Returns 0 on
+// allocation failure or when an unknown opcode is found, otherwise a malloc'd array the caller frees
+static int nseel_bc_cmp_addr(const void *a, const void *b)
+{
+  char *x = *(char **)a, *y = *(char **)b;
+  return x < y ? -1 : x > y;
+}
+static char **nseel_bc_discover(char *entry, int32_t *count)
+{
+  int32_t n = 0, cap = 256, numWork = 1, capWork = 64, hashCap = 1024;
+  char **insns = (char **)malloc(cap * sizeof(char *));
+  char **work = (char **)malloc(capWork * sizeof(char *));
+  char **hash = (char **)calloc(hashCap, sizeof(char *));
+  int32_t ok = insns && work && hash;
+  if (ok)
+    work[0] = entry;
+  while (ok && numWork)
+  {
+    char *ip = work[--numWork];
+    for (;;)
+    {
+      // Open addressing set of visited opcodes, kept at most half full
+      int32_t slot = (int32_t)((((UINT_PTR)ip >> 2) * 2654435761u) & (hashCap - 1)), seen = 0;
+      while (hash[slot])
+      {
+        if (hash[slot] == ip)
+        {
+          seen = 1;
+          break;
+        }
+        slot = (slot + 1) & (hashCap - 1);
+      }
+      if (seen)
+        break;
+      const EEL_BC_TYPE op = *(EEL_BC_TYPE *)ip;
+      const int32_t size = nseel_bc_insn_size(op);
+      if (!size)
+      {
+        ok = 0;
+        break;
+      }
+      hash[slot] = ip;
+      if (n == cap)
+      {
+        char **p = (char **)realloc(insns, (cap *= 2) * sizeof(char *));
+        if (!p)
+        {
+          ok = 0;
+          break;
+        }
+        insns = p;
+      }
+      insns[n++] = ip;
+      if (n * 2 > hashCap)
+      {
+        char **newHash = (char **)calloc(hashCap * 2, sizeof(char *));
+        if (!newHash)
+        {
+          ok = 0;
+          break;
+        }
+        hashCap *= 2;
+        for (int32_t i = 0; i < n; i++)
+        {
+          int32_t s = (int32_t)((((UINT_PTR)insns[i] >> 2) * 2654435761u) & (hashCap - 1));
+          while (newHash[s])
+            s = (s + 1) & (hashCap - 1);
+          newHash[s] = insns[i];
+        }
+        free(hash);
+        hash = newHash;
+      }
+      char *branch = nseel_bc_branch_target(ip);
+      if (branch)
+      {
+        if (numWork == capWork)
+        {
+          char **p = (char **)realloc(work, (capWork *= 2) * sizeof(char *));
+          if (!p)
+          {
+            ok = 0;
+            break;
+          }
+          work = p;
+        }
+        work[numWork++] = branch;
+      }
+      if (op == EEL_BC_RET || op == EEL_BC_JMP_NC)
+        break;
+      ip += size;
+    }
+  }
+  free(work);
+  free(hash);
+  if (!ok)
+  {
+    free(insns);
+    return 0;
+  }
+  qsort(insns, n, sizeof(char *), nseel_bc_cmp_addr);
+  *count = n;
+  return insns;
+}
 static void GLUE_CALL_CODE(INT_PTR bp, INT_PTR cp, INT_PTR rt) 
 {
   char __stack[EEL_BC_STACKSIZE];
@@ -418,144 +614,161 @@ static void GLUE_CALL_CODE(INT_PTR bp, INT_PTR cp, INT_PTR rt)
 #define fp_push(x) *++_fpstacktop=(x)
 #define fp_pop() (*_fpstacktop--)
 #define fp_rewind(x) (_fpstacktop -= (x))
+#define BC_DV_OPERAND(n) (**(float **)(iptr + (n) * (sizeof(void *) + sizeof(EEL_BC_TYPE)))) // n-th of consecutive MOV_FPTOP_DV operands
   float fpstack[GLUE_MAX_FPSTACK_SIZE];
   float *_fpstacktop=fpstack-1;
+#ifdef EEL_BC_THREADED
+  // Every handler jumps straight to the next one through the table instead of returning to a shared switch
+  // Same order as the opcode enum, EEL_BC_INVALID lands on NOP
+  static const void *const dispatch[EEL_BC_NUM_OPCODES] = {
+    &&bc_NOP,
+#define BC_LABEL(x) &&bc_##x,
+    EEL_BC_OPCODE_LIST(BC_LABEL)
+#undef BC_LABEL
+  };
+#define BC_OP(x) bc_##x:
+#define BC_NEXT() { EEL_BC_TYPE inst = *(EEL_BC_TYPE *)iptr; iptr += sizeof(EEL_BC_TYPE); goto *dispatch[inst]; }
+  BC_NEXT();
+#else
+#define BC_OP(x) case EEL_BC_##x:
+#define BC_NEXT() break
   for (;;)
   {
     EEL_BC_TYPE inst = *(EEL_BC_TYPE *)iptr;
     iptr += sizeof(EEL_BC_TYPE);
     switch (inst)
     {
-      case EEL_BC_FXCH:
+#endif
+      BC_OP(FXCH)
         {
           float a = fp_top;
           fp_top=fp_top2;
           fp_top2=a;
         }
-      break;
-      case EEL_BC_POP_FPSTACK: fp_rewind(1); break;
-      case EEL_BC_NOP: break;
-      case EEL_BC_RET: 
+      BC_NEXT();
+      BC_OP(POP_FPSTACK) fp_rewind(1); BC_NEXT();
+      BC_OP(NOP) BC_NEXT();
+      BC_OP(RET) 
         if (EEL_BC_STACK_POP() > __stack+EEL_BC_STACKSIZE) 
         {
           return;
         }
         iptr = *(void **)(stackptr - EEL_BC_STACK_POP_SIZE);
-      break;
-      case EEL_BC_JMP_NC: 
+      BC_NEXT();
+      BC_OP(JMP_NC) 
         iptr += sizeof(GLUE_JMP_TYPE)+*(GLUE_JMP_TYPE *)iptr;
-      break;
-      case EEL_BC_JMP_IF_P1_Z:
+      BC_NEXT();
+      BC_OP(JMP_IF_P1_Z)
         iptr += p1 ? sizeof(GLUE_JMP_TYPE) : sizeof(GLUE_JMP_TYPE)+*(GLUE_JMP_TYPE *)iptr;
-      break;
-      case EEL_BC_JMP_IF_P1_NZ:
+      BC_NEXT();
+      BC_OP(JMP_IF_P1_NZ)
         iptr += p1 ? sizeof(GLUE_JMP_TYPE)+*(GLUE_JMP_TYPE *)iptr : sizeof(GLUE_JMP_TYPE);
-      break;
-      case EEL_BC_MOV_FPTOP_DV:
+      BC_NEXT();
+      BC_OP(MOV_FPTOP_DV)
         fp_push(**(float **)iptr);
         iptr += sizeof(void*);
-      break;
-      case EEL_BC_MOV_P1_DV:
+      BC_NEXT();
+      BC_OP(MOV_P1_DV)
         p1 = *(void **)iptr;
         iptr += sizeof(void*);
-      break;
-      case EEL_BC_MOV_P2_DV:
+      BC_NEXT();
+      BC_OP(MOV_P2_DV)
         p2 = *(void **)iptr;
         iptr += sizeof(void*);
-      break;
-      case EEL_BC_MOV_P3_DV:
+      BC_NEXT();
+      BC_OP(MOV_P3_DV)
         p3 = *(void **)iptr;
         iptr += sizeof(void*);
-      break;
-      case EEL_BC__RESET_WTP:
+      BC_NEXT();
+      BC_OP(_RESET_WTP)
         wtp = *(void **)iptr;
         iptr += sizeof(void*);
-      break;    
-      case EEL_BC_PUSH_P1:
+      BC_NEXT();
+      BC_OP(PUSH_P1)
         EEL_BC_STACK_PUSH(void *, p1);
-      break;
-      case EEL_BC_PUSH_P1PTR_AS_VALUE:
+      BC_NEXT();
+      BC_OP(PUSH_P1PTR_AS_VALUE)
         EEL_BC_STACK_PUSH(float, *p1);
-      break;
-      case EEL_BC_POP_P1:
+      BC_NEXT();
+      BC_OP(POP_P1)
         p1 = *(float **) stackptr;
         EEL_BC_STACK_POP();
-      break;
-      case EEL_BC_POP_P2:
+      BC_NEXT();
+      BC_OP(POP_P2)
         p2 = *(float **) stackptr;
         EEL_BC_STACK_POP();
-      break;
-      case EEL_BC_POP_P3:
+      BC_NEXT();
+      BC_OP(POP_P3)
         p3 = *(float **) stackptr;
         EEL_BC_STACK_POP();
-      break;
-      case EEL_BC_POP_VALUE_TO_ADDR:
+      BC_NEXT();
+      BC_OP(POP_VALUE_TO_ADDR)
         **(float**)iptr = *(float *)stackptr;
         EEL_BC_STACK_POP();
         iptr += sizeof(void*);
-      break;
-      case EEL_BC_MOVE_STACK:
+      BC_NEXT();
+      BC_OP(MOVE_STACK)
         stackptr += *(int32_t *)iptr;
         iptr += sizeof(int32_t);
-      break;
-      case EEL_BC_STORE_P1_TO_STACK_AT_OFFS:
+      BC_NEXT();
+      BC_OP(STORE_P1_TO_STACK_AT_OFFS)
         *(void **) (stackptr + *(int32_t *)iptr) = p1;
         iptr += sizeof(int32_t);
-      break;
-      case EEL_BC_MOVE_STACKPTR_TO_P1:
+      BC_NEXT();
+      BC_OP(MOVE_STACKPTR_TO_P1)
         p1 = (float *)stackptr;
-      break;
-      case EEL_BC_MOVE_STACKPTR_TO_P2:
+      BC_NEXT();
+      BC_OP(MOVE_STACKPTR_TO_P2)
         p2 = (float *)stackptr;
-      break;
-      case EEL_BC_MOVE_STACKPTR_TO_P3:
+      BC_NEXT();
+      BC_OP(MOVE_STACKPTR_TO_P3)
         p3 = (float *)stackptr;
-      break;
-      case EEL_BC_SET_P2_FROM_P1:
+      BC_NEXT();
+      BC_OP(SET_P2_FROM_P1)
         p2=p1;
-      break;
-      case EEL_BC_SET_P3_FROM_P1:
+      BC_NEXT();
+      BC_OP(SET_P3_FROM_P1)
         p3=p1;
-      break;
-      case EEL_BC_COPY_VALUE_AT_P1_TO_ADDR:
+      BC_NEXT();
+      BC_OP(COPY_VALUE_AT_P1_TO_ADDR)
         **(float **)iptr = *p1;
         iptr += sizeof(void*);
-      break;
-      case EEL_BC_SET_P1_FROM_WTP:
+      BC_NEXT();
+      BC_OP(SET_P1_FROM_WTP)
         p1 = wtp;
-      break;
-      case EEL_BC_SET_P2_FROM_WTP:
+      BC_NEXT();
+      BC_OP(SET_P2_FROM_WTP)
         p2 = wtp;
-      break;
-      case EEL_BC_SET_P3_FROM_WTP:
+      BC_NEXT();
+      BC_OP(SET_P3_FROM_WTP)
         p3 = wtp;
-      break;
-      case EEL_BC_POP_FPSTACK_TO_PTR:
+      BC_NEXT();
+      BC_OP(POP_FPSTACK_TO_PTR)
         **((float **)iptr) = fp_pop();
         iptr += sizeof(void *);
-      break;
-      case EEL_BC_POP_FPSTACK_TOSTACK:
+      BC_NEXT();
+      BC_OP(POP_FPSTACK_TOSTACK)
         EEL_BC_STACK_PUSH(float, fp_pop());
-      break;
-      case EEL_BC_PUSH_VAL_AT_P1_TO_FPSTACK: 
+      BC_NEXT();
+      BC_OP(PUSH_VAL_AT_P1_TO_FPSTACK) 
         fp_push(*p1);
-      break;
-      case EEL_BC_PUSH_VAL_AT_P2_TO_FPSTACK: 
+      BC_NEXT();
+      BC_OP(PUSH_VAL_AT_P2_TO_FPSTACK) 
         fp_push(*p2);
-      break;
-      case EEL_BC_PUSH_VAL_AT_P3_TO_FPSTACK: 
+      BC_NEXT();
+      BC_OP(PUSH_VAL_AT_P3_TO_FPSTACK) 
         fp_push(*p3);
-      break;
-      case EEL_BC_POP_FPSTACK_TO_WTP:
+      BC_NEXT();
+      BC_OP(POP_FPSTACK_TO_WTP)
         *wtp++ = fp_pop();
-      break;
-      case EEL_BC_SET_P1_Z:
+      BC_NEXT();
+      BC_OP(SET_P1_Z)
         p1=NULL;
-      break;
-      case EEL_BC_SET_P1_NZ:
+      BC_NEXT();
+      BC_OP(SET_P1_NZ)
         p1 = EEL_BC_TRUE;
-      break;
-      case EEL_BC_LOOP_LOADCNT:
+      BC_NEXT();
+      BC_OP(LOOP_LOADCNT)
         if ((EEL_BC_STACK_PUSH(int32_t, (int32_t)fp_pop())) < 1)
         {
           EEL_BC_STACK_POP();
@@ -566,8 +779,8 @@ static void GLUE_CALL_CODE(INT_PTR bp, INT_PTR cp, INT_PTR rt)
           iptr += sizeof(GLUE_JMP_TYPE);
           EEL_BC_STACK_PUSH(void *, wtp);
         }
-      break;
-      case EEL_BC_LOOP_END:
+      BC_NEXT();
+      BC_OP(LOOP_END)
         wtp = *(void **) (stackptr);
         if (--(*(int32_t *)(stackptr+EEL_BC_STACK_POP_SIZE)) <= 0)
         {
@@ -578,14 +791,14 @@ static void GLUE_CALL_CODE(INT_PTR bp, INT_PTR cp, INT_PTR rt)
         {
           iptr += sizeof(GLUE_JMP_TYPE)+*(GLUE_JMP_TYPE *)iptr; // back to the start!
         }
-      break;
-      case EEL_BC_WHILE_SETUP:
+      BC_NEXT();
+      BC_OP(WHILE_SETUP)
         EEL_BC_STACK_PUSH(int32_t, NSEEL_NATIVE_FLT_MAX_INT);
-      break;
-      case EEL_BC_WHILE_BEGIN:
+      BC_NEXT();
+      BC_OP(WHILE_BEGIN)
         EEL_BC_STACK_PUSH(void *, wtp);
-      break;
-      case EEL_BC_WHILE_END:
+      BC_NEXT();
+      BC_OP(WHILE_END)
         wtp = *(float **) stackptr;
         EEL_BC_STACK_POP();
 		if (--(*(int32_t *)stackptr) <= 0)
@@ -595,8 +808,8 @@ static void GLUE_CALL_CODE(INT_PTR bp, INT_PTR cp, INT_PTR rt)
 		}
 		else
 			iptr += sizeof(GLUE_JMP_TYPE);
-      break;
-      case EEL_BC_WHILE_CHECK_RV:
+      BC_NEXT();
+      BC_OP(WHILE_CHECK_RV)
         if (p1)
           iptr += sizeof(GLUE_JMP_TYPE)+*(GLUE_JMP_TYPE *)iptr; // loop
         else
@@ -605,271 +818,388 @@ static void GLUE_CALL_CODE(INT_PTR bp, INT_PTR cp, INT_PTR rt)
 			EEL_BC_STACK_POP();
           iptr += sizeof(GLUE_JMP_TYPE);
         }
-      break; 
-      case EEL_BC_BNOT:
+      BC_NEXT();
+      BC_OP(BNOT)
         p1 = p1 ? NULL : EEL_BC_TRUE;
-      break;
-      case EEL_BC_BNOTNOT:
+      BC_NEXT();
+      BC_OP(BNOTNOT)
         p1 = p1 ? EEL_BC_TRUE : NULL;
-      break;
-      case EEL_BC_EQUAL:
+      BC_NEXT();
+      BC_OP(EQUAL)
         p1 = fabsf(fp_top - fp_top2) < NSEEL_CLOSEFACTOR ? EEL_BC_TRUE : NULL;
         fp_rewind(2);
-      break;
-      case EEL_BC_EQUAL_EXACT:
+      BC_NEXT();
+      BC_OP(EQUAL_EXACT)
         p1 = fp_top == fp_top2 ? EEL_BC_TRUE : NULL;
         fp_rewind(2);
-      break;
-      case EEL_BC_NOTEQUAL:
+      BC_NEXT();
+      BC_OP(NOTEQUAL)
         p1 = fabsf(fp_top - fp_top2) >= NSEEL_CLOSEFACTOR ? EEL_BC_TRUE : NULL;
         fp_rewind(2);
-      break;
-      case EEL_BC_NOTEQUAL_EXACT:
+      BC_NEXT();
+      BC_OP(NOTEQUAL_EXACT)
         p1 = fp_top != fp_top2 ? EEL_BC_TRUE : NULL;
         fp_rewind(2);
-      break;
-      case EEL_BC_ABOVE:
+      BC_NEXT();
+      BC_OP(ABOVE)
         p1 = fp_top < fp_top2 ? EEL_BC_TRUE : NULL;
         fp_rewind(2);
-      break;
-      case EEL_BC_BELOWEQ:
+      BC_NEXT();
+      BC_OP(BELOWEQ)
         p1 = fp_top >= fp_top2 ? EEL_BC_TRUE : NULL;
         fp_rewind(2);
-      break;
-      case EEL_BC_ADD:
+      BC_NEXT();
+      BC_OP(ADD)
         fp_top2 += fp_top;
         fp_rewind(1);
-      break;
-      case EEL_BC_SUB:
+      BC_NEXT();
+      BC_OP(SUB)
         fp_top2 -= fp_top;
         fp_rewind(1);
-      break;
-      case EEL_BC_MUL:
+      BC_NEXT();
+      BC_OP(MUL)
         fp_top2 *= fp_top;
         fp_rewind(1);
-      break;
-      case EEL_BC_DIV:
+      BC_NEXT();
+      BC_OP(DIV)
         fp_top2 /= fp_top;
         fp_rewind(1);
-      break;
-      case EEL_BC_AND:
+      BC_NEXT();
+      BC_OP(AND)
         fp_top2 = (float) (((int32_t)fp_top) & (int32_t)(fp_top2));
         fp_rewind(1);
-      break;
-      case EEL_BC_OR:
+      BC_NEXT();
+      BC_OP(OR)
         fp_top2 = (float) (((int32_t)fp_top) | (int32_t)(fp_top2));
         fp_rewind(1);
-      break;
-      case EEL_BC_OR0:
+      BC_NEXT();
+      BC_OP(OR0)
         fp_top = (float) ((int32_t)(fp_top));
-      break;
-      case EEL_BC_XOR:
+      BC_NEXT();
+      BC_OP(XOR)
         fp_top2 = (float) (((int32_t)fp_top) ^ (int32_t)(fp_top2));
         fp_rewind(1);
-      break;
-      case EEL_BC_ADD_OP:
+      BC_NEXT();
+      BC_OP(ADD_OP)
         *(p1 = p2) = *p2 + fp_pop();
-      break;
-      case EEL_BC_SUB_OP:
+      BC_NEXT();
+      BC_OP(SUB_OP)
         *(p1 = p2) = *p2 - fp_pop();
-      break;
-      case EEL_BC_ADD_OP_FAST:
+      BC_NEXT();
+      BC_OP(ADD_OP_FAST)
         *(p1 = p2) += fp_pop();        
-      break;
-      case EEL_BC_SUB_OP_FAST:
+      BC_NEXT();
+      BC_OP(SUB_OP_FAST)
         *(p1 = p2) -= fp_pop();
-      break;
-      case EEL_BC_MUL_OP:
+      BC_NEXT();
+      BC_OP(MUL_OP)
         *(p1 = p2) = *p2 * fp_pop();
-      break;
-      case EEL_BC_DIV_OP:
+      BC_NEXT();
+      BC_OP(DIV_OP)
         *(p1 = p2) = *p2 / fp_pop();
-      break;
-      case EEL_BC_MUL_OP_FAST:
+      BC_NEXT();
+      BC_OP(MUL_OP_FAST)
         *(p1 = p2) *= fp_pop();
-      break;
-      case EEL_BC_DIV_OP_FAST:
+      BC_NEXT();
+      BC_OP(DIV_OP_FAST)
         *(p1 = p2) /= fp_pop();
-      break;
-      case EEL_BC_AND_OP:
+      BC_NEXT();
+      BC_OP(AND_OP)
         p1 = p2;
         *p2 = (float) (((int32_t)*p2) & (int32_t)fp_pop());
-      break;
-      case EEL_BC_OR_OP:
+      BC_NEXT();
+      BC_OP(OR_OP)
         p1 = p2;
         *p2 = (float) (((int32_t)*p2) | (int32_t)fp_pop());
-      break;
-      case EEL_BC_XOR_OP:
+      BC_NEXT();
+      BC_OP(XOR_OP)
         p1 = p2;
         *p2 = (float) (((int32_t)*p2) ^ (int32_t)fp_pop());
-      break;
-      case EEL_BC_UMINUS:
+      BC_NEXT();
+      BC_OP(UMINUS)
         fp_top = -fp_top;
-      break;
-      case EEL_BC_ASSIGN:
+      BC_NEXT();
+      BC_OP(ASSIGN)
         *p2 = *p1;
         p1 = p2;
-      break;
-      case EEL_BC_ASSIGN_FAST:
+      BC_NEXT();
+      BC_OP(ASSIGN_FAST)
         *p2 = *p1;
         p1 = p2;
-      break;
-      case EEL_BC_ASSIGN_FAST_FROMFP:
+      BC_NEXT();
+      BC_OP(ASSIGN_FAST_FROMFP)
         *p2 = fp_pop();
         p1 = p2;
-      break;
-      case EEL_BC_ASSIGN_FROMFP:
+      BC_NEXT();
+      BC_OP(ASSIGN_FROMFP)
         *p2 = fp_pop();
         p1 = p2;
-      break;
-      case EEL_BC_MOD:
+      BC_NEXT();
+      BC_OP(MOD)
         {
           int32_t a = (int32_t) (fp_pop());
           fp_top = a ? (float) ((int32_t)fp_top % a) : 0.0f;
         }
-      break;
-      case EEL_BC_MOD_OP:
+      BC_NEXT();
+      BC_OP(MOD_OP)
         {
           int32_t a = (int32_t) (fp_pop());
           *p2 = a ? (float) ((int32_t)*p2 % a) : 0.0f;
           p1=p2;
         }
-      break;
-      case EEL_BC_SHR:
+      BC_NEXT();
+      BC_OP(SHR)
         fp_top2 = (float) (((int32_t)fp_top2) >> (int32_t)fp_top);
         fp_rewind(1);
-      break;
-      case EEL_BC_SHL:
+      BC_NEXT();
+      BC_OP(SHL)
         fp_top2 = (float) (((int32_t)fp_top2) << (int32_t)fp_top);
         fp_rewind(1);
-      break;
-      case EEL_BC_SQR:
+      BC_NEXT();
+      BC_OP(SQR)
         fp_top *= fp_top;
-      break;
-      case EEL_BC_MIN:
+      BC_NEXT();
+      BC_OP(MIN)
         if (*p1 > *p2) p1 = p2;
-      break;
-      case EEL_BC_MAX:
+      BC_NEXT();
+      BC_OP(MAX)
         if (*p1 < *p2) p1 = p2;
-      break;
-      case EEL_BC_MIN_FP:
+      BC_NEXT();
+      BC_OP(MIN_FP)
         {
           float a=fp_pop();
           if (a<fp_top) fp_top=a;
         }
-      break;
-      case EEL_BC_MAX_FP:
+      BC_NEXT();
+      BC_OP(MAX_FP)
         {
           float a=fp_pop();
           if (a>fp_top) fp_top=a;
         }
-      break;
-      case EEL_BC_ABS:
+      BC_NEXT();
+      BC_OP(ABS)
         fp_top = fabsf(fp_top);
-      break;
-      case EEL_BC_SIGN:
+      BC_NEXT();
+      BC_OP(SIGN)
         if (fp_top<0.0f) fp_top=-1.0f;
         else if (fp_top>0.0f) fp_top=1.0f;
-      break;
-      case EEL_BC_INVSQRT:
+      BC_NEXT();
+      BC_OP(INVSQRT)
         {
           float y = (float)fp_top;
           int32_t i  = 0x5f3759df - ( (* (int32_t *) &y) >> 1 );
           y  = *(float *) &i;
           fp_top  = y * ( 1.5f - ( (fp_top * 0.5f) * y * y ) );
         }
-      break;
-      case EEL_BC_FCALL:
+      BC_NEXT();
+      BC_OP(FCALL)
         {
           char *newiptr = *(char **)iptr;
           EEL_BC_STACK_PUSH(void *, (iptr += sizeof(void *)));
           iptr = newiptr;
         }
-      break;
-      case EEL_BC_BOOLTOFP:
+      BC_NEXT();
+      BC_OP(BOOLTOFP)
         fp_push(p1 ? 1.0f : 0.0f);
-      break;
-      case EEL_BC_FPTOBOOL:
+      BC_NEXT();
+      BC_OP(FPTOBOOL)
         p1 = fabsf(fp_pop()) >= NSEEL_CLOSEFACTOR ? EEL_BC_TRUE : NULL;
-      break;
-      case EEL_BC_FPTOBOOL_REV:
+      BC_NEXT();
+      BC_OP(FPTOBOOL_REV)
         p1 = fabsf(fp_pop()) < NSEEL_CLOSEFACTOR ? EEL_BC_TRUE : NULL;
-      break;
-      case EEL_BC_CFUNC_1PDD:
+      BC_NEXT();
+      BC_OP(CFUNC_1PDD)
         {
           float (*f)(float) = *(float (**)(float)) iptr;
           fp_top = f(fp_top);
           iptr += sizeof(void *);
         }
-      break;
-      case EEL_BC_CFUNC_2PDD:
+      BC_NEXT();
+      BC_OP(CFUNC_2PDD)
         {
           float (*f)(float,float) = *(float (**)(float,float))iptr;
           fp_top2 = f(fp_top2,fp_top);
           fp_rewind(1);
           iptr += sizeof(void *);
         }
-      break;
-      case EEL_BC_CFUNC_2PDDS:
+      BC_NEXT();
+      BC_OP(CFUNC_2PDDS)
         {
           float (*f)(float,float) = *(float (**)(float,float))iptr;
           *p2 = f(*p2,fp_pop());
           p1 = p2;
           iptr += sizeof(void *);
         }
-      break;
-      case EEL_BC_MEGABUF:
+      BC_NEXT();
+      BC_OP(MEGABUF)
         {
 		  p1 = ((float*)rt) + (uint32_t)(fp_pop() + NSEEL_CLOSEFACTOR);
         }
-      break;
-      case EEL_BC_GENERIC1PARM:
+      BC_NEXT();
+      BC_OP(GENERIC1PARM)
         {
           float *(*f)(void *,float*) = *(float *(**)(void *, float *)) (iptr+sizeof(void *));
           p1 = f(*(void **)iptr,p1);
           iptr += sizeof(void *)*2;
         }
-      break;
-      case EEL_BC_GENERIC2PARM:
+      BC_NEXT();
+      BC_OP(GENERIC2PARM)
         {
           float *(*f)(void *,float*,float*) = *(float *(**)(void *, float *, float *)) (iptr+sizeof(void *));
           p1 = f(*(void **)iptr,p2, p1);
           iptr += sizeof(void *)*2;
         }
-      break;
-      case EEL_BC_GENERIC3PARM:
+      BC_NEXT();
+      BC_OP(GENERIC3PARM)
         {
           float *(*f)(void *,float*,float*,float*) = *(float *(**)(void *, float *, float *, float *)) (iptr+sizeof(void *));
           p1 = f(*(void **)iptr,p3, p2, p1);
           iptr += sizeof(void *)*2;
         }
-      break;
-      case EEL_BC_GENERIC1PARM_RETD:
+      BC_NEXT();
+      BC_OP(GENERIC1PARM_RETD)
         {
           float (*f)(void *,float*) = *(float (**)(void *, float *)) (iptr+sizeof(void *));
           fp_push(f(*(void **)iptr,p1));
           iptr += sizeof(void *)*2;
         }
-      break;
-      case EEL_BC_GENERIC2PARM_RETD:
+      BC_NEXT();
+      BC_OP(GENERIC2PARM_RETD)
         {
           float (*f)(void *,float*,float*) = *(float (**)(void *, float *, float *)) (iptr+sizeof(void *));
           fp_push(f(*(void **)iptr,p2, p1));
           iptr += sizeof(void *)*2;
         }
-      break;
-      case EEL_BC_GENERIC3PARM_RETD:
+      BC_NEXT();
+      BC_OP(GENERIC3PARM_RETD)
         {
           float (*f)(void *,float*,float*,float*) = *(float (**)(void *, float *, float *, float *)) (iptr+sizeof(void *));
           fp_push(f(*(void **)iptr,p3, p2, p1));
           iptr += sizeof(void *)*2;
         }
-      break;
+      BC_NEXT();
+      // Superinstructions, operands are read where the fused opcodes left them
+      BC_OP(DV_ADD)
+        fp_top += **(float **)iptr;
+        iptr += sizeof(void *) + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(DV_SUB)
+        fp_top -= **(float **)iptr;
+        iptr += sizeof(void *) + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(DV_MUL)
+        fp_top *= **(float **)iptr;
+        iptr += sizeof(void *) + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(DV_DIV)
+        fp_top /= **(float **)iptr;
+        iptr += sizeof(void *) + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(DV_DV)
+        fp_push(BC_DV_OPERAND(0));
+        fp_push(BC_DV_OPERAND(1));
+        iptr += sizeof(void *) * 2 + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(DV_DV_ADD)
+        fp_push(BC_DV_OPERAND(0) + BC_DV_OPERAND(1));
+        iptr += (sizeof(void *) + sizeof(EEL_BC_TYPE)) * 2;
+      BC_NEXT();
+      BC_OP(DV_DV_SUB)
+        fp_push(BC_DV_OPERAND(0) - BC_DV_OPERAND(1));
+        iptr += (sizeof(void *) + sizeof(EEL_BC_TYPE)) * 2;
+      BC_NEXT();
+      BC_OP(DV_DV_MUL)
+        fp_push(BC_DV_OPERAND(0) * BC_DV_OPERAND(1));
+        iptr += (sizeof(void *) + sizeof(EEL_BC_TYPE)) * 2;
+      BC_NEXT();
+      BC_OP(DV_DV_DIV)
+        fp_push(BC_DV_OPERAND(0) / BC_DV_OPERAND(1));
+        iptr += (sizeof(void *) + sizeof(EEL_BC_TYPE)) * 2;
+      BC_NEXT();
+      BC_OP(ADD_MEGABUF)
+        fp_top2 += fp_top;
+        p1 = ((float*)rt) + (uint32_t)(fp_top2 + NSEEL_CLOSEFACTOR);
+        fp_rewind(2);
+        iptr += sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(ADD_MEGABUF_PUSH)
+        fp_top2 += fp_top;
+        p1 = ((float*)rt) + (uint32_t)(fp_top2 + NSEEL_CLOSEFACTOR);
+        fp_rewind(1);
+        fp_top = *p1;
+        iptr += sizeof(EEL_BC_TYPE) * 2;
+      BC_NEXT();
+      BC_OP(MEGABUF_PUSH)
+        p1 = ((float*)rt) + (uint32_t)(fp_top + NSEEL_CLOSEFACTOR);
+        fp_top = *p1;
+        iptr += sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(ASSIGN_FROMFP_DV)
+        p2 = *(void **)iptr;
+        *p2 = fp_pop();
+        p1 = p2;
+        iptr += sizeof(void *) + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(ADD_OP_DV)
+        p2 = *(void **)iptr;
+        *(p1 = p2) = *p2 + fp_pop();
+        iptr += sizeof(void *) + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(SUB_OP_DV)
+        p2 = *(void **)iptr;
+        *(p1 = p2) = *p2 - fp_pop();
+        iptr += sizeof(void *) + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(MUL_OP_DV)
+        p2 = *(void **)iptr;
+        *(p1 = p2) = *p2 * fp_pop();
+        iptr += sizeof(void *) + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(DIV_OP_DV)
+        p2 = *(void **)iptr;
+        *(p1 = p2) = *p2 / fp_pop();
+        iptr += sizeof(void *) + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(COPY_DV)
+        p1 = *(void **)iptr;
+        **(float **)(iptr + sizeof(void *) + sizeof(EEL_BC_TYPE)) = *p1;
+        iptr += sizeof(void *) * 2 + sizeof(EEL_BC_TYPE);
+      BC_NEXT();
+      BC_OP(EQUAL_JZ)
+        p1 = fabsf(fp_top - fp_top2) < NSEEL_CLOSEFACTOR ? EEL_BC_TRUE : NULL;
+        fp_rewind(2);
+        iptr += sizeof(EEL_BC_TYPE);
+        iptr += p1 ? sizeof(GLUE_JMP_TYPE) : sizeof(GLUE_JMP_TYPE)+*(GLUE_JMP_TYPE *)iptr;
+      BC_NEXT();
+      BC_OP(NOTEQUAL_JZ)
+        p1 = fabsf(fp_top - fp_top2) >= NSEEL_CLOSEFACTOR ? EEL_BC_TRUE : NULL;
+        fp_rewind(2);
+        iptr += sizeof(EEL_BC_TYPE);
+        iptr += p1 ? sizeof(GLUE_JMP_TYPE) : sizeof(GLUE_JMP_TYPE)+*(GLUE_JMP_TYPE *)iptr;
+      BC_NEXT();
+      BC_OP(ABOVE_JZ)
+        p1 = fp_top < fp_top2 ? EEL_BC_TRUE : NULL;
+        fp_rewind(2);
+        iptr += sizeof(EEL_BC_TYPE);
+        iptr += p1 ? sizeof(GLUE_JMP_TYPE) : sizeof(GLUE_JMP_TYPE)+*(GLUE_JMP_TYPE *)iptr;
+      BC_NEXT();
+      BC_OP(BELOWEQ_JZ)
+        p1 = fp_top >= fp_top2 ? EEL_BC_TRUE : NULL;
+        fp_rewind(2);
+        iptr += sizeof(EEL_BC_TYPE);
+        iptr += p1 ? sizeof(GLUE_JMP_TYPE) : sizeof(GLUE_JMP_TYPE)+*(GLUE_JMP_TYPE *)iptr;
+      BC_NEXT();
+#ifndef EEL_BC_THREADED
     }
   }
+#endif
+#undef BC_OP
+#undef BC_NEXT
 #undef fp_top
 #undef fp_top2
 #undef fp_pop
 #undef fp_push
+#undef fp_rewind
+#undef BC_DV_OPERAND
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,726 @@
+#ifndef _EEL_GLUE_X86_64_JIT_H_
+#define _EEL_GLUE_X86_64_JIT_H_
+// Translates the portable bytecode of a finished code handle to x86-64 machine code (SysV ABI, SSE scalar floats).
+// Every EEL_BC_* opcode maps to a fixed instruction sequence working on the same state the interpreter keeps:
+// p1 = r12, p2 = r13, p3 = r14, wtp = r15, fp stack top pointer = rbx, RAM = rbp, and the bytecode stack is the
+// native stack, so FCALL/RET become call/ret. Code is written to a private buffer that is made executable only
+// after it is complete. Anything the translator does not understand leaves the handle on GLUE_CALL_CODE
+#include <sys/mman.h>
+#include <unistd.h>
+enum { JIT_RAX = 0, JIT_RCX, JIT_RDX, JIT_RBX, JIT_RSP, JIT_RBP, JIT_RSI, JIT_RDI, JIT_R8, JIT_R9, JIT_R10, JIT_R11, JIT_R12, JIT_R13, JIT_R14, JIT_R15 };
+enum { JIT_CC_B = 2, JIT_CC_AE, JIT_CC_E, JIT_CC_NE, JIT_CC_BE, JIT_CC_A, JIT_CC_P = 10, JIT_CC_NP, JIT_CC_L, JIT_CC_GE, JIT_CC_LE, JIT_CC_G };
+#define JIT_P1 JIT_R12
+#define JIT_P2 JIT_R13
+#define JIT_P3 JIT_R14
+#define JIT_WTP JIT_R15
+#define JIT_FP JIT_RBX
+#define JIT_RAM JIT_RBP
+#define JIT_FPSTACK_BYTES (GLUE_MAX_FPSTACK_SIZE * sizeof(float))
+#define JIT_MAX_INSN_BYTES 128 // Upper bound of one translated opcode, including a trailing jump
+typedef struct
+{
+	unsigned char *buf;
+	int32_t pos, cap, fail;
+	struct { int32_t at; char *target; } *fixups; // rel32 at buf + at refers to bytecode target
+	int32_t numFixups, capFixups;
+} nseel_jit_emitter;
+static int32_t nseel_jit_enabled = 1;
+// Fails the translation instead of writing past the buffer, the code then stays on the interpreter
+static int32_t nseel_jit_room(nseel_jit_emitter *e, int32_t n)
+{
+	if (e->pos + n > e->cap)
+		e->fail = 1;
+	return !e->fail;
+}
+static void nseel_jit_byte(nseel_jit_emitter *e, int32_t b)
+{
+	if (nseel_jit_room(e, 1))
+		e->buf[e->pos++] = (unsigned char)b;
+}
+static void nseel_jit_int32(nseel_jit_emitter *e, int32_t v)
+{
+	if (!nseel_jit_room(e, 4))
+		return;
+	memcpy(e->buf + e->pos, &v, 4);
+	e->pos += 4;
+}
+static void nseel_jit_int64(nseel_jit_emitter *e, INT_PTR v)
+{
+	if (!nseel_jit_room(e, 8))
+		return;
+	memcpy(e->buf + e->pos, &v, 8);
+	e->pos += 8;
+}
+static void nseel_jit_bytes(nseel_jit_emitter *e, const char *b, int32_t n)
+{
+	if (!nseel_jit_room(e, n))
+		return;
+	memcpy(e->buf + e->pos, b, n);
+	e->pos += n;
+}
+// prefix, REX, one or two opcode bytes, then reg and either a register or [base + disp]
+static void nseel_jit_op(nseel_jit_emitter *e, int32_t prefix, int32_t w, int32_t opcode, int32_t reg, int32_t rm, int32_t disp, int32_t isReg)
+{
+	int32_t rex = 0x40 | (w << 3) | ((reg >> 3) << 2) | (rm >> 3);
+	if (prefix)
+		nseel_jit_byte(e, prefix);
+	if (rex != 0x40)
+		nseel_jit_byte(e, rex);
+	if (opcode > 0xff)
+		nseel_jit_byte(e, opcode >> 8);
+	nseel_jit_byte(e, opcode & 0xff);
+	if (isReg)
+	{
+		nseel_jit_byte(e, 0xC0 | ((reg & 7) << 3) | (rm & 7));
+		return;
+	}
+	int32_t mod = (!disp && (rm & 7) != JIT_RBP) ? 0 : (disp >= -128 && disp < 128) ? 1 : 2;
+	nseel_jit_byte(e, (mod << 6) | ((reg & 7) << 3) | (rm & 7));
+	if ((rm & 7) == JIT_RSP)
+		nseel_jit_byte(e, 0x24);
+	if (mod == 1)
+		nseel_jit_byte(e, disp);
+	else if (mod == 2)
+		nseel_jit_int32(e, disp);
+}
+#define JIT_MOVSS_LOAD(x, base, disp) nseel_jit_op(e, 0xF3, 0, 0x0F10, x, base, disp, 0)
+#define JIT_MOVSS_STORE(base, disp, x) nseel_jit_op(e, 0xF3, 0, 0x0F11, x, base, disp, 0)
+#define JIT_SSE_MEM(opc, x, base, disp) nseel_jit_op(e, 0xF3, 0, opc, x, base, disp, 0)
+#define JIT_SSE_RR(opc, x, y) nseel_jit_op(e, 0xF3, 0, opc, x, y, 0, 1)
+#define JIT_ADDSS 0x0F58
+#define JIT_MULSS 0x0F59
+#define JIT_SUBSS 0x0F5C
+#define JIT_DIVSS 0x0F5E
+#define JIT_UCOMISS_RR(x, y) nseel_jit_op(e, 0, 0, 0x0F2E, x, y, 0, 1)
+#define JIT_UCOMISS_MEM(x, base, disp) nseel_jit_op(e, 0, 0, 0x0F2E, x, base, disp, 0)
+#define JIT_ANDPS_RR(x, y) nseel_jit_op(e, 0, 0, 0x0F54, x, y, 0, 1)
+#define JIT_XORPS_RR(x, y) nseel_jit_op(e, 0, 0, 0x0F57, x, y, 0, 1)
+#define JIT_CVTTSS2SI_MEM(r, base, disp) nseel_jit_op(e, 0xF3, 0, 0x0F2C, r, base, disp, 0)
+#define JIT_CVTSI2SS_RR(x, r) nseel_jit_op(e, 0xF3, 0, 0x0F2A, x, r, 0, 1)
+#define JIT_MOVD_XR(x, r) nseel_jit_op(e, 0x66, 0, 0x0F6E, x, r, 0, 1)
+#define JIT_MOVD_RX(r, x) nseel_jit_op(e, 0x66, 0, 0x0F7E, x, r, 0, 1)
+#define JIT_MOV_RR(dst, src) nseel_jit_op(e, 0, 1, 0x89, src, dst, 0, 1)
+#define JIT_MOV_LOAD(r, base, disp) nseel_jit_op(e, 0, 1, 0x8B, r, base, disp, 0)
+#define JIT_MOV_STORE(base, disp, r) nseel_jit_op(e, 0, 1, 0x89, r, base, disp, 0)
+#define JIT_MOV_STORE32(base, disp, r) nseel_jit_op(e, 0, 0, 0x89, r, base, disp, 0)
+#define JIT_TEST_RR(a, b) nseel_jit_op(e, 0, 1, 0x85, b, a, 0, 1)
+#define JIT_ALU32_RR(opc, dst, src) nseel_jit_op(e, 0, 0, opc, src, dst, 0, 1) // opc 0x21 and, 0x09 or, 0x31 xor, 0x29 sub
+#define JIT_ALU_IMM8(w, ext, r, imm) { nseel_jit_op(e, 0, w, 0x83, ext, r, 0, 1); nseel_jit_byte(e, imm); } // ext 0 add, 5 sub, 7 cmp
+#define JIT_DEC32_MEM(base, disp) nseel_jit_op(e, 0, 0, 0xFF, 1, base, disp, 0)
+#define JIT_SETCC(cc, r) nseel_jit_op(e, 0, 0, 0x0F90 | (cc), 0, r, 0, 1)
+#define JIT_CMOVCC(cc, dst, src) nseel_jit_op(e, 0, 1, 0x0F40 | (cc), dst, src, 0, 1)
+static void nseel_jit_mov_imm64(nseel_jit_emitter *e, int32_t r, INT_PTR v)
+{
+	nseel_jit_byte(e, 0x48 | (r >> 3));
+	nseel_jit_byte(e, 0xB8 | (r & 7));
+	nseel_jit_int64(e, v);
+}
+static void nseel_jit_mov_imm32(nseel_jit_emitter *e, int32_t r, int32_t v)
+{
+	if (r >= 8)
+		nseel_jit_byte(e, 0x41);
+	nseel_jit_byte(e, 0xB8 | (r & 7));
+	nseel_jit_int32(e, v);
+}
+static void nseel_jit_push(nseel_jit_emitter *e, int32_t r)
+{
+	if (r >= 8)
+		nseel_jit_byte(e, 0x41);
+	nseel_jit_byte(e, 0x50 | (r & 7));
+}
+static void nseel_jit_pop(nseel_jit_emitter *e, int32_t r)
+{
+	if (r >= 8)
+		nseel_jit_byte(e, 0x41);
+	nseel_jit_byte(e, 0x58 | (r & 7));
+}
+static void nseel_jit_add_rsp(nseel_jit_emitter *e, int32_t amt)
+{
+	nseel_jit_bytes(e, "\x48\x81\xC4", 3);
+	nseel_jit_int32(e, amt);
+}
+// Float constant into an xmm register through eax
+static void nseel_jit_const(nseel_jit_emitter *e, int32_t x, float v)
+{
+	int32_t bits;
+	memcpy(&bits, &v, 4);
+	nseel_jit_mov_imm32(e, JIT_RAX, bits);
+	JIT_MOVD_XR(x, JIT_RAX);
+}
+static void nseel_jit_const_bits(nseel_jit_emitter *e, int32_t x, int32_t bits)
+{
+	nseel_jit_mov_imm32(e, JIT_RAX, bits);
+	JIT_MOVD_XR(x, JIT_RAX);
+}
+// rel32 jumps and calls to bytecode addresses are patched once every opcode has its native offset
+static void nseel_jit_branch(nseel_jit_emitter *e, int32_t cc, char *target)
+{
+	if (cc < 0)
+		nseel_jit_byte(e, 0xE9);
+	else if (cc == 0x100)
+		nseel_jit_byte(e, 0xE8);
+	else
+	{
+		nseel_jit_byte(e, 0x0F);
+		nseel_jit_byte(e, 0x80 | cc);
+	}
+	if (e->numFixups == e->capFixups)
+	{
+		e->capFixups = e->capFixups ? e->capFixups * 2 : 256;
+		void *p = realloc(e->fixups, e->capFixups * sizeof(*e->fixups));
+		if (!p)
+		{
+			e->fail = 1;
+			e->numFixups = 0;
+		}
+		else
+			e->fixups = p;
+	}
+	if (e->fail)
+	{
+		nseel_jit_int32(e, 0);
+		return;
+	}
+	e->fixups[e->numFixups].at = e->pos;
+	e->fixups[e->numFixups++].target = target;
+	nseel_jit_int32(e, 0);
+}
+#define JIT_JMP(target) nseel_jit_branch(e, -1, target)
+#define JIT_JCC(cc, target) nseel_jit_branch(e, cc, target)
+#define JIT_CALL(target) nseel_jit_branch(e, 0x100, target)
+// Short forward jump inside one opcode, returns the byte to patch with nseel_jit_here
+static int32_t nseel_jit_jcc8(nseel_jit_emitter *e, int32_t cc)
+{
+	nseel_jit_byte(e, cc < 0 ? 0xEB : 0x70 | cc);
+	nseel_jit_byte(e, 0);
+	return e->pos - 1;
+}
+static void nseel_jit_here(nseel_jit_emitter *e, int32_t at)
+{
+	e->buf[at] = (unsigned char)(e->pos - at - 1);
+}
+// C call with the stack realigned to 16 bytes, arguments already in place
+static void nseel_jit_ccall(nseel_jit_emitter *e, const void *fn)
+{
+	nseel_jit_bytes(e, "\x48\x89\xE0\x48\x83\xE4\xF0\x50\x50", 9); // mov rax, rsp; and rsp, -16; push rax; push rax
+	nseel_jit_bytes(e, "\x49\xBB", 2); // mov r11, fn
+	nseel_jit_int64(e, (INT_PTR)fn);
+	nseel_jit_bytes(e, "\x41\xFF\xD3\x48\x8B\x24\x24", 7); // call r11; mov rsp, [rsp]
+}
+#define JIT_FP_PUSH(x) { JIT_ALU_IMM8(1, 0, JIT_FP, 4) JIT_MOVSS_STORE(JIT_FP, 0, x); }
+#define JIT_FP_POP(x) { JIT_MOVSS_LOAD(x, JIT_FP, 0); JIT_ALU_IMM8(1, 5, JIT_FP, 4) }
+#define JIT_FP_REWIND(n) JIT_ALU_IMM8(1, 5, JIT_FP, 4 * (n))
+static INT_PTR nseel_jit_ptr(const char *p)
+{
+	INT_PTR v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+static int32_t nseel_jit_i32(const char *p)
+{
+	int32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+// Comparisons of fp_top with fp_top2, both popped, result in p1
+static void nseel_jit_compare(nseel_jit_emitter *e, int32_t op)
+{
+	JIT_MOVSS_LOAD(0, JIT_FP, 0);
+	JIT_MOVSS_LOAD(1, JIT_FP, -4);
+	JIT_ALU32_RR(0x31, JIT_RCX, JIT_RCX);
+	switch (op)
+	{
+	case EEL_BC_EQUAL: // fabsf(top - top2) < NSEEL_CLOSEFACTOR
+	case EEL_BC_NOTEQUAL:
+		JIT_SSE_RR(JIT_SUBSS, 0, 1);
+		nseel_jit_const_bits(e, 2, 0x7fffffff);
+		JIT_ANDPS_RR(0, 2);
+		nseel_jit_const(e, 1, NSEEL_CLOSEFACTOR);
+		if (op == EEL_BC_EQUAL)
+		{
+			JIT_UCOMISS_RR(1, 0);
+			JIT_SETCC(JIT_CC_A, JIT_RCX);
+		}
+		else
+		{
+			JIT_UCOMISS_RR(0, 1);
+			JIT_SETCC(JIT_CC_AE, JIT_RCX);
+		}
+		break;
+	case EEL_BC_EQUAL_EXACT:
+	case EEL_BC_NOTEQUAL_EXACT:
+		JIT_ALU32_RR(0x31, JIT_RDX, JIT_RDX);
+		JIT_UCOMISS_RR(0, 1);
+		JIT_SETCC(op == EEL_BC_EQUAL_EXACT ? JIT_CC_E : JIT_CC_NE, JIT_RCX);
+		JIT_SETCC(op == EEL_BC_EQUAL_EXACT ? JIT_CC_NP : JIT_CC_P, JIT_RDX);
+		JIT_ALU32_RR(op == EEL_BC_EQUAL_EXACT ? 0x21 : 0x09, JIT_RCX, JIT_RDX);
+		break;
+	case EEL_BC_ABOVE: // top < top2
+		JIT_UCOMISS_RR(1, 0);
+		JIT_SETCC(JIT_CC_A, JIT_RCX);
+		break;
+	case EEL_BC_BELOWEQ: // top >= top2
+		JIT_UCOMISS_RR(0, 1);
+		JIT_SETCC(JIT_CC_AE, JIT_RCX);
+		break;
+	}
+	JIT_MOV_RR(JIT_P1, JIT_RCX);
+	JIT_FP_REWIND(2);
+}
+// Integer binary ops on (int32_t) of two floats, a from [abase + adisp], b from [bbase + bdisp], result in xmm0
+static void nseel_jit_intop(nseel_jit_emitter *e, int32_t op, int32_t abase, int32_t adisp, int32_t bbase, int32_t bdisp)
+{
+	JIT_CVTTSS2SI_MEM(JIT_RAX, abase, adisp);
+	JIT_CVTTSS2SI_MEM(JIT_RCX, bbase, bdisp);
+	switch (op)
+	{
+	case EEL_BC_AND: case EEL_BC_AND_OP: JIT_ALU32_RR(0x21, JIT_RAX, JIT_RCX); break;
+	case EEL_BC_OR: case EEL_BC_OR_OP: JIT_ALU32_RR(0x09, JIT_RAX, JIT_RCX); break;
+	case EEL_BC_XOR: case EEL_BC_XOR_OP: JIT_ALU32_RR(0x31, JIT_RAX, JIT_RCX); break;
+	case EEL_BC_SHR: nseel_jit_bytes(e, "\xD3\xF8", 2); break; // sar eax, cl
+	case EEL_BC_SHL: nseel_jit_bytes(e, "\xD3\xE0", 2); break; // shl eax, cl
+	}
+	JIT_CVTSI2SS_RR(0, JIT_RAX);
+}
+// (float)(a % b) or 0 when (int32_t)b is 0, a from [abase + adisp], b already in ecx, result in xmm0
+static void nseel_jit_mod(nseel_jit_emitter *e, int32_t abase, int32_t adisp)
+{
+	JIT_TEST_RR(JIT_RCX, JIT_RCX);
+	int32_t zero = nseel_jit_jcc8(e, JIT_CC_E);
+	JIT_CVTTSS2SI_MEM(JIT_RAX, abase, adisp);
+	nseel_jit_bytes(e, "\x99\xF7\xF9", 3); // cdq; idiv ecx
+	JIT_CVTSI2SS_RR(0, JIT_RDX);
+	int32_t done = nseel_jit_jcc8(e, -1);
+	nseel_jit_here(e, zero);
+	JIT_XORPS_RR(0, 0);
+	nseel_jit_here(e, done);
+}
+static void nseel_jit_emit(nseel_jit_emitter *e, char *ip, int32_t op)
+{
+	char *arg = ip + sizeof(EEL_BC_TYPE);
+	char *target = nseel_bc_branch_target(ip);
+	int32_t skip;
+	switch (op)
+	{
+	case EEL_BC_NOP: break;
+	case EEL_BC_RET: nseel_jit_byte(e, 0xC3); break;
+	case EEL_BC_FXCH:
+		JIT_MOVSS_LOAD(0, JIT_FP, 0);
+		JIT_MOVSS_LOAD(1, JIT_FP, -4);
+		JIT_MOVSS_STORE(JIT_FP, 0, 1);
+		JIT_MOVSS_STORE(JIT_FP, -4, 0);
+		break;
+	case EEL_BC_POP_FPSTACK: JIT_FP_REWIND(1); break;
+	case EEL_BC_JMP_NC: JIT_JMP(target); break;
+	case EEL_BC_JMP_IF_P1_Z:
+	case EEL_BC_JMP_IF_P1_NZ:
+		JIT_TEST_RR(JIT_P1, JIT_P1);
+		JIT_JCC(op == EEL_BC_JMP_IF_P1_Z ? JIT_CC_E : JIT_CC_NE, target);
+		break;
+	case EEL_BC_MOV_FPTOP_DV:
+		nseel_jit_mov_imm64(e, JIT_RAX, nseel_jit_ptr(arg));
+		JIT_MOVSS_LOAD(0, JIT_RAX, 0);
+		JIT_FP_PUSH(0);
+		break;
+	case EEL_BC_MOV_P1_DV: nseel_jit_mov_imm64(e, JIT_P1, nseel_jit_ptr(arg)); break;
+	case EEL_BC_MOV_P2_DV: nseel_jit_mov_imm64(e, JIT_P2, nseel_jit_ptr(arg)); break;
+	case EEL_BC_MOV_P3_DV: nseel_jit_mov_imm64(e, JIT_P3, nseel_jit_ptr(arg)); break;
+	case EEL_BC__RESET_WTP: nseel_jit_mov_imm64(e, JIT_WTP, nseel_jit_ptr(arg)); break;
+	case EEL_BC_PUSH_P1: nseel_jit_push(e, JIT_P1); break;
+	case EEL_BC_PUSH_P1PTR_AS_VALUE:
+		JIT_MOVSS_LOAD(0, JIT_P1, 0);
+		JIT_ALU_IMM8(1, 5, JIT_RSP, 8)
+		JIT_MOVSS_STORE(JIT_RSP, 0, 0);
+		break;
+	case EEL_BC_POP_P1: nseel_jit_pop(e, JIT_P1); break;
+	case EEL_BC_POP_P2: nseel_jit_pop(e, JIT_P2); break;
+	case EEL_BC_POP_P3: nseel_jit_pop(e, JIT_P3); break;
+	case EEL_BC_POP_VALUE_TO_ADDR:
+		JIT_MOVSS_LOAD(0, JIT_RSP, 0);
+		JIT_ALU_IMM8(1, 0, JIT_RSP, 8)
+		nseel_jit_mov_imm64(e, JIT_RAX, nseel_jit_ptr(arg));
+		JIT_MOVSS_STORE(JIT_RAX, 0, 0);
+		break;
+	case EEL_BC_MOVE_STACK: nseel_jit_add_rsp(e, nseel_jit_i32(arg)); break;
+	case EEL_BC_STORE_P1_TO_STACK_AT_OFFS: JIT_MOV_STORE(JIT_RSP, nseel_jit_i32(arg), JIT_P1); break;
+	case EEL_BC_MOVE_STACKPTR_TO_P1: JIT_MOV_RR(JIT_P1, JIT_RSP); break;
+	case EEL_BC_MOVE_STACKPTR_TO_P2: JIT_MOV_RR(JIT_P2, JIT_RSP); break;
+	case EEL_BC_MOVE_STACKPTR_TO_P3: JIT_MOV_RR(JIT_P3, JIT_RSP); break;
+	case EEL_BC_SET_P2_FROM_P1: JIT_MOV_RR(JIT_P2, JIT_P1); break;
+	case EEL_BC_SET_P3_FROM_P1: JIT_MOV_RR(JIT_P3, JIT_P1); break;
+	case EEL_BC_COPY_VALUE_AT_P1_TO_ADDR:
+		JIT_MOVSS_LOAD(0, JIT_P1, 0);
+		nseel_jit_mov_imm64(e, JIT_RAX, nseel_jit_ptr(arg));
+		JIT_MOVSS_STORE(JIT_RAX, 0, 0);
+		break;
+	case EEL_BC_SET_P1_FROM_WTP: JIT_MOV_RR(JIT_P1, JIT_WTP); break;
+	case EEL_BC_SET_P2_FROM_WTP: JIT_MOV_RR(JIT_P2, JIT_WTP); break;
+	case EEL_BC_SET_P3_FROM_WTP: JIT_MOV_RR(JIT_P3, JIT_WTP); break;
+	case EEL_BC_POP_FPSTACK_TO_PTR:
+		JIT_FP_POP(0);
+		nseel_jit_mov_imm64(e, JIT_RAX, nseel_jit_ptr(arg));
+		JIT_MOVSS_STORE(JIT_RAX, 0, 0);
+		break;
+	case EEL_BC_POP_FPSTACK_TOSTACK:
+		JIT_FP_POP(0);
+		JIT_ALU_IMM8(1, 5, JIT_RSP, 8)
+		JIT_MOVSS_STORE(JIT_RSP, 0, 0);
+		break;
+	case EEL_BC_PUSH_VAL_AT_P1_TO_FPSTACK: JIT_MOVSS_LOAD(0, JIT_P1, 0); JIT_FP_PUSH(0); break;
+	case EEL_BC_PUSH_VAL_AT_P2_TO_FPSTACK: JIT_MOVSS_LOAD(0, JIT_P2, 0); JIT_FP_PUSH(0); break;
+	case EEL_BC_PUSH_VAL_AT_P3_TO_FPSTACK: JIT_MOVSS_LOAD(0, JIT_P3, 0); JIT_FP_PUSH(0); break;
+	case EEL_BC_POP_FPSTACK_TO_WTP:
+		JIT_FP_POP(0);
+		JIT_MOVSS_STORE(JIT_WTP, 0, 0);
+		JIT_ALU_IMM8(1, 0, JIT_WTP, 4)
+		break;
+	case EEL_BC_SET_P1_Z: JIT_ALU32_RR(0x31, JIT_P1, JIT_P1); break;
+	case EEL_BC_SET_P1_NZ: nseel_jit_mov_imm32(e, JIT_P1, 1); break;
+	case EEL_BC_LOOP_LOADCNT:
+		JIT_FP_POP(0);
+		nseel_jit_bytes(e, "\xF3\x0F\x2C\xC0", 4); // cvttss2si eax, xmm0
+		JIT_ALU_IMM8(1, 5, JIT_RSP, 8)
+		JIT_MOV_STORE32(JIT_RSP, 0, JIT_RAX);
+		JIT_ALU_IMM8(0, 7, JIT_RAX, 1)
+		skip = nseel_jit_jcc8(e, JIT_CC_GE);
+		JIT_ALU_IMM8(1, 0, JIT_RSP, 8)
+		JIT_JMP(target);
+		nseel_jit_here(e, skip);
+		nseel_jit_push(e, JIT_WTP);
+		break;
+	case EEL_BC_LOOP_END:
+		JIT_MOV_LOAD(JIT_WTP, JIT_RSP, 0);
+		JIT_DEC32_MEM(JIT_RSP, 8);
+		JIT_JCC(JIT_CC_G, target);
+		JIT_ALU_IMM8(1, 0, JIT_RSP, 16)
+		break;
+	case EEL_BC_WHILE_SETUP:
+		nseel_jit_byte(e, 0x68); // push imm32
+		nseel_jit_int32(e, NSEEL_NATIVE_FLT_MAX_INT);
+		break;
+	case EEL_BC_WHILE_BEGIN: nseel_jit_push(e, JIT_WTP); break;
+	case EEL_BC_WHILE_END:
+		nseel_jit_pop(e, JIT_WTP);
+		JIT_DEC32_MEM(JIT_RSP, 0);
+		skip = nseel_jit_jcc8(e, JIT_CC_G);
+		JIT_ALU_IMM8(1, 0, JIT_RSP, 8)
+		JIT_JMP(target);
+		nseel_jit_here(e, skip);
+		break;
+	case EEL_BC_WHILE_CHECK_RV:
+		JIT_TEST_RR(JIT_P1, JIT_P1);
+		JIT_JCC(JIT_CC_NE, target);
+		JIT_ALU_IMM8(1, 0, JIT_RSP, 8)
+		break;
+	case EEL_BC_BNOT:
+	case EEL_BC_BNOTNOT:
+		JIT_ALU32_RR(0x31, JIT_RCX, JIT_RCX);
+		JIT_TEST_RR(JIT_P1, JIT_P1);
+		JIT_SETCC(op == EEL_BC_BNOT ? JIT_CC_E : JIT_CC_NE, JIT_RCX);
+		JIT_MOV_RR(JIT_P1, JIT_RCX);
+		break;
+	case EEL_BC_EQUAL: case EEL_BC_EQUAL_EXACT: case EEL_BC_NOTEQUAL: case EEL_BC_NOTEQUAL_EXACT: case EEL_BC_ABOVE: case EEL_BC_BELOWEQ:
+		nseel_jit_compare(e, op);
+		break;
+	case EEL_BC_ADD: case EEL_BC_SUB: case EEL_BC_MUL: case EEL_BC_DIV:
+		JIT_MOVSS_LOAD(0, JIT_FP, -4);
+		JIT_SSE_MEM(op == EEL_BC_ADD ? JIT_ADDSS : op == EEL_BC_SUB ? JIT_SUBSS : op == EEL_BC_MUL ? JIT_MULSS : JIT_DIVSS, 0, JIT_FP, 0);
+		JIT_MOVSS_STORE(JIT_FP, -4, 0);
+		JIT_FP_REWIND(1);
+		break;
+	case EEL_BC_AND: case EEL_BC_OR: case EEL_BC_XOR:
+		nseel_jit_intop(e, op, JIT_FP, 0, JIT_FP, -4);
+		JIT_MOVSS_STORE(JIT_FP, -4, 0);
+		JIT_FP_REWIND(1);
+		break;
+	case EEL_BC_SHR: case EEL_BC_SHL: // top2 shifted by top
+		nseel_jit_intop(e, op, JIT_FP, -4, JIT_FP, 0);
+		JIT_MOVSS_STORE(JIT_FP, -4, 0);
+		JIT_FP_REWIND(1);
+		break;
+	case EEL_BC_OR0:
+		JIT_CVTTSS2SI_MEM(JIT_RAX, JIT_FP, 0);
+		JIT_CVTSI2SS_RR(0, JIT_RAX);
+		JIT_MOVSS_STORE(JIT_FP, 0, 0);
+		break;
+	case EEL_BC_ADD_OP: case EEL_BC_SUB_OP: case EEL_BC_MUL_OP: case EEL_BC_DIV_OP:
+	case EEL_BC_ADD_OP_FAST: case EEL_BC_SUB_OP_FAST: case EEL_BC_MUL_OP_FAST: case EEL_BC_DIV_OP_FAST:
+		JIT_MOV_RR(JIT_P1, JIT_P2);
+		JIT_MOVSS_LOAD(0, JIT_P2, 0);
+		JIT_SSE_MEM((op == EEL_BC_ADD_OP || op == EEL_BC_ADD_OP_FAST) ? JIT_ADDSS : (op == EEL_BC_SUB_OP || op == EEL_BC_SUB_OP_FAST) ? JIT_SUBSS :
+			(op == EEL_BC_MUL_OP || op == EEL_BC_MUL_OP_FAST) ? JIT_MULSS : JIT_DIVSS, 0, JIT_FP, 0);
+		JIT_FP_REWIND(1);
+		JIT_MOVSS_STORE(JIT_P2, 0, 0);
+		break;
+	case EEL_BC_AND_OP: case EEL_BC_OR_OP: case EEL_BC_XOR_OP:
+		JIT_MOV_RR(JIT_P1, JIT_P2);
+		nseel_jit_intop(e, op, JIT_P2, 0, JIT_FP, 0);
+		JIT_FP_REWIND(1);
+		JIT_MOVSS_STORE(JIT_P2, 0, 0);
+		break;
+	case EEL_BC_UMINUS:
+	case EEL_BC_ABS:
+		nseel_jit_const_bits(e, 1, op == EEL_BC_UMINUS ? (int32_t)0x80000000 : 0x7fffffff);
+		JIT_MOVSS_LOAD(0, JIT_FP, 0);
+		if (op == EEL_BC_UMINUS)
+			JIT_XORPS_RR(0, 1);
+		else
+			JIT_ANDPS_RR(0, 1);
+		JIT_MOVSS_STORE(JIT_FP, 0, 0);
+		break;
+	case EEL_BC_ASSIGN:
+	case EEL_BC_ASSIGN_FAST:
+		JIT_MOVSS_LOAD(0, JIT_P1, 0);
+		JIT_MOVSS_STORE(JIT_P2, 0, 0);
+		JIT_MOV_RR(JIT_P1, JIT_P2);
+		break;
+	case EEL_BC_ASSIGN_FAST_FROMFP:
+	case EEL_BC_ASSIGN_FROMFP:
+		JIT_FP_POP(0);
+		JIT_MOVSS_STORE(JIT_P2, 0, 0);
+		JIT_MOV_RR(JIT_P1, JIT_P2);
+		break;
+	case EEL_BC_MOD:
+		JIT_CVTTSS2SI_MEM(JIT_RCX, JIT_FP, 0);
+		JIT_FP_REWIND(1);
+		nseel_jit_mod(e, JIT_FP, 0);
+		JIT_MOVSS_STORE(JIT_FP, 0, 0);
+		break;
+	case EEL_BC_MOD_OP:
+		JIT_CVTTSS2SI_MEM(JIT_RCX, JIT_FP, 0);
+		JIT_FP_REWIND(1);
+		nseel_jit_mod(e, JIT_P2, 0);
+		JIT_MOVSS_STORE(JIT_P2, 0, 0);
+		JIT_MOV_RR(JIT_P1, JIT_P2);
+		break;
+	case EEL_BC_SQR:
+		JIT_MOVSS_LOAD(0, JIT_FP, 0);
+		JIT_SSE_RR(JIT_MULSS, 0, 0);
+		JIT_MOVSS_STORE(JIT_FP, 0, 0);
+		break;
+	case EEL_BC_MIN: // if (*p1 > *p2) p1 = p2
+		JIT_MOVSS_LOAD(0, JIT_P1, 0);
+		JIT_UCOMISS_MEM(0, JIT_P2, 0);
+		JIT_CMOVCC(JIT_CC_A, JIT_P1, JIT_P2);
+		break;
+	case EEL_BC_MAX: // if (*p1 < *p2) p1 = p2
+		JIT_MOVSS_LOAD(0, JIT_P2, 0);
+		JIT_UCOMISS_MEM(0, JIT_P1, 0);
+		JIT_CMOVCC(JIT_CC_A, JIT_P1, JIT_P2);
+		break;
+	case EEL_BC_MIN_FP: // a = pop, if (a < top) top = a
+	case EEL_BC_MAX_FP: // a = pop, if (a > top) top = a
+		JIT_FP_POP(0);
+		JIT_MOVSS_LOAD(1, JIT_FP, 0);
+		if (op == EEL_BC_MIN_FP)
+			JIT_UCOMISS_RR(1, 0);
+		else
+			JIT_UCOMISS_RR(0, 1);
+		skip = nseel_jit_jcc8(e, JIT_CC_BE);
+		JIT_MOVSS_STORE(JIT_FP, 0, 0);
+		nseel_jit_here(e, skip);
+		break;
+	case EEL_BC_SIGN:
+		{
+			JIT_MOVSS_LOAD(0, JIT_FP, 0);
+			JIT_XORPS_RR(1, 1);
+			JIT_UCOMISS_RR(1, 0);
+			int32_t negative = nseel_jit_jcc8(e, JIT_CC_A);
+			JIT_UCOMISS_RR(0, 1);
+			int32_t notPositive = nseel_jit_jcc8(e, JIT_CC_BE);
+			nseel_jit_mov_imm32(e, JIT_RAX, 0x3f800000);
+			int32_t store = nseel_jit_jcc8(e, -1);
+			nseel_jit_here(e, negative);
+			nseel_jit_mov_imm32(e, JIT_RAX, (int32_t)0xbf800000);
+			nseel_jit_here(e, store);
+			JIT_MOV_STORE32(JIT_FP, 0, JIT_RAX);
+			nseel_jit_here(e, notPositive);
+		}
+		break;
+	case EEL_BC_INVSQRT:
+		JIT_MOVSS_LOAD(0, JIT_FP, 0);
+		JIT_MOVD_RX(JIT_RCX, 0);
+		nseel_jit_bytes(e, "\xD1\xF9", 2); // sar ecx, 1
+		nseel_jit_mov_imm32(e, JIT_RDX, 0x5f3759df);
+		JIT_ALU32_RR(0x29, JIT_RDX, JIT_RCX);
+		JIT_MOVD_XR(1, JIT_RDX); // y
+		nseel_jit_const(e, 2, 0.5f);
+		JIT_SSE_RR(JIT_MULSS, 0, 2);
+		JIT_SSE_RR(JIT_MULSS, 0, 1);
+		JIT_SSE_RR(JIT_MULSS, 0, 1);
+		nseel_jit_const(e, 2, 1.5f);
+		JIT_SSE_RR(JIT_SUBSS, 2, 0);
+		JIT_SSE_RR(JIT_MULSS, 1, 2);
+		JIT_MOVSS_STORE(JIT_FP, 0, 1);
+		break;
+	case EEL_BC_FCALL: JIT_CALL((char*)nseel_jit_ptr(arg)); break;
+	case EEL_BC_BOOLTOFP:
+		JIT_ALU32_RR(0x31, JIT_RAX, JIT_RAX);
+		JIT_TEST_RR(JIT_P1, JIT_P1);
+		JIT_SETCC(JIT_CC_NE, JIT_RAX);
+		JIT_CVTSI2SS_RR(0, JIT_RAX);
+		JIT_FP_PUSH(0);
+		break;
+	case EEL_BC_FPTOBOOL: // fabsf(pop) >= NSEEL_CLOSEFACTOR
+	case EEL_BC_FPTOBOOL_REV:
+		JIT_FP_POP(0);
+		nseel_jit_const_bits(e, 2, 0x7fffffff);
+		JIT_ANDPS_RR(0, 2);
+		nseel_jit_const(e, 1, NSEEL_CLOSEFACTOR);
+		JIT_ALU32_RR(0x31, JIT_RCX, JIT_RCX);
+		if (op == EEL_BC_FPTOBOOL)
+		{
+			JIT_UCOMISS_RR(0, 1);
+			JIT_SETCC(JIT_CC_AE, JIT_RCX);
+		}
+		else
+		{
+			JIT_UCOMISS_RR(1, 0);
+			JIT_SETCC(JIT_CC_A, JIT_RCX);
+		}
+		JIT_MOV_RR(JIT_P1, JIT_RCX);
+		break;
+	case EEL_BC_CFUNC_1PDD:
+		JIT_MOVSS_LOAD(0, JIT_FP, 0);
+		nseel_jit_ccall(e, (void*)nseel_jit_ptr(arg));
+		JIT_MOVSS_STORE(JIT_FP, 0, 0);
+		break;
+	case EEL_BC_CFUNC_2PDD:
+		JIT_MOVSS_LOAD(0, JIT_FP, -4);
+		JIT_MOVSS_LOAD(1, JIT_FP, 0);
+		JIT_FP_REWIND(1);
+		nseel_jit_ccall(e, (void*)nseel_jit_ptr(arg));
+		JIT_MOVSS_STORE(JIT_FP, 0, 0);
+		break;
+	case EEL_BC_CFUNC_2PDDS:
+		JIT_MOVSS_LOAD(0, JIT_P2, 0);
+		JIT_FP_POP(1);
+		nseel_jit_ccall(e, (void*)nseel_jit_ptr(arg));
+		JIT_MOVSS_STORE(JIT_P2, 0, 0);
+		JIT_MOV_RR(JIT_P1, JIT_P2);
+		break;
+	case EEL_BC_MEGABUF: // p1 = rt + (uint32_t)(pop + NSEEL_CLOSEFACTOR)
+		JIT_FP_POP(0);
+		nseel_jit_const(e, 1, NSEEL_CLOSEFACTOR);
+		JIT_SSE_RR(JIT_ADDSS, 0, 1);
+		nseel_jit_bytes(e, "\xF3\x48\x0F\x2C\xC0\x89\xC0", 7); // cvttss2si rax, xmm0; mov eax, eax
+		nseel_jit_bytes(e, "\x4C\x8D\x64\x85\x00", 5); // lea r12, [rbp + rax * 4]
+		break;
+	case EEL_BC_GENERIC1PARM: case EEL_BC_GENERIC2PARM: case EEL_BC_GENERIC3PARM:
+	case EEL_BC_GENERIC1PARM_RETD: case EEL_BC_GENERIC2PARM_RETD: case EEL_BC_GENERIC3PARM_RETD:
+		{
+			// f(opaque, p1), f(opaque, p2, p1) or f(opaque, p3, p2, p1)
+			const int32_t parms = (op == EEL_BC_GENERIC1PARM || op == EEL_BC_GENERIC1PARM_RETD) ? 1 : (op == EEL_BC_GENERIC2PARM || op == EEL_BC_GENERIC2PARM_RETD) ? 2 : 3;
+			static const int32_t argRegs[3] = { JIT_RSI, JIT_RDX, JIT_RCX };
+			static const int32_t fromRegs[3] = { JIT_P3, JIT_P2, JIT_P1 };
+			nseel_jit_mov_imm64(e, JIT_RDI, nseel_jit_ptr(arg));
+			for (int32_t i = 0; i < parms; i++)
+				JIT_MOV_RR(argRegs[i], fromRegs[3 - parms + i]);
+			nseel_jit_ccall(e, (void*)nseel_jit_ptr(arg + sizeof(void*)));
+			if (op >= EEL_BC_GENERIC1PARM_RETD)
+				JIT_FP_PUSH(0)
+			else
+				JIT_MOV_RR(JIT_P1, JIT_RAX);
+		}
+		break;
+	default:
+		e->fail = 1;
+		break;
+	}
+}
+static int32_t nseel_jit_find(char **insns, int32_t count, char *addr)
+{
+	int32_t lo = 0, hi = count - 1;
+	while (lo <= hi)
+	{
+		int32_t mid = (lo + hi) >> 1;
+		if (insns[mid] == addr)
+			return mid;
+		if (insns[mid] < addr)
+			lo = mid + 1;
+		else
+			hi = mid - 1;
+	}
+	return -1;
+}
+static void nseel_jit_free(codeHandleType *h)
+{
+	if (h->nativeCode)
+		munmap(h->nativeCode, h->nativeSize);
+	h->nativeCode = 0;
+}
+// Leaves h->nativeCode null if the code can't be translated
+static void nseel_jit_compile(codeHandleType *h)
+{
+	int32_t count = 0;
+	char **insns = nseel_bc_discover((char*)h->code, &count);
+	if (!insns)
+		return;
+	int32_t *native = (int32_t*)malloc((count + 1) * sizeof(int32_t));
+	nseel_jit_emitter em = { 0 }, *e = &em;
+	e->cap = (count + 2) * JIT_MAX_INSN_BYTES;
+	e->buf = (unsigned char*)malloc(e->cap);
+	if (!native || !e->buf)
+		e->fail = 1;
+	if (!e->fail)
+	{
+		// void entry(float *wtp, float *ram): save callee saved registers, room for the fp stack, call the code
+		nseel_jit_bytes(e, "\x53\x55\x41\x54\x41\x55\x41\x56\x41\x57", 10);
+		nseel_jit_add_rsp(e, -(int32_t)(JIT_FPSTACK_BYTES + 8));
+		JIT_MOV_RR(JIT_WTP, JIT_RDI);
+		JIT_MOV_RR(JIT_RAM, JIT_RSI);
+		nseel_jit_bytes(e, "\x48\x8D\x5C\x24\xFC", 5); // lea rbx, [rsp - 4]
+		JIT_ALU32_RR(0x31, JIT_P1, JIT_P1);
+		JIT_ALU32_RR(0x31, JIT_P2, JIT_P2);
+		JIT_ALU32_RR(0x31, JIT_P3, JIT_P3);
+		JIT_CALL((char*)h->code);
+		nseel_jit_add_rsp(e, (int32_t)(JIT_FPSTACK_BYTES + 8));
+		nseel_jit_bytes(e, "\x41\x5F\x41\x5E\x41\x5D\x41\x5C\x5D\x5B\xC3", 11);
+	}
+	for (int32_t i = 0; i < count && !e->fail; i++)
+	{
+		char *ip = insns[i];
+		// Superinstructions are translated as the opcode they replaced, the rest of their sequence follows in place
+		const int32_t op = nseel_bc_base_op(*(EEL_BC_TYPE*)ip), size = nseel_bc_insn_size(op);
+		if (!nseel_jit_room(e, JIT_MAX_INSN_BYTES))
+			break;
+		native[i] = e->pos;
+		nseel_jit_emit(e, ip, op);
+		// Fall through to an opcode that isn't next in address order
+		if (op != EEL_BC_RET && op != EEL_BC_JMP_NC && (i + 1 == count || insns[i + 1] != ip + size))
+			JIT_JMP(ip + size);
+	}
+	for (int32_t i = 0; i < e->numFixups && !e->fail; i++)
+	{
+		int32_t idx = nseel_jit_find(insns, count, e->fixups[i].target);
+		if (idx < 0)
+			e->fail = 1;
+		else
+		{
+			int32_t rel = native[idx] - (e->fixups[i].at + 4);
+			memcpy(e->buf + e->fixups[i].at, &rel, 4);
+		}
+	}
+	if (!e->fail)
+	{
+		size_t page = (size_t)sysconf(_SC_PAGESIZE);
+		size_t size = ((size_t)e->pos + page - 1) & ~(page - 1);
+		void *mem = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mem != MAP_FAILED)
+		{
+			memcpy(mem, e->buf, e->pos);
+			if (!mprotect(mem, size, PROT_READ | PROT_EXEC))
+			{
+				h->nativeCode = mem;
+				h->nativeSize = size;
+			}
+			else
+				munmap(mem, size);
+		}
+	}
+	free(e->buf);
+	free(e->fixups);
+	free(native);
+	free(insns);
+}
+#endif
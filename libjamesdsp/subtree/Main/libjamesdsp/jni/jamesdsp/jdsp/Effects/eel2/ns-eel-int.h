@@ -111,6 +111,8 @@ typedef struct {
   int32_t code_stats[4];
   void *ramPtr;
   int32_t workTable_size; // size (minus padding/extra space) of workTable -- only used if EEL_VALIDATE_WORKTABLE_USE set, but might be handy to have around too
+  void *nativeCode; // machine code translated from code, null when the bytecode interpreter runs it
+  size_t nativeSize;
 } codeHandleType;
 #include "s_str.h"
 typedef struct
@@ -100,6 +100,7 @@ char *NSEEL_code_getcodeerror(NSEEL_VMCTX ctx);
 int32_t NSEEL_code_geterror_flag(NSEEL_VMCTX ctx);
 void NSEEL_code_execute(NSEEL_CODEHANDLE code);
 void NSEEL_code_free(NSEEL_CODEHANDLE code);
+void NSEEL_set_native_code(int32_t enable); // Translate newly compiled code to machine code where supported, on by default
 int32_t *NSEEL_code_getstats(NSEEL_CODEHANDLE code); // 4 ints...source bytes, static code bytes, call code bytes, data bytes
 // configuration:
 #define NSEEL_MAX_VARIABLE_NAMELEN 128  // define this to override the max variable length
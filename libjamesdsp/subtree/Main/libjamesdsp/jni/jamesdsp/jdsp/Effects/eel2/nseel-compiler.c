@@ -26,6 +26,10 @@
 #include <float.h>
 #include "eelCommon.h"
 #include "glue_port.h"
+#if defined(__x86_64__) && defined(__linux__)
+#define EEL_NATIVE_X86_64
+#include "glue_x86_64_jit.h"
+#endif
 static void lstrcpyn_safe(char *o, const char *in, int32_t count)
 {
 	if (count > 0)
@@ -2915,6 +2919,8 @@ static float NSEEL_CGEN_CALL _eel_iirBandSplitterProcess(void *opaque, INT_PTR n
 }
 #include "eel_matrix.h"
 #include "numericSys/FFTConvolver.h"
+// Convolver type of Conv1DMatrixInit, the others are named after their IR count
+#define CONV1D_MATRIX 8
 static float NSEEL_CGEN_CALL _eel_initfftconv1d(void *opaque, INT_PTR num_param, float **parms)
 {
 	compileContext *c = (compileContext*)opaque;
@@ -3003,6 +3009,65 @@ static float NSEEL_CGEN_CALL _eel_initfftconv1d(void *opaque, INT_PTR num_param,
 	c->convolverSink[idx] = ptr;
 	return (float)ranN;
 }
+// Convolution matrix, irBuf holds inputs * outputs responses of irLen samples, the path from input m to output n at (m * outputs + n) * irLen
+static float NSEEL_CGEN_CALL _eel_initfftconv1dmatrix(void *opaque, INT_PTR num_param, float **parms)
+{
+	compileContext *c = (compileContext*)opaque;
+	float *blocks = c->ram_state;
+	if (c->numberOfConvolver > 1024 - 1)
+		return -1;
+	uint32_t ranN;
+	while (1)
+	{
+		ranN = (uint32_t)(nseel_int_rand(1.0f) * 1024.0);
+		uint32_t counter = 0;
+		for (uint32_t i = 0; i < c->numberOfConvolver; i++)
+		{
+			if (ranN == c->convolverMap[i])
+			{
+				counter++;
+				break;
+			}
+		}
+		if (!counter)
+			break;
+	}
+	uint32_t latency = (uint32_t)(*parms[0] + NSEEL_CLOSEFACTOR);
+	uint32_t irLen = (uint32_t)(*parms[1] + NSEEL_CLOSEFACTOR);
+	uint32_t inputs = (uint32_t)(*parms[2] + NSEEL_CLOSEFACTOR);
+	uint32_t outputs = (uint32_t)(*parms[3] + NSEEL_CLOSEFACTOR);
+	uint32_t offs1 = (uint32_t)(*parms[4] + NSEEL_CLOSEFACTOR);
+	if (!inputs || !outputs || inputs > FFTCONV_MATRIX_MAXCH || outputs > FFTCONV_MATRIX_MAXCH)
+		return -2;
+	const float *ir[FFTCONV_MATRIX_MAXCH * FFTCONV_MATRIX_MAXCH];
+	for (uint32_t p = 0; p < inputs * outputs; p++)
+		ir[p] = __NSEEL_RAMAlloc(blocks, (uint64_t)offs1 + (uint64_t)p * irLen);
+	FFTConvolverMxN *conv = (FFTConvolverMxN*)malloc(sizeof(FFTConvolverMxN));
+	FFTConvolverMxNInit(conv);
+	if (!FFTConvolverMxNLoadImpulseResponse(conv, latency, inputs, outputs, ir, irLen))
+	{
+		free(conv);
+		return -3;
+	}
+	c->numberOfConvolver++;
+	int32_t idx = c->numberOfConvolver - 1;
+	if (idx)
+	{
+		c->convolverMap = (uint32_t*)realloc(c->convolverMap, c->numberOfConvolver * sizeof(uint32_t));
+		c->convolverType = (uint32_t*)realloc(c->convolverType, c->numberOfConvolver * sizeof(uint32_t));
+		c->convolverSink = (void**)realloc(c->convolverSink, c->numberOfConvolver * sizeof(void*));
+	}
+	else
+	{
+		c->convolverMap = (uint32_t*)malloc(c->numberOfConvolver * sizeof(uint32_t));
+		c->convolverType = (uint32_t*)malloc(c->numberOfConvolver * sizeof(uint32_t));
+		c->convolverSink = (void**)malloc(c->numberOfConvolver * sizeof(void*));
+	}
+	c->convolverMap[idx] = ranN;
+	c->convolverType[idx] = CONV1D_MATRIX;
+	c->convolverSink[idx] = (void*)conv;
+	return (float)ranN;
+}
 static float NSEEL_CGEN_CALL _eel_deletefftconv1d(void *opaque, float *v)
 {
 	compileContext *c = (compileContext*)opaque;
@@ -3031,6 +3096,12 @@ static float NSEEL_CGEN_CALL _eel_deletefftconv1d(void *opaque, float *v)
 		FFTConvolver2x4x2Free(conv);
 		free(conv);
 	}
+	if (convType == CONV1D_MATRIX)
+	{
+		FFTConvolverMxN *conv = (FFTConvolverMxN*)ptr;
+		FFTConvolverMxNFree(conv);
+		free(conv);
+	}
 	for (uint32_t i = idx; i < c->numberOfConvolver - 1; i++)
 	{
 		c->convolverMap[i] = c->convolverMap[i + 1];
@@ -3091,6 +3162,20 @@ static float NSEEL_CGEN_CALL _eel_processfftconv1d(void *opaque, INT_PTR num_par
 		float *x2 = __NSEEL_RAMAlloc(blocks, (uint64_t)offs2);
 		FFTConvolver2x4x2Process(conv, x1, x2, x1, x2, conv->_blockSize);
 	}
+	if (convType == CONV1D_MATRIX)
+	{
+		// Planar buffers, _blockSize samples per channel, output may be the input buffer
+		FFTConvolverMxN *conv = (FFTConvolverMxN*)ptr;
+		uint32_t offs1 = (uint32_t)(*parms[1] + NSEEL_CLOSEFACTOR);
+		uint32_t offs2 = num_param > 2 ? (uint32_t)(*parms[2] + NSEEL_CLOSEFACTOR) : offs1;
+		const float *x[FFTCONV_MATRIX_MAXCH];
+		float *y[FFTCONV_MATRIX_MAXCH];
+		for (uint32_t m = 0; m < conv->_inputs; m++)
+			x[m] = __NSEEL_RAMAlloc(blocks, (uint64_t)offs1 + (uint64_t)m * conv->_blockSize);
+		for (uint32_t n = 0; n < conv->_outputs; n++)
+			y[n] = __NSEEL_RAMAlloc(blocks, (uint64_t)offs2 + (uint64_t)n * conv->_blockSize);
+		FFTConvolverMxNProcess(conv, x, y, conv->_blockSize);
+	}
 	return 1;
 }
 
@@ -4146,6 +4231,7 @@ static functionType fnTable1[] = {
   {"IIRBandSplitterProcess",_asm_generic2parm_retd,_asm_generic2parm_retd_end,2 | BIF_TAKES_VARPARM | BIF_RETURNSONSTACK,{(void**)&_eel_iirBandSplitterProcess},NSEEL_PProc_THIS},
   {"Conv1DInit",_asm_generic2parm_retd,_asm_generic2parm_retd_end,3 | BIF_TAKES_VARPARM | BIF_RETURNSONSTACK,{(void**)&_eel_initfftconv1d},NSEEL_PProc_THIS},
   {"Conv1DProcess",_asm_generic2parm_retd,_asm_generic2parm_retd_end,2 | BIF_TAKES_VARPARM | BIF_RETURNSONSTACK,{(void**)&_eel_processfftconv1d},NSEEL_PProc_THIS},
+  {"Conv1DMatrixInit",_asm_generic2parm_retd,_asm_generic2parm_retd_end,5 | BIF_TAKES_VARPARM | BIF_RETURNSONSTACK,{(void**)&_eel_initfftconv1dmatrix},NSEEL_PProc_THIS},
   {"Conv1DFree",_asm_generic1parm_retd,_asm_generic1parm_retd_end,1 | BIF_RETURNSONSTACK,{(void**)&_eel_deletefftconv1d},NSEEL_PProc_THIS},
   {"decodeFLACFromFile",_asm_generic2parm_retd,_asm_generic2parm_retd_end,4 | BIF_TAKES_VARPARM | BIF_RETURNSONSTACK,{(void**)&_eel_flacDecodeFile},NSEEL_PProc_THIS},
   {"decodeFLACFromMemory",_asm_generic2parm_retd,_asm_generic2parm_retd_end,4 | BIF_TAKES_VARPARM | BIF_RETURNSONSTACK,{(void**)&_eel_flacDecodeMemory},NSEEL_PProc_THIS},
@@ -6730,6 +6816,72 @@ int32_t compileOpcodes(compileContext *ctx, opcodeRec *op, unsigned char *bufOut
 	return codesz;
 }
 //------------------------------------------------------------------------------
+// Common opcode sequences, longest first, and the superinstruction that runs each of them in one dispatch
+static const struct
+{
+	EEL_BC_TYPE sequence[3], fused;
+} superinstructions[] = {
+	{ { EEL_BC_MOV_FPTOP_DV, EEL_BC_MOV_FPTOP_DV, EEL_BC_ADD }, EEL_BC_DV_DV_ADD },
+	{ { EEL_BC_MOV_FPTOP_DV, EEL_BC_MOV_FPTOP_DV, EEL_BC_SUB }, EEL_BC_DV_DV_SUB },
+	{ { EEL_BC_MOV_FPTOP_DV, EEL_BC_MOV_FPTOP_DV, EEL_BC_MUL }, EEL_BC_DV_DV_MUL },
+	{ { EEL_BC_MOV_FPTOP_DV, EEL_BC_MOV_FPTOP_DV, EEL_BC_DIV }, EEL_BC_DV_DV_DIV },
+	{ { EEL_BC_ADD, EEL_BC_MEGABUF, EEL_BC_PUSH_VAL_AT_P1_TO_FPSTACK }, EEL_BC_ADD_MEGABUF_PUSH },
+	{ { EEL_BC_MOV_FPTOP_DV, EEL_BC_MOV_FPTOP_DV }, EEL_BC_DV_DV },
+	{ { EEL_BC_MOV_FPTOP_DV, EEL_BC_ADD }, EEL_BC_DV_ADD },
+	{ { EEL_BC_MOV_FPTOP_DV, EEL_BC_SUB }, EEL_BC_DV_SUB },
+	{ { EEL_BC_MOV_FPTOP_DV, EEL_BC_MUL }, EEL_BC_DV_MUL },
+	{ { EEL_BC_MOV_FPTOP_DV, EEL_BC_DIV }, EEL_BC_DV_DIV },
+	{ { EEL_BC_ADD, EEL_BC_MEGABUF }, EEL_BC_ADD_MEGABUF },
+	{ { EEL_BC_MEGABUF, EEL_BC_PUSH_VAL_AT_P1_TO_FPSTACK }, EEL_BC_MEGABUF_PUSH },
+	{ { EEL_BC_MOV_P2_DV, EEL_BC_ASSIGN_FROMFP }, EEL_BC_ASSIGN_FROMFP_DV },
+	{ { EEL_BC_MOV_P2_DV, EEL_BC_ASSIGN_FAST_FROMFP }, EEL_BC_ASSIGN_FROMFP_DV },
+	{ { EEL_BC_MOV_P2_DV, EEL_BC_ADD_OP }, EEL_BC_ADD_OP_DV },
+	{ { EEL_BC_MOV_P2_DV, EEL_BC_ADD_OP_FAST }, EEL_BC_ADD_OP_DV },
+	{ { EEL_BC_MOV_P2_DV, EEL_BC_SUB_OP }, EEL_BC_SUB_OP_DV },
+	{ { EEL_BC_MOV_P2_DV, EEL_BC_SUB_OP_FAST }, EEL_BC_SUB_OP_DV },
+	{ { EEL_BC_MOV_P2_DV, EEL_BC_MUL_OP }, EEL_BC_MUL_OP_DV },
+	{ { EEL_BC_MOV_P2_DV, EEL_BC_MUL_OP_FAST }, EEL_BC_MUL_OP_DV },
+	{ { EEL_BC_MOV_P2_DV, EEL_BC_DIV_OP }, EEL_BC_DIV_OP_DV },
+	{ { EEL_BC_MOV_P2_DV, EEL_BC_DIV_OP_FAST }, EEL_BC_DIV_OP_DV },
+	{ { EEL_BC_MOV_P1_DV, EEL_BC_COPY_VALUE_AT_P1_TO_ADDR }, EEL_BC_COPY_DV },
+	{ { EEL_BC_EQUAL, EEL_BC_JMP_IF_P1_Z }, EEL_BC_EQUAL_JZ },
+	{ { EEL_BC_NOTEQUAL, EEL_BC_JMP_IF_P1_Z }, EEL_BC_NOTEQUAL_JZ },
+	{ { EEL_BC_ABOVE, EEL_BC_JMP_IF_P1_Z }, EEL_BC_ABOVE_JZ },
+	{ { EEL_BC_BELOWEQ, EEL_BC_JMP_IF_P1_Z }, EEL_BC_BELOWEQ_JZ },
+};
+// Peephole pass over finished bytecode. Only the first opcode of a matched sequence is rewritten, so a jump
+// landing inside the sequence still finds the original opcodes, and the rest of it stays the operand storage
+static void fuseSuperinstructions(void *code)
+{
+	int32_t count = 0;
+	char **insns = nseel_bc_discover((char*)code, &count);
+	if (!insns)
+		return;
+	// In address order, so the opcodes after ip are still unfused when they are compared
+	for (int32_t i = 0; i < count; i++)
+	{
+		char *ip = insns[i];
+		for (size_t j = 0; j < sizeof(superinstructions) / sizeof(superinstructions[0]); j++)
+		{
+			const EEL_BC_TYPE *sequence = superinstructions[j].sequence;
+			char *next = ip;
+			int32_t k;
+			for (k = 0; k < 3 && sequence[k]; k++)
+			{
+				if (*(EEL_BC_TYPE*)next != sequence[k])
+					break;
+				next += nseel_bc_insn_size(sequence[k]);
+			}
+			if (k == 3 || !sequence[k])
+			{
+				*(EEL_BC_TYPE*)ip = superinstructions[j].fused;
+				break;
+			}
+		}
+	}
+	free(insns);
+}
+//------------------------------------------------------------------------------
 NSEEL_CODEHANDLE NSEEL_code_compile(NSEEL_VMCTX _ctx, const char *_expression, int32_t lineoffs)
 {
 	return NSEEL_code_compile_ex(_ctx, _expression, lineoffs, 0);
@@ -7210,6 +7362,12 @@ NSEEL_CODEHANDLE NSEEL_code_compile_ex(NSEEL_VMCTX _ctx, const char *_expression
 	if (handle)
 	{
 		handle->ramPtr = ctx->ram_state;
+		if (handle->code)
+			fuseSuperinstructions(handle->code);
+#ifdef EEL_NATIVE_X86_64
+		if (nseel_jit_enabled && handle->code)
+			nseel_jit_compile(handle);
+#endif
 		memcpy(handle->code_stats, ctx->l_stats, sizeof(ctx->l_stats));
 		nseel_evallib_stats[0] += ctx->l_stats[0];
 		nseel_evallib_stats[1] += ctx->l_stats[1];
@@ -7236,8 +7394,21 @@ void NSEEL_code_execute(NSEEL_CODEHANDLE code)
 	codeHandleType *h = (codeHandleType *)code;
 	INT_PTR codeptr = (INT_PTR)h->code;
 	INT_PTR tabptr = (INT_PTR)h->workTable;
+#ifdef EEL_NATIVE_X86_64
+	if (h->nativeCode)
+	{
+		((void(*)(void*, void*))h->nativeCode)(h->workTable, h->ramPtr);
+		return;
+	}
+#endif
 	GLUE_CALL_CODE(tabptr, codeptr, (INT_PTR)h->ramPtr);
 }
+void NSEEL_set_native_code(int32_t enable)
+{
+#ifdef EEL_NATIVE_X86_64
+	nseel_jit_enabled = enable;
+#endif
+}
 int32_t NSEEL_code_geterror_flag(NSEEL_VMCTX ctx)
 {
 	compileContext *c = (compileContext*)ctx;
@@ -7261,6 +7432,9 @@ void NSEEL_code_free(NSEEL_CODEHANDLE code)
 		nseel_evallib_stats[2] -= h->code_stats[2];
 		nseel_evallib_stats[3] -= h->code_stats[3];
 		nseel_evallib_stats[4]--;
+#ifdef EEL_NATIVE_X86_64
+		nseel_jit_free(h);
+#endif
 		freeBlocks(&h->blocks);
 		freeBlocks(&h->blocks_data);
 	}
@@ -7300,6 +7474,12 @@ void NSEEL_VM_freevars(NSEEL_VMCTX _ctx)
 					FFTConvolver2x4x2Free(conv);
 					free(conv);
 				}
+				if (convType == CONV1D_MATRIX)
+				{
+					FFTConvolverMxN *conv = (FFTConvolverMxN*)ptr;
+					FFTConvolverMxNFree(conv);
+					free(conv);
+				}
 			}
 			if (ctx->convolverMap)
 				free(ctx->convolverMap);
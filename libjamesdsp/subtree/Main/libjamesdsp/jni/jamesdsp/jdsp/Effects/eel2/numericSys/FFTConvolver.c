@@ -4,7 +4,16 @@
 #include <float.h>
 #include <math.h>
 #include "../ns-eel.h"
-#include "codelet.h"
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/vfs.h>
+#include <linux/magic.h>
+#endif
+#endif
 unsigned int upper_power_of_two(unsigned int v)
 {
 	v--;
@@ -15,9 +24,594 @@ unsigned int upper_power_of_two(unsigned int v)
 	v |= v >> 16;
 	return ++v;
 }
+// Paired Hartley transform, two real sequences interleaved as A[2 * k] = x1[k], A[2 * k + 1] = x2[k]
+// Both channels share a single pass over butterflies and twiddles, input must be bit-reversed by pair
+void pairedDiscreteHartleyFloat(float *A, const unsigned int nPoints, const float *sinTab)
+{
+	unsigned int i, j, c, n, n2, theta_inc, nptDiv2;
+	float alpha, beta;
+	const unsigned int nPairs = nPoints << 1;
+	// FHT - stage 1 and 2 (2 and 4 points)
+	for (i = 0; i < nPairs; i += 8)
+	{
+		for (c = 0; c < 2; c++)
+		{
+			const float	x0 = A[i + c];
+			const float	x1 = A[i + 2 + c];
+			const float	x2 = A[i + 4 + c];
+			const float	x3 = A[i + 6 + c];
+			const float	y0 = x0 + x1;
+			const float	y1 = x0 - x1;
+			const float	y2 = x2 + x3;
+			const float	y3 = x2 - x3;
+			A[i + c] = y0 + y2;
+			A[i + 4 + c] = y0 - y2;
+			A[i + 2 + c] = y1 + y3;
+			A[i + 6 + c] = y1 - y3;
+		}
+	}
+	// FHT - stage 3 (8 points)
+	for (i = 0; i < nPairs; i += 16)
+	{
+		for (c = 0; c < 2; c++)
+		{
+			float *a = A + i + c;
+			alpha = a[0];
+			beta = a[8];
+			a[0] = alpha + beta;
+			a[8] = alpha - beta;
+			alpha = a[4];
+			beta = a[12];
+			a[4] = alpha + beta;
+			a[12] = alpha - beta;
+			alpha = a[2];
+			const float beta1 = 0.70710678118654752440084436210485f*(a[10] + a[14]);
+			const float beta2 = 0.70710678118654752440084436210485f*(a[10] - a[14]);
+			a[2] = alpha + beta1;
+			a[10] = alpha - beta1;
+			alpha = a[6];
+			a[6] = alpha + beta2;
+			a[14] = alpha - beta2;
+		}
+	}
+	n = 16;
+	n2 = 8;
+	theta_inc = nPoints >> 4;
+	nptDiv2 = nPoints >> 2;
+	while (n <= nPoints)
+	{
+		for (i = 0; i < nPoints; i += n)
+		{
+			unsigned int theta = theta_inc;
+			const unsigned int n4 = n2 >> 1;
+			float *a = A + (i << 1);
+			for (c = 0; c < 2; c++)
+			{
+				alpha = a[c];
+				beta = a[(n2 << 1) + c];
+				a[c] = alpha + beta;
+				a[(n2 << 1) + c] = alpha - beta;
+				alpha = a[(n4 << 1) + c];
+				beta = a[((n2 + n4) << 1) + c];
+				a[(n4 << 1) + c] = alpha + beta;
+				a[((n2 + n4) << 1) + c] = alpha - beta;
+			}
+			for (j = 1; j < n4; j++)
+			{
+				const float sinval = sinTab[theta];
+				const float cosval = sinTab[theta + nptDiv2];
+				float *p0 = a + (j << 1);
+				float *p1 = a + ((n2 - j) << 1);
+				float *p2 = a + ((j + n2) << 1);
+				float *p3 = a + ((n - j) << 1);
+				for (c = 0; c < 2; c++)
+				{
+					const float alpha1 = p0[c];
+					const float alpha2 = p1[c];
+					const float beta1 = p2[c] * cosval + p3[c] * sinval;
+					const float beta2 = p2[c] * sinval - p3[c] * cosval;
+					p0[c] = alpha1 + beta1;
+					p2[c] = alpha1 - beta1;
+					p1[c] = alpha2 + beta2;
+					p3[c] = alpha2 - beta2;
+				}
+				theta += theta_inc;
+			}
+		}
+		n <<= 1;
+		n2 <<= 1;
+		theta_inc >>= 1;
+	}
+}
+// Decimation in frequency Hartley transform, the transpose of the bit-reversed input codelets
+// Takes natural order input whose upper half is zero (only A[0 .. nPoints / 2) is read) and leaves the spectrum bit-reversed
+void zeroPaddedDIFHartleyFloat(float *A, const unsigned int nPoints, const float *sinTab)
+{
+	unsigned int i, j, n, n2, n4, theta_inc, nptDiv2;
+	float alpha, beta;
+	if (nPoints < 16)
+	{
+		memset(A + (nPoints >> 1), 0, (nPoints >> 1) * sizeof(float));
+		n = 8;
+	}
+	else
+	{
+		// First stage against the implicit zero half
+		n2 = nPoints >> 1;
+		n4 = nPoints >> 2;
+		nptDiv2 = nPoints >> 2;
+		A[n2] = A[0];
+		A[n2 + n4] = A[n4];
+		for (j = 1; j < n4; j++)
+		{
+			const float sinval = sinTab[j];
+			const float cosval = sinTab[j + nptDiv2];
+			const float alpha1 = A[j];
+			const float alpha2 = A[n2 - j];
+			A[j + n2] = cosval * alpha1 + sinval * alpha2;
+			A[nPoints - j] = sinval * alpha1 - cosval * alpha2;
+		}
+		n = nPoints >> 1;
+	}
+	n2 = n >> 1;
+	theta_inc = nPoints / n;
+	nptDiv2 = nPoints >> 2;
+	while (n >= 16)
+	{
+		n4 = n2 >> 1;
+		for (i = 0; i < nPoints; i += n)
+		{
+			unsigned int theta = theta_inc;
+			float *a = A + i;
+			alpha = a[0];
+			beta = a[n2];
+			a[0] = alpha + beta;
+			a[n2] = alpha - beta;
+			alpha = a[n4];
+			beta = a[n2 + n4];
+			a[n4] = alpha + beta;
+			a[n2 + n4] = alpha - beta;
+			for (j = 1; j < n4; j++)
+			{
+				const float sinval = sinTab[theta];
+				const float cosval = sinTab[theta + nptDiv2];
+				const float alpha1 = a[j] - a[j + n2];
+				const float alpha2 = a[n2 - j] - a[n - j];
+				a[j] += a[j + n2];
+				a[n2 - j] += a[n - j];
+				a[j + n2] = cosval * alpha1 + sinval * alpha2;
+				a[n - j] = sinval * alpha1 - cosval * alpha2;
+				theta += theta_inc;
+			}
+		}
+		n >>= 1;
+		n2 >>= 1;
+		theta_inc <<= 1;
+	}
+	if (nPoints == 2)
+	{
+		A[1] = A[0];
+		return;
+	}
+	// FHT - stage 3 (8 points)
+	for (i = 0; nPoints >= 8 && i < nPoints; i += 8)
+	{
+		alpha = A[i];
+		beta = A[i + 4];
+		A[i] = alpha + beta;
+		A[i + 4] = alpha - beta;
+		alpha = A[i + 2];
+		beta = A[i + 6];
+		A[i + 2] = alpha + beta;
+		A[i + 6] = alpha - beta;
+		const float beta1 = A[i + 1] - A[i + 5];
+		const float beta2 = A[i + 3] - A[i + 7];
+		A[i + 1] += A[i + 5];
+		A[i + 3] += A[i + 7];
+		A[i + 5] = 0.70710678118654752440084436210485f*(beta1 + beta2);
+		A[i + 7] = 0.70710678118654752440084436210485f*(beta1 - beta2);
+	}
+	// FHT - stage 1 and 2 (2 and 4 points)
+	for (i = 0; i < nPoints; i += 4)
+	{
+		const float	x0 = A[i];
+		const float	x1 = A[i + 1];
+		const float	x2 = A[i + 2];
+		const float	x3 = A[i + 3];
+		const float	y0 = x0 + x1;
+		const float	y1 = x0 - x1;
+		const float	y2 = x2 + x3;
+		const float	y3 = x2 - x3;
+		A[i] = y0 + y2;
+		A[i + 2] = y0 - y2;
+		A[i + 1] = y1 + y3;
+		A[i + 3] = y1 - y3;
+	}
+}
+// Paired form of zeroPaddedDIFHartleyFloat, two channels interleaved as in pairedDiscreteHartleyFloat, nPoints >= 16
+void pairedZeroPaddedDIFHartleyFloat(float *A, const unsigned int nPoints, const float *sinTab)
+{
+	unsigned int i, j, c, n, n2, n4, theta_inc, nptDiv2;
+	float alpha, beta;
+	const unsigned int nPairs = nPoints << 1;
+	n2 = nPoints >> 1;
+	n4 = nPoints >> 2;
+	nptDiv2 = nPoints >> 2;
+	for (c = 0; c < 2; c++)
+	{
+		A[(n2 << 1) + c] = A[c];
+		A[((n2 + n4) << 1) + c] = A[(n4 << 1) + c];
+	}
+	for (j = 1; j < n4; j++)
+	{
+		const float sinval = sinTab[j];
+		const float cosval = sinTab[j + nptDiv2];
+		for (c = 0; c < 2; c++)
+		{
+			const float alpha1 = A[(j << 1) + c];
+			const float alpha2 = A[((n2 - j) << 1) + c];
+			A[((j + n2) << 1) + c] = cosval * alpha1 + sinval * alpha2;
+			A[((nPoints - j) << 1) + c] = sinval * alpha1 - cosval * alpha2;
+		}
+	}
+	n = nPoints >> 1;
+	n2 = n >> 1;
+	theta_inc = 2;
+	while (n >= 16)
+	{
+		n4 = n2 >> 1;
+		for (i = 0; i < nPoints; i += n)
+		{
+			unsigned int theta = theta_inc;
+			float *a = A + (i << 1);
+			for (c = 0; c < 2; c++)
+			{
+				alpha = a[c];
+				beta = a[(n2 << 1) + c];
+				a[c] = alpha + beta;
+				a[(n2 << 1) + c] = alpha - beta;
+				alpha = a[(n4 << 1) + c];
+				beta = a[((n2 + n4) << 1) + c];
+				a[(n4 << 1) + c] = alpha + beta;
+				a[((n2 + n4) << 1) + c] = alpha - beta;
+			}
+			for (j = 1; j < n4; j++)
+			{
+				const float sinval = sinTab[theta];
+				const float cosval = sinTab[theta + nptDiv2];
+				float *p0 = a + (j << 1);
+				float *p1 = a + ((n2 - j) << 1);
+				float *p2 = a + ((j + n2) << 1);
+				float *p3 = a + ((n - j) << 1);
+				for (c = 0; c < 2; c++)
+				{
+					const float alpha1 = p0[c] - p2[c];
+					const float alpha2 = p1[c] - p3[c];
+					p0[c] += p2[c];
+					p1[c] += p3[c];
+					p2[c] = cosval * alpha1 + sinval * alpha2;
+					p3[c] = sinval * alpha1 - cosval * alpha2;
+				}
+				theta += theta_inc;
+			}
+		}
+		n >>= 1;
+		n2 >>= 1;
+		theta_inc <<= 1;
+	}
+	// FHT - stage 3 (8 points)
+	for (i = 0; i < nPairs; i += 16)
+	{
+		for (c = 0; c < 2; c++)
+		{
+			float *a = A + i + c;
+			alpha = a[0];
+			beta = a[8];
+			a[0] = alpha + beta;
+			a[8] = alpha - beta;
+			alpha = a[4];
+			beta = a[12];
+			a[4] = alpha + beta;
+			a[12] = alpha - beta;
+			const float beta1 = a[2] - a[10];
+			const float beta2 = a[6] - a[14];
+			a[2] += a[10];
+			a[6] += a[14];
+			a[10] = 0.70710678118654752440084436210485f*(beta1 + beta2);
+			a[14] = 0.70710678118654752440084436210485f*(beta1 - beta2);
+		}
+	}
+	// FHT - stage 1 and 2 (2 and 4 points)
+	for (i = 0; i < nPairs; i += 8)
+	{
+		for (c = 0; c < 2; c++)
+		{
+			const float	x0 = A[i + c];
+			const float	x1 = A[i + 2 + c];
+			const float	x2 = A[i + 4 + c];
+			const float	x3 = A[i + 6 + c];
+			const float	y0 = x0 + x1;
+			const float	y1 = x0 - x1;
+			const float	y2 = x2 + x3;
+			const float	y3 = x2 - x3;
+			A[i + c] = y0 + y2;
+			A[i + 4 + c] = y0 - y2;
+			A[i + 2 + c] = y1 + y3;
+			A[i + 6 + c] = y1 - y3;
+		}
+	}
+}
+// Spectrum of one zero padded partition, bins are laid out in the slot order of the plan
+void fhtPartitionSpectrum(const FHTPlan *plan, float *work, const float *x, unsigned int len, float *re, float *im)
+{
+	unsigned int j;
+	const unsigned int half = plan->n >> 1;
+	const unsigned int *slot = plan->slot;
+	memcpy(work, x, len * sizeof(float));
+	if (plan->fft)
+	{
+		memset(work + len, 0, (half - len) * sizeof(float));
+		zeroPaddedDIFHartleyFloat(work, plan->n, plan->sine);
+	}
+	else
+	{
+		memset(work + len, 0, (plan->n - len) * sizeof(float));
+		mixedRadixFHTForward(plan, work);
+	}
+	re[0] = work[0];
+	im[0] = 0.0f;
+	for (j = 1; j <= half; j++)
+	{
+		re[j] = work[slot[j << 1]] + work[slot[(j << 1) + 1]];
+		im[j] = work[slot[j << 1]] - work[slot[(j << 1) + 1]];
+	}
+}
+// Spectra rows are padded to whole cache lines so every row of the arena starts 64 byte aligned
+#define FFTCONV_ARENA_ALIGN 64
+#define FFTCONV_ARENA_HUGEPAGE (2u << 20)
+static unsigned int spectrumArenaStride(unsigned int fftComplexSize)
+{
+	return (fftComplexSize + (FFTCONV_ARENA_ALIGN / sizeof(float)) - 1) & ~(unsigned int)(FFTCONV_ARENA_ALIGN / sizeof(float) - 1);
+}
+// Zeroed, aligned, arenas of 2 MB and up are hinted for transparent huge pages
+static float* spectrumArenaAlloc(size_t floats)
+{
+	const size_t bytes = floats * sizeof(float);
+	void *arena;
+#ifdef _WIN32
+	arena = _aligned_malloc(bytes, FFTCONV_ARENA_ALIGN);
+#else
+	const size_t align = bytes >= FFTCONV_ARENA_HUGEPAGE ? FFTCONV_ARENA_HUGEPAGE : FFTCONV_ARENA_ALIGN;
+	if (posix_memalign(&arena, align, bytes))
+		arena = 0;
+#ifdef MADV_HUGEPAGE
+	else if (align == FFTCONV_ARENA_HUGEPAGE)
+		madvise(arena, bytes, MADV_HUGEPAGE);
+#endif
+#endif
+	if (arena)
+		memset(arena, 0, bytes);
+	return (float*)arena;
+}
+static void spectrumArenaFree(float *arena)
+{
+#ifdef _WIN32
+	_aligned_free(arena);
+#else
+	free(arena);
+#endif
+}
+// IR spectra from this size on are streamed when the owner allows it
+#ifndef FFTCONV_STREAM_MINBYTES
+#define FFTCONV_STREAM_MINBYTES (32u << 20)
+#endif
+// IR spectra paged in ahead of the multiply position, also the amount kept in the arena
+#define FFTCONV_STREAM_WINDOWBYTES (1u << 20)
+#ifndef _WIN32
+/*
+* Unlinked temporary file for streamed spectra. A tmpfs or ramfs directory is skipped, its pages
+* stay in memory whatever we advise, so TMPDIR, /var/tmp and the cache directory are tried first
+*/
+static int spectrumStreamFile(void)
+{
+	const char *dirs[4] = { getenv("TMPDIR"), "/var/tmp", getenv("XDG_CACHE_HOME"), "/tmp" };
+	for (unsigned int d = 0; d < 4; d++)
+	{
+		if (!dirs[d])
+			continue;
+		char path[512];
+		snprintf(path, sizeof(path), "%s/jdspirXXXXXX", dirs[d]);
+		const int fd = mkstemp(path);
+		if (fd < 0)
+			continue;
+		unlink(path);
+#ifdef __linux__
+		struct statfs fs;
+		if (fstatfs(fd, &fs) || fs.f_type == TMPFS_MAGIC || fs.f_type == RAMFS_MAGIC)
+		{
+			close(fd);
+			continue;
+		}
+#endif
+		return fd;
+	}
+	return -1;
+}
+#endif
+static void spectrumStreamRelease(SpectrumStream *stream)
+{
+#ifndef _WIN32
+	if (stream->bytes)
+		munmap((void*)stream->ir, stream->bytes);
+	if (stream->fd >= 0)
+		close(stream->fd);
+#endif
+	free(stream->scratch);
+	const unsigned int enabled = stream->enabled;
+	memset(stream, 0, sizeof(SpectrumStream));
+	stream->enabled = enabled;
+	stream->fd = -1;
+}
+/*
+* Decides how many IR partitions stay in the arena. When the spectra are streamed, the partitions
+* after the first window are computed into a scratch partition and written to a file instead.
+* Returns the number of resident partitions
+*/
+static unsigned int spectrumStreamBegin(SpectrumStream *stream, unsigned int segCount, unsigned int irRows, unsigned int stride)
+{
+	stream->irPartition = (size_t)stride * irRows;
+	stream->resident = segCount;
+#ifndef _WIN32
+	if (!stream->enabled || stream->irPartition * segCount * sizeof(float) < FFTCONV_STREAM_MINBYTES)
+		return segCount;
+	stream->window = (unsigned int)(FFTCONV_STREAM_WINDOWBYTES / (stream->irPartition * sizeof(float)));
+	if (stream->window < 2)
+		stream->window = 2;
+	if (stream->window >= segCount)
+	{
+		stream->window = 0;
+		return segCount;
+	}
+	stream->fd = spectrumStreamFile();
+	if (stream->fd >= 0)
+		stream->scratch = (float*)malloc(stream->irPartition * sizeof(float));
+	if (!stream->scratch)
+	{
+		spectrumStreamRelease(stream);
+		stream->resident = segCount;
+		return segCount;
+	}
+	stream->resident = stream->window;
+#endif
+	return stream->resident;
+}
+// Points the IR rows of the streamed partitions at the scratch partition
+static void spectrumStreamCarve(const SpectrumStream *stream, unsigned int segCount, float **const *rows, unsigned int rowCount, unsigned int stride)
+{
+	for (unsigned int i = stream->resident; i < segCount; ++i)
+	{
+		for (unsigned int r = 0; r < rowCount; ++r)
+			rows[r][i] = stream->scratch + r * stride;
+	}
+}
+// Writes the spectra just computed into the scratch partition to the file
+static void spectrumStreamStore(SpectrumStream *stream, unsigned int i)
+{
+#ifndef _WIN32
+	const size_t bytes = stream->irPartition * sizeof(float);
+	const char *src = (const char*)stream->scratch;
+	off_t offset = (off_t)(i - stream->resident) * (off_t)bytes;
+	size_t left = bytes;
+	while (left && stream->fd >= 0)
+	{
+		const ssize_t written = pwrite(stream->fd, src, left, offset);
+		if (written <= 0)
+		{
+			close(stream->fd);
+			stream->fd = -1;
+			break;
+		}
+		src += written;
+		offset += written;
+		left -= written;
+	}
+#endif
+}
+/*
+* Maps the file read only and points the streamed IR rows into it. Nothing of it is resident yet,
+* the pages were written through the file. Returns 0 when the spectra could not be streamed
+*/
+static int spectrumStreamEnd(SpectrumStream *stream, unsigned int segCount, float **const *rows, unsigned int rowCount, unsigned int stride)
+{
+	if (stream->resident == segCount)
+		return 1;
+	int ok = 0;
+#ifndef _WIN32
+	const size_t bytes = stream->irPartition * (segCount - stream->resident) * sizeof(float);
+	void *map = MAP_FAILED;
+	if (stream->fd >= 0)
+	{
+		map = mmap(0, bytes, PROT_READ, MAP_SHARED, stream->fd, 0);
+		close(stream->fd);
+		stream->fd = -1;
+	}
+	free(stream->scratch);
+	stream->scratch = 0;
+	if (map != MAP_FAILED)
+	{
+		stream->ir = (const float*)map;
+		stream->bytes = bytes;
+		stream->page = (size_t)sysconf(_SC_PAGESIZE);
+		for (unsigned int i = stream->resident; i < segCount; ++i)
+		{
+			for (unsigned int r = 0; r < rowCount; ++r)
+				rows[r][i] = (float*)stream->ir + (i - stream->resident) * stream->irPartition + r * stride;
+		}
+		ok = 1;
+	}
+#endif
+	return ok;
+}
+#ifndef _WIN32
+// Advises IR partitions [first, last), readahead is widened to whole pages and drops are narrowed to them
+static void spectrumStreamAdvise(const SpectrumStream *stream, unsigned int first, unsigned int last, int advice)
+{
+	uintptr_t begin = (uintptr_t)(stream->ir + (first - stream->resident) * stream->irPartition);
+	uintptr_t end = (uintptr_t)(stream->ir + (last - stream->resident) * stream->irPartition);
+	if (advice == MADV_DONTNEED)
+	{
+		begin = (begin + stream->page - 1) & ~(stream->page - 1);
+		end &= ~(stream->page - 1);
+	}
+	else
+		begin &= ~(stream->page - 1);
+	if (end > begin)
+		madvise((void*)begin, end - begin, advice);
+}
+#endif
+/*
+* Called with the IR partition index i of the multiply loop. While the resident partitions are
+* multiplied the first streamed window is read ahead, every window after that reads the next one
+* ahead asynchronously and drops the previous one. Only the background tail thread gets here
+*/
+static void spectrumStreamStep(const SpectrumStream *stream, unsigned int segCount, unsigned int i)
+{
+#ifndef _WIN32
+	const unsigned int window = stream->window;
+	const unsigned int resident = stream->resident;
+	if (i == 1)
+	{
+		const unsigned int lastWindows = segCount - resident > 2 * window ? segCount - 2 * window : resident;
+		spectrumStreamAdvise(stream, lastWindows, segCount, MADV_DONTNEED);
+		spectrumStreamAdvise(stream, resident, min(resident + window, segCount), MADV_WILLNEED);
+	}
+	else if (i >= resident && !((i - resident) % window))
+	{
+		if (i + window < segCount)
+			spectrumStreamAdvise(stream, i + window, min(i + 2 * window, segCount), MADV_WILLNEED);
+		if (i >= resident + window)
+			spectrumStreamAdvise(stream, i - window, i, MADV_DONTNEED);
+	}
+#endif
+}
+/*
+* Points rows[r][i] at consecutive arena rows, partition major, so all channel rows of one
+* partition are adjacent and the partitions of a group follow each other in memory.
+* Returns the first row after the group
+*/
+static float* spectrumArenaCarve(float *row, unsigned int stride, unsigned int segCount, float **const *rows, unsigned int rowCount)
+{
+	for (unsigned int i = 0; i < segCount; ++i)
+	{
+		for (unsigned int r = 0; r < rowCount; ++r, row += stride)
+			rows[r][i] = row;
+	}
+	return row;
+}
 void FFTConvolver1x1Init(FFTConvolver1x1 *conv)
 {
-	conv->bit = 0;
+	conv->slot = 0;
+	conv->plan = 0;
 	conv->_blockSize = 0;
 	conv->_segSize = 0;
 	conv->_segCount = 0;
@@ -26,6 +620,7 @@ void FFTConvolver1x1Init(FFTConvolver1x1 *conv)
 	conv->_segmentsIm = 0;
 	conv->_segmentsIRRe = 0;
 	conv->_segmentsIRIm = 0;
+	conv->_arena = 0;
 	conv->_current = 0;
 	conv->_fftBuffer = 0;
 	conv->_inputBuffer = 0;
@@ -35,7 +630,8 @@ void FFTConvolver1x1Init(FFTConvolver1x1 *conv)
 }
 void FFTConvolver2x4x2Init(FFTConvolver2x4x2 *conv)
 {
-	conv->bit = 0;
+	conv->slot = 0;
+	conv->plan = 0;
 	conv->_blockSize = 0;
 	conv->_segSize = 0;
 	conv->_segCount = 0;
@@ -52,8 +648,12 @@ void FFTConvolver2x4x2Init(FFTConvolver2x4x2 *conv)
 	conv->_segmentsRLIRIm = 0;
 	conv->_segmentsRRIRRe = 0;
 	conv->_segmentsRRIRIm = 0;
+	conv->_arena = 0;
+	memset(&conv->_stream, 0, sizeof(SpectrumStream));
+	conv->_stream.fd = -1;
 	conv->_current = 0;
 	conv->_fftBuffer[0] = 0;
+	conv->_fftPairBuffer = 0;
 	conv->_inputBuffer[0] = 0;
 	conv->_overlap[0] = 0;
 	conv->_inputBufferFill = 0;
@@ -61,7 +661,8 @@ void FFTConvolver2x4x2Init(FFTConvolver2x4x2 *conv)
 }
 void FFTConvolver2x2Init(FFTConvolver2x2 *conv)
 {
-	conv->bit = 0;
+	conv->slot = 0;
+	conv->plan = 0;
 	conv->_blockSize = 0;
 	conv->_segSize = 0;
 	conv->_segCount = 0;
@@ -74,8 +675,13 @@ void FFTConvolver2x2Init(FFTConvolver2x2 *conv)
 	conv->_segmentsLLIRIm = 0;
 	conv->_segmentsRRIRRe = 0;
 	conv->_segmentsRRIRIm = 0;
+	conv->_sharedIR = 0;
+	conv->_arena = 0;
+	memset(&conv->_stream, 0, sizeof(SpectrumStream));
+	conv->_stream.fd = -1;
 	conv->_current = 0;
 	conv->_fftBuffer[0] = 0;
+	conv->_fftPairBuffer = 0;
 	conv->_inputBuffer[0] = 0;
 	conv->_overlap[0] = 0;
 	conv->_inputBufferFill = 0;
@@ -83,7 +689,8 @@ void FFTConvolver2x2Init(FFTConvolver2x2 *conv)
 }
 void FFTConvolver1x2Init(FFTConvolver1x2 *conv)
 {
-	conv->bit = 0;
+	conv->slot = 0;
+	conv->plan = 0;
 	conv->_blockSize = 0;
 	conv->_segSize = 0;
 	conv->_segCount = 0;
@@ -93,8 +700,10 @@ void FFTConvolver1x2Init(FFTConvolver1x2 *conv)
 	conv->_segmentsLLIRIm = 0;
 	conv->_segmentsRRIRRe = 0;
 	conv->_segmentsRRIRIm = 0;
+	conv->_arena = 0;
 	conv->_current = 0;
 	conv->_fftBuffer[0] = 0;
+	conv->_fftPairBuffer = 0;
 	conv->_inputBuffer = 0;
 	conv->_overlap[0] = 0;
 	conv->_inputBufferFill = 0;
@@ -104,13 +713,6 @@ void FFTConvolver1x1Free(FFTConvolver1x1 *conv)
 {
 	if (conv->_segmentsRe)
 	{
-		for (unsigned int i = 0; i < conv->_segCount; ++i)
-		{
-			free(conv->_segmentsRe[i]);
-			free(conv->_segmentsIm[i]);
-			free(conv->_segmentsIRRe[i]);
-			free(conv->_segmentsIRIm[i]);
-		}
 		free(conv->_segmentsRe);
 		free(conv->_segmentsIm);
 		free(conv->_segmentsIRRe);
@@ -120,17 +722,18 @@ void FFTConvolver1x1Free(FFTConvolver1x1 *conv)
 		conv->_segmentsIRRe = 0;
 		conv->_segmentsIRIm = 0;
 	}
-	if (conv->_preMultiplied[0])
+	if (conv->_arena)
 	{
-		free(conv->_preMultiplied[0]);
-		free(conv->_preMultiplied[1]);
+		spectrumArenaFree(conv->_arena);
+		conv->_arena = 0;
 		conv->_preMultiplied[0] = 0;
 	}
-	if (conv->bit)
+	if (conv->slot)
 	{
-		free(conv->bit);
-		free(conv->sine);
-		conv->bit = 0;
+		FHTPlanRelease(conv->plan);
+		conv->plan = 0;
+		conv->slot = 0;
+		conv->sine = 0;
 	}
 	conv->_blockSize = 0;
 	conv->_segSize = 0;
@@ -158,21 +761,6 @@ void FFTConvolver2x4x2Free(FFTConvolver2x4x2 *conv)
 {
 	if (conv->_segmentsReLeft)
 	{
-		for (unsigned int i = 0; i < conv->_segCount; ++i)
-		{
-			free(conv->_segmentsReLeft[i]);
-			free(conv->_segmentsImLeft[i]);
-			free(conv->_segmentsReRight[i]);
-			free(conv->_segmentsImRight[i]);
-			free(conv->_segmentsLLIRRe[i]);
-			free(conv->_segmentsLLIRIm[i]);
-			free(conv->_segmentsLRIRRe[i]);
-			free(conv->_segmentsLRIRIm[i]);
-			free(conv->_segmentsRLIRRe[i]);
-			free(conv->_segmentsRLIRIm[i]);
-			free(conv->_segmentsRRIRRe[i]);
-			free(conv->_segmentsRRIRIm[i]);
-		}
 		free(conv->_segmentsReLeft);
 		free(conv->_segmentsImLeft);
 		free(conv->_segmentsReRight);
@@ -198,19 +786,19 @@ void FFTConvolver2x4x2Free(FFTConvolver2x4x2 *conv)
 		conv->_segmentsRRIRRe = 0;
 		conv->_segmentsRRIRIm = 0;
 	}
-	if (conv->_preMultiplied[0][0])
+	if (conv->_arena)
 	{
-		free(conv->_preMultiplied[0][0]);
-		free(conv->_preMultiplied[0][1]);
-		free(conv->_preMultiplied[1][0]);
-		free(conv->_preMultiplied[1][1]);
+		spectrumArenaFree(conv->_arena);
+		conv->_arena = 0;
 		conv->_preMultiplied[0][0] = 0;
 	}
-	if (conv->bit)
+	spectrumStreamRelease(&conv->_stream);
+	if (conv->slot)
 	{
-		free(conv->bit);
-		free(conv->sine);
-		conv->bit = 0;
+		FHTPlanRelease(conv->plan);
+		conv->plan = 0;
+		conv->slot = 0;
+		conv->sine = 0;
 	}
 	conv->_blockSize = 0;
 	conv->_segSize = 0;
@@ -222,6 +810,11 @@ void FFTConvolver2x4x2Free(FFTConvolver2x4x2 *conv)
 		free(conv->_fftBuffer[1]);
 		conv->_fftBuffer[0] = 0;
 	}
+	if (conv->_fftPairBuffer)
+	{
+		free(conv->_fftPairBuffer);
+		conv->_fftPairBuffer = 0;
+	}
 	if (conv->_overlap[0])
 	{
 		free(conv->_overlap[0]);
@@ -242,17 +835,6 @@ void FFTConvolver2x2Free(FFTConvolver2x2 *conv)
 {
 	if (conv->_segmentsReLeft)
 	{
-		for (unsigned int i = 0; i < conv->_segCount; ++i)
-		{
-			free(conv->_segmentsReLeft[i]);
-			free(conv->_segmentsImLeft[i]);
-			free(conv->_segmentsReRight[i]);
-			free(conv->_segmentsImRight[i]);
-			free(conv->_segmentsLLIRRe[i]);
-			free(conv->_segmentsLLIRIm[i]);
-			free(conv->_segmentsRRIRRe[i]);
-			free(conv->_segmentsRRIRIm[i]);
-		}
 		free(conv->_segmentsReLeft);
 		free(conv->_segmentsImLeft);
 		free(conv->_segmentsReRight);
@@ -270,19 +852,19 @@ void FFTConvolver2x2Free(FFTConvolver2x2 *conv)
 		conv->_segmentsRRIRRe = 0;
 		conv->_segmentsRRIRIm = 0;
 	}
-	if (conv->_preMultiplied[0][0])
+	if (conv->_arena)
 	{
-		free(conv->_preMultiplied[0][0]);
-		free(conv->_preMultiplied[0][1]);
-		free(conv->_preMultiplied[1][0]);
-		free(conv->_preMultiplied[1][1]);
+		spectrumArenaFree(conv->_arena);
+		conv->_arena = 0;
 		conv->_preMultiplied[0][0] = 0;
 	}
-	if (conv->bit)
+	spectrumStreamRelease(&conv->_stream);
+	if (conv->slot)
 	{
-		free(conv->bit);
-		free(conv->sine);
-		conv->bit = 0;
+		FHTPlanRelease(conv->plan);
+		conv->plan = 0;
+		conv->slot = 0;
+		conv->sine = 0;
 	}
 	conv->_blockSize = 0;
 	conv->_segSize = 0;
@@ -294,6 +876,11 @@ void FFTConvolver2x2Free(FFTConvolver2x2 *conv)
 		free(conv->_fftBuffer[1]);
 		conv->_fftBuffer[0] = 0;
 	}
+	if (conv->_fftPairBuffer)
+	{
+		free(conv->_fftPairBuffer);
+		conv->_fftPairBuffer = 0;
+	}
 	if (conv->_overlap[0])
 	{
 		free(conv->_overlap[0]);
@@ -314,15 +901,6 @@ void FFTConvolver1x2Free(FFTConvolver1x2 *conv)
 {
 	if (conv->_segmentsRe)
 	{
-		for (unsigned int i = 0; i < conv->_segCount; ++i)
-		{
-			free(conv->_segmentsRe[i]);
-			free(conv->_segmentsIm[i]);
-			free(conv->_segmentsLLIRRe[i]);
-			free(conv->_segmentsLLIRIm[i]);
-			free(conv->_segmentsRRIRRe[i]);
-			free(conv->_segmentsRRIRIm[i]);
-		}
 		free(conv->_segmentsRe);
 		free(conv->_segmentsIm);
 		free(conv->_segmentsLLIRRe);
@@ -336,19 +914,18 @@ void FFTConvolver1x2Free(FFTConvolver1x2 *conv)
 		conv->_segmentsRRIRRe = 0;
 		conv->_segmentsRRIRIm = 0;
 	}
-	if (conv->_preMultiplied[0][0])
+	if (conv->_arena)
 	{
-		free(conv->_preMultiplied[0][0]);
-		free(conv->_preMultiplied[0][1]);
-		free(conv->_preMultiplied[1][0]);
-		free(conv->_preMultiplied[1][1]);
+		spectrumArenaFree(conv->_arena);
+		conv->_arena = 0;
 		conv->_preMultiplied[0][0] = 0;
 	}
-	if (conv->bit)
+	if (conv->slot)
 	{
-		free(conv->bit);
-		free(conv->sine);
-		conv->bit = 0;
+		FHTPlanRelease(conv->plan);
+		conv->plan = 0;
+		conv->slot = 0;
+		conv->sine = 0;
 	}
 	conv->_blockSize = 0;
 	conv->_segSize = 0;
@@ -360,6 +937,11 @@ void FFTConvolver1x2Free(FFTConvolver1x2 *conv)
 		free(conv->_fftBuffer[1]);
 		conv->_fftBuffer[0] = 0;
 	}
+	if (conv->_fftPairBuffer)
+	{
+		free(conv->_fftPairBuffer);
+		conv->_fftPairBuffer = 0;
+	}
 	if (conv->_overlap[0])
 	{
 		free(conv->_overlap[0]);
@@ -374,8 +956,6 @@ void FFTConvolver1x2Free(FFTConvolver1x2 *conv)
 	conv->_current = 0;
 	conv->_inputBufferFill = 0;
 }
-extern void fhtbitReversalTbl(unsigned *dst, unsigned int n);
-extern void fhtsinHalfTblFloat(float *dst, unsigned int n);
 int FFTConvolver1x1LoadImpulseResponse(FFTConvolver1x1 *conv, unsigned int blockSize, const float* ir, unsigned int irLen)
 {
 	if (blockSize == 0)
@@ -383,103 +963,51 @@ int FFTConvolver1x1LoadImpulseResponse(FFTConvolver1x1 *conv, unsigned int block
 	if (irLen == 0)
 		return 0;
 
-	if (conv->bit)
+	if (conv->slot)
 		FFTConvolver1x1Free(conv);
-	conv->_blockSize = upper_power_of_two(blockSize);
+	conv->_blockSize = FHTPlanBlockSize(blockSize);
 	conv->_segSize = 2 * conv->_blockSize;
 	conv->_segCount = (unsigned int)ceil((double)irLen / (double)conv->_blockSize);
 	conv->_segCountMinus1 = conv->_segCount - 1;
 	conv->_fftComplexSize = (conv->_segSize >> 1) + 1;
 
 	// FFT
-	if (conv->_segSize == 2)
-		conv->fft = DFT2;
-	else if (conv->_segSize == 4)
-		conv->fft = DFT4;
-	else if (conv->_segSize == 8)
-		conv->fft = DFT8;
-	else if (conv->_segSize == 16)
-		conv->fft = DFT16;
-	else if (conv->_segSize == 32)
-		conv->fft = DFT32;
-	else if (conv->_segSize == 64)
-		conv->fft = DFT64;
-	else if (conv->_segSize == 128)
-		conv->fft = DFT128;
-	else if (conv->_segSize == 256)
-		conv->fft = DFT256;
-	else if (conv->_segSize == 512)
-		conv->fft = DFT512;
-	else if (conv->_segSize == 1024)
-		conv->fft = DFT1024;
-	else if (conv->_segSize == 2048)
-		conv->fft = DFT2048;
-	else if (conv->_segSize == 4096)
-		conv->fft = DFT4096;
-	else if (conv->_segSize == 8192)
-		conv->fft = DFT8192;
-	else if (conv->_segSize == 16384)
-		conv->fft = DFT16384;
-	else if (conv->_segSize == 32768)
-		conv->fft = DFT32768;
-	else if (conv->_segSize == 65536)
-		conv->fft = DFT65536;
-	else if (conv->_segSize == 131072)
-		conv->fft = DFT131072;
-	else if (conv->_segSize == 262144)
-		conv->fft = DFT262144;
-	else if (conv->_segSize == 524288)
-		conv->fft = DFT524288;
-	else if (conv->_segSize == 1048576)
-		conv->fft = DFT1048576;
-	conv->bit = (unsigned int*)malloc(conv->_segSize * sizeof(unsigned int));
-	conv->sine = (float*)malloc(conv->_segSize * sizeof(float));
-	fhtbitReversalTbl(conv->bit, conv->_segSize);
-	fhtsinHalfTblFloat(conv->sine, conv->_segSize);
+	conv->plan = FHTPlanAcquire(conv->_segSize);
+	if (!conv->plan)
+		return 0;
+	conv->slot = conv->plan->slot;
+	conv->sine = conv->plan->sine;
 	conv->_fftBuffer = (float*)malloc(conv->_segSize * sizeof(float));
 
 	// Prepare segments
 	conv->_segmentsRe = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsIm = (float**)malloc(conv->_segCount * sizeof(float*));
-	for (unsigned int i = 0; i < conv->_segCount; ++i)
-	{
-		conv->_segmentsRe[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		conv->_segmentsIm[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsRe[i], 0, conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsIm[i], 0, conv->_fftComplexSize * sizeof(float));
-	}
 
 	// Prepare IR
 	conv->_segmentsIRRe = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsIRIm = (float**)malloc(conv->_segCount * sizeof(float*));
+	// Input and IR spectra plus the accumulators share one aligned arena
+	const unsigned int stride = spectrumArenaStride(conv->_fftComplexSize);
+	conv->_arena = spectrumArenaAlloc((size_t)stride * (conv->_segCount * 4 + 2));
+	if (!conv->_arena)
+		return 0;
+	float **const inputRows[2] = { conv->_segmentsRe, conv->_segmentsIm };
+	float **const irRows[2] = { conv->_segmentsIRRe, conv->_segmentsIRIm };
+	float *row = spectrumArenaCarve(conv->_arena, stride, conv->_segCount, inputRows, 2);
+	row = spectrumArenaCarve(row, stride, conv->_segCount, irRows, 2);
+	conv->_preMultiplied[0] = row;
+	conv->_preMultiplied[1] = row + stride;
 	for (unsigned int i = 0; i < conv->_segCount; ++i)
 	{
-		float* segmentRe = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		float* segmentIm = (float*)malloc(conv->_fftComplexSize * sizeof(float));
+		float* segmentRe = conv->_segmentsIRRe[i];
+		float* segmentIm = conv->_segmentsIRIm[i];
 		const unsigned int remaining = irLen - (i * conv->_blockSize);
 		const unsigned int sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (unsigned int j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[conv->bit[j]] = ir[i*conv->_blockSize + j];
-		for (unsigned int j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer, conv->sine);
-		segmentRe[0] = conv->_fftBuffer[0] * 2.0f;
-		segmentIm[0] = 0.0f;
-		for (unsigned int j = 1; j < conv->_fftComplexSize; j++)
-		{
-			unsigned int symIdx = conv->_segSize - j;
-			segmentRe[j] = conv->_fftBuffer[j] + conv->_fftBuffer[symIdx];
-			segmentIm[j] = conv->_fftBuffer[j] - conv->_fftBuffer[symIdx];
-		}
-		conv->_segmentsIRRe[i] = segmentRe;
-		conv->_segmentsIRIm[i] = segmentIm;
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer, ir + i * conv->_blockSize, sizeCopy, segmentRe, segmentIm);
+		segmentRe[0] *= 2.0f;
 	}
 
 	// Prepare convolution buffers
-	conv->_preMultiplied[0] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	conv->_preMultiplied[1] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[0], 0, conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[1], 0, conv->_fftComplexSize * sizeof(float));
 	conv->_overlap = (float*)malloc(conv->_blockSize * sizeof(float));
 	memset(conv->_overlap, 0, conv->_blockSize * sizeof(float));
 
@@ -506,19 +1034,8 @@ int FFTConvolver1x1RefreshImpulseResponse(FFTConvolver1x1 *conv, unsigned int bl
 		float* segmentIm = conv->_segmentsIRIm[i];
 		const unsigned int remaining = irLen - (i * conv->_blockSize);
 		const unsigned int sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (unsigned int j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[conv->bit[j]] = ir[i*conv->_blockSize + j];
-		for (unsigned int j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer, conv->sine);
-		segmentRe[0] = conv->_fftBuffer[0] * 2.0f;
-		segmentIm[0] = 0.0f;
-		for (unsigned int j = 1; j < conv->_fftComplexSize; j++)
-		{
-			unsigned int symIdx = conv->_segSize - j;
-			segmentRe[j] = conv->_fftBuffer[j] + conv->_fftBuffer[symIdx];
-			segmentIm[j] = conv->_fftBuffer[j] - conv->_fftBuffer[symIdx];
-		}
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer, ir + i * conv->_blockSize, sizeCopy, segmentRe, segmentIm);
+		segmentRe[0] *= 2.0f;
 	}
 	return 1;
 }
@@ -529,79 +1046,31 @@ int FFTConvolver2x4x2LoadImpulseResponse(FFTConvolver2x4x2 *conv, unsigned int b
 	if (irLen == 0)
 		return 0;
 
-	if (conv->bit)
+	if (conv->slot)
 		FFTConvolver2x4x2Free(conv);
 
-	conv->_blockSize = upper_power_of_two(blockSize);
+	conv->_blockSize = FHTPlanBlockSize(blockSize);
 	conv->_segSize = 2 * conv->_blockSize;
 	conv->_segCount = (unsigned int)ceil((double)irLen / (double)conv->_blockSize);
 	conv->_segCountMinus1 = conv->_segCount - 1;
 	conv->_fftComplexSize = (conv->_segSize >> 1) + 1;
 
 	// FFT
-	if (conv->_segSize == 2)
-		conv->fft = DFT2;
-	else if (conv->_segSize == 4)
-		conv->fft = DFT4;
-	else if (conv->_segSize == 8)
-		conv->fft = DFT8;
-	else if (conv->_segSize == 16)
-		conv->fft = DFT16;
-	else if (conv->_segSize == 32)
-		conv->fft = DFT32;
-	else if (conv->_segSize == 64)
-		conv->fft = DFT64;
-	else if (conv->_segSize == 128)
-		conv->fft = DFT128;
-	else if (conv->_segSize == 256)
-		conv->fft = DFT256;
-	else if (conv->_segSize == 512)
-		conv->fft = DFT512;
-	else if (conv->_segSize == 1024)
-		conv->fft = DFT1024;
-	else if (conv->_segSize == 2048)
-		conv->fft = DFT2048;
-	else if (conv->_segSize == 4096)
-		conv->fft = DFT4096;
-	else if (conv->_segSize == 8192)
-		conv->fft = DFT8192;
-	else if (conv->_segSize == 16384)
-		conv->fft = DFT16384;
-	else if (conv->_segSize == 32768)
-		conv->fft = DFT32768;
-	else if (conv->_segSize == 65536)
-		conv->fft = DFT65536;
-	else if (conv->_segSize == 131072)
-		conv->fft = DFT131072;
-	else if (conv->_segSize == 262144)
-		conv->fft = DFT262144;
-	else if (conv->_segSize == 524288)
-		conv->fft = DFT524288;
-	else if (conv->_segSize == 1048576)
-		conv->fft = DFT1048576;
-	conv->bit = (unsigned int*)malloc(conv->_segSize * sizeof(unsigned int));
-	conv->sine = (float*)malloc(conv->_segSize * sizeof(float));
-	fhtbitReversalTbl(conv->bit, conv->_segSize);
-	fhtsinHalfTblFloat(conv->sine, conv->_segSize);
+	conv->plan = FHTPlanAcquire(conv->_segSize);
+	if (!conv->plan)
+		return 0;
+	conv->slot = conv->plan->slot;
+	conv->sine = conv->plan->sine;
 	conv->_fftBuffer[0] = (float*)malloc(conv->_segSize * sizeof(float));
 	conv->_fftBuffer[1] = (float*)malloc(conv->_segSize * sizeof(float));
+	if (conv->plan->fft && conv->_segSize >= FFTCONV_PAIRED_FHT_MINSIZE)
+		conv->_fftPairBuffer = (float*)malloc(conv->_segSize * 2 * sizeof(float));
 
 	// Prepare segments
 	conv->_segmentsReLeft = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsImLeft = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsReRight = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsImRight = (float**)malloc(conv->_segCount * sizeof(float*));
-	for (unsigned int i = 0; i < conv->_segCount; ++i)
-	{
-		conv->_segmentsReLeft[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		conv->_segmentsImLeft[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsReLeft[i], 0, conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsImLeft[i], 0, conv->_fftComplexSize * sizeof(float));
-		conv->_segmentsReRight[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		conv->_segmentsImRight[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsReRight[i], 0, conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsImRight[i], 0, conv->_fftComplexSize * sizeof(float));
-	}
 
 	// Prepare IR
 	conv->_segmentsLLIRRe = (float**)malloc(conv->_segCount * sizeof(float*));
@@ -612,99 +1081,63 @@ int FFTConvolver2x4x2LoadImpulseResponse(FFTConvolver2x4x2 *conv, unsigned int b
 	conv->_segmentsRLIRIm = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsRRIRRe = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsRRIRIm = (float**)malloc(conv->_segCount * sizeof(float*));
+	// Input spectra, the resident IR spectra and the accumulators share one aligned arena
+	const unsigned int stride = spectrumArenaStride(conv->_fftComplexSize);
+	const unsigned int resident = spectrumStreamBegin(&conv->_stream, conv->_segCount, 8, stride);
+	conv->_arena = spectrumArenaAlloc((size_t)stride * (conv->_segCount * 4 + resident * 8 + 4));
+	if (!conv->_arena)
+		return 0;
+	float **const inputRows[4] = { conv->_segmentsReLeft, conv->_segmentsImLeft, conv->_segmentsReRight, conv->_segmentsImRight };
+	float **const irRows[8] = { conv->_segmentsLLIRRe, conv->_segmentsLLIRIm, conv->_segmentsLRIRRe, conv->_segmentsLRIRIm, conv->_segmentsRLIRRe, conv->_segmentsRLIRIm, conv->_segmentsRRIRRe, conv->_segmentsRRIRIm };
+	float *row = spectrumArenaCarve(conv->_arena, stride, conv->_segCount, inputRows, 4);
+	row = spectrumArenaCarve(row, stride, resident, irRows, 8);
+	spectrumStreamCarve(&conv->_stream, conv->_segCount, irRows, 8, stride);
+	conv->_preMultiplied[0][0] = row;
+	conv->_preMultiplied[0][1] = row + stride;
+	conv->_preMultiplied[1][0] = row + 2 * stride;
+	conv->_preMultiplied[1][1] = row + 3 * stride;
 	for (unsigned int i = 0; i < conv->_segCount; ++i)
 	{
-		unsigned int j, symIdx;
-		float* segmentLLRe = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		float* segmentLLIm = (float*)malloc(conv->_fftComplexSize * sizeof(float));
+		float* segmentLLRe = conv->_segmentsLLIRRe[i];
+		float* segmentLLIm = conv->_segmentsLLIRIm[i];
 		unsigned int remaining = irLen - (i * conv->_blockSize);
 		unsigned int sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = irLL[i*conv->_blockSize + j];
-		for (j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		segmentLLRe[0] = conv->_fftBuffer[0][0] * 2.0f;
-		segmentLLIm[0] = 0.0f;
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			segmentLLRe[j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			segmentLLIm[j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-		}
-		conv->_segmentsLLIRRe[i] = segmentLLRe;
-		conv->_segmentsLLIRIm[i] = segmentLLIm;
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], irLL + i * conv->_blockSize, sizeCopy, segmentLLRe, segmentLLIm);
+		segmentLLRe[0] *= 2.0f;
 		//
-		float* segmentLRRe = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		float* segmentLRIm = (float*)malloc(conv->_fftComplexSize * sizeof(float));
+		float* segmentLRRe = conv->_segmentsLRIRRe[i];
+		float* segmentLRIm = conv->_segmentsLRIRIm[i];
 		remaining = irLen - (i * conv->_blockSize);
 		sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = irLR[i*conv->_blockSize + j];
-		for (j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		segmentLRRe[0] = conv->_fftBuffer[0][0] * 2.0f;
-		segmentLRIm[0] = 0.0f;
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			segmentLRRe[j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			segmentLRIm[j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-		}
-		conv->_segmentsLRIRRe[i] = segmentLRRe;
-		conv->_segmentsLRIRIm[i] = segmentLRIm;
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], irLR + i * conv->_blockSize, sizeCopy, segmentLRRe, segmentLRIm);
+		segmentLRRe[0] *= 2.0f;
 		//
-		float* segmentRLRe = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		float* segmentRLIm = (float*)malloc(conv->_fftComplexSize * sizeof(float));
+		float* segmentRLRe = conv->_segmentsRLIRRe[i];
+		float* segmentRLIm = conv->_segmentsRLIRIm[i];
 		remaining = irLen - (i * conv->_blockSize);
 		sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = irRL[i*conv->_blockSize + j];
-		for (j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		segmentRLRe[0] = conv->_fftBuffer[0][0] * 2.0f;
-		segmentRLIm[0] = 0.0f;
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			segmentRLRe[j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			segmentRLIm[j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-		}
-		conv->_segmentsRLIRRe[i] = segmentRLRe;
-		conv->_segmentsRLIRIm[i] = segmentRLIm;
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], irRL + i * conv->_blockSize, sizeCopy, segmentRLRe, segmentRLIm);
+		segmentRLRe[0] *= 2.0f;
 		//
-		float* segmentRRRe = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		float* segmentRRIm = (float*)malloc(conv->_fftComplexSize * sizeof(float));
+		float* segmentRRRe = conv->_segmentsRRIRRe[i];
+		float* segmentRRIm = conv->_segmentsRRIRIm[i];
 		remaining = irLen - (i * conv->_blockSize);
 		sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = irRR[i*conv->_blockSize + j];
-		for (j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		segmentRRRe[0] = conv->_fftBuffer[0][0] * 2.0f;
-		segmentRRIm[0] = 0.0f;
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			segmentRRRe[j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			segmentRRIm[j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-		}
-		conv->_segmentsRRIRRe[i] = segmentRRRe;
-		conv->_segmentsRRIRIm[i] = segmentRRIm;
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], irRR + i * conv->_blockSize, sizeCopy, segmentRRRe, segmentRRIm);
+		segmentRRRe[0] *= 2.0f;
+		if (i >= resident)
+			spectrumStreamStore(&conv->_stream, i);
+	}
+	if (!spectrumStreamEnd(&conv->_stream, conv->_segCount, irRows, 8, stride))
+	{
+		// The file could not be written or mapped, keep every spectrum in the arena instead
+		conv->_stream.enabled = 0;
+		const int ret = FFTConvolver2x4x2LoadImpulseResponse(conv, blockSize, irLL, irLR, irRL, irRR, irLen);
+		conv->_stream.enabled = 1;
+		return ret;
 	}
 
 	// Prepare convolution buffers
-	conv->_preMultiplied[0][0] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	conv->_preMultiplied[0][1] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	conv->_preMultiplied[1][0] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	conv->_preMultiplied[1][1] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[0][0], 0, conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[0][1], 0, conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[1][0], 0, conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[1][1], 0, conv->_fftComplexSize * sizeof(float));
 	conv->_overlap[0] = (float*)malloc(conv->_blockSize * sizeof(float));
 	memset(conv->_overlap[0], 0, conv->_blockSize * sizeof(float));
 	conv->_overlap[1] = (float*)malloc(conv->_blockSize * sizeof(float));
@@ -729,138 +1162,91 @@ int FFTConvolver2x2LoadImpulseResponse(FFTConvolver2x2 *conv, unsigned int block
 	if (irLen == 0)
 		return 0;
 
-	if (conv->bit)
+	if (conv->slot)
 		FFTConvolver2x2Free(conv);
 
-	conv->_blockSize = upper_power_of_two(blockSize);
+	conv->_blockSize = FHTPlanBlockSize(blockSize);
 	conv->_segSize = 2 * conv->_blockSize;
 	conv->_segCount = (unsigned int)ceil((double)irLen / (double)conv->_blockSize);
 	conv->_segCountMinus1 = conv->_segCount - 1;
 	conv->_fftComplexSize = (conv->_segSize >> 1) + 1;
 
 	// FFT
-	if (conv->_segSize == 2)
-		conv->fft = DFT2;
-	else if (conv->_segSize == 4)
-		conv->fft = DFT4;
-	else if (conv->_segSize == 8)
-		conv->fft = DFT8;
-	else if (conv->_segSize == 16)
-		conv->fft = DFT16;
-	else if (conv->_segSize == 32)
-		conv->fft = DFT32;
-	else if (conv->_segSize == 64)
-		conv->fft = DFT64;
-	else if (conv->_segSize == 128)
-		conv->fft = DFT128;
-	else if (conv->_segSize == 256)
-		conv->fft = DFT256;
-	else if (conv->_segSize == 512)
-		conv->fft = DFT512;
-	else if (conv->_segSize == 1024)
-		conv->fft = DFT1024;
-	else if (conv->_segSize == 2048)
-		conv->fft = DFT2048;
-	else if (conv->_segSize == 4096)
-		conv->fft = DFT4096;
-	else if (conv->_segSize == 8192)
-		conv->fft = DFT8192;
-	else if (conv->_segSize == 16384)
-		conv->fft = DFT16384;
-	else if (conv->_segSize == 32768)
-		conv->fft = DFT32768;
-	else if (conv->_segSize == 65536)
-		conv->fft = DFT65536;
-	else if (conv->_segSize == 131072)
-		conv->fft = DFT131072;
-	else if (conv->_segSize == 262144)
-		conv->fft = DFT262144;
-	else if (conv->_segSize == 524288)
-		conv->fft = DFT524288;
-	else if (conv->_segSize == 1048576)
-		conv->fft = DFT1048576;
-	conv->bit = (unsigned int*)malloc(conv->_segSize * sizeof(unsigned int));
-	conv->sine = (float*)malloc(conv->_segSize * sizeof(float));
-	fhtbitReversalTbl(conv->bit, conv->_segSize);
-	fhtsinHalfTblFloat(conv->sine, conv->_segSize);
+	conv->plan = FHTPlanAcquire(conv->_segSize);
+	if (!conv->plan)
+		return 0;
+	conv->slot = conv->plan->slot;
+	conv->sine = conv->plan->sine;
 	conv->_fftBuffer[0] = (float*)malloc(conv->_segSize * sizeof(float));
 	conv->_fftBuffer[1] = (float*)malloc(conv->_segSize * sizeof(float));
+	if (conv->plan->fft && conv->_segSize >= FFTCONV_PAIRED_FHT_MINSIZE)
+		conv->_fftPairBuffer = (float*)malloc(conv->_segSize * 2 * sizeof(float));
 
 	// Prepare segments
 	conv->_segmentsReLeft = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsImLeft = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsReRight = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsImRight = (float**)malloc(conv->_segCount * sizeof(float*));
-	for (unsigned int i = 0; i < conv->_segCount; ++i)
-	{
-		conv->_segmentsReLeft[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		conv->_segmentsImLeft[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsReLeft[i], 0, conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsImLeft[i], 0, conv->_fftComplexSize * sizeof(float));
-		conv->_segmentsReRight[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		conv->_segmentsImRight[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsReRight[i], 0, conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsImRight[i], 0, conv->_fftComplexSize * sizeof(float));
-	}
 
 	// Prepare IR
 	conv->_segmentsLLIRRe = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsLLIRIm = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsRRIRRe = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsRRIRIm = (float**)malloc(conv->_segCount * sizeof(float*));
+	// Input spectra, the resident IR spectra and the accumulators share one aligned arena
+	const unsigned int stride = spectrumArenaStride(conv->_fftComplexSize);
+	// Identical channels keep a single IR spectrum, the RR rows alias the LL rows
+	conv->_sharedIR = irL == irR || !memcmp(irL, irR, irLen * sizeof(float));
+	const unsigned int irRowCount = conv->_sharedIR ? 2 : 4;
+	const unsigned int resident = spectrumStreamBegin(&conv->_stream, conv->_segCount, irRowCount, stride);
+	conv->_arena = spectrumArenaAlloc((size_t)stride * (conv->_segCount * 4 + resident * irRowCount + 4));
+	if (!conv->_arena)
+		return 0;
+	float **const inputRows[4] = { conv->_segmentsReLeft, conv->_segmentsImLeft, conv->_segmentsReRight, conv->_segmentsImRight };
+	float **const irRows[4] = { conv->_segmentsLLIRRe, conv->_segmentsLLIRIm, conv->_segmentsRRIRRe, conv->_segmentsRRIRIm };
+	float *row = spectrumArenaCarve(conv->_arena, stride, conv->_segCount, inputRows, 4);
+	row = spectrumArenaCarve(row, stride, resident, irRows, irRowCount);
+	spectrumStreamCarve(&conv->_stream, conv->_segCount, irRows, irRowCount, stride);
+	conv->_preMultiplied[0][0] = row;
+	conv->_preMultiplied[0][1] = row + stride;
+	conv->_preMultiplied[1][0] = row + 2 * stride;
+	conv->_preMultiplied[1][1] = row + 3 * stride;
 	for (unsigned int i = 0; i < conv->_segCount; ++i)
 	{
-		unsigned int j, symIdx;
-		float* segmentLLRe = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		float* segmentLLIm = (float*)malloc(conv->_fftComplexSize * sizeof(float));
+		float* segmentLLRe = conv->_segmentsLLIRRe[i];
+		float* segmentLLIm = conv->_segmentsLLIRIm[i];
 		unsigned int remaining = irLen - (i * conv->_blockSize);
 		unsigned int sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = irL[i*conv->_blockSize + j];
-		for (j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		segmentLLRe[0] = conv->_fftBuffer[0][0] * 2.0f;
-		segmentLLIm[0] = 0.0f;
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			segmentLLRe[j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			segmentLLIm[j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-		}
-		conv->_segmentsLLIRRe[i] = segmentLLRe;
-		conv->_segmentsLLIRIm[i] = segmentLLIm;
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], irL + i * conv->_blockSize, sizeCopy, segmentLLRe, segmentLLIm);
+		segmentLLRe[0] *= 2.0f;
 		//
-		float* segmentRRRe = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		float* segmentRRIm = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		remaining = irLen - (i * conv->_blockSize);
-		sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = irR[i*conv->_blockSize + j];
-		for (j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		segmentRRRe[0] = conv->_fftBuffer[0][0] * 2.0f;
-		segmentRRIm[0] = 0.0f;
-		for (j = 1; j < conv->_fftComplexSize; j++)
+		if (!conv->_sharedIR)
 		{
-			symIdx = conv->_segSize - j;
-			segmentRRRe[j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			segmentRRIm[j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
+			float* segmentRRRe = conv->_segmentsRRIRRe[i];
+			float* segmentRRIm = conv->_segmentsRRIRIm[i];
+			remaining = irLen - (i * conv->_blockSize);
+			sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
+			fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], irR + i * conv->_blockSize, sizeCopy, segmentRRRe, segmentRRIm);
+			segmentRRRe[0] *= 2.0f;
 		}
-		conv->_segmentsRRIRRe[i] = segmentRRRe;
-		conv->_segmentsRRIRIm[i] = segmentRRIm;
+		if (i >= resident)
+			spectrumStreamStore(&conv->_stream, i);
+	}
+	if (!spectrumStreamEnd(&conv->_stream, conv->_segCount, irRows, irRowCount, stride))
+	{
+		// The file could not be written or mapped, keep every spectrum in the arena instead
+		conv->_stream.enabled = 0;
+		const int ret = FFTConvolver2x2LoadImpulseResponse(conv, blockSize, irL, irR, irLen);
+		conv->_stream.enabled = 1;
+		return ret;
+	}
+	if (conv->_sharedIR)
+	{
+		memcpy(conv->_segmentsRRIRRe, conv->_segmentsLLIRRe, conv->_segCount * sizeof(float*));
+		memcpy(conv->_segmentsRRIRIm, conv->_segmentsLLIRIm, conv->_segCount * sizeof(float*));
 	}
 
 	// Prepare convolution buffers
-	conv->_preMultiplied[0][0] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	conv->_preMultiplied[0][1] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	conv->_preMultiplied[1][0] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	conv->_preMultiplied[1][1] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[0][0], 0, conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[0][1], 0, conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[1][0], 0, conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[1][1], 0, conv->_fftComplexSize * sizeof(float));
 	conv->_overlap[0] = (float*)malloc(conv->_blockSize * sizeof(float));
 	memset(conv->_overlap[0], 0, conv->_blockSize * sizeof(float));
 	conv->_overlap[1] = (float*)malloc(conv->_blockSize * sizeof(float));
@@ -884,44 +1270,28 @@ int FFTConvolver2x2RefreshImpulseResponse(FFTConvolver2x2 *conv, unsigned int bl
 		return 0;
 	if (irLen == 0)
 		return 0;
+	if (conv->_sharedIR && irL != irR && memcmp(irL, irR, irLen * sizeof(float)))
+		return 0;
+	// Streamed spectra are mapped read only
+	if (conv->_stream.bytes)
+		return 0;
 	for (unsigned int i = 0; i < conv->_segCount; ++i)
 	{
-		unsigned int j, symIdx;
 		float* segmentLLRe = conv->_segmentsLLIRRe[i];
 		float* segmentLLIm = conv->_segmentsLLIRIm[i];
 		unsigned int remaining = irLen - (i * conv->_blockSize);
 		unsigned int sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = irL[i*conv->_blockSize + j];
-		for (j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		segmentLLRe[0] = conv->_fftBuffer[0][0] * 2.0f;
-		segmentLLIm[0] = 0.0f;
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			segmentLLRe[j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			segmentLLIm[j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-		}
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], irL + i * conv->_blockSize, sizeCopy, segmentLLRe, segmentLLIm);
+		segmentLLRe[0] *= 2.0f;
 		//
+		if (conv->_sharedIR)
+			continue;
 		float* segmentRRRe = conv->_segmentsRRIRRe[i];
 		float* segmentRRIm = conv->_segmentsRRIRIm[i];
 		remaining = irLen - (i * conv->_blockSize);
 		sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = irR[i*conv->_blockSize + j];
-		for (j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		segmentRRRe[0] = conv->_fftBuffer[0][0] * 2.0f;
-		segmentRRIm[0] = 0.0f;
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			segmentRRRe[j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			segmentRRIm[j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-		}
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], irR + i * conv->_blockSize, sizeCopy, segmentRRRe, segmentRRIm);
+		segmentRRRe[0] *= 2.0f;
 	}
 	return 1;
 }
@@ -932,132 +1302,66 @@ int FFTConvolver1x2LoadImpulseResponse(FFTConvolver1x2 *conv, unsigned int block
 	if (irLen == 0)
 		return 0;
 
-	if (conv->bit)
+	if (conv->slot)
 		FFTConvolver1x2Free(conv);
 
-	conv->_blockSize = upper_power_of_two(blockSize);
+	conv->_blockSize = FHTPlanBlockSize(blockSize);
 	conv->_segSize = 2 * conv->_blockSize;
 	conv->_segCount = (unsigned int)ceil((double)irLen / (double)conv->_blockSize);
 	conv->_segCountMinus1 = conv->_segCount - 1;
 	conv->_fftComplexSize = (conv->_segSize >> 1) + 1;
 
 	// FFT
-	if (conv->_segSize == 2)
-		conv->fft = DFT2;
-	else if (conv->_segSize == 4)
-		conv->fft = DFT4;
-	else if (conv->_segSize == 8)
-		conv->fft = DFT8;
-	else if (conv->_segSize == 16)
-		conv->fft = DFT16;
-	else if (conv->_segSize == 32)
-		conv->fft = DFT32;
-	else if (conv->_segSize == 64)
-		conv->fft = DFT64;
-	else if (conv->_segSize == 128)
-		conv->fft = DFT128;
-	else if (conv->_segSize == 256)
-		conv->fft = DFT256;
-	else if (conv->_segSize == 512)
-		conv->fft = DFT512;
-	else if (conv->_segSize == 1024)
-		conv->fft = DFT1024;
-	else if (conv->_segSize == 2048)
-		conv->fft = DFT2048;
-	else if (conv->_segSize == 4096)
-		conv->fft = DFT4096;
-	else if (conv->_segSize == 8192)
-		conv->fft = DFT8192;
-	else if (conv->_segSize == 16384)
-		conv->fft = DFT16384;
-	else if (conv->_segSize == 32768)
-		conv->fft = DFT32768;
-	else if (conv->_segSize == 65536)
-		conv->fft = DFT65536;
-	else if (conv->_segSize == 131072)
-		conv->fft = DFT131072;
-	else if (conv->_segSize == 262144)
-		conv->fft = DFT262144;
-	else if (conv->_segSize == 524288)
-		conv->fft = DFT524288;
-	else if (conv->_segSize == 1048576)
-		conv->fft = DFT1048576;
-	conv->bit = (unsigned int*)malloc(conv->_segSize * sizeof(unsigned int));
-	conv->sine = (float*)malloc(conv->_segSize * sizeof(float));
-	fhtbitReversalTbl(conv->bit, conv->_segSize);
-	fhtsinHalfTblFloat(conv->sine, conv->_segSize);
+	conv->plan = FHTPlanAcquire(conv->_segSize);
+	if (!conv->plan)
+		return 0;
+	conv->slot = conv->plan->slot;
+	conv->sine = conv->plan->sine;
 	conv->_fftBuffer[0] = (float*)malloc(conv->_segSize * sizeof(float));
 	conv->_fftBuffer[1] = (float*)malloc(conv->_segSize * sizeof(float));
+	if (conv->plan->fft && conv->_segSize >= FFTCONV_PAIRED_FHT_MINSIZE)
+		conv->_fftPairBuffer = (float*)malloc(conv->_segSize * 2 * sizeof(float));
 
 	// Prepare segments
 	conv->_segmentsRe = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsIm = (float**)malloc(conv->_segCount * sizeof(float*));
-	for (unsigned int i = 0; i < conv->_segCount; ++i)
-	{
-		conv->_segmentsRe[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		conv->_segmentsIm[i] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsRe[i], 0, conv->_fftComplexSize * sizeof(float));
-		memset(conv->_segmentsIm[i], 0, conv->_fftComplexSize * sizeof(float));
-	}
 
 	// Prepare IR
 	conv->_segmentsLLIRRe = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsLLIRIm = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsRRIRRe = (float**)malloc(conv->_segCount * sizeof(float*));
 	conv->_segmentsRRIRIm = (float**)malloc(conv->_segCount * sizeof(float*));
+	// Input and IR spectra plus the accumulators share one aligned arena
+	const unsigned int stride = spectrumArenaStride(conv->_fftComplexSize);
+	conv->_arena = spectrumArenaAlloc((size_t)stride * (conv->_segCount * 6 + 4));
+	if (!conv->_arena)
+		return 0;
+	float **const inputRows[2] = { conv->_segmentsRe, conv->_segmentsIm };
+	float **const irRows[4] = { conv->_segmentsLLIRRe, conv->_segmentsLLIRIm, conv->_segmentsRRIRRe, conv->_segmentsRRIRIm };
+	float *row = spectrumArenaCarve(conv->_arena, stride, conv->_segCount, inputRows, 2);
+	row = spectrumArenaCarve(row, stride, conv->_segCount, irRows, 4);
+	conv->_preMultiplied[0][0] = row;
+	conv->_preMultiplied[0][1] = row + stride;
+	conv->_preMultiplied[1][0] = row + 2 * stride;
+	conv->_preMultiplied[1][1] = row + 3 * stride;
 	for (unsigned int i = 0; i < conv->_segCount; ++i)
 	{
-		unsigned int j, symIdx;
-		float* segmentLLRe = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		float* segmentLLIm = (float*)malloc(conv->_fftComplexSize * sizeof(float));
+		float* segmentLLRe = conv->_segmentsLLIRRe[i];
+		float* segmentLLIm = conv->_segmentsLLIRIm[i];
 		unsigned int remaining = irLen - (i * conv->_blockSize);
 		unsigned int sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = irL[i*conv->_blockSize + j];
-		for (j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		segmentLLRe[0] = conv->_fftBuffer[0][0] * 2.0f;
-		segmentLLIm[0] = 0.0f;
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			segmentLLRe[j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			segmentLLIm[j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-		}
-		conv->_segmentsLLIRRe[i] = segmentLLRe;
-		conv->_segmentsLLIRIm[i] = segmentLLIm;
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], irL + i * conv->_blockSize, sizeCopy, segmentLLRe, segmentLLIm);
+		segmentLLRe[0] *= 2.0f;
 		//
-		float* segmentRRRe = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-		float* segmentRRIm = (float*)malloc(conv->_fftComplexSize * sizeof(float));
+		float* segmentRRRe = conv->_segmentsRRIRRe[i];
+		float* segmentRRIm = conv->_segmentsRRIRIm[i];
 		remaining = irLen - (i * conv->_blockSize);
 		sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
-		for (j = 0; j < sizeCopy; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = irR[i*conv->_blockSize + j];
-		for (j = sizeCopy; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		segmentRRRe[0] = conv->_fftBuffer[0][0] * 2.0f;
-		segmentRRIm[0] = 0.0f;
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			segmentRRRe[j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			segmentRRIm[j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-		}
-		conv->_segmentsRRIRRe[i] = segmentRRRe;
-		conv->_segmentsRRIRIm[i] = segmentRRIm;
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], irR + i * conv->_blockSize, sizeCopy, segmentRRRe, segmentRRIm);
+		segmentRRRe[0] *= 2.0f;
 	}
 
 	// Prepare convolution buffers
-	conv->_preMultiplied[0][0] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	conv->_preMultiplied[0][1] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	conv->_preMultiplied[1][0] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	conv->_preMultiplied[1][1] = (float*)malloc(conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[0][0], 0, conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[0][1], 0, conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[1][0], 0, conv->_fftComplexSize * sizeof(float));
-	memset(conv->_preMultiplied[1][1], 0, conv->_fftComplexSize * sizeof(float));
 	conv->_overlap[0] = (float*)malloc(conv->_blockSize * sizeof(float));
 	memset(conv->_overlap[0], 0, conv->_blockSize * sizeof(float));
 	conv->_overlap[1] = (float*)malloc(conv->_blockSize * sizeof(float));
@@ -1075,7 +1379,7 @@ int FFTConvolver1x2LoadImpulseResponse(FFTConvolver1x2 *conv, unsigned int block
 }
 void FFTConvolver1x1Process(FFTConvolver1x1 *conv, const float* input, float* output, unsigned int len)
 {
-	unsigned int j, symIdx;
+	unsigned int j;
 	unsigned int processed = 0;
 	while (processed < len)
 	{
@@ -1085,25 +1389,14 @@ void FFTConvolver1x1Process(FFTConvolver1x1 *conv, const float* input, float* ou
 		memcpy(conv->_inputBuffer + inputBufferPos, input + processed, processing * sizeof(float));
 
 		// Forward FFT
-		for (j = 0; j < conv->_blockSize; j++)
-			conv->_fftBuffer[conv->bit[j]] = conv->_inputBuffer[j];
-		for (j = conv->_blockSize; j < conv->_segSize; j++)
-			conv->_fftBuffer[conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer, conv->sine);
-		conv->_segmentsRe[conv->_current][0] = conv->_fftBuffer[0];
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			conv->_segmentsRe[conv->_current][j] = conv->_fftBuffer[j] + conv->_fftBuffer[symIdx];
-			conv->_segmentsIm[conv->_current][j] = conv->_fftBuffer[j] - conv->_fftBuffer[symIdx];
-		}
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer, conv->_inputBuffer, conv->_blockSize, conv->_segmentsRe[conv->_current], conv->_segmentsIm[conv->_current]);
 
 		// Complex multiplication
 		const float *reA;
 		const float *imA;
 		const float *reB;
 		const float *imB;
-		unsigned int end4 = conv->_fftComplexSize - 1;
+		unsigned int end4 = (conv->_fftComplexSize - 1) & ~3u;
 		if (inputBufferWasEmpty)
 		{
 			unsigned int segFrameIndex = (conv->_current + 1) % conv->_segCount;
@@ -1126,8 +1419,11 @@ void FFTConvolver1x1Process(FFTConvolver1x1 *conv, const float* input, float* ou
 					im[j + 2] = reA[j + 2] * imB[j + 2] + imA[j + 2] * reB[j + 2];
 					im[j + 3] = reA[j + 3] * imB[j + 3] + imA[j + 3] * reB[j + 3];
 				}
-				re[end4] = reA[end4] * reB[end4] - imA[end4] * imB[end4];
-				im[end4] = reA[end4] * imB[end4] + imA[end4] * reB[end4];
+				for (j = end4; j < conv->_fftComplexSize; j++)
+				{
+					re[j] = reA[j] * reB[j] - imA[j] * imB[j];
+					im[j] = reA[j] * imB[j] + imA[j] * reB[j];
+				}
 				for (unsigned int i = 2; i < conv->_segCount; ++i)
 				{
 					segFrameIndex = (conv->_current + i) % conv->_segCount;
@@ -1148,8 +1444,11 @@ void FFTConvolver1x1Process(FFTConvolver1x1 *conv, const float* input, float* ou
 						im[j + 2] += reA[j + 2] * imB[j + 2] + imA[j + 2] * reB[j + 2];
 						im[j + 3] += reA[j + 3] * imB[j + 3] + imA[j + 3] * reB[j + 3];
 					}
-					re[end4] += reA[end4] * reB[end4] - imA[end4] * imB[end4];
-					im[end4] += reA[end4] * imB[end4] + imA[end4] * reB[end4];
+					for (j = end4; j < conv->_fftComplexSize; j++)
+					{
+						re[j] += reA[j] * reB[j] - imA[j] * imB[j];
+						im[j] += reA[j] * imB[j] + imA[j] * reB[j];
+					}
 				}
 			}
 		}
@@ -1163,14 +1462,13 @@ void FFTConvolver1x1Process(FFTConvolver1x1 *conv, const float* input, float* ou
 		conv->_fftBuffer[0] = reB[0] * reA[0] + srcRe[0];
 		for (j = 1; j < conv->_fftComplexSize; ++j)
 		{
-			symIdx = conv->_segSize - j;
 			real = reB[j] * reA[j] - imB[j] * imA[j] + srcRe[j];
 			imag = reB[j] * imA[j] + imB[j] * reA[j] + srcIm[j];
-			conv->_fftBuffer[conv->bit[j]] = (real + imag) * 0.5f;
-			conv->_fftBuffer[conv->bit[symIdx]] = (real - imag) * 0.5f;
+			conv->_fftBuffer[conv->slot[j << 1]] = (real + imag) * 0.5f;
+			conv->_fftBuffer[conv->slot[(j << 1) + 1]] = (real - imag) * 0.5f;
 		}
 		// Backward FFT
-		conv->fft(conv->_fftBuffer, conv->sine);
+		FHTPlanInverse(conv->plan, conv->_fftBuffer);
 
 		// Add overlap
 		float *result = output + processed;
@@ -1204,7 +1502,7 @@ void FFTConvolver1x1Process(FFTConvolver1x1 *conv, const float* input, float* ou
 }
 void FFTConvolver2x4x2Process(FFTConvolver2x4x2 *conv, const float* x1, const float* x2, float* y1, float* y2, unsigned int len)
 {
-	unsigned int j, symIdx;
+	unsigned int j;
 	unsigned int processed = 0;
 	while (processed < len)
 	{
@@ -1214,28 +1512,32 @@ void FFTConvolver2x4x2Process(FFTConvolver2x4x2 *conv, const float* x1, const fl
 		memcpy(conv->_inputBuffer[0] + inputBufferPos, x1 + processed, processing * sizeof(float));
 		memcpy(conv->_inputBuffer[1] + inputBufferPos, x2 + processed, processing * sizeof(float));
 
-		// Forward FFT
-		for (j = 0; j < conv->_blockSize; j++)
-		{
-			conv->_fftBuffer[0][conv->bit[j]] = conv->_inputBuffer[0][j];
-			conv->_fftBuffer[1][conv->bit[j]] = conv->_inputBuffer[1][j];
-		}
-		for (j = conv->_blockSize; j < conv->_segSize; j++)
+		// Forward FFT, both channels go through one paired pass when the interleaved workspace exists
+		if (conv->_fftPairBuffer)
 		{
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-			conv->_fftBuffer[1][conv->bit[j]] = 0.0f;
+			float *pair = conv->_fftPairBuffer;
+			for (j = 0; j < conv->_blockSize; j++)
+			{
+				pair[j << 1] = conv->_inputBuffer[0][j];
+				pair[(j << 1) + 1] = conv->_inputBuffer[1][j];
+			}
+			pairedZeroPaddedDIFHartleyFloat(pair, conv->_segSize, conv->sine);
+			conv->_segmentsReLeft[conv->_current][0] = pair[0];
+			conv->_segmentsReRight[conv->_current][0] = pair[1];
+			for (j = 1; j < conv->_fftComplexSize; j++)
+			{
+				const unsigned int p = conv->slot[j << 1] << 1;
+				const unsigned int q = conv->slot[(j << 1) + 1] << 1;
+				conv->_segmentsReLeft[conv->_current][j] = pair[p] + pair[q];
+				conv->_segmentsImLeft[conv->_current][j] = pair[p] - pair[q];
+				conv->_segmentsReRight[conv->_current][j] = pair[p + 1] + pair[q + 1];
+				conv->_segmentsImRight[conv->_current][j] = pair[p + 1] - pair[q + 1];
+			}
 		}
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		conv->_segmentsReLeft[conv->_current][0] = conv->_fftBuffer[0][0];
-		conv->fft(conv->_fftBuffer[1], conv->sine);
-		conv->_segmentsReRight[conv->_current][0] = conv->_fftBuffer[1][0];
-		for (j = 1; j < conv->_fftComplexSize; j++)
+		else
 		{
-			symIdx = conv->_segSize - j;
-			conv->_segmentsReLeft[conv->_current][j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			conv->_segmentsImLeft[conv->_current][j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-			conv->_segmentsReRight[conv->_current][j] = conv->_fftBuffer[1][j] + conv->_fftBuffer[1][symIdx];
-			conv->_segmentsImRight[conv->_current][j] = conv->_fftBuffer[1][j] - conv->_fftBuffer[1][symIdx];
+			fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], conv->_inputBuffer[0], conv->_blockSize, conv->_segmentsReLeft[conv->_current], conv->_segmentsImLeft[conv->_current]);
+			fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[1], conv->_inputBuffer[1], conv->_blockSize, conv->_segmentsReRight[conv->_current], conv->_segmentsImRight[conv->_current]);
 		}
 
 		// Complex multiplication
@@ -1244,12 +1546,14 @@ void FFTConvolver2x4x2Process(FFTConvolver2x4x2 *conv, const float* x1, const fl
 		const float *imBLeft;
 		const float *reBRight;
 		const float *imBRight;
-		unsigned int end4 = conv->_fftComplexSize - 1;
+		unsigned int end4 = (conv->_fftComplexSize - 1) & ~3u;
 		if (inputBufferWasEmpty)
 		{
 			unsigned int segFrameIndex = (conv->_current + 1) % conv->_segCount;
 			if (conv->_segCount > 1)
 			{
+				if (conv->_stream.window)
+					spectrumStreamStep(&conv->_stream, conv->_segCount, 1);
 				float *reLeft = conv->_preMultiplied[0][0];
 				float *imLeft = conv->_preMultiplied[0][1];
 				float *reRight = conv->_preMultiplied[1][0];
@@ -1285,13 +1589,18 @@ void FFTConvolver2x4x2Process(FFTConvolver2x4x2 *conv, const float* x1, const fl
 					imRight[j + 2] = (imALR[j + 2] * reBLeft[j + 2] + reALR[j + 2] * imBLeft[j + 2]) + (reARR[j + 2] * imBRight[j + 2] + imARR[j + 2] * reBRight[j + 2]);
 					imRight[j + 3] = (imALR[j + 3] * reBLeft[j + 3] + reALR[j + 3] * imBLeft[j + 3]) + (reARR[j + 3] * imBRight[j + 3] + imARR[j + 3] * reBRight[j + 3]);
 				}
-				reLeft[end4] = (reARL[end4] * reBRight[end4] - imARL[end4] * imBRight[end4]) + (reALL[end4] * reBLeft[end4] - imALL[end4] * imBLeft[end4]);
-				imLeft[end4] = (imARL[end4] * reBRight[end4] + reARL[end4] * imBRight[end4]) + (reALL[end4] * imBLeft[end4] + imALL[end4] * reBLeft[end4]);
-				reRight[end4] = (reALR[end4] * reBLeft[end4] - imALR[end4] * imBLeft[end4]) + (reARR[end4] * reBRight[end4] - imARR[end4] * imBRight[end4]);
-				imRight[end4] = (imALR[end4] * reBLeft[end4] + reALR[end4] * imBLeft[end4]) + (reARR[end4] * imBRight[end4] + imARR[end4] * reBRight[end4]);
+				for (j = end4; j < conv->_fftComplexSize; j++)
+				{
+					reLeft[j] = (reARL[j] * reBRight[j] - imARL[j] * imBRight[j]) + (reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j]);
+					imLeft[j] = (imARL[j] * reBRight[j] + reARL[j] * imBRight[j]) + (reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j]);
+					reRight[j] = (reALR[j] * reBLeft[j] - imALR[j] * imBLeft[j]) + (reARR[j] * reBRight[j] - imARR[j] * imBRight[j]);
+					imRight[j] = (imALR[j] * reBLeft[j] + reALR[j] * imBLeft[j]) + (reARR[j] * imBRight[j] + imARR[j] * reBRight[j]);
+				}
 				for (unsigned int i = 2; i < conv->_segCount; ++i)
 				{
 					segFrameIndex = (conv->_current + i) % conv->_segCount;
+					if (conv->_stream.window)
+						spectrumStreamStep(&conv->_stream, conv->_segCount, i);
 					reLeft = conv->_preMultiplied[0][0];
 					imLeft = conv->_preMultiplied[0][1];
 					reRight = conv->_preMultiplied[1][0];
@@ -1327,10 +1636,13 @@ void FFTConvolver2x4x2Process(FFTConvolver2x4x2 *conv, const float* x1, const fl
 						imRight[j + 2] += (imALR[j + 2] * reBLeft[j + 2] + reALR[j + 2] * imBLeft[j + 2]) + (reARR[j + 2] * imBRight[j + 2] + imARR[j + 2] * reBRight[j + 2]);
 						imRight[j + 3] += (imALR[j + 3] * reBLeft[j + 3] + reALR[j + 3] * imBLeft[j + 3]) + (reARR[j + 3] * imBRight[j + 3] + imARR[j + 3] * reBRight[j + 3]);
 					}
-					reLeft[end4] += (reARL[end4] * reBRight[end4] - imARL[end4] * imBRight[end4]) + (reALL[end4] * reBLeft[end4] - imALL[end4] * imBLeft[end4]);
-					imLeft[end4] += (imARL[end4] * reBRight[end4] + reARL[end4] * imBRight[end4]) + (reALL[end4] * imBLeft[end4] + imALL[end4] * reBLeft[end4]);
-					reRight[end4] += (reALR[end4] * reBLeft[end4] - imALR[end4] * imBLeft[end4]) + (reARR[end4] * reBRight[end4] - imARR[end4] * imBRight[end4]);
-					imRight[end4] += (imALR[end4] * reBLeft[end4] + reALR[end4] * imBLeft[end4]) + (reARR[end4] * imBRight[end4] + imARR[end4] * reBRight[end4]);
+					for (j = end4; j < conv->_fftComplexSize; j++)
+					{
+						reLeft[j] += (reARL[j] * reBRight[j] - imARL[j] * imBRight[j]) + (reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j]);
+						imLeft[j] += (imARL[j] * reBRight[j] + reARL[j] * imBRight[j]) + (reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j]);
+						reRight[j] += (reALR[j] * reBLeft[j] - imALR[j] * imBLeft[j]) + (reARR[j] * reBRight[j] - imARR[j] * imBRight[j]);
+						imRight[j] += (imALR[j] * reBLeft[j] + reALR[j] * imBLeft[j]) + (reARR[j] * imBRight[j] + imARR[j] * reBRight[j]);
+					}
 				}
 			}
 		}
@@ -1350,24 +1662,38 @@ void FFTConvolver2x4x2Process(FFTConvolver2x4x2 *conv, const float* x1, const fl
 		const float *src1Im = conv->_preMultiplied[0][1];
 		const float *src2Re = conv->_preMultiplied[1][0];
 		const float *src2Im = conv->_preMultiplied[1][1];
+		const unsigned int stride = conv->_fftPairBuffer ? 1 : 0;
+		float *ch0 = conv->_fftPairBuffer ? conv->_fftPairBuffer : conv->_fftBuffer[0];
+		float *ch1 = conv->_fftPairBuffer ? (conv->_fftPairBuffer + 1) : conv->_fftBuffer[1];
 		float realL, imagL, realR, imagR;
-		conv->_fftBuffer[0][0] = (reARL[0] * reBRight[0]) + (reALL[0] * reBLeft[0]) + src1Re[0];
-		conv->_fftBuffer[1][0] = (reALR[0] * reBLeft[0]) + (reARR[0] * reBRight[0]) + src2Re[0];
+		ch0[0] = (reARL[0] * reBRight[0]) + (reALL[0] * reBLeft[0]) + src1Re[0];
+		ch1[0] = (reALR[0] * reBLeft[0]) + (reARR[0] * reBRight[0]) + src2Re[0];
 		for (j = 1; j < conv->_fftComplexSize; ++j)
 		{
-			symIdx = conv->_segSize - j;
 			realL = (reARL[j] * reBRight[j] - imARL[j] * imBRight[j]) + (reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j]) + src1Re[j];
 			imagL = (imARL[j] * reBRight[j] + reARL[j] * imBRight[j]) + (reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j]) + src1Im[j];
 			realR = (reALR[j] * reBLeft[j] - imALR[j] * imBLeft[j]) + (reARR[j] * reBRight[j] - imARR[j] * imBRight[j]) + src2Re[j];
 			imagR = (imALR[j] * reBLeft[j] + reALR[j] * imBLeft[j]) + (reARR[j] * imBRight[j] + imARR[j] * reBRight[j]) + src2Im[j];
-			conv->_fftBuffer[0][conv->bit[j]] = (realL + imagL) * 0.5f;
-			conv->_fftBuffer[0][conv->bit[symIdx]] = (realL - imagL) * 0.5f;
-			conv->_fftBuffer[1][conv->bit[j]] = (realR + imagR) * 0.5f;
-			conv->_fftBuffer[1][conv->bit[symIdx]] = (realR - imagR) * 0.5f;
+			ch0[conv->slot[j << 1] << stride] = (realL + imagL) * 0.5f;
+			ch0[conv->slot[(j << 1) + 1] << stride] = (realL - imagL) * 0.5f;
+			ch1[conv->slot[j << 1] << stride] = (realR + imagR) * 0.5f;
+			ch1[conv->slot[(j << 1) + 1] << stride] = (realR - imagR) * 0.5f;
 		}
 		// Backward FFT
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		conv->fft(conv->_fftBuffer[1], conv->sine);
+		if (stride)
+		{
+			pairedDiscreteHartleyFloat(conv->_fftPairBuffer, conv->_segSize, conv->sine);
+			for (j = 0; j < conv->_segSize; j++)
+			{
+				conv->_fftBuffer[0][j] = ch0[j << 1];
+				conv->_fftBuffer[1][j] = ch1[j << 1];
+			}
+		}
+		else
+		{
+			FHTPlanInverse(conv->plan, ch0);
+			FHTPlanInverse(conv->plan, ch1);
+		}
 
 		// Add overlap
 		float *result1 = y1 + processed;
@@ -1411,9 +1737,50 @@ void FFTConvolver2x4x2Process(FFTConvolver2x4x2 *conv, const float* x1, const fl
 		processed += processing;
 	}
 }
+// 2x2 spectral MAC against one IR shared by both channels, every IR bin is loaded once
+#define SHAREDIR_BIN(j, OP) do { \
+	const float ar = reA[j], ai = imA[j]; \
+	reLeft[j] OP ar * reBLeft[j] - ai * imBLeft[j]; \
+	imLeft[j] OP ar * imBLeft[j] + ai * reBLeft[j]; \
+	reRight[j] OP ar * reBRight[j] - ai * imBRight[j]; \
+	imRight[j] OP ar * imBRight[j] + ai * reBRight[j]; \
+} while (0)
+static void sharedIRMultiply(float *const acc[2][2], const float *reA, const float *imA, const float *reBLeft, const float *imBLeft, const float *reBRight, const float *imBRight, const unsigned int n, const int accumulate)
+{
+	float *reLeft = acc[0][0];
+	float *imLeft = acc[0][1];
+	float *reRight = acc[1][0];
+	float *imRight = acc[1][1];
+	const unsigned int end4 = (n - 1) & ~3u;
+	unsigned int j;
+	if (accumulate)
+	{
+		for (j = 0; j < end4; j += 4)
+		{
+			SHAREDIR_BIN(j + 0, +=);
+			SHAREDIR_BIN(j + 1, +=);
+			SHAREDIR_BIN(j + 2, +=);
+			SHAREDIR_BIN(j + 3, +=);
+		}
+		for (j = end4; j < n; j++)
+			SHAREDIR_BIN(j, +=);
+	}
+	else
+	{
+		for (j = 0; j < end4; j += 4)
+		{
+			SHAREDIR_BIN(j + 0, =);
+			SHAREDIR_BIN(j + 1, =);
+			SHAREDIR_BIN(j + 2, =);
+			SHAREDIR_BIN(j + 3, =);
+		}
+		for (j = end4; j < n; j++)
+			SHAREDIR_BIN(j, =);
+	}
+}
 void FFTConvolver2x2Process(FFTConvolver2x2 *conv, const float* x1, const float* x2, float* y1, float* y2, unsigned int len)
 {
-	unsigned int j, symIdx;
+	unsigned int j;
 	unsigned int processed = 0;
 	while (processed < len)
 	{
@@ -1423,28 +1790,32 @@ void FFTConvolver2x2Process(FFTConvolver2x2 *conv, const float* x1, const float*
 		memcpy(conv->_inputBuffer[0] + inputBufferPos, x1 + processed, processing * sizeof(float));
 		memcpy(conv->_inputBuffer[1] + inputBufferPos, x2 + processed, processing * sizeof(float));
 
-		// Forward FFT
-		for (j = 0; j < conv->_blockSize; j++)
-		{
-			conv->_fftBuffer[0][conv->bit[j]] = conv->_inputBuffer[0][j];
-			conv->_fftBuffer[1][conv->bit[j]] = conv->_inputBuffer[1][j];
-		}
-		for (j = conv->_blockSize; j < conv->_segSize; j++)
+		// Forward FFT, both channels go through one paired pass when the interleaved workspace exists
+		if (conv->_fftPairBuffer)
 		{
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-			conv->_fftBuffer[1][conv->bit[j]] = 0.0f;
+			float *pair = conv->_fftPairBuffer;
+			for (j = 0; j < conv->_blockSize; j++)
+			{
+				pair[j << 1] = conv->_inputBuffer[0][j];
+				pair[(j << 1) + 1] = conv->_inputBuffer[1][j];
+			}
+			pairedZeroPaddedDIFHartleyFloat(pair, conv->_segSize, conv->sine);
+			conv->_segmentsReLeft[conv->_current][0] = pair[0];
+			conv->_segmentsReRight[conv->_current][0] = pair[1];
+			for (j = 1; j < conv->_fftComplexSize; j++)
+			{
+				const unsigned int p = conv->slot[j << 1] << 1;
+				const unsigned int q = conv->slot[(j << 1) + 1] << 1;
+				conv->_segmentsReLeft[conv->_current][j] = pair[p] + pair[q];
+				conv->_segmentsImLeft[conv->_current][j] = pair[p] - pair[q];
+				conv->_segmentsReRight[conv->_current][j] = pair[p + 1] + pair[q + 1];
+				conv->_segmentsImRight[conv->_current][j] = pair[p + 1] - pair[q + 1];
+			}
 		}
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		conv->_segmentsReLeft[conv->_current][0] = conv->_fftBuffer[0][0];
-		conv->fft(conv->_fftBuffer[1], conv->sine);
-		conv->_segmentsReRight[conv->_current][0] = conv->_fftBuffer[1][0];
-		for (j = 1; j < conv->_fftComplexSize; j++)
+		else
 		{
-			symIdx = conv->_segSize - j;
-			conv->_segmentsReLeft[conv->_current][j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			conv->_segmentsImLeft[conv->_current][j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-			conv->_segmentsReRight[conv->_current][j] = conv->_fftBuffer[1][j] + conv->_fftBuffer[1][symIdx];
-			conv->_segmentsImRight[conv->_current][j] = conv->_fftBuffer[1][j] - conv->_fftBuffer[1][symIdx];
+			fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], conv->_inputBuffer[0], conv->_blockSize, conv->_segmentsReLeft[conv->_current], conv->_segmentsImLeft[conv->_current]);
+			fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[1], conv->_inputBuffer[1], conv->_blockSize, conv->_segmentsReRight[conv->_current], conv->_segmentsImRight[conv->_current]);
 		}
 
 		// Complex multiplication
@@ -1453,12 +1824,24 @@ void FFTConvolver2x2Process(FFTConvolver2x2 *conv, const float* x1, const float*
 		const float *imBLeft;
 		const float *reBRight;
 		const float *imBRight;
-		unsigned int end4 = conv->_fftComplexSize - 1;
+		unsigned int end4 = (conv->_fftComplexSize - 1) & ~3u;
 		if (inputBufferWasEmpty)
 		{
 			unsigned int segFrameIndex = (conv->_current + 1) % conv->_segCount;
-			if (conv->_segCount > 1)
+			if (conv->_sharedIR)
 			{
+				for (unsigned int i = 1; i < conv->_segCount; ++i)
+				{
+					segFrameIndex = (conv->_current + i) % conv->_segCount;
+					if (conv->_stream.window)
+						spectrumStreamStep(&conv->_stream, conv->_segCount, i);
+					sharedIRMultiply(conv->_preMultiplied, conv->_segmentsLLIRRe[i], conv->_segmentsLLIRIm[i], conv->_segmentsReLeft[segFrameIndex], conv->_segmentsImLeft[segFrameIndex], conv->_segmentsReRight[segFrameIndex], conv->_segmentsImRight[segFrameIndex], conv->_fftComplexSize, i > 1);
+				}
+			}
+			else if (conv->_segCount > 1)
+			{
+				if (conv->_stream.window)
+					spectrumStreamStep(&conv->_stream, conv->_segCount, 1);
 				float *reLeft = conv->_preMultiplied[0][0];
 				float *imLeft = conv->_preMultiplied[0][1];
 				float *reRight = conv->_preMultiplied[1][0];
@@ -1490,13 +1873,18 @@ void FFTConvolver2x2Process(FFTConvolver2x2 *conv, const float* x1, const float*
 					imRight[j + 2] = reARR[j + 2] * imBRight[j + 2] + imARR[j + 2] * reBRight[j + 2];
 					imRight[j + 3] = reARR[j + 3] * imBRight[j + 3] + imARR[j + 3] * reBRight[j + 3];
 				}
-				reLeft[end4] = reALL[end4] * reBLeft[end4] - imALL[end4] * imBLeft[end4];
-				imLeft[end4] = reALL[end4] * imBLeft[end4] + imALL[end4] * reBLeft[end4];
-				reRight[end4] = reARR[end4] * reBRight[end4] - imARR[end4] * imBRight[end4];
-				imRight[end4] = reARR[end4] * imBRight[end4] + imARR[end4] * reBRight[end4];
+				for (j = end4; j < conv->_fftComplexSize; j++)
+				{
+					reLeft[j] = reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j];
+					imLeft[j] = reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j];
+					reRight[j] = reARR[j] * reBRight[j] - imARR[j] * imBRight[j];
+					imRight[j] = reARR[j] * imBRight[j] + imARR[j] * reBRight[j];
+				}
 				for (unsigned int i = 2; i < conv->_segCount; ++i)
 				{
 					segFrameIndex = (conv->_current + i) % conv->_segCount;
+					if (conv->_stream.window)
+						spectrumStreamStep(&conv->_stream, conv->_segCount, i);
 					reLeft = conv->_preMultiplied[0][0];
 					imLeft = conv->_preMultiplied[0][1];
 					reRight = conv->_preMultiplied[1][0];
@@ -1528,10 +1916,13 @@ void FFTConvolver2x2Process(FFTConvolver2x2 *conv, const float* x1, const float*
 						imRight[j + 2] += reARR[j + 2] * imBRight[j + 2] + imARR[j + 2] * reBRight[j + 2];
 						imRight[j + 3] += reARR[j + 3] * imBRight[j + 3] + imARR[j + 3] * reBRight[j + 3];
 					}
-					reLeft[end4] += reALL[end4] * reBLeft[end4] - imALL[end4] * imBLeft[end4];
-					imLeft[end4] += reALL[end4] * imBLeft[end4] + imALL[end4] * reBLeft[end4];
-					reRight[end4] += reARR[end4] * reBRight[end4] - imARR[end4] * imBRight[end4];
-					imRight[end4] += reARR[end4] * imBRight[end4] + imARR[end4] * reBRight[end4];
+					for (j = end4; j < conv->_fftComplexSize; j++)
+					{
+						reLeft[j] += reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j];
+						imLeft[j] += reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j];
+						reRight[j] += reARR[j] * reBRight[j] - imARR[j] * imBRight[j];
+						imRight[j] += reARR[j] * imBRight[j] + imARR[j] * reBRight[j];
+					}
 				}
 			}
 		}
@@ -1547,24 +1938,38 @@ void FFTConvolver2x2Process(FFTConvolver2x2 *conv, const float* x1, const float*
 		const float *src1Im = conv->_preMultiplied[0][1];
 		const float *src2Re = conv->_preMultiplied[1][0];
 		const float *src2Im = conv->_preMultiplied[1][1];
+		const unsigned int stride = conv->_fftPairBuffer ? 1 : 0;
+		float *ch0 = conv->_fftPairBuffer ? conv->_fftPairBuffer : conv->_fftBuffer[0];
+		float *ch1 = conv->_fftPairBuffer ? (conv->_fftPairBuffer + 1) : conv->_fftBuffer[1];
 		float realL, imagL, realR, imagR;
-		conv->_fftBuffer[0][0] = (reALL[0] * reBLeft[0]) + src1Re[0];
-		conv->_fftBuffer[1][0] = (reARR[0] * reBRight[0]) + src2Re[0];
+		ch0[0] = (reALL[0] * reBLeft[0]) + src1Re[0];
+		ch1[0] = (reARR[0] * reBRight[0]) + src2Re[0];
 		for (j = 1; j < conv->_fftComplexSize; ++j)
 		{
-			symIdx = conv->_segSize - j;
 			realL = (reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j]) + src1Re[j];
 			imagL = (reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j]) + src1Im[j];
 			realR = (reARR[j] * reBRight[j] - imARR[j] * imBRight[j]) + src2Re[j];
 			imagR = (reARR[j] * imBRight[j] + imARR[j] * reBRight[j]) + src2Im[j];
-			conv->_fftBuffer[0][conv->bit[j]] = (realL + imagL) * 0.5f;
-			conv->_fftBuffer[0][conv->bit[symIdx]] = (realL - imagL) * 0.5f;
-			conv->_fftBuffer[1][conv->bit[j]] = (realR + imagR) * 0.5f;
-			conv->_fftBuffer[1][conv->bit[symIdx]] = (realR - imagR) * 0.5f;
+			ch0[conv->slot[j << 1] << stride] = (realL + imagL) * 0.5f;
+			ch0[conv->slot[(j << 1) + 1] << stride] = (realL - imagL) * 0.5f;
+			ch1[conv->slot[j << 1] << stride] = (realR + imagR) * 0.5f;
+			ch1[conv->slot[(j << 1) + 1] << stride] = (realR - imagR) * 0.5f;
 		}
 		// Backward FFT
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		conv->fft(conv->_fftBuffer[1], conv->sine);
+		if (stride)
+		{
+			pairedDiscreteHartleyFloat(conv->_fftPairBuffer, conv->_segSize, conv->sine);
+			for (j = 0; j < conv->_segSize; j++)
+			{
+				conv->_fftBuffer[0][j] = ch0[j << 1];
+				conv->_fftBuffer[1][j] = ch1[j << 1];
+			}
+		}
+		else
+		{
+			FHTPlanInverse(conv->plan, ch0);
+			FHTPlanInverse(conv->plan, ch1);
+		}
 
 		// Add overlap
 		float *result1 = y1 + processed;
@@ -1610,7 +2015,7 @@ void FFTConvolver2x2Process(FFTConvolver2x2 *conv, const float* x1, const float*
 }
 void FFTConvolver1x2Process(FFTConvolver1x2 *conv, const float* x, float* y1, float* y2, unsigned int len)
 {
-	unsigned int j, symIdx;
+	unsigned int j;
 	unsigned int processed = 0;
 	while (processed < len)
 	{
@@ -1620,24 +2025,13 @@ void FFTConvolver1x2Process(FFTConvolver1x2 *conv, const float* x, float* y1, fl
 		memcpy(conv->_inputBuffer + inputBufferPos, x + processed, processing * sizeof(float));
 
 		// Forward FFT
-		for (j = 0; j < conv->_blockSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = conv->_inputBuffer[j];
-		for (j = conv->_blockSize; j < conv->_segSize; j++)
-			conv->_fftBuffer[0][conv->bit[j]] = 0.0f;
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		conv->_segmentsRe[conv->_current][0] = conv->_fftBuffer[0][0];
-		for (j = 1; j < conv->_fftComplexSize; j++)
-		{
-			symIdx = conv->_segSize - j;
-			conv->_segmentsRe[conv->_current][j] = conv->_fftBuffer[0][j] + conv->_fftBuffer[0][symIdx];
-			conv->_segmentsIm[conv->_current][j] = conv->_fftBuffer[0][j] - conv->_fftBuffer[0][symIdx];
-		}
+		fhtPartitionSpectrum(conv->plan, conv->_fftBuffer[0], conv->_inputBuffer, conv->_blockSize, conv->_segmentsRe[conv->_current], conv->_segmentsIm[conv->_current]);
 
 		// Complex multiplication
 		const float *reALL, *imALL, *reARR, *imARR;
 		const float *reB;
 		const float *imB;
-		unsigned int end4 = conv->_fftComplexSize - 1;
+		unsigned int end4 = (conv->_fftComplexSize - 1) & ~3u;
 		if (inputBufferWasEmpty)
 		{
 			unsigned int segFrameIndex = (conv->_current + 1) % conv->_segCount;
@@ -1672,10 +2066,13 @@ void FFTConvolver1x2Process(FFTConvolver1x2 *conv, const float* x, float* y1, fl
 					imRight[j + 2] = reARR[j + 2] * imB[j + 2] + imARR[j + 2] * reB[j + 2];
 					imRight[j + 3] = reARR[j + 3] * imB[j + 3] + imARR[j + 3] * reB[j + 3];
 				}
-				reLeft[end4] = reALL[end4] * reB[end4] - imALL[end4] * imB[end4];
-				imLeft[end4] = reALL[end4] * imB[end4] + imALL[end4] * reB[end4];
-				reRight[end4] = reARR[end4] * reB[end4] - imARR[end4] * imB[end4];
-				imRight[end4] = reARR[end4] * imB[end4] + imARR[end4] * reB[end4];
+				for (j = end4; j < conv->_fftComplexSize; j++)
+				{
+					reLeft[j] = reALL[j] * reB[j] - imALL[j] * imB[j];
+					imLeft[j] = reALL[j] * imB[j] + imALL[j] * reB[j];
+					reRight[j] = reARR[j] * reB[j] - imARR[j] * imB[j];
+					imRight[j] = reARR[j] * imB[j] + imARR[j] * reB[j];
+				}
 				for (unsigned int i = 2; i < conv->_segCount; ++i)
 				{
 					segFrameIndex = (conv->_current + i) % conv->_segCount;
@@ -1708,10 +2105,13 @@ void FFTConvolver1x2Process(FFTConvolver1x2 *conv, const float* x, float* y1, fl
 						imRight[j + 2] += reARR[j + 2] * imB[j + 2] + imARR[j + 2] * reB[j + 2];
 						imRight[j + 3] += reARR[j + 3] * imB[j + 3] + imARR[j + 3] * reB[j + 3];
 					}
-					reLeft[end4] += reALL[end4] * reB[end4] - imALL[end4] * imB[end4];
-					imLeft[end4] += reALL[end4] * imB[end4] + imALL[end4] * reB[end4];
-					reRight[end4] += reARR[end4] * reB[end4] - imARR[end4] * imB[end4];
-					imRight[end4] += reARR[end4] * imB[end4] + imARR[end4] * reB[end4];
+					for (j = end4; j < conv->_fftComplexSize; j++)
+					{
+						reLeft[j] += reALL[j] * reB[j] - imALL[j] * imB[j];
+						imLeft[j] += reALL[j] * imB[j] + imALL[j] * reB[j];
+						reRight[j] += reARR[j] * reB[j] - imARR[j] * imB[j];
+						imRight[j] += reARR[j] * imB[j] + imARR[j] * reB[j];
+					}
 				}
 			}
 		}
@@ -1726,23 +2126,37 @@ void FFTConvolver1x2Process(FFTConvolver1x2 *conv, const float* x, float* y1, fl
 		const float *src2Re = conv->_preMultiplied[1][0];
 		const float *src2Im = conv->_preMultiplied[1][1];
 		float realL, imagL, realR, imagR;
-		conv->_fftBuffer[0][0] = (reALL[0] * reB[0]) + src1Re[0];
-		conv->_fftBuffer[1][0] = (reARR[0] * reB[0]) + src2Re[0];
+		const unsigned int stride = conv->_fftPairBuffer ? 1 : 0;
+		float *ch0 = conv->_fftPairBuffer ? conv->_fftPairBuffer : conv->_fftBuffer[0];
+		float *ch1 = conv->_fftPairBuffer ? (conv->_fftPairBuffer + 1) : conv->_fftBuffer[1];
+		ch0[0] = (reALL[0] * reB[0]) + src1Re[0];
+		ch1[0] = (reARR[0] * reB[0]) + src2Re[0];
 		for (j = 1; j < conv->_fftComplexSize; ++j)
 		{
-			symIdx = conv->_segSize - j;
 			realL = (reALL[j] * reB[j] - imALL[j] * imB[j]) + src1Re[j];
 			imagL = (reALL[j] * imB[j] + imALL[j] * reB[j]) + src1Im[j];
 			realR = (reARR[j] * reB[j] - imARR[j] * imB[j]) + src2Re[j];
 			imagR = (reARR[j] * imB[j] + imARR[j] * reB[j]) + src2Im[j];
-			conv->_fftBuffer[0][conv->bit[j]] = (realL + imagL) * 0.5f;
-			conv->_fftBuffer[0][conv->bit[symIdx]] = (realL - imagL) * 0.5f;
-			conv->_fftBuffer[1][conv->bit[j]] = (realR + imagR) * 0.5f;
-			conv->_fftBuffer[1][conv->bit[symIdx]] = (realR - imagR) * 0.5f;
+			ch0[conv->slot[j << 1] << stride] = (realL + imagL) * 0.5f;
+			ch0[conv->slot[(j << 1) + 1] << stride] = (realL - imagL) * 0.5f;
+			ch1[conv->slot[j << 1] << stride] = (realR + imagR) * 0.5f;
+			ch1[conv->slot[(j << 1) + 1] << stride] = (realR - imagR) * 0.5f;
 		}
 		// Backward FFT
-		conv->fft(conv->_fftBuffer[0], conv->sine);
-		conv->fft(conv->_fftBuffer[1], conv->sine);
+		if (stride)
+		{
+			pairedDiscreteHartleyFloat(conv->_fftPairBuffer, conv->_segSize, conv->sine);
+			for (j = 0; j < conv->_segSize; j++)
+			{
+				conv->_fftBuffer[0][j] = ch0[j << 1];
+				conv->_fftBuffer[1][j] = ch1[j << 1];
+			}
+		}
+		else
+		{
+			FHTPlanInverse(conv->plan, ch0);
+			FHTPlanInverse(conv->plan, ch1);
+		}
 
 		// Add overlap
 		float *result1 = y1 + processed;
@@ -1784,4 +2198,228 @@ void FFTConvolver1x2Process(FFTConvolver1x2 *conv, const float* x, float* y1, fl
 		}
 		processed += processing;
 	}
-}
\ No newline at end of file
+}
+void FFTConvolverMxNInit(FFTConvolverMxN *conv)
+{
+	memset(conv, 0, sizeof(FFTConvolverMxN));
+}
+void FFTConvolverMxNFree(FFTConvolverMxN *conv)
+{
+	free(conv->_segmentsRe);
+	free(conv->_rowTable);
+	if (conv->_arena)
+		spectrumArenaFree(conv->_arena);
+	if (conv->slot)
+		FHTPlanRelease(conv->plan);
+	free(conv->_fftBuffer);
+	free(conv->_channelBuffer);
+	FFTConvolverMxNInit(conv);
+}
+int FFTConvolverMxNLoadImpulseResponse(FFTConvolverMxN *conv, unsigned int blockSize, unsigned int inputs, unsigned int outputs, const float* const* ir, unsigned int irLen)
+{
+	if (blockSize == 0)
+		return 0;
+	if (irLen == 0)
+		return 0;
+	if (!inputs || !outputs || inputs > FFTCONV_MATRIX_MAXCH || outputs > FFTCONV_MATRIX_MAXCH)
+		return 0;
+
+	if (conv->slot)
+		FFTConvolverMxNFree(conv);
+	const unsigned int paths = inputs * outputs;
+	conv->_inputs = inputs;
+	conv->_outputs = outputs;
+	conv->_blockSize = FHTPlanBlockSize(blockSize);
+	conv->_segSize = 2 * conv->_blockSize;
+	conv->_segCount = (unsigned int)ceil((double)irLen / (double)conv->_blockSize);
+	conv->_segCountMinus1 = conv->_segCount - 1;
+	conv->_fftComplexSize = (conv->_segSize >> 1) + 1;
+
+	// FFT
+	conv->plan = FHTPlanAcquire(conv->_segSize);
+	if (!conv->plan)
+		return 0;
+	conv->slot = conv->plan->slot;
+	conv->sine = conv->plan->sine;
+	conv->_fftBuffer = (float*)malloc(conv->_segSize * sizeof(float));
+
+	// Row tables, the Re and Im rows of every input followed by those of every path
+	const unsigned int rowCount = 2 * (inputs + paths);
+	conv->_segmentsRe = (float***)malloc(rowCount * 2 * sizeof(float**));
+	conv->_rowTable = (float**)malloc((size_t)rowCount * conv->_segCount * sizeof(float*));
+	conv->_channelBuffer = (float*)calloc((size_t)(inputs + outputs) * conv->_blockSize, sizeof(float));
+	if (!conv->_fftBuffer || !conv->_segmentsRe || !conv->_rowTable || !conv->_channelBuffer)
+	{
+		FFTConvolverMxNFree(conv);
+		return 0;
+	}
+	conv->_segmentsIm = conv->_segmentsRe + inputs;
+	conv->_segmentsIRRe = conv->_segmentsRe + 2 * inputs;
+	conv->_segmentsIRIm = conv->_segmentsIRRe + paths;
+	for (unsigned int r = 0; r < rowCount; r++)
+		conv->_segmentsRe[r] = conv->_rowTable + (size_t)r * conv->_segCount;
+	// Carve order keeps Re and Im of one channel adjacent
+	float ***carveOrder = conv->_segmentsRe + rowCount;
+	for (unsigned int m = 0; m < inputs; m++)
+	{
+		carveOrder[2 * m] = conv->_segmentsRe[m];
+		carveOrder[2 * m + 1] = conv->_segmentsIm[m];
+	}
+	for (unsigned int p = 0; p < paths; p++)
+	{
+		carveOrder[2 * (inputs + p)] = conv->_segmentsIRRe[p];
+		carveOrder[2 * (inputs + p) + 1] = conv->_segmentsIRIm[p];
+	}
+	// Input and IR spectra plus the accumulators share one aligned arena
+	const unsigned int stride = spectrumArenaStride(conv->_fftComplexSize);
+	conv->_arena = spectrumArenaAlloc((size_t)stride * ((size_t)conv->_segCount * rowCount + 2 * outputs + 2));
+	if (!conv->_arena)
+	{
+		FFTConvolverMxNFree(conv);
+		return 0;
+	}
+	float *row = spectrumArenaCarve(conv->_arena, stride, conv->_segCount, carveOrder, 2 * inputs);
+	row = spectrumArenaCarve(row, stride, conv->_segCount, carveOrder + 2 * inputs, 2 * paths);
+	for (unsigned int n = 0; n < outputs; n++, row += 2 * stride)
+	{
+		conv->_preMultiplied[n][0] = row;
+		conv->_preMultiplied[n][1] = row + stride;
+		conv->_overlap[n] = conv->_channelBuffer + (size_t)n * conv->_blockSize;
+	}
+	conv->_sum[0] = row;
+	conv->_sum[1] = row + stride;
+	for (unsigned int m = 0; m < inputs; m++)
+		conv->_inputBuffer[m] = conv->_channelBuffer + (size_t)(outputs + m) * conv->_blockSize;
+	for (unsigned int p = 0; p < paths; p++)
+	{
+		for (unsigned int i = 0; i < conv->_segCount; ++i)
+		{
+			const unsigned int remaining = irLen - (i * conv->_blockSize);
+			const unsigned int sizeCopy = (remaining >= conv->_blockSize) ? conv->_blockSize : remaining;
+			fhtPartitionSpectrum(conv->plan, conv->_fftBuffer, ir[p] + i * conv->_blockSize, sizeCopy, conv->_segmentsIRRe[p][i], conv->_segmentsIRIm[p][i]);
+			conv->_segmentsIRRe[p][i][0] *= 2.0f;
+		}
+	}
+	conv->_inputBufferFill = 0;
+	conv->_current = 0;
+	conv->gain = 1.0f / ((float)conv->_segSize * 2.0f);
+	return 1;
+}
+#define MATRIX_BIN(j, OP) do { \
+	re[j] OP reA[j] * reB[j] - imA[j] * imB[j]; \
+	im[j] OP reA[j] * imB[j] + imA[j] * reB[j]; \
+} while (0)
+static void spectrumMultiplyAccumulate(float *re, float *im, const float *reA, const float *imA, const float *reB, const float *imB, const unsigned int n, const int accumulate)
+{
+	const unsigned int end4 = (n - 1) & ~3u;
+	unsigned int j;
+	if (accumulate)
+	{
+		for (j = 0; j < end4; j += 4)
+		{
+			MATRIX_BIN(j + 0, +=);
+			MATRIX_BIN(j + 1, +=);
+			MATRIX_BIN(j + 2, +=);
+			MATRIX_BIN(j + 3, +=);
+		}
+		for (j = end4; j < n; j++)
+			MATRIX_BIN(j, +=);
+	}
+	else
+	{
+		for (j = 0; j < end4; j += 4)
+		{
+			MATRIX_BIN(j + 0, =);
+			MATRIX_BIN(j + 1, =);
+			MATRIX_BIN(j + 2, =);
+			MATRIX_BIN(j + 3, =);
+		}
+		for (j = end4; j < n; j++)
+			MATRIX_BIN(j, =);
+	}
+}
+void FFTConvolverMxNProcess(FFTConvolverMxN *conv, const float* const* x, float* const* y, unsigned int len)
+{
+	unsigned int j, m, n;
+	const unsigned int inputs = conv->_inputs;
+	const unsigned int outputs = conv->_outputs;
+	const unsigned int bins = conv->_fftComplexSize;
+	unsigned int processed = 0;
+	while (processed < len)
+	{
+		const int inputBufferWasEmpty = (conv->_inputBufferFill == 0);
+		const unsigned int processing = min(len - processed, conv->_blockSize - conv->_inputBufferFill);
+		const unsigned int inputBufferPos = conv->_inputBufferFill;
+		const int blockComplete = inputBufferPos + processing == conv->_blockSize;
+
+		// One forward FFT per input, shared by every output it feeds
+		for (m = 0; m < inputs; m++)
+		{
+			memcpy(conv->_inputBuffer[m] + inputBufferPos, x[m] + processed, processing * sizeof(float));
+			fhtPartitionSpectrum(conv->plan, conv->_fftBuffer, conv->_inputBuffer[m], conv->_blockSize, conv->_segmentsRe[m][conv->_current], conv->_segmentsIm[m][conv->_current]);
+		}
+
+		// Older partitions only change once per block
+		if (inputBufferWasEmpty && conv->_segCount > 1)
+		{
+			for (n = 0; n < outputs; n++)
+			{
+				float *re = conv->_preMultiplied[n][0];
+				float *im = conv->_preMultiplied[n][1];
+				for (unsigned int i = 1; i < conv->_segCount; ++i)
+				{
+					const unsigned int segFrameIndex = (conv->_current + i) % conv->_segCount;
+					for (m = 0; m < inputs; m++)
+					{
+						const unsigned int p = m * outputs + n;
+						spectrumMultiplyAccumulate(re, im, conv->_segmentsIRRe[p][i], conv->_segmentsIRIm[p][i], conv->_segmentsRe[m][segFrameIndex], conv->_segmentsIm[m][segFrameIndex], bins, i > 1 || m);
+					}
+				}
+			}
+		}
+
+		// Newest partition, then one inverse FFT per output
+		for (n = 0; n < outputs; n++)
+		{
+			float *sumRe = conv->_sum[0];
+			float *sumIm = conv->_sum[1];
+			memcpy(sumRe, conv->_preMultiplied[n][0], bins * sizeof(float));
+			memcpy(sumIm, conv->_preMultiplied[n][1], bins * sizeof(float));
+			for (m = 0; m < inputs; m++)
+			{
+				const unsigned int p = m * outputs + n;
+				spectrumMultiplyAccumulate(sumRe, sumIm, conv->_segmentsIRRe[p][0], conv->_segmentsIRIm[p][0], conv->_segmentsRe[m][conv->_current], conv->_segmentsIm[m][conv->_current], bins, 1);
+			}
+			conv->_fftBuffer[0] = sumRe[0];
+			for (j = 1; j < bins; ++j)
+			{
+				conv->_fftBuffer[conv->slot[j << 1]] = (sumRe[j] + sumIm[j]) * 0.5f;
+				conv->_fftBuffer[conv->slot[(j << 1) + 1]] = (sumRe[j] - sumIm[j]) * 0.5f;
+			}
+			FHTPlanInverse(conv->plan, conv->_fftBuffer);
+
+			// Add overlap
+			float *result = y[n] + processed;
+			const float *a = conv->_fftBuffer + inputBufferPos;
+			const float *b = conv->_overlap[n] + inputBufferPos;
+			for (j = 0; j < processing; ++j)
+				result[j] = (a[j] + b[j]) * conv->gain;
+			// Save the overlap
+			if (blockComplete)
+				memcpy(conv->_overlap[n], conv->_fftBuffer + conv->_blockSize, conv->_blockSize * sizeof(float));
+		}
+
+		// Input buffer full => Next block
+		conv->_inputBufferFill += processing;
+		if (blockComplete)
+		{
+			// Input buffer is empty again now
+			for (m = 0; m < inputs; m++)
+				memset(conv->_inputBuffer[m], 0, conv->_blockSize * sizeof(float));
+			conv->_inputBufferFill = 0;
+			// Update current segment
+			conv->_current = (conv->_current > 0) ? (conv->_current - 1) : conv->_segCountMinus1;
+		}
+		processed += processing;
+	}
+}
@@ -1,6 +1,32 @@
 #ifndef _FFTCONVOLVER_FFTCONVOLVER_H
 #define _FFTCONVOLVER_FFTCONVOLVER_H
+#include <stddef.h>
+#include "FHTPlan.h"
 extern unsigned int upper_power_of_two(unsigned int v);
+// Stereo convolvers transform both channels in one paired FHT pass from this segment size on
+#ifndef FFTCONV_PAIRED_FHT_MINSIZE
+#define FFTCONV_PAIRED_FHT_MINSIZE 65536
+#endif
+extern void pairedDiscreteHartleyFloat(float *A, const unsigned int nPoints, const float *sinTab);
+// Decimation-in-frequency FHT of a half zero-padded block, output left in bit-reversed order
+extern void zeroPaddedDIFHartleyFloat(float *A, const unsigned int nPoints, const float *sinTab);
+extern void pairedZeroPaddedDIFHartleyFloat(float *A, const unsigned int nPoints, const float *sinTab);
+// Spectrum of len samples zero padded to plan->n, bins are stored in slot order
+extern void fhtPartitionSpectrum(const FHTPlan *plan, float *work, const float *x, unsigned int len, float *re, float *im);
+// IR spectra past the first window kept in a read only mapping of an unlinked file, they are paged
+// in ahead of the multiply loop and dropped behind it, see spectrumStreamStep
+typedef struct
+{
+	unsigned int enabled; // Set by the owner before loading, only for convolvers processed off the audio thread
+	unsigned int resident; // IR partitions kept in the arena
+	unsigned int window; // Partitions per prefetch window, 0 when nothing is streamed
+	const float *ir; // Mapping of the streamed IR partitions
+	size_t bytes; // Mapping length
+	size_t irPartition; // Floats per IR partition
+	size_t page;
+	float *scratch; // Partition the spectra are computed into while loading
+	int fd;
+} SpectrumStream;
 /**
 * @class FFTConvolver1x1
 * @brief Implementation of a partitioned FFT convolution algorithm with uniform block size
@@ -19,6 +45,9 @@ extern unsigned int upper_power_of_two(unsigned int v);
 *   "unpredictable" operations like allocations, locking, API calls, etc. are
 *   performed during processing (all necessary allocations and preparations take
 *   place during initialization).
+* - Stereo convolvers loaded with _stream.enabled set keep very long IR spectra in
+*   a file, processing them pages it in with madvise and page faults. Only the tail
+*   convolver that TwoStageFFTConvolver runs on its background thread enables it.
 */
 typedef struct
 {
@@ -31,8 +60,10 @@ typedef struct
 	float **_segmentsIm;
 	float **_segmentsIRRe;
 	float **_segmentsIRIm;
+	float *_arena; // Every partition spectrum and accumulator, see spectrumArenaCarve
 	float *_fftBuffer;
-	unsigned int *bit;
+	const FHTPlan *plan;
+	const unsigned int *slot;
 	float *sine;
 	float *_preMultiplied[2];
 	float *_overlap;
@@ -40,7 +71,6 @@ typedef struct
 	float *_inputBuffer;
 	unsigned int _inputBufferFill;
 	float gain; // float32, it's perfectly safe to have blockSize == 2097152, however, it's impractical to have such large block
-	void(*fft)(float*, const float*);
 } FFTConvolver1x1;
 typedef struct
 {
@@ -61,8 +91,12 @@ typedef struct
 	float **_segmentsRLIRIm;
 	float **_segmentsRRIRRe;
 	float **_segmentsRRIRIm;
+	float *_arena; // Every partition spectrum and accumulator, see spectrumArenaCarve
+	SpectrumStream _stream;
 	float *_fftBuffer[2];
-	unsigned int *bit;
+	float *_fftPairBuffer; // Interleaved stereo FHT workspace, NULL when transforms run per channel
+	const FHTPlan *plan;
+	const unsigned int *slot;
 	float *sine;
 	float *_preMultiplied[2][2];
 	float *_overlap[2];
@@ -70,7 +104,6 @@ typedef struct
 	float *_inputBuffer[2];
 	unsigned int _inputBufferFill;
 	float gain; // float32, it's perfectly safe to have blockSize == 2097152, however, it's impractical to have such large block
-	void(*fft)(float*, const float*);
 } FFTConvolver2x4x2;
 typedef struct
 {
@@ -87,8 +120,13 @@ typedef struct
 	float **_segmentsLLIRIm;
 	float **_segmentsRRIRRe;
 	float **_segmentsRRIRIm;
+	unsigned int _sharedIR; // Identical channel IRs, RR rows alias the LL rows
+	float *_arena; // Every partition spectrum and accumulator, see spectrumArenaCarve
+	SpectrumStream _stream;
 	float *_fftBuffer[2];
-	unsigned int *bit;
+	float *_fftPairBuffer; // Interleaved stereo FHT workspace, NULL when transforms run per channel
+	const FHTPlan *plan;
+	const unsigned int *slot;
 	float *sine;
 	float *_preMultiplied[2][2];
 	float *_overlap[2];
@@ -96,7 +134,6 @@ typedef struct
 	float *_inputBuffer[2];
 	unsigned int _inputBufferFill;
 	float gain; // float32, it's perfectly safe to have blockSize == 2097152, however, it's impractical to have such large block
-	void(*fft)(float*, const float*);
 } FFTConvolver2x2;
 typedef struct
 {
@@ -111,8 +148,11 @@ typedef struct
 	float **_segmentsLLIRIm;
 	float **_segmentsRRIRRe;
 	float **_segmentsRRIRIm;
+	float *_arena; // Every partition spectrum and accumulator, see spectrumArenaCarve
 	float *_fftBuffer[2];
-	unsigned int *bit;
+	float *_fftPairBuffer; // Interleaved stereo FHT workspace, NULL when transforms run per channel
+	const FHTPlan *plan;
+	const unsigned int *slot;
 	float *sine;
 	float *_preMultiplied[2][2];
 	float *_overlap[2];
@@ -120,9 +160,48 @@ typedef struct
 	float *_inputBuffer;
 	unsigned int _inputBufferFill;
 	float gain; // float32, it's perfectly safe to have blockSize == 2097152, however, it's impractical to have such large block
-	void(*fft)(float*, const float*);
 } FFTConvolver1x2;
+// Inputs and outputs of FFTConvolverMxN
+#define FFTCONV_MATRIX_MAXCH 16
+typedef struct
+{
+	unsigned int _inputs;
+	unsigned int _outputs;
+	unsigned int _blockSize;
+	unsigned int _segSize;
+	unsigned int _segCount;
+	unsigned int _segCountMinus1;
+	unsigned int _fftComplexSize;
+	float ***_segmentsRe; // [input][partition]
+	float ***_segmentsIm;
+	float ***_segmentsIRRe; // [input * _outputs + output][partition]
+	float ***_segmentsIRIm;
+	float **_rowTable; // Storage of every partition row pointer
+	float *_arena; // Every partition spectrum and accumulator, see spectrumArenaCarve
+	float *_fftBuffer;
+	const FHTPlan *plan;
+	const unsigned int *slot;
+	float *sine;
+	float *_preMultiplied[FFTCONV_MATRIX_MAXCH][2];
+	float *_sum[2];
+	float *_overlap[FFTCONV_MATRIX_MAXCH];
+	unsigned int _current;
+	float *_inputBuffer[FFTCONV_MATRIX_MAXCH];
+	float *_channelBuffer; // Storage of _overlap and _inputBuffer
+	unsigned int _inputBufferFill;
+	float gain;
+} FFTConvolverMxN;
+/**
+* @class FFTConvolverMxN
+* @brief Convolution matrix, every input reaches every output through its own impulse response
+*
+* Each input runs one forward transform per partition however many outputs it
+* feeds, each output accumulates all of its paths in the frequency domain and
+* runs one inverse transform. A 6x2 matrix costs 6 + 2 transforms per block
+* instead of the 24 twelve separate convolvers would need.
+*/
 extern void FFTConvolver1x1Init(FFTConvolver1x1 *conv);
+extern void FFTConvolverMxNInit(FFTConvolverMxN *conv);
 extern void FFTConvolver2x4x2Init(FFTConvolver2x4x2 *conv);
 extern void FFTConvolver2x2Init(FFTConvolver2x2 *conv);
 extern void FFTConvolver1x2Init(FFTConvolver1x2 *conv);
@@ -138,6 +217,8 @@ int FFTConvolver1x1LoadImpulseResponse(FFTConvolver1x1 *conv, unsigned int block
 int FFTConvolver2x4x2LoadImpulseResponse(FFTConvolver2x4x2 *conv, unsigned int blockSize, const float* irLL, const float* irLR, const float* irRL, const float* irRR, unsigned int irLen);
 int FFTConvolver2x2LoadImpulseResponse(FFTConvolver2x2 *conv, unsigned int blockSize, const float* irL, const float* irR, unsigned int irLen);
 int FFTConvolver1x2LoadImpulseResponse(FFTConvolver1x2 *conv, unsigned int blockSize, const float* irL, const float* irR, unsigned int irLen);
+// ir[m * outputs + n] is the path from input m to output n
+int FFTConvolverMxNLoadImpulseResponse(FFTConvolverMxN *conv, unsigned int blockSize, unsigned int inputs, unsigned int outputs, const float* const* ir, unsigned int irLen);
 
 /**
 * @brief Convolves the the given input samples and immediately outputs the result
@@ -149,6 +230,8 @@ extern void FFTConvolver1x1Process(FFTConvolver1x1 *conv, const float* input, fl
 extern void FFTConvolver2x4x2Process(FFTConvolver2x4x2 *conv, const float* x1, const float* x2, float* y1, float* y2, unsigned int len);
 extern void FFTConvolver2x2Process(FFTConvolver2x2 *conv, const float* x1, const float* x2, float* y1, float* y2, unsigned int len);
 extern void FFTConvolver1x2Process(FFTConvolver1x2 *conv, const float* x, float* y1, float* y2, unsigned int len);
+// Outputs may alias inputs
+extern void FFTConvolverMxNProcess(FFTConvolverMxN *conv, const float* const* x, float* const* y, unsigned int len);
 
 /**
 * @brief Resets the convolver and discards the set impulse response
@@ -157,10 +240,12 @@ extern void FFTConvolver1x1Free(FFTConvolver1x1 *conv);
 extern void FFTConvolver2x4x2Free(FFTConvolver2x4x2 *conv);
 extern void FFTConvolver2x2Free(FFTConvolver2x2 *conv);
 extern void FFTConvolver1x2Free(FFTConvolver1x2 *conv);
+extern void FFTConvolverMxNFree(FFTConvolverMxN *conv);
 
 /**
 * @brief Refreshs the convolver without modify memory pointers
-* blockSize, irLen must be the same as the one in initialization
+* blockSize, irLen must be the same as the one in initialization, FFTConvolver2x2 loaded with
+* identical channels only accepts identical channels again
 */
 extern int FFTConvolver1x1RefreshImpulseResponse(FFTConvolver1x1 *conv, unsigned int blockSize, const float* ir, unsigned int irLen);
 extern int FFTConvolver2x2RefreshImpulseResponse(FFTConvolver2x2 *conv, unsigned int blockSize, const float* irL, const float* irR, unsigned int irLen);
@@ -0,0 +1,176 @@
+#include <stdlib.h>
+#include "../cpthread.h"
+#include "FHTPlan.h"
+#include "codelet.h"
+extern void fhtbitReversalTbl(unsigned *dst, unsigned int n);
+extern void fhtsinHalfTblFloat(float *dst, unsigned int n);
+#define FHTPLAN_MAXLOG2 20
+#define FHTPLAN_MAXPLANS 32
+static FHTPlan planRegistry[FHTPLAN_MAXPLANS] = { 0 };
+static void(*const planCodelets[FHTPLAN_MAXLOG2 + 1])(float*, const float*) =
+{
+	0, DFT2, DFT4, DFT8, DFT16, DFT32, DFT64, DFT128, DFT256, DFT512, DFT1024, DFT2048, DFT4096, DFT8192,
+	DFT16384, DFT32768, DFT65536, DFT131072, DFT262144, DFT524288, DFT1048576
+};
+#ifdef _WIN32
+static SRWLOCK planLock = SRWLOCK_INIT;
+#define FHTPLAN_LOCK() AcquireSRWLockExclusive(&planLock)
+#define FHTPLAN_UNLOCK() ReleaseSRWLockExclusive(&planLock)
+#else
+static pthread_mutex_t planLock = PTHREAD_MUTEX_INITIALIZER;
+#define FHTPLAN_LOCK() pthread_mutex_lock(&planLock)
+#define FHTPLAN_UNLOCK() pthread_mutex_unlock(&planLock)
+#endif
+// Bin pairs (k, n - k) sit mirrored within each octave [2^m, 2^(m + 1)) of a bit-reversed spectrum
+static void fhtSlotTbl(unsigned int *dst, unsigned int n)
+{
+	unsigned int s = 1, oct, k;
+	dst[0] = dst[1] = 0;
+	for (oct = 1; oct < n; oct <<= 1)
+	{
+		for (k = 0; k < ((oct + 1) >> 1); k++, s++)
+		{
+			dst[s << 1] = oct + k;
+			dst[(s << 1) + 1] = (oct << 1) - 1 - k;
+		}
+	}
+}
+static unsigned int planLog2(unsigned int n)
+{
+	unsigned int lg = 0;
+	if (n < 2 || (n & (n - 1)))
+		return 0;
+	while ((1u << lg) < n)
+		lg++;
+	return lg <= FHTPLAN_MAXLOG2 ? lg : 0;
+}
+/*
+* Relative cost of one mixed radix transform pair of size n, in units of one log2 stage of the
+* power of 2 codelets per point. Stage weights and the 2.5x overhead of the generic stage loops
+* over the unrolled codelets were measured on the transform pair alone, 0 when n is unsupported
+*/
+static double mixedRadixCost(unsigned int n)
+{
+	unsigned int radix[sizeof(((FHTPlan*)0)->radix) / sizeof(unsigned int)], i;
+	double stages = 0.0;
+	if (n <= 2 || (n & 1) || n > (1u << FHTPLAN_MAXLOG2) || !mixedRadixFactorize(n >> 1, radix, sizeof(radix) / sizeof(radix[0])))
+		return 0.0;
+	for (i = 0; radix[i]; i++)
+		stages += radix[i] == 2 ? 1.0 : radix[i] == 7 ? 3.2 : radix[i] == 5 ? 2.3 : 1.6;
+	return 2.5 * n * stages;
+}
+static int planSupported(unsigned int n)
+{
+	return planLog2(n) || mixedRadixCost(n) > 0.0;
+}
+unsigned int FHTPlanBlockSize(unsigned int blockSize)
+{
+	unsigned int pow2 = 1, lg = 0;
+	double mixed;
+	while (pow2 < blockSize)
+	{
+		pow2 <<= 1;
+		lg++;
+	}
+	if (pow2 == blockSize)
+		return pow2;
+	mixed = mixedRadixCost(blockSize << 1);
+	// A padded partition needs a second transform round whenever the quantum straddles a partition boundary
+	if (!mixed || (pow2 % blockSize ? 2.0 * pow2 * (lg + 1) * (1.0 + (double)blockSize / pow2) : 2.0 * pow2 * (lg + 1)) <= mixed)
+		return pow2;
+	return blockSize;
+}
+void FHTPlanInverse(const FHTPlan *plan, float *A)
+{
+	if (plan->fft)
+		plan->fft(A, plan->sine);
+	else
+		mixedRadixFHTInverse(plan, A);
+}
+static int planCreate(FHTPlan *plan, unsigned int n)
+{
+	const unsigned int lg = planLog2(n);
+	if (!lg)
+	{
+		plan->fft = 0;
+		return mixedRadixFHTInit(plan, n);
+	}
+	plan->bit = (unsigned int*)malloc(n * sizeof(unsigned int));
+	plan->sine = (float*)malloc(n * sizeof(float));
+	plan->slot = (unsigned int*)malloc(((n >> 1) + 1) * 2 * sizeof(unsigned int));
+	if (!plan->bit || !plan->sine || !plan->slot)
+	{
+		free(plan->bit);
+		free(plan->sine);
+		free(plan->slot);
+		plan->bit = 0;
+		plan->sine = 0;
+		plan->slot = 0;
+		return 0;
+	}
+	fhtbitReversalTbl(plan->bit, n);
+	fhtsinHalfTblFloat(plan->sine, n);
+	fhtSlotTbl(plan->slot, n);
+	plan->fft = planCodelets[lg];
+	return 1;
+}
+static void planDestroy(FHTPlan *plan)
+{
+	if (!plan->fft)
+	{
+		mixedRadixFHTFree(plan);
+		return;
+	}
+	free(plan->bit);
+	free(plan->sine);
+	free(plan->slot);
+	plan->bit = 0;
+	plan->sine = 0;
+	plan->slot = 0;
+	plan->fft = 0;
+}
+const FHTPlan* FHTPlanAcquire(unsigned int n)
+{
+	FHTPlan *plan = 0;
+	unsigned int i;
+	if (!planSupported(n))
+		return 0;
+	FHTPLAN_LOCK();
+	for (i = 0; i < FHTPLAN_MAXPLANS; i++)
+	{
+		if (planRegistry[i].refCount && planRegistry[i].n == n)
+		{
+			plan = &planRegistry[i];
+			break;
+		}
+		if (!plan && !planRegistry[i].refCount)
+			plan = &planRegistry[i];
+	}
+	if (!plan)
+	{
+		FHTPLAN_UNLOCK();
+		return 0;
+	}
+	if (!plan->refCount)
+	{
+		if (!planCreate(plan, n))
+		{
+			FHTPLAN_UNLOCK();
+			return 0;
+		}
+		plan->n = n;
+	}
+	plan->refCount++;
+	FHTPLAN_UNLOCK();
+	return plan;
+}
+void FHTPlanRelease(const FHTPlan *plan)
+{
+	if (!plan)
+		return;
+	FHTPlan *entry = (FHTPlan*)plan;
+	FHTPLAN_LOCK();
+	if (entry->refCount && !--entry->refCount)
+		planDestroy(entry);
+	FHTPLAN_UNLOCK();
+}
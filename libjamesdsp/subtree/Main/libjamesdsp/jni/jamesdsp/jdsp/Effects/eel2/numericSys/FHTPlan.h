@@ -0,0 +1,49 @@
+#ifndef _FHTPLAN_H
+#define _FHTPLAN_H
+/**
+* @brief Shared, immutable transform tables for the real Hartley transforms
+*
+* Plans are keyed by transform size and reference counted, every user of the
+* same size gets the same tables. Powers of 2 run on the radix-2 codelets (fft != 0),
+* other sizes run on the mixed-radix 2/3/5/7 transform in MixedRadixFHT.c.
+* Acquire/release are meant for initialization, never call them from the audio path.
+*/
+typedef struct
+{
+	unsigned int n;
+	unsigned int *bit;
+	float *sine;
+	unsigned int *slot; // Positions of Hartley bins k and n - k in the forward transform output, (n / 2 + 1) pairs in increasing position order
+	void(*fft)(float*, const float*);
+	// Mixed-radix sizes only
+	unsigned int radix[24]; // Radices of the n / 2 point complex transform, 0 terminated
+	unsigned int *bin; // Complex bin held by each digit-reversed position
+	unsigned int *mirror; // Position holding bin n / 2 - bin[p]
+	float *twiddle; // exp(-2 pi i p / (n / 2)), interleaved
+	float *rotate; // exp(-2 pi i k / n), interleaved
+	unsigned int refCount;
+} FHTPlan;
+/**
+* @param n Transform size, power of 2 from 2 to 1048576 or even size up to 1048576 with n / 2 being 7-smooth
+* @return Plan for size n, 0 when n is unsupported or allocation failed
+*/
+extern const FHTPlan* FHTPlanAcquire(unsigned int n);
+extern void FHTPlanRelease(const FHTPlan *plan);
+/**
+* @brief Partition length for a convolver fed with blocks of blockSize samples
+* Keeps blockSize when its double has a mixed-radix transform that is estimated cheaper than
+* the padded power of 2 partition, which needs two transform rounds for blocks straddling a
+* partition boundary. Everything else is rounded up to a power of 2
+*/
+extern unsigned int FHTPlanBlockSize(unsigned int blockSize);
+/**
+* @brief Hartley transform of a spectrum in slot order, result is the time domain in natural order
+*/
+extern void FHTPlanInverse(const FHTPlan *plan, float *A);
+// Natural order time domain to slot order spectrum for mixed-radix plans
+extern void mixedRadixFHTForward(const FHTPlan *plan, float *A);
+extern void mixedRadixFHTInverse(const FHTPlan *plan, float *A);
+extern int mixedRadixFactorize(unsigned int m, unsigned int *radix, unsigned int maxRadix);
+extern int mixedRadixFHTInit(FHTPlan *plan, unsigned int n);
+extern void mixedRadixFHTFree(FHTPlan *plan);
+#endif
@@ -45,6 +45,7 @@ extern void process5BandsCrossover(FiveBandsCrossover *lr4, float x, double *low
 extern void init6BandsCrossover(SixBandsCrossover *lr4, double fs, double lowBandHz, double midBand1Hz, double midBand2Hz, double midBand3Hz, double midBand4Hz);
 extern void clearState6BandsCrossover(SixBandsCrossover *lr4);
 extern void process6BandsCrossover(SixBandsCrossover *lr4, float x, double *lowOut, double *midOut1, double *midOut2, double *midOut3, double *midOut4, double *highOut);
+extern void process6BandsCrossoverStereo(SixBandsCrossover *lr1, SixBandsCrossover *lr2, double *band[6], size_t n);
 extern void init7BandsCrossover(SevenBandsCrossover *lr4, double fs, double lowBandHz, double midBand1Hz, double midBand2Hz, double midBand3Hz, double midBand4Hz, double midBand5Hz);
 extern void clearState7BandsCrossover(SevenBandsCrossover *lr4);
 extern void process7BandsCrossover(SevenBandsCrossover *lr4, float x, double *lowOut, double *midOut1, double *midOut2, double *midOut3, double *midOut4, double *midOut5, double *highOut);
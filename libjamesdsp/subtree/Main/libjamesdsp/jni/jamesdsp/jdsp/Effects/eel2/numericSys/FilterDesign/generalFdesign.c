@@ -663,6 +663,98 @@ void process6BandsCrossover(SixBandsCrossover *lr4, float x, double *lowOut, dou
 	LWZRProcessSampleAPF(&lr4->sys[11], apf, midOut3); //APF
 	LWZRProcessSample(&lr4->sys[14], band4, midOut4, highOut);
 }
+// Stereo block versions of the LWZR sections, x holding n interleaved L/R samples. Loops over channels and
+// sections are written out so that the states stay in registers
+#define LWZR_CHANNEL_SPLIT(c) \
+	{ \
+		double in = x[t + c]; \
+		double lo = a2_lp * in + lp_xm0[c]; \
+		lp_xm0[c] = a1_lp * in - b1 * lo + lp_xm1[c]; \
+		lp_xm1[c] = a2_lp * in - b2 * lo; \
+		double hi = a2_hp * in + hp_xm0[c]; \
+		hp_xm0[c] = a1_hp * in - b1 * hi + hp_xm1[c]; \
+		hp_xm1[c] = a2_hp * in - b2 * hi; \
+		low[t + c] = lo; \
+		x[t + c] = hi; \
+	}
+// Splits x into low, returned in low, and high, replacing x
+static void LWZRProcessStereo(LinkwitzRileyCrossover *lr1, LinkwitzRileyCrossover *lr2, double *x, double *low, size_t n)
+{
+	double a1_lp = lr1->a1_lp, a2_lp = lr1->a2_lp, a1_hp = lr1->a1_hp, a2_hp = lr1->a2_hp, b1 = lr1->b1, b2 = lr1->b2;
+	double lp_xm0[2] = { lr1->lp_xm0, lr2->lp_xm0 }, lp_xm1[2] = { lr1->lp_xm1, lr2->lp_xm1 };
+	double hp_xm0[2] = { lr1->hp_xm0, lr2->hp_xm0 }, hp_xm1[2] = { lr1->hp_xm1, lr2->hp_xm1 };
+	for (size_t t = 0; t < 2 * n; t += 2)
+	{
+		LWZR_CHANNEL_SPLIT(0)
+		LWZR_CHANNEL_SPLIT(1)
+	}
+	lr1->lp_xm0 = lp_xm0[0]; lr1->lp_xm1 = lp_xm1[0]; lr1->hp_xm0 = hp_xm0[0]; lr1->hp_xm1 = hp_xm1[0];
+	lr2->lp_xm0 = lp_xm0[1]; lr2->lp_xm1 = lp_xm1[1]; lr2->hp_xm0 = hp_xm0[1]; lr2->hp_xm1 = hp_xm1[1];
+}
+#define LWZR_CHANNEL_APF(g, k, c) \
+	{ \
+		double in = x[2 * (k) + c]; \
+		double y = a2[g] * in + xm0[g][c]; \
+		xm0[g][c] = a1[g] * in - b1[g] * y + xm1[g][c]; \
+		xm1[g][c] = a2[g] * in - b2[g] * y; \
+		x[2 * (k) + c] = y; \
+	}
+#define LWZR_APF(g, k) { LWZR_CHANNEL_APF(g, k, 0) LWZR_CHANNEL_APF(g, k, 1) }
+// Runs x through up to 4 allpass sections in series, section g lagging g samples behind the first so that their
+// recursions overlap
+static void LWZRProcessAPFStereo(LinkwitzRileyCrossover *sys1, LinkwitzRileyCrossover *sys2, const unsigned char *sections, int count, double *x, size_t n)
+{
+	double a1[4] = { 0 }, a2[4] = { 0 }, b1[4] = { 0 }, b2[4] = { 0 }, xm0[4][2] = { 0 }, xm1[4][2] = { 0 };
+	int g;
+	for (g = 0; g < count; g++)
+	{
+		LinkwitzRileyCrossover *lr1 = &sys1[sections[g]], *lr2 = &sys2[sections[g]];
+		a1[g] = lr1->a1_lp; a2[g] = lr1->a2_lp; b1[g] = lr1->b1; b2[g] = lr1->b2;
+		xm0[g][0] = lr1->lp_xm0; xm1[g][0] = lr1->lp_xm1;
+		xm0[g][1] = lr2->lp_xm0; xm1[g][1] = lr2->lp_xm1;
+	}
+	for (size_t t = 0; t < n + count - 1; t++)
+	{
+		if (count == 4 && t >= 3 && t < n)
+		{
+			LWZR_APF(0, t)
+			LWZR_APF(1, t - 1)
+			LWZR_APF(2, t - 2)
+			LWZR_APF(3, t - 3)
+		}
+		else
+		{
+			if (t < n)
+				LWZR_APF(0, t)
+			if (count > 1 && t >= 1 && t - 1 < n)
+				LWZR_APF(1, t - 1)
+			if (count > 2 && t >= 2 && t - 2 < n)
+				LWZR_APF(2, t - 2)
+			if (count > 3 && t >= 3 && t - 3 < n)
+				LWZR_APF(3, t - 3)
+		}
+	}
+	for (g = 0; g < count; g++)
+	{
+		LinkwitzRileyCrossover *lr1 = &sys1[sections[g]], *lr2 = &sys2[sections[g]];
+		lr1->lp_xm0 = xm0[g][0]; lr1->lp_xm1 = xm1[g][0];
+		lr2->lp_xm0 = xm0[g][1]; lr2->lp_xm1 = xm1[g][1];
+	}
+}
+// Stereo block version, band[5] holding n interleaved L/R input samples. Outputs from low to high in band[0] to band[5]
+void process6BandsCrossoverStereo(SixBandsCrossover *lr1, SixBandsCrossover *lr2, double *band[6], size_t n)
+{
+	static const unsigned char apf0[] = { 1, 5, 7, 10 }, apf1[] = { 3, 8, 12 }, apf2[] = { 9, 13 }, apf3[] = { 11 };
+	LWZRProcessStereo(&lr1->sys[0], &lr2->sys[0], band[5], band[0], n);
+	LWZRProcessAPFStereo(lr1->sys, lr2->sys, apf0, 4, band[0], n);
+	LWZRProcessStereo(&lr1->sys[2], &lr2->sys[2], band[5], band[1], n);
+	LWZRProcessAPFStereo(lr1->sys, lr2->sys, apf1, 3, band[1], n);
+	LWZRProcessStereo(&lr1->sys[4], &lr2->sys[4], band[5], band[2], n);
+	LWZRProcessAPFStereo(lr1->sys, lr2->sys, apf2, 2, band[2], n);
+	LWZRProcessStereo(&lr1->sys[6], &lr2->sys[6], band[5], band[3], n);
+	LWZRProcessAPFStereo(lr1->sys, lr2->sys, apf3, 1, band[3], n);
+	LWZRProcessStereo(&lr1->sys[14], &lr2->sys[14], band[5], band[4], n);
+}
 void init7BandsCrossover(SevenBandsCrossover *lr4, double fs, double lowBandHz, double midBand1Hz, double midBand2Hz, double midBand3Hz, double midBand4Hz, double midBand5Hz)
 {
 	LWZRCalculateCoefficients(&lr4->sys[0], fs, lowBandHz, 0);
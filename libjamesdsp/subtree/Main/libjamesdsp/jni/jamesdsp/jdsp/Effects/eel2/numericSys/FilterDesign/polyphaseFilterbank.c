@@ -437,4 +437,220 @@ void synthesisWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, float *y1, float
 	}
 	*y1 = R1_b * pfb1->postGain;
 	*y2 = R1_b_x2 * pfb1->postGain;
+}
+// Block version of the stereo analysis and synthesis, pfb2 holding the state of the second channel and pfb1
+// everything else. Blocks are stored row by row, row r of a block of n samples at r * n, so that the subband
+// matrices run along the samples.
+// Every stage of the warping networks is a first order allpass waiting on its own output of the previous sample.
+// Up to WARPEDPFB_SKEW neighbouring stages run together, stage g lagging g samples behind the first, so that their
+// recursions overlap instead of running one after another
+#define WARPEDPFB_SKEW 4
+#define WARPEDPFB_SKEWED(n, G, STEP) \
+	for (t = 0; t < (n) + (G) - 1; t++) \
+	{ \
+		if ((G) == WARPEDPFB_SKEW && t >= WARPEDPFB_SKEW - 1 && t < (n)) \
+		{ \
+			for (g = 0; g < WARPEDPFB_SKEW; g++) \
+				STEP(g, t - g) \
+		} \
+		else \
+		{ \
+			for (g = 0; g < (G); g++) \
+				if (t >= g && t - g < (n)) \
+					STEP(g, t - g) \
+		} \
+	}
+// Tap i0 + g of sample k from tap i0 + g - 1
+#define WARPING_STEP(g, k) \
+	{ \
+		float *c1 = taps1 + (i0 + (g)) * n + (k), *c2 = taps2 + (i0 + (g)) * n + (k); \
+		float in1 = c1[-(int)n], in2 = c2[-(int)n]; \
+		y1[g] = (y1[g] - in1) * alpha + u1[g]; \
+		y2[g] = (y2[g] - in2) * alpha + u2[g]; \
+		u1[g] = in1; \
+		u2[g] = in2; \
+		*c1 = y1[g]; \
+		*c2 = y2[g]; \
+	}
+// L rows of taps
+void warpingWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, const float *x1, const float *x2, float *taps1, float *taps2, unsigned int n)
+{
+	unsigned int i0, g, t, L = pfb1->L;
+	float alpha = pfb1->alpha;
+	float *chain1 = pfb1->allpass_delay_chain, *chain2 = pfb2->allpass_delay_chain;
+	if (!n)
+		return;
+	for (t = 0; t < n; t++)
+	{
+		float noise = pfb1->noiseBuffer[pfb1->noiseLoop];
+		pfb1->noiseLoop = (pfb1->noiseLoop + 1) & (DENORMAL_BUFFER - 1);
+		taps1[t] = x1[t] + noise;
+		taps2[t] = x2[t] + noise;
+	}
+	for (i0 = 1; i0 < L; i0 += WARPEDPFB_SKEW)
+	{
+		unsigned int G = L - i0 < WARPEDPFB_SKEW ? L - i0 : WARPEDPFB_SKEW;
+		float y1[WARPEDPFB_SKEW], u1[WARPEDPFB_SKEW], y2[WARPEDPFB_SKEW], u2[WARPEDPFB_SKEW];
+		for (g = 0; g < G; g++)
+		{
+			y1[g] = chain1[i0 + g];
+			u1[g] = chain1[i0 + g - 1];
+			y2[g] = chain2[i0 + g];
+			u2[g] = chain2[i0 + g - 1];
+		}
+		WARPEDPFB_SKEWED(n, G, WARPING_STEP)
+	}
+	for (t = 0; t < L; t++)
+	{
+		chain1[t] = taps1[t * n + n - 1];
+		chain2[t] = taps2[t * n + n - 1];
+	}
+}
+// N rows of subbands from the taps, which are overwritten. Bands not due at a sample are 0.
+// Both channels share the prototype, modulation and decimation counters of pfb, only the taps are per channel
+void analysisBlockWarpedPFBStereo(WarpedPFB *pfb, float *taps1, float *taps2, float *sub1, float *sub2, unsigned int n)
+{
+	unsigned int i, j, k, N = pfb->N, N2 = pfb->N2, m = pfb->m;
+	// Polyphase components, into the first N2 rows
+	for (i = 0; i < N2; i++)
+	{
+		float *x1 = taps1 + i * n, *x2 = taps2 + i * n;
+		for (k = 0; k < n; k++)
+		{
+			x1[k] *= pfb->h[i];
+			x2[k] *= pfb->h[i];
+		}
+		for (j = 1; j < m; j++)
+		{
+			const float *t1 = taps1 + (i + j * N2) * n, *t2 = taps2 + (i + j * N2) * n;
+			float h = pfb->h[i + j * N2];
+			for (k = 0; k < n; k++)
+			{
+				x1[k] += t1[k] * h;
+				x2[k] += t2[k] * h;
+			}
+		}
+	}
+	// Cosine modulation
+	for (j = 0; j < N; j++)
+	{
+		float *s1 = sub1 + j * n, *s2 = sub2 + j * n;
+		const float *c = pfb->channelMatrix + j * N2;
+		for (k = 0; k < n; k++)
+		{
+			s1[k] = 0.0f;
+			s2[k] = 0.0f;
+		}
+		for (i = 0; i < N2; i++)
+		{
+			const float *x1 = taps1 + i * n, *x2 = taps2 + i * n;
+			for (k = 0; k < n; k++)
+			{
+				s1[k] += c[i] * x1[k];
+				s2[k] += c[i] * x2[k];
+			}
+		}
+		unsigned int counter = pfb->decimationCounter[j], Sk = pfb->Sk[j];
+		for (k = 0; k < n; k++)
+		{
+			if (counter == Sk)
+			{
+				s1[k] *= Sk;
+				s2[k] *= Sk;
+			}
+			else
+			{
+				s1[k] = 0.0f;
+				s2[k] = 0.0f;
+			}
+			counter = counter >= Sk ? 1 : counter + 1;
+		}
+	}
+}
+// L rows of polyphase output from N rows of subbands, then moves the decimation counters on by n samples.
+// Bands not due at a sample must be 0
+void synthesisBlockWarpedPFBStereo(WarpedPFB *pfb, const float *sub1, const float *sub2, float *xk1, float *xk2, unsigned int n)
+{
+	unsigned int i, j, k, N = pfb->N, N2 = pfb->N2, m = pfb->m;
+	// Cosine demodulation, into the first N2 rows
+	for (i = 0; i < N2; i++)
+	{
+		float *x1 = xk1 + i * n, *x2 = xk2 + i * n;
+		for (k = 0; k < n; k++)
+		{
+			x1[k] = 0.0f;
+			x2[k] = 0.0f;
+		}
+		for (j = 0; j < N; j++)
+		{
+			const float *s1 = sub1 + j * n, *s2 = sub2 + j * n;
+			float c = pfb->channelMatrix[j * N2 + i];
+			for (k = 0; k < n; k++)
+			{
+				x1[k] += c * s1[k];
+				x2[k] += c * s2[k];
+			}
+		}
+	}
+	// Polyphase filtering, first rows last
+	for (j = m; j-- > 0;)
+	{
+		for (i = 0; i < N2; i++)
+		{
+			const float *c1 = xk1 + i * n, *c2 = xk2 + i * n;
+			float *x1 = xk1 + (j * N2 + i) * n, *x2 = xk2 + (j * N2 + i) * n;
+			float h = pfb->h[j * N2 + i];
+			for (k = 0; k < n; k++)
+			{
+				x1[k] = c1[k] * h;
+				x2[k] = c2[k] * h;
+			}
+		}
+	}
+	// Subsampling counter
+	for (i = 0; i < N; i++)
+		pfb->decimationCounter[i] = (pfb->decimationCounter[i] - 1 + n) % pfb->Sk[i] + 1;
+}
+// Stage i0 + g of sample k, adding its output to the row feeding the next stage
+#define DEWARPING_STEP(g, k) \
+	{ \
+		float *c1 = xk1 + (i0 + (g)) * n + (k), *c2 = xk2 + (i0 + (g)) * n + (k); \
+		float in1 = c1[0], in2 = c2[0]; \
+		y1[g] = (y1[g] - in1) * alpha + u1[g]; \
+		y2[g] = (y2[g] - in2) * alpha + u2[g]; \
+		u1[g] = in1; \
+		u2[g] = in2; \
+		c1[n] = y1[g] + c1[n]; \
+		c2[n] = y2[g] + c2[n]; \
+	}
+// Overwrites the polyphase output with the inputs of every stage
+void dewarpingWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, float *xk1, float *xk2, float *y1Out, float *y2Out, unsigned int n)
+{
+	unsigned int i0, g, t, L = pfb1->L;
+	float alpha = pfb1->alpha;
+	for (i0 = 0; i0 < L - 1; i0 += WARPEDPFB_SKEW)
+	{
+		unsigned int G = L - 1 - i0 < WARPEDPFB_SKEW ? L - 1 - i0 : WARPEDPFB_SKEW;
+		float y1[WARPEDPFB_SKEW], u1[WARPEDPFB_SKEW], y2[WARPEDPFB_SKEW], u2[WARPEDPFB_SKEW];
+		for (g = 0; g < G; g++)
+		{
+			y1[g] = pfb1->APC_delay_2[i0 + g];
+			u1[g] = pfb1->APC_delay_1[i0 + g];
+			y2[g] = pfb2->APC_delay_2[i0 + g];
+			u2[g] = pfb2->APC_delay_1[i0 + g];
+		}
+		WARPEDPFB_SKEWED(n, G, DEWARPING_STEP)
+		for (g = 0; g < G; g++)
+		{
+			pfb1->APC_delay_2[i0 + g] = y1[g];
+			pfb1->APC_delay_1[i0 + g] = u1[g];
+			pfb2->APC_delay_2[i0 + g] = y2[g];
+			pfb2->APC_delay_1[i0 + g] = u2[g];
+		}
+	}
+	for (t = 0; t < n; t++)
+	{
+		y1Out[t] = xk1[(L - 1) * n + t] * pfb1->postGain;
+		y2Out[t] = xk2[(L - 1) * n + t] * pfb1->postGain;
+	}
 }
\ No newline at end of file
@@ -24,6 +24,10 @@ void getSubbandDatWarpedPFB(WarpedPFB *pfb, float *subbands, float *curSk);
 void writeSubbandDatWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, float *subbands1, float *subbands2);
 size_t getMemSizeWarpedPFB(unsigned int N, unsigned int m);
 void synthesisWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, float *y1, float *y2);
+void warpingWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, const float *x1, const float *x2, float *taps1, float *taps2, unsigned int n);
+void analysisBlockWarpedPFBStereo(WarpedPFB *pfb, float *taps1, float *taps2, float *sub1, float *sub2, unsigned int n);
+void synthesisBlockWarpedPFBStereo(WarpedPFB *pfb, const float *sub1, const float *sub2, float *xk1, float *xk2, unsigned int n);
+void dewarpingWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, float *xk1, float *xk2, float *y1, float *y2, unsigned int n);
 void initWarpedPFB(WarpedPFB *pfb, double fs, unsigned int N, unsigned int m);
 void assignPtrWarpedPFB(WarpedPFB *pfb, unsigned int N, unsigned int m);
 void changeWarpingFactorWarpedPFB(WarpedPFB *pfb, float fs, float pfb_log_grid_den);
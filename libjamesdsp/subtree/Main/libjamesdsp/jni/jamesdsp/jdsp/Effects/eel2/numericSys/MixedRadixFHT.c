@@ -0,0 +1,352 @@
+#include <stdlib.h>
+#include <math.h>
+#include "FHTPlan.h"
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+/*
+* Real Hartley transform of any even size n whose half m = n / 2 has no prime factor above 7.
+* The real sequence is viewed as m complex points, transformed with an in-place mixed-radix
+* complex FFT and split into Hartley bin pairs.
+* Forward runs decimation-in-frequency and leaves complex bin k at the digit-reversed position p
+* with bin[p] == k, the split then stores the Hartley pair (k, n - k) at (2p, 2p + 1), which is
+* also the slot order of the plan. Inverse undoes the split in the same positions and runs
+* decimation-in-time back to natural order, so neither direction needs a permutation pass.
+*/
+#define MR_C3 -0.5f
+#define MR_S3 -0.866025403784438647f
+#define MR_C51 0.309016994374947424f
+#define MR_C52 -0.809016994374947424f
+#define MR_S51 -0.951056516295153572f
+#define MR_S52 -0.587785252292473129f
+// Small DFT kernels with exp(-2 pi i / radix) twiddles, operate in place on split real/imag arrays
+static inline void butterfly2(float *re, float *im)
+{
+	const float tr = re[0] - re[1], ti = im[0] - im[1];
+	re[0] += re[1];
+	im[0] += im[1];
+	re[1] = tr;
+	im[1] = ti;
+}
+static inline void butterfly3(float *re, float *im)
+{
+	const float sr = re[1] + re[2], si = im[1] + im[2];
+	const float mr = re[0] + MR_C3 * sr, mi = im[0] + MR_C3 * si;
+	const float dr = -MR_S3 * (im[1] - im[2]), di = MR_S3 * (re[1] - re[2]);
+	re[0] += sr;
+	im[0] += si;
+	re[1] = mr + dr;
+	im[1] = mi + di;
+	re[2] = mr - dr;
+	im[2] = mi - di;
+}
+static inline void butterfly4(float *re, float *im)
+{
+	const float t0r = re[0] + re[2], t0i = im[0] + im[2];
+	const float t1r = re[0] - re[2], t1i = im[0] - im[2];
+	const float t2r = re[1] + re[3], t2i = im[1] + im[3];
+	const float t3r = re[1] - re[3], t3i = im[1] - im[3];
+	re[0] = t0r + t2r;
+	im[0] = t0i + t2i;
+	re[2] = t0r - t2r;
+	im[2] = t0i - t2i;
+	re[1] = t1r + t3i;
+	im[1] = t1i - t3r;
+	re[3] = t1r - t3i;
+	im[3] = t1i + t3r;
+}
+static inline void butterfly5(float *re, float *im)
+{
+	const float a1r = re[1] + re[4], a1i = im[1] + im[4];
+	const float b1r = re[1] - re[4], b1i = im[1] - im[4];
+	const float a2r = re[2] + re[3], a2i = im[2] + im[3];
+	const float b2r = re[2] - re[3], b2i = im[2] - im[3];
+	const float t0r = re[0] + MR_C51 * a1r + MR_C52 * a2r, t0i = im[0] + MR_C51 * a1i + MR_C52 * a2i;
+	const float t1r = -(MR_S51 * b1i + MR_S52 * b2i), t1i = MR_S51 * b1r + MR_S52 * b2r;
+	const float t2r = re[0] + MR_C52 * a1r + MR_C51 * a2r, t2i = im[0] + MR_C52 * a1i + MR_C51 * a2i;
+	const float t3r = -(MR_S52 * b1i - MR_S51 * b2i), t3i = MR_S52 * b1r - MR_S51 * b2r;
+	re[0] += a1r + a2r;
+	im[0] += a1i + a2i;
+	re[1] = t0r + t1r;
+	im[1] = t0i + t1i;
+	re[4] = t0r - t1r;
+	im[4] = t0i - t1i;
+	re[2] = t2r + t3r;
+	im[2] = t2i + t3i;
+	re[3] = t2r - t3r;
+	im[3] = t2i - t3i;
+}
+static inline void butterfly7(float *re, float *im)
+{
+	const float c1 = 0.623489801858733531f, c2 = -0.222520933956314404f, c3 = -0.900968867902419126f;
+	const float s1 = 0.781831482468029809f, s2 = 0.974927912181823607f, s3 = 0.433883739117558121f;
+	const float a1r = re[1] + re[6], a1i = im[1] + im[6], b1r = re[1] - re[6], b1i = im[1] - im[6];
+	const float a2r = re[2] + re[5], a2i = im[2] + im[5], b2r = re[2] - re[5], b2i = im[2] - im[5];
+	const float a3r = re[3] + re[4], a3i = im[3] + im[4], b3r = re[3] - re[4], b3i = im[3] - im[4];
+	const float m1r = re[0] + c1 * a1r + c2 * a2r + c3 * a3r, m1i = im[0] + c1 * a1i + c2 * a2i + c3 * a3i;
+	const float m2r = re[0] + c2 * a1r + c3 * a2r + c1 * a3r, m2i = im[0] + c2 * a1i + c3 * a2i + c1 * a3i;
+	const float m3r = re[0] + c3 * a1r + c1 * a2r + c2 * a3r, m3i = im[0] + c3 * a1i + c1 * a2i + c2 * a3i;
+	const float n1r = s1 * b1r + s2 * b2r + s3 * b3r, n1i = s1 * b1i + s2 * b2i + s3 * b3i;
+	const float n2r = s2 * b1r - s3 * b2r - s1 * b3r, n2i = s2 * b1i - s3 * b2i - s1 * b3i;
+	const float n3r = s3 * b1r - s1 * b2r + s2 * b3r, n3i = s3 * b1i - s1 * b2i + s2 * b3i;
+	re[0] += a1r + a2r + a3r;
+	im[0] += a1i + a2i + a3i;
+	re[1] = m1r + n1i;
+	im[1] = m1i - n1r;
+	re[6] = m1r - n1i;
+	im[6] = m1i + n1r;
+	re[2] = m2r + n2i;
+	im[2] = m2i - n2r;
+	re[5] = m2r - n2i;
+	im[5] = m2i + n2r;
+	re[3] = m3r + n3i;
+	im[3] = m3i - n3r;
+	re[4] = m3r - n3i;
+	im[4] = m3i + n3r;
+}
+/*
+* One stage of the m point complex transform, radix-point DFTs over elements span apart.
+* DIT multiplies the inputs by the twiddles before the butterfly, DIF (the transposed stage)
+* multiplies the outputs after it. Twiddles only depend on j so they are fetched once per j,
+* j == 0 has unit twiddles and skips the multiplies.
+*/
+#define MR_LOAD(q) do { re[q] = a[(q) * step]; im[q] = a[(q) * step + 1]; } while (0)
+#define MR_STORE(q) do { a[(q) * step] = re[q]; a[(q) * step + 1] = im[q]; } while (0)
+#define MR_LOAD_TW(q) do { const float xr = a[(q) * step], xi = a[(q) * step + 1]; re[q] = xr * tw[q][0] - xi * tw[q][1]; im[q] = xr * tw[q][1] + xi * tw[q][0]; } while (0)
+#define MR_STORE_TW(q) do { a[(q) * step] = re[q] * tw[q][0] - im[q] * tw[q][1]; a[(q) * step + 1] = re[q] * tw[q][1] + im[q] * tw[q][0]; } while (0)
+#define MR_STAGE(RADIX, BUTTERFLY) \
+	for (g = 0; g < m; g += group) \
+	{ \
+		float *a = A + (g << 1); \
+		for (q = 0; q < RADIX; q++) \
+			MR_LOAD(q); \
+		BUTTERFLY(re, im); \
+		for (q = 0; q < RADIX; q++) \
+			MR_STORE(q); \
+	} \
+	for (j = 1; j < span; j++) \
+	{ \
+		for (q = 1; q < RADIX; q++) \
+			tw[q] = w + ((q * j * stride) << 1); \
+		for (g = j; g < m; g += group) \
+		{ \
+			float *a = A + (g << 1); \
+			if (dif) \
+			{ \
+				for (q = 0; q < RADIX; q++) \
+					MR_LOAD(q); \
+				BUTTERFLY(re, im); \
+				MR_STORE(0); \
+				for (q = 1; q < RADIX; q++) \
+					MR_STORE_TW(q); \
+			} \
+			else \
+			{ \
+				MR_LOAD(0); \
+				for (q = 1; q < RADIX; q++) \
+					MR_LOAD_TW(q); \
+				BUTTERFLY(re, im); \
+				for (q = 0; q < RADIX; q++) \
+					MR_STORE(q); \
+			} \
+		} \
+	}
+static void mixedRadixStage(float *A, unsigned int m, unsigned int span, unsigned int radix, const float *w, const int dif)
+{
+	const unsigned int group = span * radix;
+	const unsigned int stride = m / group;
+	const unsigned int step = span << 1;
+	float re[7], im[7];
+	const float *tw[7];
+	unsigned int g, j, q;
+	switch (radix)
+	{
+	case 2:
+		MR_STAGE(2, butterfly2)
+		break;
+	case 3:
+		MR_STAGE(3, butterfly3)
+		break;
+	case 4:
+		MR_STAGE(4, butterfly4)
+		break;
+	case 5:
+		MR_STAGE(5, butterfly5)
+		break;
+	default:
+		MR_STAGE(7, butterfly7)
+		break;
+	}
+}
+// Digit-reversed input, natural order output
+static void mixedRadixDIT(const FHTPlan *plan, float *A)
+{
+	const unsigned int m = plan->n >> 1;
+	unsigned int span = 1, t;
+	for (t = 0; plan->radix[t]; t++)
+	{
+		mixedRadixStage(A, m, span, plan->radix[t], plan->twiddle, 0);
+		span *= plan->radix[t];
+	}
+}
+// Transpose of mixedRadixDIT, natural order input, digit-reversed output
+static void mixedRadixDIF(const FHTPlan *plan, float *A)
+{
+	const unsigned int m = plan->n >> 1;
+	unsigned int span = m, t = 0;
+	while (plan->radix[t])
+		t++;
+	while (t--)
+	{
+		span /= plan->radix[t];
+		mixedRadixStage(A, m, span, plan->radix[t], plan->twiddle, 1);
+	}
+}
+void mixedRadixFHTForward(const FHTPlan *plan, float *A)
+{
+	const unsigned int m = plan->n >> 1;
+	unsigned int p, q, k;
+	mixedRadixDIF(plan, A);
+	const float dc = A[0], nyquist = A[1];
+	A[0] = dc + nyquist;
+	A[1] = dc - nyquist;
+	for (p = 1; p < m; p++)
+	{
+		q = plan->mirror[p];
+		if (q < p)
+			continue;
+		k = plan->bin[p];
+		const float *wp = plan->rotate + (k << 1);
+		const float zr = A[p << 1], zi = A[(p << 1) + 1];
+		const float mr = A[q << 1], mi = A[(q << 1) + 1];
+		const float er = 0.5f * (zr + mr), ei = 0.5f * (zi - mi);
+		const float ur = 0.5f * (zi + mi), ui = -0.5f * (zr - mr);
+		const float tr = wp[0] * ur - wp[1] * ui, ti = wp[0] * ui + wp[1] * ur;
+		const float xr = er + tr, xi = ei + ti;
+		A[p << 1] = xr - xi;
+		A[(p << 1) + 1] = xr + xi;
+		if (q != p)
+		{
+			const float yr = er - tr, yi = ti - ei;
+			A[q << 1] = yr - yi;
+			A[(q << 1) + 1] = yr + yi;
+		}
+	}
+}
+void mixedRadixFHTInverse(const FHTPlan *plan, float *A)
+{
+	const unsigned int m = plan->n >> 1;
+	unsigned int p, q, k;
+	const float dc = A[0], nyquist = A[1];
+	A[0] = dc + nyquist;
+	A[1] = nyquist - dc;
+	for (p = 1; p < m; p++)
+	{
+		q = plan->mirror[p];
+		if (q < p)
+			continue;
+		k = plan->bin[p];
+		const float *wp = plan->rotate + (k << 1);
+		const float a = 0.5f * (A[p << 1] + A[(p << 1) + 1]), b = 0.5f * (A[p << 1] - A[(p << 1) + 1]);
+		const float c = 0.5f * (A[q << 1] + A[(q << 1) + 1]), d = 0.5f * (A[q << 1] - A[(q << 1) + 1]);
+		const float sr = a + c, si = d - b;
+		const float dr = a - c, di = -b - d;
+		const float tr = dr * wp[0] + di * wp[1], ti = di * wp[0] - dr * wp[1];
+		A[p << 1] = sr - ti;
+		A[(p << 1) + 1] = -(si + tr);
+		if (q != p)
+		{
+			A[q << 1] = sr + ti;
+			A[(q << 1) + 1] = si - tr;
+		}
+	}
+	mixedRadixDIT(plan, A);
+	for (p = 1; p < plan->n; p += 2)
+		A[p] = -A[p];
+}
+// Radices of m, fours first, 0 terminated, returns 0 when m has a prime factor above 7
+int mixedRadixFactorize(unsigned int m, unsigned int *radix, unsigned int maxRadix)
+{
+	static const unsigned int candidates[] = { 4, 2, 3, 5, 7 };
+	unsigned int i, count = 0;
+	if (m < 2)
+		return 0;
+	for (i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+	{
+		while (!(m % candidates[i]))
+		{
+			if (count + 1 >= maxRadix)
+				return 0;
+			if (radix)
+				radix[count] = candidates[i];
+			count++;
+			m /= candidates[i];
+		}
+	}
+	if (radix)
+		radix[count] = 0;
+	return m == 1;
+}
+int mixedRadixFHTInit(FHTPlan *plan, unsigned int n)
+{
+	const unsigned int m = n >> 1;
+	unsigned int p, t, *position;
+	if ((n & 1) || !mixedRadixFactorize(m, plan->radix, sizeof(plan->radix) / sizeof(plan->radix[0])))
+		return 0;
+	plan->twiddle = (float*)malloc(m * 2 * sizeof(float));
+	plan->rotate = (float*)malloc(m * 2 * sizeof(float));
+	plan->bin = (unsigned int*)malloc(m * sizeof(unsigned int));
+	plan->mirror = (unsigned int*)malloc(m * sizeof(unsigned int));
+	plan->slot = (unsigned int*)malloc((m + 1) * 2 * sizeof(unsigned int));
+	position = (unsigned int*)malloc(m * sizeof(unsigned int));
+	if (!plan->twiddle || !plan->rotate || !plan->bin || !plan->mirror || !plan->slot || !position)
+	{
+		free(position);
+		mixedRadixFHTFree(plan);
+		return 0;
+	}
+	for (p = 0; p < m; p++)
+	{
+		plan->twiddle[p << 1] = (float)cos(2.0 * M_PI * p / m);
+		plan->twiddle[(p << 1) + 1] = (float)-sin(2.0 * M_PI * p / m);
+		plan->rotate[p << 1] = (float)cos(M_PI * p / m);
+		plan->rotate[(p << 1) + 1] = (float)-sin(M_PI * p / m);
+	}
+	for (p = 0; p < m; p++)
+	{
+		unsigned int rem = p, weight = m, k = 0;
+		for (t = 0; plan->radix[t]; t++)
+		{
+			weight /= plan->radix[t];
+			k += (rem % plan->radix[t]) * weight;
+			rem /= plan->radix[t];
+		}
+		plan->bin[p] = k;
+		position[k] = p;
+	}
+	for (p = 0; p < m; p++)
+		plan->mirror[p] = position[(m - plan->bin[p]) % m];
+	free(position);
+	// DC sits alone at 0, Nyquist at 1, every other pair takes one complex position
+	plan->slot[0] = plan->slot[1] = 0;
+	plan->slot[2] = plan->slot[3] = 1;
+	for (p = 1; p < m; p++)
+	{
+		plan->slot[(p + 1) << 1] = p << 1;
+		plan->slot[((p + 1) << 1) + 1] = (p << 1) + 1;
+	}
+	return 1;
+}
+void mixedRadixFHTFree(FHTPlan *plan)
+{
+	free(plan->twiddle);
+	free(plan->rotate);
+	free(plan->bin);
+	free(plan->mirror);
+	free(plan->slot);
+	plan->twiddle = 0;
+	plan->rotate = 0;
+	plan->bin = 0;
+	plan->mirror = 0;
+	plan->slot = 0;
+}
@@ -9,11 +9,11 @@ void FIREqualizerConstructor(JamesDSPLib *jdsp)
 	initIerper(&jdsp->fireq.pch1, NUMPTS + 2);
 	initIerper(&jdsp->fireq.pch2, NUMPTS + 2);
 	jdsp->fireq.instance.filterLen = InitArbitraryEq(&jdsp->fireq.instance.coeffGen, 0);
-	FFTConvolver2x2Init(&jdsp->fireq.instance.convState);
+	HybridFIRConvolver2x2Init(&jdsp->fireq.instance.convState);
 	float *kDelta = (float*)malloc(jdsp->fireq.instance.filterLen * sizeof(float));
 	memset(kDelta, 0, jdsp->fireq.instance.filterLen * sizeof(float));
 	kDelta[0] = 1.0f;
-	FFTConvolver2x2LoadImpulseResponse(&jdsp->fireq.instance.convState, (unsigned int)jdsp->blockSize, kDelta, kDelta, jdsp->fireq.instance.filterLen);
+	HybridFIRConvolver2x2LoadImpulseResponse(&jdsp->fireq.instance.convState, (unsigned int)jdsp->blockSize, kDelta, kDelta, jdsp->fireq.instance.filterLen);
 	free(kDelta);
 }
 void FIREqualizerDestructor(JamesDSPLib *jdsp)
@@ -21,8 +21,8 @@ void FIREqualizerDestructor(JamesDSPLib *jdsp)
 	jdsp_lock(jdsp);
 	freeIerper(&jdsp->fireq.pch1);
 	freeIerper(&jdsp->fireq.pch2);
-	EqNodesFree(&jdsp->fireq.instance.coeffGen);
-	FFTConvolver2x2Free(&jdsp->fireq.instance.convState);
+	FreeArbitraryEq(&jdsp->fireq.instance.coeffGen);
+	HybridFIRConvolver2x2Free(&jdsp->fireq.instance.convState);
 	jdsp_unlock(jdsp);
 }
 void FIREqualizerAxisInterpolation(JamesDSPLib *jdsp, int interpolationMode, int phaseMode, double *freqAx, double *gaindB)
@@ -68,12 +68,12 @@ void FIREqualizerAxisInterpolation(JamesDSPLib *jdsp, int interpolationMode, int
 		filterLen = MUL2FILTERLEN - 1;
 	if (jdsp->equalizerForceRefresh || jdsp->fireq.currentPhaseMode != phaseMode)
 	{
-		FFTConvolver2x2Free(&jdsp->fireq.instance.convState);
-		FFTConvolver2x2LoadImpulseResponse(&jdsp->fireq.instance.convState, (unsigned int)jdsp->blockSize, eqFil, eqFil, filterLen);
+		HybridFIRConvolver2x2Free(&jdsp->fireq.instance.convState);
+		HybridFIRConvolver2x2LoadImpulseResponse(&jdsp->fireq.instance.convState, (unsigned int)jdsp->blockSize, eqFil, eqFil, filterLen);
 		jdsp->equalizerForceRefresh = 0;
 	}
 	else
-		FFTConvolver2x2RefreshImpulseResponse(&jdsp->fireq.instance.convState, (unsigned int)jdsp->blockSize, eqFil, eqFil, filterLen);
+		HybridFIRConvolver2x2RefreshImpulseResponse(&jdsp->fireq.instance.convState, (unsigned int)jdsp->blockSize, eqFil, eqFil, filterLen);
 	jdsp->fireq.currentPhaseMode = phaseMode;
 	jdsp->fireq.currentInterpolationMode = interpolationMode;
 	jdsp_unlock(jdsp);
@@ -115,7 +115,7 @@ void FIREqualizerEnable(JamesDSPLib *jdsp)
 			filterLen = FILTERLEN;
 		else
 			filterLen = MUL2FILTERLEN - 1;
-		FFTConvolver2x2RefreshImpulseResponse(&jdsp->fireq.instance.convState, (unsigned int)jdsp->blockSize, eqFil, eqFil, filterLen);
+		HybridFIRConvolver2x2RefreshImpulseResponse(&jdsp->fireq.instance.convState, (unsigned int)jdsp->blockSize, eqFil, eqFil, filterLen);
 		jdsp->equalizerForceRefresh = 0;
 	}
 	jdsp->equalizerEnabled = 1;
@@ -127,5 +127,5 @@ void FIREqualizerDisable(JamesDSPLib *jdsp)
 }
 void FIREqualizerProcess(JamesDSPLib *jdsp, size_t n)
 {
-	FFTConvolver2x2Process(&jdsp->fireq.instance.convState, jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], (unsigned int)n);
+	HybridFIRConvolver2x2Process(&jdsp->fireq.instance.convState, jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], (unsigned int)n);
 }
\ No newline at end of file
@@ -1,28 +1,79 @@
 void NSEEL_HOSTSTUB_EnterMutex() { }
 void NSEEL_HOSTSTUB_LeaveMutex() { }
 #include "../jdsp_header.h"
+static void LiveProgRegisterVariables(LiveProg *pg, double fs)
+{
+	pg->vmFs = NSEEL_VM_regvar(pg->vm, "srate");
+	*pg->vmFs = (float)fs;
+	pg->input1 = NSEEL_VM_regvar(pg->vm, "spl0");
+	pg->input2 = NSEEL_VM_regvar(pg->vm, "spl1");
+	// @block sees the buffer as nframes samples of each channel in EEL RAM, at spl0buf and spl1buf
+	pg->vmFrames = NSEEL_VM_regvar(pg->vm, "nframes");
+	pg->block1 = NSEEL_VM_regvar(pg->vm, "spl0buf");
+	pg->block2 = NSEEL_VM_regvar(pg->vm, "spl1buf");
+}
 void LiveProgConstructor(JamesDSPLib *jdsp)
 {
 	LiveProg *pg = &jdsp->eel;
     pg->active = 1;
 	pg->compileSucessfully = 0;
 	pg->codehandleInit = 0;
+	pg->codehandleBlock = 0;
 	pg->codehandleProcess = 0;
+	pg->retired = 0;
+	pg->fadeBuf = 0;
+	pg->fadeLen = 0;
 	pg->vm = NSEEL_VM_alloc(); // create virtual machine
-	pg->vmFs = NSEEL_VM_regvar(pg->vm, "srate");
-	*pg->vmFs = jdsp->fs;
-	pg->input1 = NSEEL_VM_regvar(pg->vm, "spl0");
-	pg->input2 = NSEEL_VM_regvar(pg->vm, "spl1");
+	LiveProgRegisterVariables(pg, jdsp->fs);
 }
-void LiveProgDestructor(JamesDSPLib *jdsp)
+// Frees the code and VM of a script that no longer runs on the audio thread
+static void LiveProgFree(LiveProg *pg)
+{
+	if (pg->vm)
+	{
+		NSEEL_code_free(pg->codehandleInit);
+		NSEEL_code_free(pg->codehandleBlock);
+		NSEEL_code_free(pg->codehandleProcess);
+		NSEEL_VM_free(pg->vm);
+	}
+	if (pg->retired)
+	{
+		LiveProgFree(pg->retired);
+		free(pg->retired);
+	}
+	if (pg->fadeBuf)
+		free(pg->fadeBuf);
+}
+// Frees the script replaced by the last reload once its crossfade has run, or when Liveprog was disabled before it could.
+// Called periodically from a control thread through JamesDSPReclaim
+void LiveProgReclaim(JamesDSPLib *jdsp)
 {
+	if (!jdsp->eel.retired)
+		return;
+	LiveProg *old = 0;
+	float *fadeBuf = 0;
 	jdsp_lock(jdsp);
-	if (jdsp->eel.vm)
+	if (jdsp->eel.retired && (!jdsp->eel.fadeLen || !jdsp->liveprogEnabled))
+	{
+		old = jdsp->eel.retired;
+		fadeBuf = jdsp->eel.fadeBuf;
+		jdsp->eel.retired = 0;
+		jdsp->eel.fadeBuf = 0;
+		jdsp->eel.fadeLen = 0;
+	}
+	jdsp_unlock(jdsp);
+	if (old)
 	{
-		NSEEL_code_free(jdsp->eel.codehandleInit);
-		NSEEL_code_free(jdsp->eel.codehandleProcess);
-		NSEEL_VM_free(jdsp->eel.vm);
+		LiveProgFree(old);
+		free(old);
 	}
+	if (fadeBuf)
+		free(fadeBuf);
+}
+void LiveProgDestructor(JamesDSPLib *jdsp)
+{
+	jdsp_lock(jdsp);
+	LiveProgFree(&jdsp->eel);
 	jdsp_unlock(jdsp);
 }
 void LiveProgEnable(JamesDSPLib *jdsp)
@@ -34,28 +85,10 @@ void LiveProgDisable(JamesDSPLib *jdsp)
 {
 	jdsp->liveprogEnabled = 0;
 }
-int LiveProgLoadCode(JamesDSPLib *jdsp, char *codeTextInit, char *codeTextProcess)
+// Compiles into the fresh VM of pg, either of codeTextBlock and codeTextProcess may be null, the script then has no such section
+static int LiveProgLoadCode(LiveProg *pg, char *codeTextInit, char *codeTextBlock, char *codeTextProcess)
 {
-	LiveProg *pg = &jdsp->eel;
 	pg->compileSucessfully = 0;
-	compileContext *ctx = (compileContext*)pg->vm;
-	NSEEL_VM_freevars(pg->vm);
-	NSEEL_init_string(pg->vm);
-	pg->vmFs = NSEEL_VM_regvar(pg->vm, "srate");
-	*pg->vmFs = jdsp->fs;
-	pg->input1 = NSEEL_VM_regvar(pg->vm, "spl0");
-	pg->input2 = NSEEL_VM_regvar(pg->vm, "spl1");
-	if (pg->codehandleInit)
-	{
-		NSEEL_code_free(pg->codehandleInit);
-		pg->codehandleInit = 0;
-	}
-	if (pg->codehandleProcess)
-	{
-		NSEEL_code_free(pg->codehandleProcess);
-		pg->codehandleProcess = 0;
-	}
-	ctx->functions_common = 0;
 	pg->codehandleInit = NSEEL_code_compile_ex(pg->vm, codeTextInit, 0, 1);
 	if (!pg->codehandleInit)
 	{
@@ -63,19 +96,19 @@ int LiveProgLoadCode(JamesDSPLib *jdsp, char *codeTextInit, char *codeTextProces
 		return -1;
 	}
 	NSEEL_code_execute(pg->codehandleInit);
-	pg->codehandleProcess = NSEEL_code_compile(pg->vm, codeTextProcess, 0);
-	if (pg->codehandleInit && pg->codehandleProcess)
+	if (codeTextBlock)
 	{
-		if (pg->codehandleProcess)
-			pg->compileSucessfully = 1;
-		else
-			pg->compileSucessfully = 0;
+		pg->codehandleBlock = NSEEL_code_compile(pg->vm, codeTextBlock, 0);
+		if (!pg->codehandleBlock)
+			return -4;
 	}
-	else
+	if (codeTextProcess)
 	{
-		pg->compileSucessfully = 0;
-		return -3;
+		pg->codehandleProcess = NSEEL_code_compile(pg->vm, codeTextProcess, 0);
+		if (!pg->codehandleProcess)
+			return -3;
 	}
+	pg->compileSucessfully = 1;
 	return 1;
 }
 const char* checkErrorCode(int errCode)
@@ -87,77 +120,141 @@ const char* checkErrorCode(int errCode)
 	case -1:
 		return "Syntax error at @init section";
 	case -2:
-		return "@sample section not found";
+		return "@sample or @block section not found";
 	case -3:
 		return "Syntax error at @sample section";
+	case -4:
+		return "Syntax error at @block section";
 	default:
 		return "No syntax errors detected";
 	}
 }
+// Copy of the text following tag up to the next section, 0 when the script has no such section
+static char* LiveProgSection(const char *eelCode, const char *tag)
+{
+	static const char *tags[3] = { "@init", "@block", "@sample" };
+	const char *start = strstr(eelCode, tag);
+	if (!start)
+		return 0;
+	start += strlen(tag);
+	size_t len = strlen(start);
+	for (int i = 0; i < 3; i++)
+	{
+		const char *next = strstr(start, tags[i]);
+		if (next && (size_t)(next - start) < len)
+			len = next - start;
+	}
+	char *text = (char*)malloc(len + 1);
+	memcpy(text, start, len);
+	text[len] = 0;
+	return text;
+}
+// Compiles and runs @init in a new VM without holding jdsp_lock, the audio thread keeps running the current script meanwhile.
+// The lock is only taken to swap the VMs, the following block crossfades from the old script to the new one
 int LiveProgStringParser(JamesDSPLib *jdsp, char *eelCode)
 {
+	char *codeTextInit = LiveProgSection(eelCode, "@init");
+	char *codeTextBlock = LiveProgSection(eelCode, "@block");
+	char *codeTextProcess = LiveProgSection(eelCode, "@sample");
+	LiveProg next = { 0 };
+	next.vm = NSEEL_VM_alloc();
+	LiveProgRegisterVariables(&next, jdsp->fs);
+	int errorMsg;
+	if (!codeTextInit)
+		errorMsg = 0;
+	else if (!codeTextBlock && !codeTextProcess)
+		errorMsg = -2;
+	else
+		errorMsg = LiveProgLoadCode(&next, codeTextInit, codeTextBlock, codeTextProcess);
+	free(codeTextInit);
+	free(codeTextBlock);
+	free(codeTextProcess);
+	// Crossfade buffer is sized from the block size seen so far, a larger block will switch without fading
+	LiveProg *old = (LiveProg*)malloc(sizeof(LiveProg));
+	size_t fadeLen = jdsp->blockSizeMax;
+	float *fadeBuf = (float*)malloc(2 * fadeLen * sizeof(float));
 	jdsp_lock(jdsp);
-	long long strLen = (long long)strlen(eelCode);
-	const char *initSegment = strstr(eelCode, "@init");
-	if (!initSegment)
+	*old = jdsp->eel;
+	next.active = old->active;
+	if (jdsp->liveprogEnabled && old->compileSucessfully && old->active && fadeLen)
 	{
-		jdsp_unlock(jdsp);
-		return 0;
+		next.retired = old;
+		next.fadeBuf = fadeBuf;
+		next.fadeLen = fadeLen;
+		old = old->retired;
+		fadeBuf = jdsp->eel.fadeBuf;
+		next.retired->retired = 0;
+		next.retired->fadeBuf = 0;
 	}
-	else
-		initSegment += 6;
-	const char *processSegment = strstr(eelCode, "@sample");
-	if (!processSegment)
+	jdsp->eel = next;
+	jdsp_unlock(jdsp);
+	// Whatever the audio thread no longer references is freed here, out of the lock
+	if (old)
 	{
-		jdsp_unlock(jdsp);
-		return -2;
+		LiveProgFree(old);
+		free(old);
 	}
-	else
-		processSegment += 8;
-	char *codeTextInit = (char*)malloc(strLen * sizeof(char));
-	char *codeTextProcess = (char*)malloc(strLen * sizeof(char));
-	memset(codeTextInit, 0, strLen * sizeof(char));
-	memset(codeTextProcess, 0, strLen * sizeof(char));
-	int errorMsg = 1;
-	if (initSegment && processSegment)
+	if (fadeBuf)
+		free(fadeBuf);
+	return errorMsg;
+}
+static void LiveProgRun(LiveProg *eel, float *x1, float *x2, size_t n)
+{
+	if (eel->compileSucessfully && eel->active)
 	{
-		if (initSegment < processSegment)
+		if (eel->codehandleBlock)
 		{
-			long long cpyLen = processSegment - initSegment - (8 + 1);
-			if (cpyLen > 0)
-				strncpy(codeTextInit, initSegment, cpyLen);
-			if (processSegment - eelCode < strLen)
-			{
-				strcpy(codeTextProcess, processSegment);
-			}
-			errorMsg = LiveProgLoadCode(jdsp, codeTextInit, codeTextProcess);
+			// Buffer goes to the top of EEL RAM, away from the low addresses scripts allocate from
+			float *ram = ((compileContext*)eel->vm)->ram_state;
+			size_t offset = NSEEL_RAM_ITEMSPERBLOCK - 2 * n;
+			memcpy(ram + offset, x1, n * sizeof(float));
+			memcpy(ram + offset + n, x2, n * sizeof(float));
+			*eel->vmFrames = (float)n;
+			*eel->block1 = (float)offset;
+			*eel->block2 = (float)(offset + n);
+			NSEEL_code_execute(eel->codehandleBlock);
+			memcpy(x1, ram + offset, n * sizeof(float));
+			memcpy(x2, ram + offset + n, n * sizeof(float));
 		}
-		else
+		if (!eel->codehandleProcess)
+			return;
+		for (size_t i = 0; i < n; i++)
 		{
-			strcpy(codeTextInit, initSegment);
-			long long cpyLen = initSegment - processSegment - (6 + 1);
-			if (cpyLen > 0)
-				strncpy(codeTextProcess, processSegment, cpyLen);
-			errorMsg = LiveProgLoadCode(jdsp, codeTextInit, codeTextProcess);
+			*eel->input1 = x1[i];
+			*eel->input2 = x2[i];
+			NSEEL_code_execute(eel->codehandleProcess);
+			x1[i] = (float)*eel->input1;
+			x2[i] = (float)*eel->input2;
 		}
 	}
-	free(codeTextInit);
-	free(codeTextProcess);
-	jdsp_unlock(jdsp);
-	return errorMsg;
 }
 void LiveProgProcess(JamesDSPLib *jdsp, size_t n)
 {
 	LiveProg *eel = &jdsp->eel;
-    if (eel->compileSucessfully && eel->active)
+	float *x1 = jdsp->tmpBuffer[0];
+	float *x2 = jdsp->tmpBuffer[1];
+	if (eel->fadeLen)
 	{
-		for (size_t i = 0; i < n; i++)
+		// First block after a reload, both scripts see the same input and the output moves linearly from the old to the new
+		size_t fadeLen = eel->fadeLen;
+		eel->fadeLen = 0;
+		if (n && n <= fadeLen)
 		{
-			*eel->input1 = jdsp->tmpBuffer[0][i];
-			*eel->input2 = jdsp->tmpBuffer[1][i];
-			NSEEL_code_execute(eel->codehandleProcess);
-			jdsp->tmpBuffer[0][i] = (float)*eel->input1;
-			jdsp->tmpBuffer[1][i] = (float)*eel->input2;
+			float *y1 = eel->fadeBuf;
+			float *y2 = eel->fadeBuf + fadeLen;
+			memcpy(y1, x1, n * sizeof(float));
+			memcpy(y2, x2, n * sizeof(float));
+			LiveProgRun(eel->retired, y1, y2, n);
+			LiveProgRun(eel, x1, x2, n);
+			float step = 1.0f / (float)n;
+			for (size_t i = 0; i < n; i++)
+			{
+				float g = (float)(i + 1) * step;
+				x1[i] = y1[i] + g * (x1[i] - y1[i]);
+				x2[i] = y2[i] + g * (x2[i] - y2[i]);
+			}
+			return;
 		}
 	}
+	LiveProgRun(eel, x1, x2, n);
 }
@@ -3,11 +3,13 @@
 // Changes:
 // 1. Remove sample in/out structure
 // 2. Change file extension to cpp for easy integrate with c++ program
+// 3. Block processing with L/R as the two lanes of every element, delay lines sized to the room
 // MIT License
 // Project Home: https://github.com/voidqk/sndfilter
 // Using in: JamesDSPManager
 
 #include "../jdsp_header.h"
+#include <stdlib.h>
 #include <math.h>
 #include <string.h>
 
@@ -66,48 +68,88 @@ static inline float randfloat()
     } u = { u.i = 0x3F800000 | R };
     return u.f - 1.0f;
 }
+//
+// delay lines
+//
+// Every element steps exactly once per sample, so one write index per rate serves all of them. Lines are
+// allocated twice: a first pass with no base only measures the arena
+typedef struct
+{
+    float *base;
+    size_t used;
+} sf_rv_arena;
+
+static void ring_make(sf_rv_ring_st *ring, sf_rv_arena *arena, int lag)
+{
+    unsigned int capacity = 1;
+    while (capacity < (unsigned int)lag + SF_REVERB_CHUNK)
+        capacity <<= 1;
+    ring->mask = capacity - 1;
+    ring->buf = arena->base ? arena->base + arena->used : 0;
+    arena->used += capacity * 2;
+}
+
+// Sample written back steps before index w (back 1 being index w - 1)
+#define RV_AT(ring, w, c) ((ring)->buf[((((unsigned int)(w)) & (ring)->mask) << 1) + (c)])
+
+// Lag of the modulated line tap, taken from the write index; wraps (fm - 2 * msize) into [1, size] like
+// the separate read pointer did
+static inline int modlag(int fm, int twoMs, int size)
+{
+    int back = fm - twoMs;
+    while (back <= 0)
+        back += size;
+    while (back > size)
+        back -= size;
+    return back;
+}
+
 //
 // delay
 //
-static inline void delay_make(sf_rv_delay_st *delay, int size)
+static inline void delay_make(sf_rv_delay_st *delay, sf_rv_arena *arena, int sizeL, int sizeR)
 {
-    delay->pos = 0;
-    delay->size = clampi(size, 1, SF_REVERB_DS);
-    memset(delay->buf, 0, sizeof(float) * delay->size);
+    delay->size[0] = clampi(sizeL, 1, SF_REVERB_DS);
+    delay->size[1] = clampi(sizeR, 1, SF_REVERB_DS);
+    ring_make(&delay->ring, arena, delay->size[0] > delay->size[1] ? delay->size[0] : delay->size[1]);
 }
 
-static inline float delay_step(sf_rv_delay_st *delay, float v)
+// y may alias x
+static inline void delay_run(sf_rv_delay_st *delay, unsigned int w, const float *x, float *y, int n)
 {
-    // Prevent FPE due to division by zero! Usually caused by an empty delay buffer (init phase)
-    if(delay->size == 0)
+    for (int i = 0; i < n; i++, w++)
     {
-        return 0;
+        for (int c = 0; c < 2; c++)
+        {
+            float v = x[i * 2 + c];
+            y[i * 2 + c] = RV_AT(&delay->ring, w - delay->size[c], c);
+            RV_AT(&delay->ring, w, c) = v;
+        }
     }
+}
 
-    float out = delay->buf[delay->pos];
-    delay->buf[delay->pos] = v;
-    delay->pos = (delay->pos + 1) % delay->size;
-    return out;
+// Output half of delay_run, valid as long as n does not exceed the delay
+static inline void delay_read(sf_rv_delay_st *delay, unsigned int w, float *y, int n)
+{
+    for (int i = 0; i < n; i++, w++)
+        for (int c = 0; c < 2; c++)
+            y[i * 2 + c] = RV_AT(&delay->ring, w - delay->size[c], c);
 }
 
-// delay_get(d, 1) returns the last written value
-// delay_get(d, 2) returns the second-last written value
-// ..etc
-static inline float delay_get(sf_rv_delay_st *delay, int offset)
+static inline void delay_write(sf_rv_delay_st *delay, unsigned int w, const float *x, int n)
 {
-    if (offset > delay->size)
-        return delay->buf[delay->pos];
-    else if (offset <= 0)
-        offset = 1;
-    int pos = delay->pos - offset;
-    if (pos < 0)
-        pos += delay->size;
-    return delay->buf[pos];
+    for (int i = 0; i < n; i++, w++)
+        for (int c = 0; c < 2; c++)
+            RV_AT(&delay->ring, w, c) = x[i * 2 + c];
 }
 
-static inline float delay_getlast(sf_rv_delay_st *delay)
+// offset 1 is the last written value, offsets beyond the delay return the oldest one
+static inline void delay_tap(sf_rv_tap_st *tap, const sf_rv_ring_st *ring, int c, int size, int offset)
 {
-    return delay->buf[delay->pos];
+    tap->buf = ring->buf;
+    tap->mask = ring->mask;
+    tap->lane = c;
+    tap->back = clampi(offset, 1, size);
 }
 
 //
@@ -121,7 +163,7 @@ static inline void iir1_makeLPF(sf_rv_iir1_st *iir1, int rate, float freq)
     float tano2 = tanf(omega2);
     iir1->b1 = iir1->b2 = tano2 / (1.0f + tano2);
     iir1->a2 = (1.0f - tano2) / (1.0f + tano2);
-    iir1->y1 = 0;
+    iir1->y1[0] = iir1->y1[1] = 0;
 }
 
 static inline void iir1_makeHPF(sf_rv_iir1_st *iir1, int rate, float freq)
@@ -133,19 +175,40 @@ static inline void iir1_makeHPF(sf_rv_iir1_st *iir1, int rate, float freq)
     iir1->b1 = 1.0f / (1.0f + tano2);
     iir1->b2 = -iir1->b1;
     iir1->a2 = (1.0f - tano2) / (1.0f + tano2);
-    iir1->y1 = 0;
+    iir1->y1[0] = iir1->y1[1] = 0;
 }
 
+// Single lane, for the LFO smoothing
 static inline float iir1_step(sf_rv_iir1_st *iir1, float v)
 {
-    float out = v * iir1->b1 + iir1->y1;
-    iir1->y1 = out * iir1->a2 + v * iir1->b2;
+    float out = v * iir1->b1 + iir1->y1[0];
+    iir1->y1[0] = out * iir1->a2 + v * iir1->b2;
     return out;
 }
 
+static inline void iir1_run(sf_rv_iir1_st *iir1, const float *x, float *y, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            float v = x[i * 2 + c];
+            float out = v * iir1->b1 + iir1->y1[c];
+            iir1->y1[c] = out * iir1->a2 + v * iir1->b2;
+            y[i * 2 + c] = out;
+        }
+    }
+}
+
 //
 // biquad
 //
+static inline void biquad_reset(sf_rv_biquad_st *biquad)
+{
+    for (int c = 0; c < 2; c++)
+        biquad->xn1[c] = biquad->xn2[c] = biquad->yn1[c] = biquad->yn2[c] = 0;
+}
+
 static inline void biquad_makeLPF(sf_rv_biquad_st *biquad, int rate, float freq, float bw)
 {
 	freq = clampf(freq, 0, (float)rate * 0.5f);
@@ -159,10 +222,7 @@ static inline void biquad_makeLPF(sf_rv_biquad_st *biquad, int rate, float freq,
     biquad->b2 = biquad->b0;
     biquad->a1 = a0inv * -2.0f * cs;
     biquad->a2 = a0inv * (1.0f - alpha);
-    biquad->xn1 = 0;
-    biquad->xn2 = 0;
-    biquad->yn1 = 0;
-    biquad->yn2 = 0;
+    biquad_reset(biquad);
 }
 
 static inline void biquad_makeLPFQ(sf_rv_biquad_st *biquad, int rate, float freq, float bw)
@@ -177,10 +237,7 @@ static inline void biquad_makeLPFQ(sf_rv_biquad_st *biquad, int rate, float freq
     biquad->b2 = biquad->b0;
     biquad->a1 = a0inv * -2.0f * cs;
     biquad->a2 = a0inv * (1.0f - alpha);
-    biquad->xn1 = 0;
-    biquad->xn2 = 0;
-    biquad->yn1 = 0;
-    biquad->yn2 = 0;
+    biquad_reset(biquad);
 }
 
 static inline void biquad_makeAPF(sf_rv_biquad_st *biquad, int rate, float freq, float bw)
@@ -195,77 +252,84 @@ static inline void biquad_makeAPF(sf_rv_biquad_st *biquad, int rate, float freq,
     biquad->b2 = a0inv * (1.0f + alpha);
     biquad->a1 = biquad->b1;
     biquad->a2 = biquad->b0;
-    biquad->xn1 = 0;
-    biquad->xn2 = 0;
-    biquad->yn1 = 0;
-    biquad->yn2 = 0;
+    biquad_reset(biquad);
 }
 
-static inline float biquad_step(sf_rv_biquad_st *biquad, float v)
+static inline void biquad_run(sf_rv_biquad_st *biquad, const float *x, float *y, int n)
 {
-    float out = v * biquad->b0 + biquad->xn1 * biquad->b1 + biquad->xn2 * biquad->b2 -
-                biquad->yn1 * biquad->a1 - biquad->yn2 * biquad->a2;
-    biquad->xn2 = biquad->xn1;
-    biquad->xn1 = v;
-    biquad->yn2 = biquad->yn1;
-    biquad->yn1 = out;
-    return out;
+    for (int i = 0; i < n; i++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            float v = x[i * 2 + c];
+            float out = v * biquad->b0 + biquad->xn1[c] * biquad->b1 + biquad->xn2[c] * biquad->b2 -
+                        biquad->yn1[c] * biquad->a1 - biquad->yn2[c] * biquad->a2;
+            biquad->xn2[c] = biquad->xn1[c];
+            biquad->xn1[c] = v;
+            biquad->yn2[c] = biquad->yn1[c];
+            biquad->yn1[c] = out;
+            y[i * 2 + c] = out;
+        }
+    }
 }
 
 //
 // earlyref
 //
-static inline void earlyref_make(sf_rv_earlyref_st *earlyref, int rate, float factor, float width)
+static inline void earlyref_make(sf_rv_earlyref_st *earlyref, sf_rv_arena *arena, int rate, float factor, float width)
 {
-    static const float delaytblLc[18] = { 0.0043f, 0.0215f, 0.0225f, 0.0268f, 0.0270f, 0.0298f, 0.0458f, 0.0485f, 0.0572f, 0.0587f, 0.0595f, 0.0612f, 0.0707f, 0.0708f, 0.0726f, 0.0741f, 0.0753f, 0.0797f };
-    static const float delaytblRc[18] = { 0.0053f, 0.0225f, 0.0235f, 0.0278f, 0.0290f, 0.0288f, 0.0468f, 0.0475f, 0.0582f, 0.0577f, 0.0575f, 0.0622f, 0.0697f, 0.0718f, 0.0736f, 0.0751f, 0.0763f, 0.0817f };
+    static const float delaytblc[2][18] = {
+        { 0.0043f, 0.0215f, 0.0225f, 0.0268f, 0.0270f, 0.0298f, 0.0458f, 0.0485f, 0.0572f, 0.0587f, 0.0595f, 0.0612f, 0.0707f, 0.0708f, 0.0726f, 0.0741f, 0.0753f, 0.0797f },
+        { 0.0053f, 0.0225f, 0.0235f, 0.0278f, 0.0290f, 0.0288f, 0.0468f, 0.0475f, 0.0582f, 0.0577f, 0.0575f, 0.0622f, 0.0697f, 0.0718f, 0.0736f, 0.0751f, 0.0763f, 0.0817f } };
     earlyref->wet1 = width * 0.5f + 0.5f;
     earlyref->wet2 = (1.0f - width) * 0.5f;
     int lrdelay = (int)(0.0002f * (float)rate);
-    delay_make(&earlyref->delayRL, lrdelay);
-    delay_make(&earlyref->delayLR, lrdelay);
-    biquad_makeAPF(&earlyref->allpassXL, rate, 740.0f, 4.0f);
-    earlyref->allpassXR = earlyref->allpassXL;
-    biquad_makeAPF(&earlyref->allpassL, rate, 150.0f, 4.0f);
-    earlyref->allpassR = earlyref->allpassL;
+    delay_make(&earlyref->delayX, arena, lrdelay, lrdelay);
+    biquad_makeAPF(&earlyref->allpassX, rate, 740.0f, 4.0f);
+    biquad_makeAPF(&earlyref->allpass, rate, 150.0f, 4.0f);
     factor *= rate;
-    for (int i = 0; i < 18; i++)
-    {
-        earlyref->delaytblL[i] = (int)(delaytblLc[i] * factor);
-        earlyref->delaytblR[i] = (int)(delaytblRc[i] * factor);
-    }
-    delay_make(&earlyref->delayPWL, earlyref->delaytblL[17] + 10);
-    delay_make(&earlyref->delayPWR, earlyref->delaytblR[17] + 10);
-    iir1_makeLPF(&earlyref->lpfL, rate, 20000.0f);
-    earlyref->lpfR = earlyref->lpfL;
-    iir1_makeHPF(&earlyref->hpfL, rate, 4.0f);
-    earlyref->hpfR = earlyref->hpfL;
-}
-
-static inline void earlyref_step(sf_rv_earlyref_st *earlyref, float inputL, float inputR, float *outL, float *outR)
-{
-    static const float gaintblL[18] = { 0.841f, 0.504f, 0.491f, 0.379f, 0.380f, 0.346f, 0.289f, 0.272f, 0.192f, 0.193f, 0.217f, 0.181f, 0.180f, 0.181f, 0.176f, 0.142f, 0.167f, 0.134f };
-    static const float gaintblR[18] = { 0.842f, 0.506f, 0.489f, 0.382f, 0.300f, 0.346f, 0.290f, 0.271f, 0.193f, 0.192f, 0.217f, 0.195f, 0.192f, 0.166f, 0.186f, 0.131f, 0.168f, 0.133f };
-    float wetL = 0, wetR = 0;
-    delay_step(&earlyref->delayPWL, inputL);
-    delay_step(&earlyref->delayPWR, inputR);
-    for (int i = 0; i < 18; i++)
+    for (int c = 0; c < 2; c++)
+        for (int i = 0; i < 18; i++)
+            earlyref->delaytbl[c][i] = (int)(delaytblc[c][i] * factor);
+    delay_make(&earlyref->delayPW, arena, earlyref->delaytbl[0][17] + 10, earlyref->delaytbl[1][17] + 10);
+    // Taps are read right after the write, turn the offsets into lags once
+    for (int c = 0; c < 2; c++)
+        for (int i = 0; i < 18; i++)
+            earlyref->delaytbl[c][i] = clampi(earlyref->delaytbl[c][i], 1, earlyref->delayPW.size[c]);
+    iir1_makeLPF(&earlyref->lpf, rate, 20000.0f);
+    iir1_makeHPF(&earlyref->hpf, rate, 4.0f);
+    earlyref->pos = 0;
+}
+
+static inline void earlyref_run(sf_rv_earlyref_st *earlyref, const float *x, float *y, int n)
+{
+    static const float gaintbl[2][18] = {
+        { 0.841f, 0.504f, 0.491f, 0.379f, 0.380f, 0.346f, 0.289f, 0.272f, 0.192f, 0.193f, 0.217f, 0.181f, 0.180f, 0.181f, 0.176f, 0.142f, 0.167f, 0.134f },
+        { 0.842f, 0.506f, 0.489f, 0.382f, 0.300f, 0.346f, 0.290f, 0.271f, 0.193f, 0.192f, 0.217f, 0.195f, 0.192f, 0.166f, 0.186f, 0.131f, 0.168f, 0.133f } };
+    const sf_rv_ring_st *pw = &earlyref->delayPW.ring;
+    float wet[SF_REVERB_CHUNK * 2], cross[SF_REVERB_CHUNK * 2];
+    unsigned int w = earlyref->pos;
+    delay_write(&earlyref->delayPW, w, x, n);
+    for (int i = 0; i < n; i++)
     {
-        wetL += gaintblL[i] * delay_get(&earlyref->delayPWL, earlyref->delaytblL[i]);
-        wetR += gaintblR[i] * delay_get(&earlyref->delayPWR, earlyref->delaytblR[i]);
+        for (int c = 0; c < 2; c++)
+        {
+            float v = 0;
+            for (int j = 0; j < 18; j++)
+                v += gaintbl[c][j] * RV_AT(pw, w + i + 1 - earlyref->delaytbl[c][j], c);
+            wet[i * 2 + c] = v;
+        }
+        cross[i * 2] = x[i * 2 + 1] + wet[i * 2 + 1];
+        cross[i * 2 + 1] = x[i * 2] + wet[i * 2];
     }
-    float L = delay_step(&earlyref->delayRL, inputR + wetR);
-    L = biquad_step(&earlyref->allpassXL, L);
-    L = biquad_step(&earlyref->allpassL, earlyref->wet1 * wetL + earlyref->wet2 * L);
-    L = iir1_step(&earlyref->hpfL, L);
-    L = iir1_step(&earlyref->lpfL, L);
-    float R = delay_step(&earlyref->delayLR, inputL + wetL);
-    R = biquad_step(&earlyref->allpassXR, R);
-    R = biquad_step(&earlyref->allpassR, earlyref->wet1 * wetR + earlyref->wet2 * R);
-    R = iir1_step(&earlyref->hpfR, R);
-    R = iir1_step(&earlyref->lpfR, R);
-    *outL = L;
-    *outR = R;
+    delay_run(&earlyref->delayX, w, cross, cross, n);
+    biquad_run(&earlyref->allpassX, cross, cross, n);
+    for (int i = 0; i < n * 2; i++)
+        cross[i] = earlyref->wet1 * wet[i] + earlyref->wet2 * cross[i];
+    biquad_run(&earlyref->allpass, cross, y, n);
+    iir1_run(&earlyref->hpf, y, y, n);
+    iir1_run(&earlyref->lpf, y, y, n);
+    earlyref->pos = w + n;
 }
 
 //
@@ -276,31 +340,29 @@ static inline void oversample_make(sf_rv_oversample_st *oversample, int factor)
     oversample->factor = clampi(factor, 1, SF_REVERB_OF);
     biquad_makeLPFQ(&oversample->lpfU, 2 * oversample->factor, 1.0f,
                     0.5773502691896258f); // 1/sqrt(3)
-    oversample->lpfD = oversample->lpfU;
 }
 
-// output length must be oversample->factor
-static inline void oversample_stepup(sf_rv_oversample_st *oversample, float input, float *output)
+// output length must be n * oversample->factor
+static inline void oversample_up(sf_rv_oversample_st *oversample, const float *x, float *y, int n)
 {
-    if (oversample->factor == 1)
+    const int factor = oversample->factor;
+    if (factor == 1)
     {
-        output[0] = input;
+        memcpy(y, x, n * 2 * sizeof(float));
         return;
     }
-    output[0] = biquad_step(&oversample->lpfU, input * oversample->factor);
-    for (int i = 1; i < oversample->factor; i++)
-        output[i] = biquad_step(&oversample->lpfU, 0);
-}
-
-// input length must be oversample->factor
-static inline float oversample_stepdown(sf_rv_oversample_st *oversample, float *input)
-{
-    if (oversample->factor == 1)
-        return input[0];
-    for (int i = 0; i < oversample->factor; i++)
-        biquad_step(&oversample->lpfD, input[i]);
-    return input[0];
+    for (int i = 0; i < n; i++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            y[i * factor * 2 + c] = x[i * 2 + c] * factor;
+            for (int k = 1; k < factor; k++)
+                y[(i * factor + k) * 2 + c] = 0;
+        }
+    }
+    biquad_run(&oversample->lpfU, y, y, n * factor);
 }
+// Downsampling keeps the first sample of every group, the output of its lowpass was never used
 
 //
 // dccut
@@ -312,16 +374,23 @@ static inline void dccut_make(sf_rv_dccut_st *dccut, int rate, float freq)
     float sn = sinf(ang);
     float sqrt3 = 1.7320508075688772f;
     dccut->gain = (sqrt3 - 2.0f * sn) / (sn + sqrt3 * cosf(ang));
-    dccut->y1 = 0;
-    dccut->y2 = 0;
+    dccut->y1[0] = dccut->y1[1] = 0;
+    dccut->y2[0] = dccut->y2[1] = 0;
 }
 
-static inline float dccut_step(sf_rv_dccut_st *dccut, float v)
+static inline void dccut_run(sf_rv_dccut_st *dccut, const float *x, float *y, int n)
 {
-    float out = v - dccut->y1 + dccut->gain * dccut->y2;
-    dccut->y1 = v;
-    dccut->y2 = out;
-    return out;
+    for (int i = 0; i < n; i++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            float v = x[i * 2 + c];
+            float out = v - dccut->y1[c] + dccut->gain * dccut->y2[c];
+            dccut->y1[c] = v;
+            dccut->y2[c] = out;
+            y[i * 2 + c] = out;
+        }
+    }
 }
 
 //
@@ -397,236 +466,235 @@ static inline float lfo_step(sf_rv_lfo_st *lfo)
 //
 // allpass
 //
-static inline void allpass_make(sf_rv_allpass_st *allpass, int size, float feedback, float decay)
+static inline void allpass_make(sf_rv_allpass_st *allpass, sf_rv_arena *arena, int sizeL, int sizeR, float feedback, float decay)
 {
-    allpass->pos = 0;
-    allpass->size = clampi(size, 1, SF_REVERB_APS);
+    allpass->size[0] = clampi(sizeL, 1, SF_REVERB_APS);
+    allpass->size[1] = clampi(sizeR, 1, SF_REVERB_APS);
     allpass->feedback = feedback;
     allpass->decay = decay;
-    memset(allpass->buf, 0, sizeof(float) * allpass->size);
+    ring_make(&allpass->ring, arena, allpass->size[0] > allpass->size[1] ? allpass->size[0] : allpass->size[1]);
 }
 
-static inline float allpass_step(sf_rv_allpass_st *allpass, float v)
+static inline void allpass_run(sf_rv_allpass_st *allpass, unsigned int w, float *x, int n)
 {
-    v += allpass->feedback * allpass->buf[allpass->pos];
-    float out = allpass->decay * allpass->buf[allpass->pos] - allpass->feedback * v;
-    allpass->buf[allpass->pos] = v;
-    allpass->pos = (allpass->pos + 1) % allpass->size;
-    return out;
+    for (int i = 0; i < n; i++, w++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            float buf = RV_AT(&allpass->ring, w - allpass->size[c], c);
+            float v = x[i * 2 + c];
+            v += allpass->feedback * buf;
+            x[i * 2 + c] = allpass->decay * buf - allpass->feedback * v;
+            RV_AT(&allpass->ring, w, c) = v;
+        }
+    }
 }
 
 //
 // allpass2
 //
-static inline void allpass2_make(sf_rv_allpass2_st *allpass2, int size1, int size2, float feedback1,
-                                 float feedback2, float decay1, float decay2)
+static inline void allpass2_make(sf_rv_allpass2_st *allpass2, sf_rv_arena *arena, const int size1[2], const int size2[2],
+                                 float feedback1, float feedback2, float decay1, float decay2)
 {
-    allpass2->pos1 = 0;
-    allpass2->pos2 = 0;
-    allpass2->size1 = clampi(size1, 1, SF_REVERB_AP2S1);
-    allpass2->size2 = clampi(size2, 1, SF_REVERB_AP2S2);
+    for (int c = 0; c < 2; c++)
+    {
+        allpass2->size1[c] = clampi(size1[c], 1, SF_REVERB_AP2S1);
+        allpass2->size2[c] = clampi(size2[c], 1, SF_REVERB_AP2S2);
+    }
     allpass2->feedback1 = feedback1;
     allpass2->feedback2 = feedback2;
     allpass2->decay1 = decay1;
     allpass2->decay2 = decay2;
-    memset(allpass2->buf1, 0, sizeof(float) * allpass2->size1);
-    memset(allpass2->buf2, 0, sizeof(float) * allpass2->size2);
+    ring_make(&allpass2->ring1, arena, allpass2->size1[0] > allpass2->size1[1] ? allpass2->size1[0] : allpass2->size1[1]);
+    ring_make(&allpass2->ring2, arena, allpass2->size2[0] > allpass2->size2[1] ? allpass2->size2[0] : allpass2->size2[1]);
 }
 
-static inline float allpass2_step(sf_rv_allpass2_st *allpass2, float v)
+static inline void allpass2_run(sf_rv_allpass2_st *allpass2, unsigned int w, float *x, int n)
 {
-    v += allpass2->feedback2 * allpass2->buf2[allpass2->pos2];
-    float out = allpass2->decay2 * allpass2->buf2[allpass2->pos2] - v * allpass2->feedback2;
-    v += allpass2->feedback1 * allpass2->buf1[allpass2->pos1];
-    allpass2->buf2[allpass2->pos2] = allpass2->decay1 * allpass2->buf1[allpass2->pos1] -
-                                     v * allpass2->feedback1;
-    allpass2->buf1[allpass2->pos1] = v;
-    allpass2->pos1 = (allpass2->pos1 + 1) % allpass2->size1;
-    allpass2->pos2 = (allpass2->pos2 + 1) % allpass2->size2;
-    return out;
-}
-
-static inline float allpass2_get1(sf_rv_allpass2_st *allpass2, int offset)
-{
-    if (offset > allpass2->size1)
-        return allpass2->buf1[allpass2->pos1];
-    else if (offset <= 0)
-        offset = 1;
-    int rp = allpass2->pos1 - offset;
-    if (rp < 0)
-        rp += allpass2->size1;
-    return allpass2->buf1[rp];
-}
-
-static inline float allpass2_get2(sf_rv_allpass2_st *allpass2, int offset)
-{
-    if (offset > allpass2->size2)
-        return allpass2->buf2[allpass2->pos2];
-    else if (offset <= 0)
-        offset = 1;
-    int rp = allpass2->pos2 - offset;
-    if (rp < 0)
-        rp += allpass2->size2;
-    return allpass2->buf2[rp];
+    for (int i = 0; i < n; i++, w++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            float buf1 = RV_AT(&allpass2->ring1, w - allpass2->size1[c], c);
+            float buf2 = RV_AT(&allpass2->ring2, w - allpass2->size2[c], c);
+            float v = x[i * 2 + c];
+            v += allpass2->feedback2 * buf2;
+            x[i * 2 + c] = allpass2->decay2 * buf2 - v * allpass2->feedback2;
+            v += allpass2->feedback1 * buf1;
+            RV_AT(&allpass2->ring2, w, c) = allpass2->decay1 * buf1 - v * allpass2->feedback1;
+            RV_AT(&allpass2->ring1, w, c) = v;
+        }
+    }
 }
 
 //
 // allpass3
 //
-static inline void allpass3_make(sf_rv_allpass3_st *allpass3, int size1, int msize1, int size2,
-                                 int size3, float feedback1, float feedback2, float feedback3, float decay1, float decay2,
-                                 float decay3)
-{
-    size1 = clampi(size1, 1, SF_REVERB_AP3S1);
-    msize1 = clampi(msize1, 1, SF_REVERB_AP3M1);
-    if (msize1 > size1)
-        msize1 = size1;
-    int newsize = size1 + msize1;
-    allpass3->rpos1 = (msize1 * 2) % newsize;
-    allpass3->wpos1 = 0;
-    allpass3->pos2 = 0;
-    allpass3->pos3 = 0;
-    allpass3->size1 = newsize;
-    allpass3->msize1 = msize1;
-    allpass3->size2 = clampi(size2, 1, SF_REVERB_AP3S2);
-    allpass3->size3 = clampi(size3, 1, SF_REVERB_AP3S3);
+static inline void allpass3_make(sf_rv_allpass3_st *allpass3, sf_rv_arena *arena, const int size1[2], const int msize1[2],
+                                 const int size2[2], const int size3[2], float feedback1, float feedback2, float feedback3,
+                                 float decay1, float decay2, float decay3)
+{
+    int max1 = 0, max2 = 0, max3 = 0;
+    for (int c = 0; c < 2; c++)
+    {
+        int size = clampi(size1[c], 1, SF_REVERB_AP3S1);
+        int msize = clampi(msize1[c], 1, SF_REVERB_AP3M1);
+        if (msize > size)
+            msize = size;
+        allpass3->size1[c] = size + msize;
+        allpass3->msize1[c] = msize;
+        allpass3->size2[c] = clampi(size2[c], 1, SF_REVERB_AP3S2);
+        allpass3->size3[c] = clampi(size3[c], 1, SF_REVERB_AP3S3);
+        if (allpass3->size1[c] > max1)
+            max1 = allpass3->size1[c];
+        if (allpass3->size2[c] > max2)
+            max2 = allpass3->size2[c];
+        if (allpass3->size3[c] > max3)
+            max3 = allpass3->size3[c];
+    }
     allpass3->feedback1 = feedback1;
     allpass3->feedback2 = feedback2;
     allpass3->feedback3 = feedback3;
     allpass3->decay1 = decay1;
     allpass3->decay2 = decay2;
     allpass3->decay3 = decay3;
-    memset(allpass3->buf1, 0, sizeof(float) * allpass3->size1);
-    memset(allpass3->buf2, 0, sizeof(float) * allpass3->size2);
-    memset(allpass3->buf3, 0, sizeof(float) * allpass3->size3);
-}
-
-static inline float allpass3_step(sf_rv_allpass3_st *allpass3, float v, float mod)
-{
-    mod = (mod + 1.0f) * (float)allpass3->msize1;
-    float floormod = floorf(mod);
-    float mfrac = mod - floormod;
-    int rpos1 = allpass3->rpos1 - (int)floormod;
-    if (rpos1 < 0)
-        rpos1 += allpass3->size1;
-    int rpos2 = rpos1 - 1;
-    if (rpos2 < 0)
-        rpos2 += allpass3->size1;
-    v += allpass3->feedback3 * allpass3->buf3[allpass3->pos3];
-    float out = allpass3->decay3 * allpass3->buf3[allpass3->pos3] - allpass3->feedback3 * v;
-    v += allpass3->feedback2 * allpass3->buf2[allpass3->pos2];
-    allpass3->buf3[allpass3->pos3] = allpass3->decay2 * allpass3->buf2[allpass3->pos2] -
-                                     allpass3->feedback2 * v;
-    float tmp = allpass3->buf1[rpos2] * mfrac + allpass3->buf1[rpos1] * (1.0f - mfrac);
-    v += allpass3->feedback1 * tmp;
-    allpass3->buf2[allpass3->pos2] = allpass3->decay1 * tmp - allpass3->feedback1 * v;
-    allpass3->buf1[allpass3->wpos1] = v;
-    allpass3->wpos1 = (allpass3->wpos1 + 1) % allpass3->size1;
-    allpass3->rpos1 = (allpass3->rpos1 + 1) % allpass3->size1;
-    allpass3->pos2 = (allpass3->pos2 + 1) % allpass3->size2;
-    allpass3->pos3 = (allpass3->pos3 + 1) % allpass3->size3;
-    return out;
+    ring_make(&allpass3->ring1, arena, max1);
+    ring_make(&allpass3->ring2, arena, max2);
+    ring_make(&allpass3->ring3, arena, max3);
 }
 
-static inline float allpass3_get1(sf_rv_allpass3_st *allpass3, int offset)
+// The right lane runs with the modulation inverted
+static inline void allpass3_run(sf_rv_allpass3_st *allpass3, unsigned int w, float *x, const float *lfo, int n)
 {
-    if (offset > allpass3->size1)
-        return allpass3->buf1[allpass3->rpos1];
-    else if (offset <= 0)
-        offset = 1;
-    int rp = allpass3->rpos1 - offset;
-    if (rp < 0)
-        rp += allpass3->size1;
-    return allpass3->buf1[rp];
-}
-
-static inline float allpass3_get2(sf_rv_allpass3_st *allpass3, int offset)
-{
-    if (offset > allpass3->size2)
-        return allpass3->buf2[allpass3->pos2];
-    else if (offset <= 0)
-        offset = 1;
-    int rp = allpass3->pos2 - offset;
-    if (rp < 0)
-        rp += allpass3->size2;
-    return allpass3->buf2[rp];
+    for (int i = 0; i < n; i++, w++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            float mod = c ? -lfo[i] : lfo[i];
+            mod = (mod + 1.0f) * (float)allpass3->msize1[c];
+            float floormod = floorf(mod);
+            float mfrac = mod - floormod;
+            int size1 = allpass3->size1[c];
+            int back1 = modlag((int)floormod, allpass3->msize1[c] * 2, size1);
+            int back2 = back1 + 1 > size1 ? 1 : back1 + 1;
+            float buf3 = RV_AT(&allpass3->ring3, w - allpass3->size3[c], c);
+            float buf2 = RV_AT(&allpass3->ring2, w - allpass3->size2[c], c);
+            float v = x[i * 2 + c];
+            v += allpass3->feedback3 * buf3;
+            x[i * 2 + c] = allpass3->decay3 * buf3 - allpass3->feedback3 * v;
+            v += allpass3->feedback2 * buf2;
+            RV_AT(&allpass3->ring3, w, c) = allpass3->decay2 * buf2 - allpass3->feedback2 * v;
+            float tmp = RV_AT(&allpass3->ring1, w - back2, c) * mfrac + RV_AT(&allpass3->ring1, w - back1, c) * (1.0f - mfrac);
+            v += allpass3->feedback1 * tmp;
+            RV_AT(&allpass3->ring2, w, c) = allpass3->decay1 * tmp - allpass3->feedback1 * v;
+            RV_AT(&allpass3->ring1, w, c) = v;
+        }
+    }
 }
 
-static inline float allpass3_get3(sf_rv_allpass3_st *allpass3, int offset)
+// Line 1 offsets count from the read pointer, which leads the write index by twice the mod size
+static inline void allpass3_tap1(sf_rv_tap_st *tap, const sf_rv_allpass3_st *allpass3, int c, int offset)
 {
-    if (offset > allpass3->size3)
-        return allpass3->buf3[allpass3->pos3];
+    int size1 = allpass3->size1[c];
+    if (offset > size1)
+        offset = 0;
     else if (offset <= 0)
         offset = 1;
-    int rp = allpass3->pos3 - offset;
-    if (rp < 0)
-        rp += allpass3->size3;
-    return allpass3->buf3[rp];
+    tap->buf = allpass3->ring1.buf;
+    tap->mask = allpass3->ring1.mask;
+    tap->lane = c;
+    tap->back = modlag(offset, allpass3->msize1[c] * 2, size1);
 }
 
 //
 // allpassm
 //
-static inline void allpassm_make(sf_rv_allpassm_st *allpassm, int size, int msize, float feedback,
-                                 float decay)
-{
-    size = clampi(size, 1, SF_REVERB_APMS);
-    msize = clampi(msize, 1, SF_REVERB_APMM);
-    if (msize > size)
-        msize = size;
-    int newsize = size + msize;
-    allpassm->rpos = (msize * 2) % newsize;
-    allpassm->wpos = 0;
-    allpassm->size = newsize;
-    allpassm->msize = msize;
+static inline void allpassm_make(sf_rv_allpassm_st *allpassm, sf_rv_arena *arena, int sizeL, int sizeR, int msize,
+                                 float feedback, float decay)
+{
+    int sizes[2] = { sizeL, sizeR };
+    for (int c = 0; c < 2; c++)
+    {
+        int size = clampi(sizes[c], 1, SF_REVERB_APMS);
+        int ms = clampi(msize, 1, SF_REVERB_APMM);
+        if (ms > size)
+            ms = size;
+        allpassm->size[c] = size + ms;
+        allpassm->msize[c] = ms;
+        allpassm->z1[c] = 0;
+    }
     allpassm->feedback = feedback;
     allpassm->decay = decay;
-    allpassm->z1 = 0;
-    memset(allpassm->buf, 0, sizeof(float) * allpassm->size);
-}
-
-static inline float allpassm_step(sf_rv_allpassm_st *allpassm, float v, float mod, float fbmod)
-{
-    float mfeedback = allpassm->feedback + fbmod;
-    mod = (mod + 1.0f) * (float)allpassm->msize;
-    float floormod = floorf(mod);
-    float mfrac = 1.0f - mod + floormod;
-    int rpos1 = allpassm->rpos - (int)floormod;
-    if (rpos1 < 0)
-        rpos1 += allpassm->size;
-    int rpos2 = rpos1 - 1;
-    if (rpos2 < 0)
-        rpos2 += allpassm->size;
-    allpassm->z1 = allpassm->buf[rpos2] + mfrac * (allpassm->buf[rpos1] - allpassm->z1);
-    allpassm->rpos = (allpassm->rpos + 1) % allpassm->size;
-    allpassm->buf[allpassm->wpos] = v + allpassm->z1 * mfeedback;
-    v = allpassm->decay * allpassm->z1 - allpassm->buf[allpassm->wpos] * mfeedback;
-    allpassm->wpos = (allpassm->wpos + 1) % allpassm->size;
-    return v;
+    ring_make(&allpassm->ring, arena, allpassm->size[0] > allpassm->size[1] ? allpassm->size[0] : allpassm->size[1]);
+}
+
+// Tap position of the modulated line for one chunk, shared by every all-pass with the same mod size
+typedef struct
+{
+    int fm[SF_REVERB_CHUNK];
+    float mfrac[SF_REVERB_CHUNK];
+} sf_rv_mod_st;
+
+static inline void allpassm_mod(sf_rv_mod_st *pos, const float *mod, float sign, int msize, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        float m = (mod[i] * sign + 1.0f) * (float)msize;
+        float floormod = floorf(m);
+        pos->fm[i] = (int)floormod;
+        pos->mfrac[i] = 1.0f - m + floormod;
+    }
+}
+
+// Each lane reads its own tap positions and scales the feedback modulation by its own sign
+static inline void allpassm_run(sf_rv_allpassm_st *allpassm, unsigned int w, float *x, const sf_rv_mod_st *mod[2],
+                                const float *fbmod, const float fbsign[2], int n)
+{
+    for (int i = 0; i < n; i++, w++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            float mfeedback = allpassm->feedback + fbmod[i] * fbsign[c];
+            float mfrac = mod[c]->mfrac[i];
+            int size = allpassm->size[c];
+            int back1 = modlag(mod[c]->fm[i], allpassm->msize[c] * 2, size);
+            int back2 = back1 + 1 > size ? 1 : back1 + 1;
+            float z1 = RV_AT(&allpassm->ring, w - back2, c) + mfrac * (RV_AT(&allpassm->ring, w - back1, c) - allpassm->z1[c]);
+            float v = x[i * 2 + c] + z1 * mfeedback;
+            allpassm->z1[c] = z1;
+            RV_AT(&allpassm->ring, w, c) = v;
+            x[i * 2 + c] = allpassm->decay * z1 - v * mfeedback;
+        }
+    }
 }
 
 //
 // comb
 //
-static inline void comb_make(sf_rv_comb_st *comb, int size)
+static inline void comb_make(sf_rv_comb_st *comb, sf_rv_arena *arena, int size)
 {
-    comb->pos = 0;
-    comb->size = clampi(size, 1, SF_REVERB_CS);
-    memset(comb->buf, 0, sizeof(float) * comb->size);
+    comb->size[0] = comb->size[1] = clampi(size, 1, SF_REVERB_CS);
+    ring_make(&comb->ring, arena, comb->size[0]);
 }
 
-static inline float comb_step(sf_rv_comb_st *comb, float v, float feedback)
+// The right lane runs with the feedback inverted
+static inline void comb_run(sf_rv_comb_st *comb, unsigned int w, float *x, const float *feedback, int n)
 {
-    v = comb->buf[comb->pos] * feedback + v;
-    comb->buf[comb->pos] = v;
-    comb->pos = (comb->pos + 1) % comb->size;
-    return v;
+    for (int i = 0; i < n; i++, w++)
+    {
+        for (int c = 0; c < 2; c++)
+        {
+            float v = RV_AT(&comb->ring, w - comb->size[c], c) * (c ? -feedback[i] : feedback[i]) + x[i * 2 + c];
+            RV_AT(&comb->ring, w, c) = v;
+            x[i * 2 + c] = v;
+        }
+    }
 }
 
 //
 // reverb implementation
 //
-void sf_advancereverb(sf_reverb_state_st *rv, int rate, int oversamplefactor, float ertolate, float erefwet, float dry, float ereffactor, float erefwidth, float width, float wet, float wander, float bassb, float spin, float inputlpf, float basslpf, float damplpf, float outputlpf, float rt60, float delay)
+static void sf_buildreverb(sf_reverb_state_st *rv, sf_rv_arena *arena, int rate, int oversamplefactor, float ertolate, float erefwet, float dry, float ereffactor, float erefwidth, float width, float wet, float wander, float bassb, float spin, float inputlpf, float basslpf, float damplpf, float outputlpf, float rt60, float delay)
 {
 	rv->ertolate = ertolate;
 	rv->erefwet = db2lin(erefwet);
@@ -636,12 +704,10 @@ void sf_advancereverb(sf_reverb_state_st *rv, int rate, int oversamplefactor, fl
 	rv->wet2 = wet * ((1.0f - width) * 0.5f);
 	rv->wander = wander;
 	rv->bassb = bassb;
-	earlyref_make(&rv->earlyref, rate, ereffactor, erefwidth);
-	oversample_make(&rv->oversampleL, oversamplefactor);
-	rv->oversampleR = rv->oversampleL;
-	int osrate = rate * rv->oversampleL.factor;
-	dccut_make(&rv->dccutL, osrate, 5.0f);
-	rv->dccutR = rv->dccutL;
+	earlyref_make(&rv->earlyref, arena, rate, ereffactor, erefwidth);
+	oversample_make(&rv->oversample, oversamplefactor);
+	int osrate = rate * rv->oversample.factor;
+	dccut_make(&rv->dccut, osrate, 5.0f);
 	noise_make(&rv->noise);
 	lfo_make(&rv->lfo1, osrate, spin);
 	iir1_makeLPF(&rv->lfo1_lpf, osrate, 20.0f);
@@ -652,85 +718,104 @@ void sf_advancereverb(sf_reverb_state_st *rv, int rate, int oversamplefactor, fl
 	int totfactor = osrate / 34125;
 	int msize = nextprime(10 * osrate / 34125);
 	for (int i = 0; i < 10; i++)
-	{
-		allpassm_make(&rv->diffL[i], nextprime(diffLc[i] * totfactor), msize, -0.78f, 1);
-		allpassm_make(&rv->diffR[i], nextprime(diffRc[i] * totfactor), msize, -0.78f, 1);
-	}
+		allpassm_make(&rv->diff[i], arena, nextprime(diffLc[i] * totfactor), nextprime(diffRc[i] * totfactor), msize, -0.78f, 1);
 	static const int crossLc[4] = { 430, 341, 264, 174 };
 	static const int crossRc[4] = { 447, 324, 247, 191 };
 	for (int i = 0; i < 4; i++)
-	{
-		allpass_make(&rv->crossL[i], nextprime(crossLc[i] * totfactor), 0.78f, 1);
-		allpass_make(&rv->crossR[i], nextprime(crossRc[i] * totfactor), 0.78f, 1);
-	}
-	iir1_makeLPF(&rv->clpfL, osrate, inputlpf);
-	rv->clpfR = rv->clpfL;
-	delay_make(&rv->cdelayL, nextprime(1572 * totfactor));
-	delay_make(&rv->cdelayR, nextprime(16 * totfactor));
-	delay_make(&rv->dampdL, nextprime(2 * totfactor));
-	delay_make(&rv->dampdR, nextprime(totfactor));
-	delay_make(&rv->cbassd1L, nextprime(1055 * totfactor));
-	delay_make(&rv->cbassd1R, nextprime(1460 * totfactor));
-	delay_make(&rv->cbassd2L, nextprime(344 * totfactor));
-	delay_make(&rv->cbassd2R, nextprime(500 * totfactor));
-	biquad_makeAPF(&rv->bassapL, osrate, 150.0f, 4.0f);
-	rv->bassapR = rv->bassapL;
-	biquad_makeLPF(&rv->basslpL, osrate, basslpf, 2.0f);
-	rv->basslpR = rv->basslpL;
-	iir1_makeLPF(&rv->damplpL, osrate, damplpf);
-	rv->damplpR = rv->damplpL;
+		allpass_make(&rv->cross[i], arena, nextprime(crossLc[i] * totfactor), nextprime(crossRc[i] * totfactor), 0.78f, 1);
+	iir1_makeLPF(&rv->clpf, osrate, inputlpf);
+	delay_make(&rv->cdelay, arena, nextprime(1572 * totfactor), nextprime(16 * totfactor));
+	delay_make(&rv->dampd, arena, nextprime(2 * totfactor), nextprime(totfactor));
+	delay_make(&rv->cbassd1, arena, nextprime(1055 * totfactor), nextprime(1460 * totfactor));
+	delay_make(&rv->cbassd2, arena, nextprime(344 * totfactor), nextprime(500 * totfactor));
+	biquad_makeAPF(&rv->bassap, osrate, 150.0f, 4.0f);
+	biquad_makeLPF(&rv->basslp, osrate, basslpf, 2.0f);
+	iir1_makeLPF(&rv->damplp, osrate, damplpf);
 	float decay0 = powf(10.0f, log10f(0.237f) / rt60);
 	float decay1 = powf(10.0f, log10f(0.938f) / rt60);
 	float decay2 = powf(10.0f, log10f(0.844f) / rt60);
 	float decay3 = powf(10.0f, log10f(0.906f) / rt60);
 	rv->loopdecay = decay0;
 	msize = nextprime(32 * totfactor);
-	allpassm_make(&rv->dampap1L, nextprime(239 * totfactor), msize, 0.375f, decay2);
-	allpassm_make(&rv->dampap1R, nextprime(205 * totfactor), msize, 0.375f, decay2);
-	allpassm_make(&rv->dampap2L, nextprime(392 * totfactor), msize, 0.312f, decay3);
-	allpassm_make(&rv->dampap2R, nextprime(329 * totfactor), msize, 0.312f, decay3);
-	allpass2_make(&rv->cbassap1L, nextprime(1944 * totfactor), nextprime(612 * totfactor),
-		0.250f, 0.406f, decay1, decay2);
-	allpass2_make(&rv->cbassap1R, nextprime(2032 * totfactor), nextprime(368 * totfactor),
-		0.250f, 0.406f, decay1, decay2);
-	allpass3_make(&rv->cbassap2L,
-		nextprime(1212 * totfactor),
-		nextprime(121 * totfactor),
-		nextprime(816 * totfactor),
-		nextprime(1264 * totfactor),
-		0.250f, 0.250f, 0.406f, decay1, decay1, decay2);
-	allpass3_make(&rv->cbassap2R,
-		nextprime(1452 * totfactor),
-		nextprime(5 * totfactor),
-		nextprime(688 * totfactor),
-		nextprime(1340 * totfactor),
+	allpassm_make(&rv->dampap1, arena, nextprime(239 * totfactor), nextprime(205 * totfactor), msize, 0.375f, decay2);
+	allpassm_make(&rv->dampap2, arena, nextprime(392 * totfactor), nextprime(329 * totfactor), msize, 0.312f, decay3);
+	const int ap2size1[2] = { nextprime(1944 * totfactor), nextprime(2032 * totfactor) };
+	const int ap2size2[2] = { nextprime(612 * totfactor), nextprime(368 * totfactor) };
+	allpass2_make(&rv->cbassap1, arena, ap2size1, ap2size2, 0.250f, 0.406f, decay1, decay2);
+	const int ap3size1[2] = { nextprime(1212 * totfactor), nextprime(1452 * totfactor) };
+	const int ap3msize1[2] = { nextprime(121 * totfactor), nextprime(5 * totfactor) };
+	const int ap3size2[2] = { nextprime(816 * totfactor), nextprime(688 * totfactor) };
+	const int ap3size3[2] = { nextprime(1264 * totfactor), nextprime(1340 * totfactor) };
+	allpass3_make(&rv->cbassap2, arena, ap3size1, ap3msize1, ap3size2, ap3size3,
 		0.250f, 0.250f, 0.406f, decay1, decay1, decay2);
+	comb_make(&rv->comb, arena, nextprime(22 * osrate / 1000));
+	biquad_makeLPF(&rv->lastlpf, osrate, outputlpf, 1.0f);
+	int delaysamp = (int)(osrate * delay);
+	if (delaysamp >= 0)
+	{
+		delay_make(&rv->inpdelay, arena, 0, 0);
+		delay_make(&rv->lastdelay, arena, delaysamp, delaysamp);
+	}
+	else
+	{
+		delay_make(&rv->inpdelay, arena, -delaysamp, -delaysamp);
+		delay_make(&rv->lastdelay, arena, 0, 0);
+	}
 	static const int outco[32] =
 	{
 		1,  40, 192, 276, 321, 110, 468, 1572, 121, 480, 103, 26, 780, 1200, 310, 780,
 		625, 468, 312,  24,  36, 790, 189,   8,  10, 359,  30, 10, 109, 1310, 800,  10
 	};
-	for (int i = 0; i < 32; i++)
-		rv->outco[i] = outco[i] * totfactor;
-	comb_make(&rv->combL, nextprime(22 * osrate / 1000));
-	rv->combR = rv->combL;
-	biquad_makeLPF(&rv->lastlpfL, osrate, outputlpf, 1.0f);
-	rv->lastlpfR = rv->lastlpfL;
-	int delaysamp = (int)(osrate * delay);
-	if (delaysamp >= 0)
+	// Output taps in the order sf_reverb_process sums them, lane 0 building D and lane 1 building B
+	sf_rv_tap_st *tap = rv->tap;
+	for (int c = 0, i = 0; c < 2; c++, i += 16)
 	{
-		delay_make(&rv->inpdelayL, 0);
-		delay_make(&rv->inpdelayR, 0);
-		delay_make(&rv->lastdelayL, delaysamp);
-		delay_make(&rv->lastdelayR, delaysamp);
+		int o = 1 - c;
+		delay_tap(&tap[i + 0], &rv->cbassd1.ring, c, rv->cbassd1.size[c], outco[i + 0] * totfactor);
+		delay_tap(&tap[i + 1], &rv->cbassd2.ring, c, rv->cbassd2.size[c], outco[i + 1] * totfactor);
+		delay_tap(&tap[i + 2], &rv->cbassd2.ring, o, rv->cbassd2.size[o], outco[i + 2] * totfactor);
+		delay_tap(&tap[i + 3], &rv->cbassd2.ring, c, rv->cbassd2.size[c], outco[i + 3] * totfactor);
+		delay_tap(&tap[i + 4], &rv->cdelay.ring, o, rv->cdelay.size[o], outco[i + 4] * totfactor);
+		delay_tap(&tap[i + 5], &rv->cbassd1.ring, o, rv->cbassd1.size[o], outco[i + 5] * totfactor);
+		delay_tap(&tap[i + 6], &rv->cbassd2.ring, o, rv->cbassd2.size[o], outco[i + 6] * totfactor);
+		delay_tap(&tap[i + 7], &rv->cdelay.ring, c, rv->cdelay.size[c], outco[i + 7] * totfactor);
+		delay_tap(&tap[i + 8], &rv->cbassap1.ring1, c, rv->cbassap1.size1[c], outco[i + 8] * totfactor);
+		delay_tap(&tap[i + 9], &rv->cbassap1.ring2, c, rv->cbassap1.size2[c], outco[i + 9] * totfactor);
+		delay_tap(&tap[i + 10], &rv->cbassap1.ring2, o, rv->cbassap1.size2[o], outco[i + 10] * totfactor);
+		allpass3_tap1(&tap[i + 11], &rv->cbassap2, c, outco[i + 11] * totfactor);
+		delay_tap(&tap[i + 12], &rv->cbassap2.ring2, c, rv->cbassap2.size2[c], outco[i + 12] * totfactor);
+		delay_tap(&tap[i + 13], &rv->cbassap2.ring3, c, rv->cbassap2.size3[c], outco[i + 13] * totfactor);
+		delay_tap(&tap[i + 14], &rv->cbassap2.ring2, o, rv->cbassap2.size2[o], outco[i + 14] * totfactor);
+		delay_tap(&tap[i + 15], &rv->cdelay.ring, c, rv->cdelay.size[c], outco[i + 15] * totfactor);
 	}
-	else
+	// Cross-fade bass delay (1) closes the feedback loop, every other stage only feeds forward
+	rv->chunk = SF_REVERB_CHUNK;
+	for (int c = 0; c < 2; c++)
+		if (rv->cbassd1.size[c] < rv->chunk)
+			rv->chunk = rv->cbassd1.size[c];
+	rv->pos = 0;
+}
+// Not safe against a concurrent sf_reverb_process, use Reverb_SetAdvancedParam on a running JamesDSPLib
+void sf_advancereverb(sf_reverb_state_st *rv, int rate, int oversamplefactor, float ertolate, float erefwet, float dry, float ereffactor, float erefwidth, float width, float wet, float wander, float bassb, float spin, float inputlpf, float basslpf, float damplpf, float outputlpf, float rt60, float delay)
+{
+	sf_rv_arena arena = { 0, 0 };
+	sf_buildreverb(rv, &arena, rate, oversamplefactor, ertolate, erefwet, dry, ereffactor, erefwidth, width, wet, wander, bassb, spin, inputlpf, basslpf, damplpf, outputlpf, rt60, delay);
+	float *mem = (float*)calloc(arena.used, sizeof(float));
+	if (mem)
 	{
-		delay_make(&rv->inpdelayL, -delaysamp);
-		delay_make(&rv->inpdelayR, -delaysamp);
-		delay_make(&rv->lastdelayL, 0);
-		delay_make(&rv->lastdelayR, 0);
+		arena.base = mem;
+		arena.used = 0;
+		sf_buildreverb(rv, &arena, rate, oversamplefactor, ertolate, erefwet, dry, ereffactor, erefwidth, width, wet, wander, bassb, spin, inputlpf, basslpf, damplpf, outputlpf, rt60, delay);
 	}
+	if (rv->arena)
+		free(rv->arena);
+	rv->arena = mem;
+}
+void sf_reverb_free(sf_reverb_state_st *rv)
+{
+	if (rv->arena)
+		free(rv->arena);
+	rv->arena = 0;
 }
 // now that all the components are done (thank god), we can start on the actual reverb effect
 void sf_presetreverb(sf_reverb_state_st *rv, int rate, sf_reverb_preset preset)
@@ -792,143 +877,171 @@ void sf_presetreverb(sf_reverb_state_st *rv, int rate, sf_reverb_preset preset)
     }
 #undef CASE
 }
-void sf_reverb_process(sf_reverb_state_st *rv, float inputL, float inputR, float *outputL, float *outputR)
+// One chunk of the oversampled network, x holds the upsampled input and receives the output
+static void sf_reverb_network(sf_reverb_state_st *rv, float *x, int n)
 {
     // extra hardcoded constants
     const float modnoise1 = 0.09f;
     const float modnoise2 = 0.06f;
     const float crossfeed = 0.4f;
-    // oversample buffer
-    float osL[SF_REVERB_OF], osR[SF_REVERB_OF];
-    float outLRef, outRRef;
-    // early reflection
-    earlyref_step(&rv->earlyref, inputL, inputR, &outLRef, &outRRef);
-    float erL = outLRef * rv->ertolate + inputL;
-    float erR = outRRef * rv->ertolate + inputR;
-    // oversample the single input into multiple outputs
-    oversample_stepup(&rv->oversampleL, erL, osL);
-    oversample_stepup(&rv->oversampleR, erR, osR);
-    // for each oversampled sample...
-    for (int i2 = 0; i2 < rv->oversampleL.factor; i2++)
+    static const float same[2] = { 1.0f, 1.0f };
+    static const float lr[2] = { 1.0f, -1.0f };
+    static const float rl[2] = { -1.0f, 1.0f };
+    float lfo[SF_REVERB_CHUNK], mnoise[SF_REVERB_CHUNK], lfo2[SF_REVERB_CHUNK];
+    float out[SF_REVERB_CHUNK * 2], cross[SF_REVERB_CHUNK * 2], tmp[SF_REVERB_CHUNK * 2];
+    sf_rv_mod_st modp, modn;
+    const sf_rv_mod_st *mpp[2] = { &modp, &modp }, *mpn[2] = { &modp, &modn }, *mnp[2] = { &modn, &modp };
+    const unsigned int w = rv->pos;
+    // noise
+    for (int i = 0; i < n; i++)
+    {
+        float mn = noise_step(&rv->noise);
+        lfo[i] = iir1_step(&rv->lfo1_lpf, (lfo_step(&rv->lfo1) + modnoise1 * mn) * rv->wander);
+        mnoise[i] = mn * modnoise2;
+        lfo2[i] = iir1_step(&rv->lfo2_lpf, lfo_step(&rv->lfo2) * rv->wander);
+    }
+    // update cross fade bass boost delay, only fed by samples older than the chunk
+    delay_read(&rv->cbassd1, w, tmp, n);
+    allpass2_run(&rv->cbassap1, w, tmp, n);
+    delay_run(&rv->cbassd2, w, tmp, tmp, n);
+    allpass3_run(&rv->cbassap2, w, tmp, lfo, n);
+    delay_write(&rv->cdelay, w, tmp, n);
+    // dc cut
+    dccut_run(&rv->dccut, x, out, n);
+    // diffusion, alternating the modulation of the left lane and the feedback modulation of the right one.
+    // Every stage ends up with the same mod size, so do the two dampening all-passes
+    allpassm_mod(&modp, lfo, 1.0f, rv->diff[0].msize[0], n);
+    allpassm_mod(&modn, lfo, -1.0f, rv->diff[0].msize[0], n);
+    for (int i = 0; i < 10; i++)
+        allpassm_run(&rv->diff[i], w, out, (i & 1) ? mpp : mnp, mnoise, (i & 1) ? same : lr, n);
+    // cross fade
+    memcpy(cross, out, n * 2 * sizeof(float));
+    for (int i = 0; i < 4; i++)
+        allpass_run(&rv->cross[i], w, cross, n);
+    for (int i = 0; i < n; i++)
+    {
+        tmp[i * 2] = out[i * 2] + crossfeed * cross[i * 2 + 1];
+        tmp[i * 2 + 1] = out[i * 2 + 1] + crossfeed * cross[i * 2];
+    }
+    iir1_run(&rv->clpf, tmp, out, n);
+    // bass boost, each side fed by the other side's delay
+    for (int i = 0; i < n; i++)
+    {
+        cross[i * 2] = RV_AT(&rv->cdelay.ring, w + i - rv->cdelay.size[1], 1);
+        cross[i * 2 + 1] = RV_AT(&rv->cdelay.ring, w + i - rv->cdelay.size[0], 0);
+    }
+    biquad_run(&rv->bassap, cross, tmp, n);
+    biquad_run(&rv->basslp, tmp, tmp, n);
+    for (int i = 0; i < n * 2; i++)
+        out[i] += rv->loopdecay * (cross[i] + rv->bassb * tmp[i]);
+    // dampening
+    iir1_run(&rv->damplp, out, out, n);
+    allpassm_mod(&modp, lfo, 1.0f, rv->dampap1.msize[0], n);
+    allpassm_mod(&modn, lfo, -1.0f, rv->dampap1.msize[0], n);
+    allpassm_run(&rv->dampap1, w, out, mpn, mnoise, lr, n);
+    delay_run(&rv->dampd, w, out, out, n);
+    allpassm_run(&rv->dampap2, w, out, mnp, mnoise, rl, n);
+    delay_write(&rv->cbassd1, w, out, n);
+    //
+    const sf_rv_tap_st *tap = rv->tap;
+    for (int i = 0; i < n; i++)
     {
-        // dc cut
-        float outL = dccut_step(&rv->dccutL, osL[i2]);
-        float outR = dccut_step(&rv->dccutR, osR[i2]);
-        // noise
-        float mnoise = noise_step(&rv->noise);
-        float lfo = (lfo_step(&rv->lfo1) + modnoise1 * mnoise) * rv->wander;
-        lfo = iir1_step(&rv->lfo1_lpf, lfo);
-        mnoise *= modnoise2;
-        // diffusion
-        for (int i = 0, s = -1; i < 10; i++, s = -s)
+        const unsigned int wt = w + i + 1;
+        for (int c = 0, j = 0; c < 2; c++, j += 16)
         {
-            outL = allpassm_step(&rv->diffL[i], outL, lfo * s, mnoise);
-            outR = allpassm_step(&rv->diffR[i], outR, lfo, mnoise * s);
+#define TAP(k) tap[j + k].buf[(((wt - tap[j + k].back) & tap[j + k].mask) << 1) + tap[j + k].lane]
+            float D1 = TAP(0);
+            float D2 = TAP(1) - TAP(2) + TAP(3) - TAP(4) - TAP(5) - TAP(6);
+            float D3 = TAP(7) + TAP(8) + TAP(9) - TAP(10) + TAP(11) + TAP(12) + TAP(13) - TAP(14);
+            float D4 = TAP(15);
+#undef TAP
+            out[i * 2 + c] = D1 * 0.469f + D2 * 0.219f + D3 * 0.064f + D4 * 0.045f;
         }
-        // cross fade
-        float crossL = outL, crossR = outR;
-        for (int i = 0; i < 4; i++)
+    }
+    comb_run(&rv->comb, w, out, lfo2, n);
+    biquad_run(&rv->lastlpf, out, out, n);
+    delay_run(&rv->lastdelay, w, out, out, n);
+    delay_run(&rv->inpdelay, w, x, tmp, n);
+    for (int i = 0; i < n; i++)
+    {
+        float outL = out[i * 2], outR = out[i * 2 + 1];
+        x[i * 2] = outL * rv->wet1 + outR * rv->wet2 + tmp[i * 2] * rv->dry;
+        x[i * 2 + 1] = outR * rv->wet1 + outL * rv->wet2 + tmp[i * 2 + 1] * rv->dry;
+    }
+    rv->pos = w + n;
+}
+// input and output may alias
+void sf_reverb_process(sf_reverb_state_st *rv, const float *inputL, const float *inputR, float *outputL, float *outputR, size_t n)
+{
+    if (!rv->arena)
+    {
+        if (outputL != inputL)
+            memmove(outputL, inputL, n * sizeof(float));
+        if (outputR != inputR)
+            memmove(outputR, inputR, n * sizeof(float));
+        return;
+    }
+    const int factor = rv->oversample.factor;
+    const size_t maxChunk = (size_t)(rv->chunk / factor);
+    float in[SF_REVERB_CHUNK * 2], ref[SF_REVERB_CHUNK * 2], er[SF_REVERB_CHUNK * 2], os[SF_REVERB_CHUNK * 2];
+    for (size_t offset = 0; offset < n; offset += maxChunk)
+    {
+        int len = (int)(n - offset < maxChunk ? n - offset : maxChunk);
+        for (int i = 0; i < len; i++)
         {
-            crossL = allpass_step(&rv->crossL[i], crossL);
-            crossR = allpass_step(&rv->crossR[i], crossR);
+            in[i * 2] = inputL[offset + i];
+            in[i * 2 + 1] = inputR[offset + i];
+        }
+        // early reflection
+        earlyref_run(&rv->earlyref, in, ref, len);
+        for (int i = 0; i < len * 2; i++)
+            er[i] = ref[i] * rv->ertolate + in[i];
+        // oversample, process, and keep the first sample of every group
+        oversample_up(&rv->oversample, er, os, len);
+        sf_reverb_network(rv, os, len * factor);
+        for (int i = 0; i < len; i++)
+        {
+            outputL[offset + i] = os[i * factor * 2] + (ref[i * 2] * rv->erefwet + in[i * 2] * rv->dry);
+            outputR[offset + i] = os[i * factor * 2 + 1] + (ref[i * 2 + 1] * rv->erefwet + in[i * 2 + 1] * rv->dry);
         }
-        outL = iir1_step(&rv->clpfL, outL + crossfeed * crossR);
-        outR = iir1_step(&rv->clpfR, outR + crossfeed * crossL);
-        // bass boost
-        crossL = delay_getlast(&rv->cdelayL);
-        crossR = delay_getlast(&rv->cdelayR);
-        outL += rv->loopdecay *
-                (crossR + rv->bassb * biquad_step(&rv->basslpL, biquad_step(&rv->bassapL, crossR)));
-        outR += rv->loopdecay *
-                (crossL + rv->bassb * biquad_step(&rv->basslpR, biquad_step(&rv->bassapR, crossL)));
-        // dampening
-        outL = allpassm_step(&rv->dampap2L,
-                             delay_step(&rv->dampdL,
-                                        allpassm_step(&rv->dampap1L,
-                                                iir1_step(&rv->damplpL, outL), lfo, mnoise)),
-                             -lfo, -mnoise);
-        outR = allpassm_step(&rv->dampap2R,
-                             delay_step(&rv->dampdR,
-                                        allpassm_step(&rv->dampap1R,
-                                                iir1_step(&rv->damplpR, outR), -lfo, -mnoise)),
-                             lfo, mnoise);
-        // update cross fade bass boost delay
-        delay_step(&rv->cdelayL,
-                   allpass3_step(&rv->cbassap2L,
-                                 delay_step(&rv->cbassd2L,
-                                            allpass2_step(&rv->cbassap1L,
-                                                    delay_step(&rv->cbassd1L, outL))),
-                                 lfo));
-        delay_step(&rv->cdelayR,
-                   allpass3_step(&rv->cbassap2R,
-                                 delay_step(&rv->cbassd2R,
-                                            allpass2_step(&rv->cbassap1R,
-                                                    delay_step(&rv->cbassd1R, outR))),
-                                 -lfo));
-        //
-        float D1 =
-            delay_get(&rv->cbassd1L, rv->outco[0]);
-        float D2 =
-            delay_get(&rv->cbassd2L, rv->outco[1]) -
-            delay_get(&rv->cbassd2R, rv->outco[2]) +
-            delay_get(&rv->cbassd2L, rv->outco[3]) -
-            delay_get(&rv->cdelayR, rv->outco[4]) -
-            delay_get(&rv->cbassd1R, rv->outco[5]) -
-            delay_get(&rv->cbassd2R, rv->outco[6]);
-        float D3 =
-            delay_get(&rv->cdelayL, rv->outco[7]) +
-            allpass2_get1(&rv->cbassap1L, rv->outco[8]) +
-            allpass2_get2(&rv->cbassap1L, rv->outco[9]) -
-            allpass2_get2(&rv->cbassap1R, rv->outco[10]) +
-            allpass3_get1(&rv->cbassap2L, rv->outco[11]) +
-            allpass3_get2(&rv->cbassap2L, rv->outco[12]) +
-            allpass3_get3(&rv->cbassap2L, rv->outco[13]) -
-            allpass3_get2(&rv->cbassap2R, rv->outco[14]);
-        float D4 =
-            delay_get(&rv->cdelayL, rv->outco[15]);
-        float B1 =
-            delay_get(&rv->cbassd1R, rv->outco[16]);
-        float B2 =
-            delay_get(&rv->cbassd2R, rv->outco[17]) -
-            delay_get(&rv->cbassd2L, rv->outco[18]) +
-            delay_get(&rv->cbassd2R, rv->outco[19]) -
-            delay_get(&rv->cdelayL, rv->outco[20]) -
-            delay_get(&rv->cbassd1L, rv->outco[21]) -
-            delay_get(&rv->cbassd2L, rv->outco[22]);
-        float B3 =
-            delay_get(&rv->cdelayR, rv->outco[23]) +
-            allpass2_get1(&rv->cbassap1R, rv->outco[24]) +
-            allpass2_get2(&rv->cbassap1R, rv->outco[25]) -
-            allpass2_get2(&rv->cbassap1L, rv->outco[26]) +
-            allpass3_get1(&rv->cbassap2R, rv->outco[27]) +
-            allpass3_get2(&rv->cbassap2R, rv->outco[28]) +
-            allpass3_get3(&rv->cbassap2R, rv->outco[29]) -
-            allpass3_get2(&rv->cbassap2L, rv->outco[30]);
-        float B4 =
-            delay_get(&rv->cdelayR, rv->outco[31]);
-        float D = D1 * 0.469f + D2 * 0.219f + D3 * 0.064f + D4 * 0.045f;
-        float B = B1 * 0.469f + B2 * 0.219f + B3 * 0.064f + B4 * 0.045f;
-        lfo = iir1_step(&rv->lfo2_lpf, lfo_step(&rv->lfo2) * rv->wander);
-        outL = comb_step(&rv->combL, D, lfo);
-        outR = comb_step(&rv->combR, B, -lfo);
-        outL = delay_step(&rv->lastdelayL, biquad_step(&rv->lastlpfL, outL));
-        outR = delay_step(&rv->lastdelayR, biquad_step(&rv->lastlpfR, outR));
-        osL[i2] = outL * rv->wet1 + outR * rv->wet2 +
-                  delay_step(&rv->inpdelayL, osL[i2]) * rv->dry;
-        osR[i2] = outR * rv->wet1 + outL * rv->wet2 +
-                  delay_step(&rv->inpdelayR, osR[i2]) * rv->dry;
     }
-    float outL = oversample_stepdown(&rv->oversampleL, osL);
-    float outR = oversample_stepdown(&rv->oversampleR, osR);
-    outL += outLRef * rv->erefwet + inputL * rv->dry;
-    outR += outRRef * rv->erefwet + inputR * rv->dry;
-    *outputL = outL;
-    *outputR = outR;
 }
 // Reverb
+void ReverbConstructor(JamesDSPLib *jdsp)
+{
+	jdsp->reverb.arena = 0;
+}
+void ReverbDestructor(JamesDSPLib *jdsp)
+{
+	sf_reverb_free(&jdsp->reverb);
+}
+// The new room is built outside the lock, the audio thread only waits for the swap
+static void ReverbSwap(JamesDSPLib *jdsp, sf_reverb_state_st *rv)
+{
+	jdsp_lock(jdsp);
+	float *old = jdsp->reverb.arena;
+	jdsp->reverb = *rv;
+	jdsp_unlock(jdsp);
+	if (old)
+		free(old);
+}
 void Reverb_SetParam(JamesDSPLib *jdsp, int presets)
 {
-	sf_presetreverb(&jdsp->reverb, (int)jdsp->fs, (sf_reverb_preset)presets);
+	sf_reverb_state_st *rv = (sf_reverb_state_st*)calloc(1, sizeof(sf_reverb_state_st));
+	if (!rv)
+		return;
+	sf_presetreverb(rv, (int)jdsp->fs, (sf_reverb_preset)presets);
+	ReverbSwap(jdsp, rv);
+	free(rv);
+}
+void Reverb_SetAdvancedParam(JamesDSPLib *jdsp, int oversamplefactor, float ertolate, float erefwet, float dry, float ereffactor, float erefwidth, float width, float wet, float wander, float bassb, float spin, float inputlpf, float basslpf, float damplpf, float outputlpf, float rt60, float delay)
+{
+	sf_reverb_state_st *rv = (sf_reverb_state_st*)calloc(1, sizeof(sf_reverb_state_st));
+	if (!rv)
+		return;
+	sf_advancereverb(rv, (int)jdsp->fs, oversamplefactor, ertolate, erefwet, dry, ereffactor, erefwidth, width, wet, wander, bassb, spin, inputlpf, basslpf, damplpf, outputlpf, rt60, delay);
+	ReverbSwap(jdsp, rv);
+	free(rv);
 }
 void ReverbEnable(JamesDSPLib *jdsp)
 {
@@ -940,6 +1053,5 @@ void ReverbDisable(JamesDSPLib *jdsp)
 }
 void ReverbProcess(JamesDSPLib *jdsp, size_t n)
 {
-	for (size_t i = 0; i < n; i++)
-		sf_reverb_process(&jdsp->reverb, jdsp->tmpBuffer[0][i], jdsp->tmpBuffer[1][i], &jdsp->tmpBuffer[0][i], &jdsp->tmpBuffer[1][i]);
+	sf_reverb_process(&jdsp->reverb, jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], n);
 }
@@ -5,8 +5,10 @@
 void initWarpedPFB(WarpedPFB *pfb, double fs, unsigned int N, unsigned int m);
 void assignPtrWarpedPFB(WarpedPFB *pfb, unsigned int N, unsigned int m);
 size_t getMemSizeWarpedPFB(unsigned int N, unsigned int m);
-void analysisWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, float *x1, float *x2);
-void synthesisWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, float *y1, float *y2);
+void warpingWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, const float *x1, const float *x2, float *taps1, float *taps2, unsigned int n);
+void analysisBlockWarpedPFBStereo(WarpedPFB *pfb, float *taps1, float *taps2, float *sub1, float *sub2, unsigned int n);
+void synthesisBlockWarpedPFBStereo(WarpedPFB *pfb, const float *sub1, const float *sub2, float *xk1, float *xk2, unsigned int n);
+void dewarpingWarpedPFBStereo(WarpedPFB *pfb1, WarpedPFB *pfb2, float *xk1, float *xk2, float *y1, float *y2, unsigned int n);
 void StereoEnhancementSetParam(JamesDSPLib *jdsp, float mix)
 {
     jdsp_lock(jdsp);
@@ -33,6 +35,9 @@ void StereoEnhancementSetParam(JamesDSPLib *jdsp, float mix)
 		jdsp->sterEnh.subband[1] = (char*)malloc(memSize);
 	initWarpedPFB((WarpedPFB*)jdsp->sterEnh.subband[0], jdsp->fs, 5, 2);
 	assignPtrWarpedPFB((WarpedPFB*)jdsp->sterEnh.subband[1], 5, 2);
+	// Taps, later polyphase output, and subbands of a block for both channels
+	if (!jdsp->sterEnh.work)
+		jdsp->sterEnh.work = (float*)malloc(STEREOENH_BLOCK * 2 * (((WarpedPFB*)jdsp->sterEnh.subband[0])->L + 5) * sizeof(float));
 	unsigned int *Sk = ((WarpedPFB*)jdsp->sterEnh.subband[0])->Sk;
 	float ms = 0.75f; // 0.75 ms
 	for (unsigned int i = 0; i < 5; i++)
@@ -43,6 +48,7 @@ void StereoEnhancementConstructor(JamesDSPLib *jdsp)
 {
     jdsp_lock(jdsp);
 	jdsp->sterEnh.subband[1] = jdsp->sterEnh.subband[0] = 0;
+	jdsp->sterEnh.work = 0;
     jdsp_unlock(jdsp);
 }
 void StereoEnhancementDestructor(JamesDSPLib *jdsp)
@@ -52,6 +58,8 @@ void StereoEnhancementDestructor(JamesDSPLib *jdsp)
 		free(jdsp->sterEnh.subband[0]);
 	if (jdsp->sterEnh.subband[1])
 		free(jdsp->sterEnh.subband[1]);
+	if (jdsp->sterEnh.work)
+		free(jdsp->sterEnh.work);
     jdsp_unlock(jdsp);
 }
 void StereoEnhancementEnable(JamesDSPLib *jdsp)
@@ -65,33 +73,48 @@ void StereoEnhancementDisable(JamesDSPLib *jdsp)
 void StereoEnhancementProcess(JamesDSPLib *jdsp, size_t n)
 {
 	stereoEnhancement *snh = &jdsp->sterEnh;
-	unsigned int *samplingPeriod = ((WarpedPFB*)snh->subband[0])->decimationCounter;
-	unsigned int *Sk = ((WarpedPFB*)snh->subband[0])->Sk;
-	float *bandLeft = ((WarpedPFB*)snh->subband[0])->subbandData;
-	float *bandRight = ((WarpedPFB*)snh->subband[1])->subbandData;
-	float y1, y2;
-	for (size_t i = 0; i < n; i++)
+	WarpedPFB *pfb1 = (WarpedPFB*)snh->subband[0], *pfb2 = (WarpedPFB*)snh->subband[1];
+	unsigned int *Sk = pfb1->Sk;
+	unsigned int L = pfb1->L;
+	float *taps1 = snh->work, *taps2 = taps1 + STEREOENH_BLOCK * L;
+	float *sub1 = taps2 + STEREOENH_BLOCK * L, *sub2 = sub1 + STEREOENH_BLOCK * 5;
+	for (size_t offset = 0; offset < n; offset += STEREOENH_BLOCK)
 	{
-		analysisWarpedPFBStereo((WarpedPFB*)snh->subband[0], (WarpedPFB*)snh->subband[1], &jdsp->tmpBuffer[0][i], &jdsp->tmpBuffer[1][i]);
-		for (int j = 0; j < 5; j++)
+		unsigned int len = (unsigned int)(n - offset < STEREOENH_BLOCK ? n - offset : STEREOENH_BLOCK);
+		unsigned int samplingPeriod[5];
+		float *x1 = jdsp->tmpBuffer[0] + offset, *x2 = jdsp->tmpBuffer[1] + offset;
+		warpingWarpedPFBStereo(pfb1, pfb2, x1, x2, taps1, taps2, len);
+		analysisBlockWarpedPFBStereo(pfb1, taps1, taps2, sub1, sub2, len);
+		memcpy(samplingPeriod, pfb1->decimationCounter, sizeof(samplingPeriod));
+		for (unsigned int i = 0; i < len; i++)
 		{
-			if (samplingPeriod[j] == Sk[j])
+			for (int j = 0; j < 5; j++)
 			{
-				float sum = bandLeft[j] + bandRight[j];
-				float diff = bandLeft[j] - bandRight[j];
-				float sumSq = sum * sum;
-				float diffSq = diff * diff;
-				snh->sumStates[j] = snh->sumStates[j] * (1.0f - snh->emaAlpha[j]) + sumSq * snh->emaAlpha[j];
-				snh->diffStates[j] = snh->diffStates[j] * (1.0f - snh->emaAlpha[j]) + diffSq * snh->emaAlpha[j];
-				float centre = 0.0f;
-				if (sumSq > FLT_EPSILON)
-					centre = (0.5f - sqrtf(snh->diffStates[j] / snh->sumStates[j]) * 0.5f) * sum;
-				bandLeft[j] = (bandLeft[j] - centre) * snh->mix + centre * snh->minusMix;
-				bandRight[j] = (bandRight[j] - centre) * snh->mix + centre * snh->minusMix;
+				if (samplingPeriod[j] == Sk[j])
+				{
+					float *bandLeft = sub1 + j * len + i, *bandRight = sub2 + j * len + i;
+					float sum = *bandLeft + *bandRight;
+					float diff = *bandLeft - *bandRight;
+					float sumSq = sum * sum;
+					float diffSq = diff * diff;
+					snh->sumStates[j] = snh->sumStates[j] * (1.0f - snh->emaAlpha[j]) + sumSq * snh->emaAlpha[j];
+					snh->diffStates[j] = snh->diffStates[j] * (1.0f - snh->emaAlpha[j]) + diffSq * snh->emaAlpha[j];
+					float centre = 0.0f;
+					if (sumSq > FLT_EPSILON)
+						centre = (0.5f - sqrtf(snh->diffStates[j] / snh->sumStates[j]) * 0.5f) * sum;
+					*bandLeft = (*bandLeft - centre) * snh->mix + centre * snh->minusMix;
+					*bandRight = (*bandRight - centre) * snh->mix + centre * snh->minusMix;
+				}
+				samplingPeriod[j] = samplingPeriod[j] >= Sk[j] ? 1 : samplingPeriod[j] + 1;
 			}
 		}
-		synthesisWarpedPFBStereo((WarpedPFB*)snh->subband[0], (WarpedPFB*)snh->subband[1], &y1, &y2);
-		jdsp->tmpBuffer[0][i] = y1 * snh->gain;
-		jdsp->tmpBuffer[1][i] = y2 * snh->gain;
+		// Polyphase output replaces the taps
+		synthesisBlockWarpedPFBStereo(pfb1, sub1, sub2, taps1, taps2, len);
+		dewarpingWarpedPFBStereo(pfb1, pfb2, taps1, taps2, x1, x2, len);
+		for (unsigned int i = 0; i < len; i++)
+		{
+			x1[i] *= snh->gain;
+			x2[i] *= snh->gain;
+		}
 	}
 }
@@ -39,67 +39,53 @@ void VTInit(VacuumTube *tb, double fs)
 }
 void VTProcess(VacuumTube *tb, float *x1, float *x2, float *out1, float *out2, size_t n)
 {
-	float upsample[2][5];
-	double bandCh1[6], bandCh2[6];
-	if (tb->needOversample)
+	int factor = tb->needOversample ? tb->smp[0].factor : 1;
+	double *band[6] = { tb->band[0], tb->band[1], tb->band[2], tb->band[3], tb->band[4], tb->band[5] };
+	for (size_t offset = 0; offset < n; offset += VT_BLOCK)
 	{
-		for (size_t i = 0; i < n; i++)
+		size_t len = n - offset < VT_BLOCK ? n - offset : VT_BLOCK;
+		size_t m = len * factor;
+		float in[2][VT_BLOCK];
+		for (size_t i = 0; i < len; i++)
 		{
-			char state1[6] = { 0 };
-			char state2[6] = { 0 };
-			oversample_stepupSmp(&tb->smp[0], x1[i] * tb->pregain, upsample[0]);
-			oversample_stepupSmp(&tb->smp[1], x2[i] * tb->pregain, upsample[1]);
-			for (int j = 0; j < tb->smp[0].factor; j++)
+			in[0][i] = x1[offset + i] * tb->pregain;
+			in[1][i] = x2[offset + i] * tb->pregain;
+		}
+		if (tb->needOversample)
+			oversample_stepupSmpStereo(&tb->smp[0], &tb->smp[1], in[0], in[1], band[5], len);
+		else
+		{
+			for (size_t i = 0; i < len; i++)
 			{
-				process6BandsCrossover(&tb->subband[0], upsample[0][j], &bandCh1[0], &bandCh1[1], &bandCh1[2], &bandCh1[3], &bandCh1[4], &bandCh1[5]);
-				process6BandsCrossover(&tb->subband[1], upsample[1][j], &bandCh2[0], &bandCh2[1], &bandCh2[2], &bandCh2[3], &bandCh2[4], &bandCh2[5]);
-				bandCh1[1] = -bandCh1[1];
-				bandCh1[3] = -bandCh1[3];
-				bandCh1[5] = -bandCh1[5];
-				bandCh2[1] = -bandCh2[1];
-				bandCh2[3] = -bandCh2[3];
-				bandCh2[5] = -bandCh2[5];
-				double allpassCh1 = bandCh1[1] + bandCh1[2] + bandCh1[3] + bandCh1[4];
-				double harmonic2Ch1 = bandCh1[1] * bandCh1[1] * bandCh1[1] * bandCh1[1] * bandCh1[1] * bandCh1[1] * bandCh1[1] * bandCh1[1];
-				double harmonic3Ch1 = bandCh1[2] * bandCh1[2] * bandCh1[2] * bandCh1[2] * bandCh1[2] * bandCh1[2];
-				double harmonic4Ch1 = bandCh1[3] * bandCh1[3] * bandCh1[3] * bandCh1[3];
-				double harmonic5Ch1 = bandCh1[4] * bandCh1[4];
-				double allpassCh2 = bandCh2[1] + bandCh2[2] + bandCh2[3] + bandCh2[4];
-				double harmonic2Ch2 = bandCh2[1] * bandCh2[1] * bandCh2[1] * bandCh2[1] * bandCh2[1] * bandCh2[1] * bandCh2[1] * bandCh2[1];
-				double harmonic3Ch2 = bandCh2[2] * bandCh2[2] * bandCh2[2] * bandCh2[2] * bandCh2[2] * bandCh2[2];
-				double harmonic4Ch2 = bandCh2[3] * bandCh2[3] * bandCh2[3] * bandCh2[3];
-				double harmonic5Ch2 = bandCh2[4] * bandCh2[4];
-				upsample[0][j] = (float)(bandCh1[0] + (harmonic2Ch1 + harmonic3Ch1 + harmonic4Ch1 + harmonic5Ch1) + allpassCh1 + bandCh1[5]);
-				upsample[1][j] = (float)(bandCh2[0] + (harmonic2Ch2 + harmonic3Ch2 + harmonic4Ch2 + harmonic5Ch2) + allpassCh2 + bandCh2[5]);
+				band[5][2 * i] = in[0][i];
+				band[5][2 * i + 1] = in[1][i];
 			}
-			out1[i] = oversample_stepdownSmpFloat(&tb->smp[0], upsample[0]) * tb->postgain;
-			out2[i] = oversample_stepdownSmpFloat(&tb->smp[1], upsample[1]) * tb->postgain;
 		}
-	}
-	else
-	{
-		for (size_t j = 0; j < n; j++)
+		process6BandsCrossoverStereo(&tb->subband[0], &tb->subband[1], band, m);
+		for (size_t j = 0; j < 2 * m; j++)
+		{
+			double b0 = band[0][j], b1 = -band[1][j], b2 = band[2][j], b3 = -band[3][j], b4 = band[4][j], b5 = -band[5][j];
+			double allpass = b1 + b2 + b3 + b4;
+			double harmonic2 = b1 * b1 * b1 * b1 * b1 * b1 * b1 * b1;
+			double harmonic3 = b2 * b2 * b2 * b2 * b2 * b2;
+			double harmonic4 = b3 * b3 * b3 * b3;
+			double harmonic5 = b4 * b4;
+			band[0][j] = (float)(b0 + (harmonic2 + harmonic3 + harmonic4 + harmonic5) + allpass + b5);
+		}
+		if (tb->needOversample)
+			oversample_stepdownSmpStereo(&tb->smp[0], &tb->smp[1], band[0], in[0], in[1], len);
+		else
+		{
+			for (size_t i = 0; i < len; i++)
+			{
+				in[0][i] = (float)band[0][2 * i];
+				in[1][i] = (float)band[0][2 * i + 1];
+			}
+		}
+		for (size_t i = 0; i < len; i++)
 		{
-			process6BandsCrossover(&tb->subband[0], x1[j] * tb->pregain, &bandCh1[0], &bandCh1[1], &bandCh1[2], &bandCh1[3], &bandCh1[4], &bandCh1[5]);
-			process6BandsCrossover(&tb->subband[1], x2[j] * tb->pregain, &bandCh2[0], &bandCh2[1], &bandCh2[2], &bandCh2[3], &bandCh2[4], &bandCh2[5]);
-			bandCh1[1] = -bandCh1[1];
-			bandCh1[3] = -bandCh1[3];
-			bandCh1[5] = -bandCh1[5];
-			bandCh2[1] = -bandCh2[1];
-			bandCh2[3] = -bandCh2[3];
-			bandCh2[5] = -bandCh2[5];
-			double allpassCh1 = bandCh1[1] + bandCh1[2] + bandCh1[3] + bandCh1[4];
-			double harmonic2Ch1 = bandCh1[1] * bandCh1[1] * bandCh1[1] * bandCh1[1] * bandCh1[1] * bandCh1[1] * bandCh1[1] * bandCh1[1];
-			double harmonic3Ch1 = bandCh1[2] * bandCh1[2] * bandCh1[2] * bandCh1[2] * bandCh1[2] * bandCh1[2];
-			double harmonic4Ch1 = bandCh1[3] * bandCh1[3] * bandCh1[3] * bandCh1[3];
-			double harmonic5Ch1 = bandCh1[4] * bandCh1[4];
-			double allpassCh2 = bandCh2[1] + bandCh2[2] + bandCh2[3] + bandCh2[4];
-			double harmonic2Ch2 = bandCh2[1] * bandCh2[1] * bandCh2[1] * bandCh2[1] * bandCh2[1] * bandCh2[1] * bandCh2[1] * bandCh2[1];
-			double harmonic3Ch2 = bandCh2[2] * bandCh2[2] * bandCh2[2] * bandCh2[2] * bandCh2[2] * bandCh2[2];
-			double harmonic4Ch2 = bandCh2[3] * bandCh2[3] * bandCh2[3] * bandCh2[3];
-			double harmonic5Ch2 = bandCh2[4] * bandCh2[4];
-			out1[j] = (float)(bandCh1[0] + (harmonic2Ch1 + harmonic3Ch1 + harmonic4Ch1 + harmonic5Ch1) + allpassCh1 + bandCh1[5]) * tb->postgain;
-			out2[j] = (float)(bandCh2[0] + (harmonic2Ch2 + harmonic3Ch2 + harmonic4Ch2 + harmonic5Ch2) + allpassCh2 + bandCh2[5]) * tb->postgain;
+			out1[offset + i] = in[0][i] * tb->postgain;
+			out2[offset + i] = in[1][i] * tb->postgain;
 		}
 	}
 }
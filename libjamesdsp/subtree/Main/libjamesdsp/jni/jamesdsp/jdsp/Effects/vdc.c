@@ -1,264 +1,415 @@
 #include <string.h>
 #include <stdlib.h>
-#include <errno.h>
 #include <math.h>
-#include <float.h>
 #include "../jdsp_header.h"
-double SOS_DF2Process(DirectForm2 *df2, double x1)
+// Sample rates of the SR_44100 and SR_48000 tables of a DDC file
+static const double ddcTableFs[2] = { 44100.0, 48000.0 };
+static const char *ddcTableTag[2] = { "SR_44100", "SR_48000" };
+// Sections are only prewarped below this fraction of the lower of the two rates
+#define DDC_PREWARP_LIMIT 0.45
+// Reads the numbers following a tag up to the next tag in a single pass, five per section. Returns the
+// number of sections, 0 when the tag is missing or holds anything that is not a finite number
+static int DDCParseTable(const char *str, const char *tag, double **table)
 {
-	double w1 = x1 - df2->a1*df2->v1L - df2->a2*df2->v2L;
-	double y1 = df2->b0*w1 + df2->b1*df2->v1L + df2->b2*df2->v2L;
-	df2->v2L = df2->v1L;
-	df2->v1L = w1;
-	return y1;
+	*table = 0;
+	const char *p = strstr(str, tag);
+	if (!p)
+		return 0;
+	p += strlen(tag);
+	size_t count = 0, capacity = 0;
+	double *numbers = 0;
+	while (*p && !(p[0] == 'S' && p[1] == 'R' && p[2] == '_'))
+	{
+		char *end;
+		double val = strtod(p, &end);
+		if (end == p)
+		{
+			p++;
+			continue;
+		}
+		if (!isfinite(val))
+		{
+			free(numbers);
+			return 0;
+		}
+		if (count == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 160;
+			double *grown = (double*)realloc(numbers, capacity * sizeof(double));
+			if (!grown)
+			{
+				free(numbers);
+				return 0;
+			}
+			numbers = grown;
+		}
+		numbers[count++] = val;
+		p = end;
+	}
+	int sosCount = (int)(count / 5);
+	if (!sosCount)
+	{
+		free(numbers);
+		return 0;
+	}
+	// Files store the feedback coefficients negated
+	for (int i = 0; i < sosCount; i++)
+	{
+		numbers[i * 5 + 3] = -numbers[i * 5 + 3];
+		numbers[i * 5 + 4] = -numbers[i * 5 + 4];
+	}
+	*table = numbers;
+	return sosCount;
 }
-void SOS_DF2_StereoProcess(DirectForm2 *df2, double x1, double x2, double *Out_y1, double *Out_y2)
+// c0 + c1 z^-1 + c2 z^-2 <-> p0 + p1 s + p2 s^2 under s = (1 - z^-1) / (1 + z^-1), its own inverse up to a factor of 4
+static void DDCBilinear(double c0, double c1, double c2, double *p)
 {
-	double w1 = x1 - df2->a1*df2->v1L - df2->a2*df2->v2L;
-	double y1 = df2->b0*w1 + df2->b1*df2->v1L + df2->b2*df2->v2L;
-	df2->v2L = df2->v1L;
-	df2->v1L = w1;
-	*Out_y1 = y1;
-	double w2 = x2 - df2->a1*df2->v1R - df2->a2*df2->v2R;
-	double y2 = df2->b0*w2 + df2->b1*df2->v1R + df2->b2*df2->v2R;
-	df2->v2R = df2->v1R;
-	df2->v1R = w2;
-	*Out_y2 = y2;
+	p[0] = c0 + c1 + c2;
+	p[1] = 2.0 * (c0 - c2);
+	p[2] = c0 - c1 + c2;
 }
-int countChars(char* s, char c)
+// Natural frequency of the roots of c0 + c1 z^-1 + c2 z^-2 on the prewarped axis, s = j tan(w / 2), 0 if there is none
+static double DDCNaturalFrequency(double c0, double c1, double c2)
 {
-	return *s == '\0' ? 0 : countChars(s + 1, c) + (*s == c);
+	if (c2 == 0.0)
+		return c0 != c1 ? fabs((c0 + c1) / (c0 - c1)) : 0.0;
+	double p[3];
+	DDCBilinear(c0, c1, c2, p);
+	return p[0] * p[2] > 0.0 ? sqrt(p[0] / p[2]) : 0.0;
 }
-int get_doubleVDC(char *val, double *F)
+// Same design as the peaking filters DDC files are made of
+static void designPeakingFilter(double dbGain, double centreFreq, double fs, double bandwidth, double *sos)
 {
-	char *eptr;
-	errno = 0;
-	double f = strtod(val, &eptr);
-	if (eptr != val && errno != ERANGE)
-	{
-		*F = f;
-		return 1;
-	}
-	return 0;
+	const double at1d3 = atanh(1.0 / 3.0);
+	double lingain = pow(10.0, dbGain / 40.0);
+	double omega = (6.2831853071795862 * centreFreq) / fs;
+	double sn = sin(omega);
+	double cs = cos(omega);
+	double alpha = sn * sinh((at1d3 * bandwidth * omega) / sn);
+	double A0 = 1.0 + (alpha / lingain);
+	sos[0] = (1.0 + (alpha * lingain)) / A0;
+	sos[1] = (-2.0 * cs) / A0;
+	sos[2] = (1.0 - (alpha * lingain)) / A0;
+	sos[3] = (-2.0 * cs) / A0;
+	sos[4] = (1.0 - (alpha / lingain)) / A0;
 }
-int DDCParser(char *DDCString, DirectForm2 ***ptrdf441, DirectForm2 ***ptrdf48)
+// Recovers gain, centre frequency and bandwidth of a section that is a peaking filter, the inverse of
+// designPeakingFilter(), so that it can be designed again at another rate exactly as it was at this one
+static int DDCPeakingParameters(const double *sos, double fs, double *dbGain, double *centreFreq, double *bandwidth)
 {
-	char *fs44_1 = strstr(DDCString, "SR_44100");
-	char *fs48 = strstr(DDCString, "SR_48000");
-	if (!fs44_1 || !fs48)
+	const double tol = 1e-9;
+	double b0 = sos[0], b1 = sos[1], b2 = sos[2], a1 = sos[3], a2 = sos[4];
+	if (fabs(b1 - a1) > tol || fabs(b0 + b2 - 1.0 - a2) > tol || 1.0 + a2 <= 0.0)
 		return 0;
-	int numberCount = (countChars(fs48, ',') + 1);
-	int sosCount = numberCount / 5;
-	if (!sosCount)
+	double A0 = 2.0 / (1.0 + a2);
+	double cs = -a1 / (1.0 + a2);
+	double alphaDivGain = A0 - 1.0;
+	double alphaMulGain = b0 * A0 - 1.0;
+	if (fabs(cs) >= 1.0 || alphaDivGain <= 0.0 || alphaMulGain <= 0.0)
 		return 0;
-	DirectForm2 **df441 = (DirectForm2**)malloc(sosCount * sizeof(DirectForm2*));
-	DirectForm2 **df48 = (DirectForm2**)malloc(sosCount * sizeof(DirectForm2*));
-	int i;
-	for (i = 0; i < sosCount; i++)
+	double omega = acos(cs);
+	double sn = sin(omega);
+	*dbGain = 20.0 * log10(alphaMulGain / alphaDivGain);
+	*centreFreq = omega * fs / 6.2831853071795862;
+	*bandwidth = asinh(sqrt(alphaMulGain * alphaDivGain) / sn) * sn / (omega * atanh(1.0 / 3.0));
+	return 1;
+}
+// Moves a section designed with the bilinear transform from fs1 to fs2. Peaking filters are designed again. Anything
+// else is mapped back to the prewarped analogue domain, the frequency axis is scaled so that the natural frequency of
+// its poles (or zeros, when it has no feedback) keeps its frequency in Hz, and it is mapped forward again. DC and
+// Nyquist gains are kept and a stable section stays stable whatever the rates
+static void DDCRemapSection(const double *in, double *out, double fs1, double fs2)
+{
+	double dbGain, centreFreq, bandwidth;
+	if (DDCPeakingParameters(in, fs1, &dbGain, &centreFreq, &bandwidth) && centreFreq < DDC_PREWARP_LIMIT * fs2)
 	{
-		df441[i] = (DirectForm2*)malloc(sizeof(DirectForm2));
-		memset(df441[i], 0, sizeof(DirectForm2));
-		df48[i] = (DirectForm2*)malloc(sizeof(DirectForm2));
-		memset(df48[i], 0, sizeof(DirectForm2));
+		designPeakingFilter(dbGain, centreFreq, fs2, bandwidth, out);
+		return;
 	}
-	double number;
-	i = 0;
-	int counter = 0;
-	int b0b1b2a1a2 = 0;
-	char *startingPoint = fs44_1 + 9;
-	while (counter < numberCount)
+	if (in[1] == 0.0 && in[2] == 0.0 && in[3] == 0.0 && in[4] == 0.0)
 	{
-		if (get_doubleVDC(startingPoint, &number))
-		{
-			double val = strtod(startingPoint, &startingPoint);
-			counter++;
-			if (!b0b1b2a1a2)
-				df441[i]->b0 = val;
-			else if (b0b1b2a1a2 == 1)
-				df441[i]->b1 = val;
-			else if (b0b1b2a1a2 == 2)
-				df441[i]->b2 = val;
-			else if (b0b1b2a1a2 == 3)
-				df441[i]->a1 = -val;
-			else if (b0b1b2a1a2 == 4)
-			{
-				df441[i]->a2 = -val;
-				i++;
-			}
-			b0b1b2a1a2++;
-			if (b0b1b2a1a2 == 5)
-				b0b1b2a1a2 = 0;
-		}
-		else
-			startingPoint++;
+		memcpy(out, in, 5 * sizeof(double));
+		return;
 	}
-	i = 0;
-	counter = 0;
-	b0b1b2a1a2 = 0;
-	startingPoint = fs48 + 9;
-	while (counter < numberCount)
+	double t = (in[3] != 0.0 || in[4] != 0.0) ? DDCNaturalFrequency(1.0, in[3], in[4]) : DDCNaturalFrequency(in[0], in[1], in[2]);
+	double f = atan(t) * fs1 / M_PI;
+	double fMax = DDC_PREWARP_LIMIT * (fs1 < fs2 ? fs1 : fs2);
+	if (!(f < fMax))
+		f = fMax;
+	// Plain bilinear mapping of the analogue prototype in the limit f -> 0
+	double k = f > 0.0 ? tan(M_PI * f / fs1) / tan(M_PI * f / fs2) : fs2 / fs1;
+	double num[3], den[3];
+	DDCBilinear(in[0], in[1], in[2], num);
+	DDCBilinear(1.0, in[3], in[4], den);
+	num[1] *= k;
+	num[2] *= k * k;
+	den[1] *= k;
+	den[2] *= k * k;
+	double b[3], a[3];
+	DDCBilinear(num[0], num[1], num[2], b);
+	DDCBilinear(den[0], den[1], den[2], a);
+	out[0] = b[0] / a[0];
+	out[1] = b[1] / a[0];
+	out[2] = b[2] / a[0];
+	out[3] = a[1] / a[0];
+	out[4] = a[2] / a[0];
+}
+// Samples converted to double per pass of the cascade, L/R interleaved
+#define DDC_BLOCK 256
+// Impulse response probed in steps of this many samples until a whole step stays below DDC_FIR_FLOOR
+#define DDC_FIR_STEP 1024
+#define DDC_FIR_MAXLEN 131072
+#define DDC_FIR_FLOOR 1e-7
+static void DDCFreeEngine(DDC *ddc)
+{
+	if (ddc->state)
+		free(ddc->state);
+	if (ddc->sosFloat)
+		free(ddc->sosFloat);
+	if (ddc->stateFloat)
+		free(ddc->stateFloat);
+	if (ddc->fir)
 	{
-		if (get_doubleVDC(startingPoint, &number))
-		{
-			double val = strtod(startingPoint, &startingPoint);
-			counter++;
-			if (!b0b1b2a1a2)
-				df48[i]->b0 = val;
-			else if (b0b1b2a1a2 == 1)
-				df48[i]->b1 = val;
-			else if (b0b1b2a1a2 == 2)
-				df48[i]->b2 = val;
-			else if (b0b1b2a1a2 == 3)
-				df48[i]->a1 = -val;
-			else if (b0b1b2a1a2 == 4)
-			{
-				df48[i]->a2 = -val;
-				i++;
-			}
-			b0b1b2a1a2++;
-			if (b0b1b2a1a2 == 5)
-				b0b1b2a1a2 = 0;
-		}
-		else
-			startingPoint++;
+		TwoStageFFTConvolver2x2Free(ddc->fir);
+		free(ddc->fir);
 	}
-	*ptrdf441 = df441;
-	*ptrdf48 = df48;
-	return sosCount;
+	ddc->state = 0;
+	ddc->sosFloat = 0;
+	ddc->stateFloat = 0;
+	ddc->fir = 0;
 }
-void complexMultiplicationRI(double *zReal, double *zImag, double xReal, double xImag, double yReal, double yImag)
+static void DDCFreeProfile(DDC *ddc)
 {
-	*zReal = xReal * yReal - xImag * yImag;
-	*zImag = xReal * yImag + xImag * yReal;
+	DDCFreeEngine(ddc);
+	for (int i = 0; i < 2; i++)
+	{
+		if (ddc->table[i])
+			free(ddc->table[i]);
+		ddc->table[i] = 0;
+		ddc->tableCount[i] = 0;
+	}
+	for (int i = 0; i < DDC_RATE_CACHE; i++)
+	{
+		if (ddc->rates[i].sos)
+			free(ddc->rates[i].sos);
+		ddc->rates[i].sos = 0;
+		ddc->rates[i].fs = 0.0;
+		ddc->rates[i].sosCount = 0;
+	}
+	ddc->nextRate = 0;
+	ddc->sos = 0;
+	ddc->usedSOSCount = 0;
 }
-void complexDivisionRI(double *zReal, double *zImag, double xReal, double xImag, double yReal, double yImag)
+// One section over an interleaved block, both channels sharing the coefficients
+#define SOS_TDF2_STEP(type, b0, b1, b2, a1, a2, z1, z2, x) \
+	for (int c = 0; c < 2; c++) \
+	{ \
+		type in = (x)[c]; \
+		type out = (b0)[k] * in + (z1)[k][c]; \
+		(z1)[k][c] = (b1)[k] * in - (a1)[k] * out + (z2)[k][c]; \
+		(z2)[k][c] = (b2)[k] * in - (a2)[k] * out; \
+		(x)[c] = out; \
+	}
+// Up to DDC_SKEW sections at once, section k running k samples behind section 0. Every section still sees the
+// output of the previous one, but the recursions of neighbouring sections no longer wait for each other
+#define DDC_SKEW 4
+#define SOS_TDF2_SKEWED(type, sos, state, x, n, sections) \
+{ \
+	type b0[DDC_SKEW], b1[DDC_SKEW], b2[DDC_SKEW], a1[DDC_SKEW], a2[DDC_SKEW], z1[DDC_SKEW][2], z2[DDC_SKEW][2]; \
+	for (int k = 0; k < sections; k++) \
+	{ \
+		b0[k] = sos[k * 5]; b1[k] = sos[k * 5 + 1]; b2[k] = sos[k * 5 + 2]; a1[k] = sos[k * 5 + 3]; a2[k] = sos[k * 5 + 4]; \
+		z1[k][0] = state[k * 4]; z1[k][1] = state[k * 4 + 1]; z2[k][0] = state[k * 4 + 2]; z2[k][1] = state[k * 4 + 3]; \
+	} \
+	for (size_t t = 0; t < n + sections - 1; t++) \
+	{ \
+		if (sections == DDC_SKEW && t >= DDC_SKEW - 1 && t < n) \
+		{ \
+			for (int k = 0; k < DDC_SKEW; k++) \
+				SOS_TDF2_STEP(type, b0, b1, b2, a1, a2, z1, z2, x + (t - k) * 2) \
+		} \
+		else \
+		{ \
+			for (int k = 0; k < sections; k++) \
+				if (t >= (size_t)k && t - k < n) \
+					SOS_TDF2_STEP(type, b0, b1, b2, a1, a2, z1, z2, x + (t - k) * 2) \
+		} \
+	} \
+	for (int k = 0; k < sections; k++) \
+	{ \
+		state[k * 4] = z1[k][0]; state[k * 4 + 1] = z1[k][1]; state[k * 4 + 2] = z2[k][0]; state[k * 4 + 3] = z2[k][1]; \
+	} \
+}
+static void SOS_TDF2_StereoBlock(const double *sos, double *state, double *x, size_t n, int sections)
 {
-	*zReal = (xReal * yReal + xImag * yImag) / (yReal * yReal + yImag * yImag);
-	*zImag = (xImag * yReal - xReal * yImag) / (yReal * yReal + yImag * yImag);
+	for (; sections >= DDC_SKEW; sections -= DDC_SKEW, sos += DDC_SKEW * 5, state += DDC_SKEW * 4)
+		SOS_TDF2_SKEWED(double, sos, state, x, n, DDC_SKEW)
+	if (sections > 0)
+		SOS_TDF2_SKEWED(double, sos, state, x, n, sections)
 }
-// Analytical magnitude response of digital filters
-void DigitalFilterMagnitudeResponsedB(DirectForm2 **IIR, int section, double *magnitude, int NumPts)
+static void SOS_TDF2_StereoBlockFloat(const float *sos, float *state, float *x, size_t n, int sections)
 {
-	double Arg;
-	double z1Real, z1Imag, z2Real, z2Imag, HofZReal, HofZImag, DenomReal, DenomImag, tmpReal, tmpImag;
-	for (int j = 0; j < NumPts; j++)
+	for (; sections >= DDC_SKEW; sections -= DDC_SKEW, sos += DDC_SKEW * 5, state += DDC_SKEW * 4)
+		SOS_TDF2_SKEWED(float, sos, state, x, n, DDC_SKEW)
+	if (sections > 0)
+		SOS_TDF2_SKEWED(float, sos, state, x, n, sections)
+}
+// Impulse response of the cascade, cut once it has decayed below DDC_FIR_FLOOR. It keeps the phase of the
+// recursive filter, which is minimum phase for the peaking sections DDC files are made of
+static float* DDCImpulseResponse(DDC *ddc, unsigned int *irLen)
+{
+	double *state = (double*)calloc(ddc->usedSOSCount * 4, sizeof(double));
+	float *ir = (float*)malloc(DDC_FIR_MAXLEN * sizeof(float));
+	if (!state || !ir)
 	{
-		Arg = M_PI * (double)j / (double)NumPts;
-		z1Real = cos(Arg), z1Imag = -sin(Arg);
-		complexMultiplicationRI(&z2Real, &z2Imag, z1Real, z1Imag, z1Real, z1Imag);
-		HofZReal = 1.0, HofZImag = 0.0;
-		tmpReal = IIR[section]->b0 + IIR[section]->b1 * z1Real + IIR[section]->b2 * z2Real;
-		tmpImag = IIR[section]->b1 * z1Imag + IIR[section]->b2 * z2Imag;
-		complexMultiplicationRI(&HofZReal, &HofZImag, HofZReal, HofZImag, tmpReal, tmpImag);
-		DenomReal = 1.0 + IIR[section]->a1 * z1Real + IIR[section]->a2 * z2Real;
-		DenomImag = IIR[section]->a1 * z1Imag + IIR[section]->a2 * z2Imag;
-		if (sqrt(DenomReal * DenomReal + DenomImag * DenomImag) < DBL_EPSILON)
-			magnitude[j] = 0.0;
-		else
+		free(state);
+		free(ir);
+		return 0;
+	}
+	double buf[DDC_FIR_STEP * 2];
+	unsigned int len = 0;
+	while (len < DDC_FIR_MAXLEN)
+	{
+		memset(buf, 0, sizeof(buf));
+		if (!len)
+			buf[0] = 1.0;
+		SOS_TDF2_StereoBlock(ddc->sos, state, buf, DDC_FIR_STEP, ddc->usedSOSCount);
+		double peak = 0.0;
+		for (int i = 0; i < DDC_FIR_STEP; i++)
 		{
-			complexDivisionRI(&HofZReal, &HofZImag, HofZReal, HofZImag, DenomReal, DenomImag);
-			magnitude[j] = 20.0 * log10(sqrt(HofZReal * HofZReal + HofZImag * HofZImag));
+			ir[len + i] = (float)buf[i * 2];
+			if (fabs(buf[i * 2]) > peak)
+				peak = fabs(buf[i * 2]);
 		}
+		len += DDC_FIR_STEP;
+		if (peak < DDC_FIR_FLOOR)
+			break;
 	}
+	free(state);
+	*irLen = len;
+	return ir;
 }
-// DDC resampler
-void designPeakingFilter(double dbGain, double centreFreq, double fs, double dBandwidthOrQOrS, double *b0, double *b1, double *b2, double *a1, double *a2)
+// Builds whatever the current engine settings need on top of the coefficients
+static int DDCSetupEngine(JamesDSPLib *jdsp)
 {
-	if (centreFreq <= DBL_EPSILON || fs <= DBL_EPSILON)
-		return;
-	const double at1d3 = atanh(1.0 / 3.0);
-	double lingain = pow(10.0, dbGain / 40.0);
-	double omega = (6.2831853071795862 * centreFreq) / fs;
-	double num3 = sin(omega);
-	double cs = cos(omega);
-	double alpha = num3 * sinh((at1d3 * dBandwidthOrQOrS * omega) / num3);
-	double B0 = 1.0 + (alpha * lingain);
-	double B1 = -2.0 * cs;
-	double B2 = 1.0 - (alpha * lingain);
-	double A0 = 1.0 + (alpha / lingain);
-	double A1 = -2.0 * cs;
-	double A2 = 1.0 - (alpha / lingain);
-	*b0 = B0 / A0;
-	*b1 = B1 / A0;
-	*b2 = B2 / A0;
-	*a1 = A1 / A0;
-	*a2 = A2 / A0;
+	DDC *ddc = &jdsp->vdcFl;
+	DDCFreeEngine(ddc);
+	if (!ddc->usedSOSCount)
+		return 0;
+	if (ddc->firSections > 0 && ddc->usedSOSCount >= ddc->firSections)
+	{
+		unsigned int irLen;
+		float *ir = DDCImpulseResponse(ddc, &irLen);
+		ddc->fir = (TwoStageFFTConvolver2x2*)malloc(sizeof(TwoStageFFTConvolver2x2));
+		if (ir && ddc->fir)
+		{
+			// Same partitioning as the convolver
+			unsigned int seg1Len = (unsigned int)jdsp->blockSize;
+			unsigned int seg2Len = (irLen - seg1Len) / 4;
+			if (seg2Len > 32768)
+				seg2Len = 32768;
+			if (seg2Len < 1)
+				seg2Len = 1;
+			TwoStageFFTConvolver2x2Init(ddc->fir);
+			TwoStageFFTConvolver2x2LoadImpulseResponse(ddc->fir, seg1Len, seg2Len, ir, ir, irLen);
+			free(ir);
+			return 1;
+		}
+		// Fall back to the recursive cascade
+		if (ir)
+			free(ir);
+		if (ddc->fir)
+			free(ddc->fir);
+		ddc->fir = 0;
+	}
+	if (ddc->useFloat)
+	{
+		ddc->sosFloat = (float*)malloc(ddc->usedSOSCount * 5 * sizeof(float));
+		ddc->stateFloat = (float*)calloc(ddc->usedSOSCount * 4, sizeof(float));
+		if (!ddc->sosFloat || !ddc->stateFloat)
+		{
+			DDCFreeEngine(ddc);
+			return 0;
+		}
+		for (int i = 0; i < ddc->usedSOSCount * 5; i++)
+			ddc->sosFloat[i] = (float)ddc->sos[i];
+		return 1;
+	}
+	ddc->state = (double*)calloc(ddc->usedSOSCount * 4, sizeof(double));
+	return ddc->state != 0;
 }
-int PeakingFilterResampler(DirectForm2 **inputIIR, double inFs, DirectForm2 ***resampledIIR, double outFs, int sosCount)
+// Sections of the current profile at fs: a table of the file when it was made for fs, otherwise the table of the
+// nearest rate remapped once and kept in a small cache, so that switching between a few rates does not redo it
+static double* DDCSectionsForRate(DDC *ddc, double fs, int *sosCount)
 {
-	const int filterTestLength = 32768;
-	double *magnitude = (double*)malloc(filterTestLength * sizeof(double));
-	int i;
-	int outSOSCount = 0;
-	double *cell[3];
-	for (i = 0; i < 3; i++)
-		cell[i] = (double*)malloc(sosCount * sizeof(double));
-	for (i = 0; i < sosCount; i++)
+	int src = -1;
+	double bestDistance = 0.0;
+	for (int i = 0; i < 2; i++)
 	{
-		DigitalFilterMagnitudeResponsedB(inputIIR, i, magnitude, filterTestLength);
-		double absoluteMax = fabs(magnitude[0]);
-		double centreFreq = 0.0;
-		int index = 0;
-		for (int c = 1; c < filterTestLength; c++)
+		if (!ddc->table[i])
+			continue;
+		if (fs == ddcTableFs[i])
 		{
-			if (fabs(magnitude[c]) > absoluteMax)
-			{
-				absoluteMax = fabs(magnitude[c]);
-				index = c;
-				centreFreq = round(c * (inFs / filterTestLength / 2.0));
-			}
+			*sosCount = ddc->tableCount[i];
+			return ddc->table[i];
 		}
-		if (centreFreq < DBL_EPSILON)
-			centreFreq = DBL_EPSILON;
-		if (fabs(inputIIR[i]->b1) < DBL_EPSILON)
+		double distance = fabs(log(fs / ddcTableFs[i]));
+		if (src < 0 || distance < bestDistance)
 		{
-			if (inputIIR[i]->b1 < 0.0)
-				inputIIR[i]->b1 = -DBL_EPSILON;
-			else
-				inputIIR[i]->b1 = DBL_EPSILON;
+			src = i;
+			bestDistance = distance;
 		}
-		double omega = (6.2831853071795862 * centreFreq) / inFs;
-		double A0 = (-2.0 * cos(omega)) / inputIIR[i]->b1;
-		double lingain = pow(10.0, magnitude[index] / 40.0);
-		double num3 = sin(omega);
-		double bandwidth = ((asinh(((A0 - 1.0) * lingain) / num3) * num3) / omega) / 0.34657359027997264;
-		if (bandwidth > 98.8 - DBL_EPSILON)
-			bandwidth = 98.8;
-		if (centreFreq < outFs - DBL_EPSILON)
-			outSOSCount++;
-		cell[0][i] = magnitude[index];
-		cell[1][i] = centreFreq;
-		cell[2][i] = bandwidth;
 	}
-	free(magnitude);
-	DirectForm2 **temp = (DirectForm2**)malloc(outSOSCount * sizeof(DirectForm2*));
-	for (i = 0; i < outSOSCount; i++)
+	if (src < 0)
+		return 0;
+	for (int i = 0; i < DDC_RATE_CACHE; i++)
 	{
-		temp[i] = (DirectForm2*)malloc(sizeof(DirectForm2));
-		memset(temp[i], 0, sizeof(DirectForm2));
-		designPeakingFilter(cell[0][i], cell[1][i], outFs, cell[2][i], &temp[i]->b0, &temp[i]->b1, &temp[i]->b2, &temp[i]->a1, &temp[i]->a2);
+		if (ddc->rates[i].sos && ddc->rates[i].fs == fs)
+		{
+			*sosCount = ddc->rates[i].sosCount;
+			return ddc->rates[i].sos;
+		}
 	}
-	for (i = 0; i < 3; i++)
-		free(cell[i]);
-	*resampledIIR = temp;
-	return outSOSCount;
+	DDCRate *rate = &ddc->rates[ddc->nextRate];
+	ddc->nextRate = (ddc->nextRate + 1) % DDC_RATE_CACHE;
+	if (rate->sos)
+		free(rate->sos);
+	rate->fs = 0.0;
+	rate->sosCount = 0;
+	rate->sos = (double*)malloc(ddc->tableCount[src] * 5 * sizeof(double));
+	if (!rate->sos)
+		return 0;
+	for (int i = 0; i < ddc->tableCount[src]; i++)
+		DDCRemapSection(ddc->table[src] + i * 5, rate->sos + i * 5, ddcTableFs[src], fs);
+	rate->fs = fs;
+	rate->sosCount = ddc->tableCount[src];
+	*sosCount = rate->sosCount;
+	return rate->sos;
+}
+// Points the cascade at the sections for the current sample rate and rebuilds the engine
+static int DDCLoadCascade(JamesDSPLib *jdsp)
+{
+	DDC *ddc = &jdsp->vdcFl;
+	DDCFreeEngine(ddc);
+	int sosCount = 0;
+	ddc->sos = DDCSectionsForRate(ddc, jdsp->fs, &sosCount);
+	ddc->usedSOSCount = ddc->sos ? sosCount : 0;
+	if (!ddc->sos || !DDCSetupEngine(jdsp))
+	{
+		ddc->sos = 0;
+		ddc->usedSOSCount = 0;
+		return 0;
+	}
+	return 1;
 }
 void DDCConstructor(JamesDSPLib *jdsp)
 {
-	jdsp->vdcFl.oldFile = 0;
-	jdsp->vdcFl.sosPointer = 0;
-	jdsp->vdcFl.usedSOSCount = 0;
+	memset(&jdsp->vdcFl, 0, sizeof(DDC));
 }
 void DDCDestructor(JamesDSPLib *jdsp)
 {
 	jdsp_lock(jdsp);
-	if (jdsp->vdcFl.sosPointer)
-	{
-		for (int i = 0; i < jdsp->vdcFl.usedSOSCount; i++)
-			free(jdsp->vdcFl.sosPointer[i]);
-		free(jdsp->vdcFl.sosPointer);
-		jdsp->vdcFl.sosPointer = 0;
-	}
+	DDCFreeProfile(&jdsp->vdcFl);
 	if (jdsp->vdcFl.oldFile)
 	{
 		free(jdsp->vdcFl.oldFile);
@@ -266,64 +417,22 @@ void DDCDestructor(JamesDSPLib *jdsp)
 	}
 	jdsp_unlock(jdsp);
 }
-int DDCRefresh(JamesDSPLib *jdsp, char *inStr)
-{
-	if (!inStr)
-		return 0;
-	DirectForm2 **df441, **df48;
-	int sosCount = DDCParser(inStr, &df441, &df48);
-	if (!sosCount)
-		return 0;
-	if (jdsp->fs == 44100.0f && df441)
-	{
-		jdsp->vdcFl.sosPointer = df441;
-		jdsp->vdcFl.usedSOSCount = sosCount;
-		for (int i = 0; i < sosCount; i++)
-			free(df48[i]);
-		free(df48);
-	}
-	else if (jdsp->fs == 48000.0f && df48)
-	{
-		jdsp->vdcFl.sosPointer = df48;
-		jdsp->vdcFl.usedSOSCount = sosCount;
-		for (int i = 0; i < sosCount; i++)
-			free(df441[i]);
-		free(df441);
-	}
-	else
-	{
-		DirectForm2 **dfResampled;
-		int resampledSOSCount = PeakingFilterResampler(df48, 48000.0, &dfResampled, jdsp->fs, sosCount);
-		jdsp->vdcFl.usedSOSCount = resampledSOSCount;
-		jdsp->vdcFl.sosPointer = dfResampled;
-		for (int i = 0; i < sosCount; i++)
-		{
-			free(df441[i]);
-			free(df48[i]);
-		}
-		free(df441);
-		free(df48);
-	}
-	return 1;
-}
 int DDCEnable(JamesDSPLib *jdsp)
 {
 	int success = 1;
+	jdsp_lock(jdsp);
+	// The profile is parsed once, a new sample rate only needs its sections
 	if (jdsp->ddcForceRefresh)
 	{
-		success = DDCRefresh(jdsp, jdsp->vdcFl.oldFile);
-		jdsp->ddcForceRefresh = 1;
+		success = DDCLoadCascade(jdsp);
+		jdsp->ddcForceRefresh = 0;
 	}
-	if (!success || !jdsp->vdcFl.usedSOSCount || !jdsp->vdcFl.sosPointer)
-	{
+	if (!success || !jdsp->vdcFl.usedSOSCount || !jdsp->vdcFl.sos)
 		jdsp->ddcEnabled = 0;
-		return -1;
-	}
 	else
-	{
 		jdsp->ddcEnabled = 1;
-		return 1;
-	}
+	jdsp_unlock(jdsp);
+	return jdsp->ddcEnabled ? 1 : -1;
 }
 void DDCDisable(JamesDSPLib *jdsp)
 {
@@ -332,54 +441,104 @@ void DDCDisable(JamesDSPLib *jdsp)
 int DDCStringParser(JamesDSPLib *jdsp, char *newStr)
 {
 	jdsp_lock(jdsp);
-	if (jdsp->vdcFl.oldFile)
+	if (jdsp->vdcFl.oldFile && !strcmp(jdsp->vdcFl.oldFile, newStr))
 	{
-		if (!strcmp(jdsp->vdcFl.oldFile, newStr) && !jdsp->ddcForceRefresh)
-		{
-			jdsp_unlock(jdsp);
-			return 0;
-		}
+		jdsp_unlock(jdsp);
+		return 0;
 	}
-	if (jdsp->vdcFl.sosPointer)
+	jdsp_unlock(jdsp);
+	// Parsing a large profile does not hold up the audio thread
+	double *table[2];
+	int tableCount[2];
+	for (int i = 0; i < 2; i++)
+		tableCount[i] = DDCParseTable(newStr, ddcTableTag[i], &table[i]);
+	size_t stLe = strlen(newStr);
+	char *file = (char*)malloc(stLe + 1);
+	if (file)
+		memcpy(file, newStr, stLe + 1);
+	jdsp_lock(jdsp);
+	DDC *ddc = &jdsp->vdcFl;
+	DDCFreeProfile(ddc);
+	if (ddc->oldFile)
+		free(ddc->oldFile);
+	ddc->oldFile = 0;
+	for (int i = 0; i < 2; i++)
 	{
-		for (int i = 0; i < jdsp->vdcFl.usedSOSCount; i++)
-			free(jdsp->vdcFl.sosPointer[i]);
-		free(jdsp->vdcFl.sosPointer);
-		jdsp->vdcFl.usedSOSCount = 0;
-		jdsp->vdcFl.sosPointer = 0;
+		ddc->table[i] = table[i];
+		ddc->tableCount[i] = tableCount[i];
 	}
-	int success = DDCRefresh(jdsp, newStr);
-	if (!success)
+	if (!file || !DDCLoadCascade(jdsp))
 	{
-		if (jdsp->vdcFl.oldFile)
-		{
-			free(jdsp->vdcFl.oldFile);
-			jdsp->vdcFl.oldFile = 0;
-		}
+		DDCFreeProfile(ddc);
+		if (file)
+			free(file);
 		jdsp_unlock(jdsp);
 		return -1;
 	}
-	if (jdsp->vdcFl.oldFile)
-		free(jdsp->vdcFl.oldFile);
-	size_t stLe = strlen(newStr);
-	jdsp->vdcFl.oldFile = (char*)malloc(stLe + 1);
-	strncpy(jdsp->vdcFl.oldFile, newStr, stLe);
-	jdsp->vdcFl.oldFile[stLe] = '\0';
+	ddc->oldFile = file;
 	jdsp->ddcForceRefresh = 0;
 	jdsp_unlock(jdsp);
 	return 1;
 }
+void DDCSetEngine(JamesDSPLib *jdsp, int useFloat, int firSections)
+{
+	jdsp_lock(jdsp);
+	if (jdsp->vdcFl.useFloat != useFloat || jdsp->vdcFl.firSections != firSections)
+	{
+		jdsp->vdcFl.useFloat = useFloat;
+		jdsp->vdcFl.firSections = firSections;
+		if (jdsp->vdcFl.sos && !DDCSetupEngine(jdsp))
+		{
+			jdsp->vdcFl.sos = 0;
+			jdsp->vdcFl.usedSOSCount = 0;
+		}
+	}
+	jdsp_unlock(jdsp);
+}
 void DDCProcess(JamesDSPLib *jdsp, size_t n)
 {
-	if (jdsp->vdcFl.usedSOSCount)
+	DDC *ddc = &jdsp->vdcFl;
+	if (!ddc->usedSOSCount)
+		return;
+	if (ddc->fir)
 	{
-		for (size_t i = 0; i < n; i++)
+		TwoStageFFTConvolver2x2Process(ddc->fir, jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], jdsp->tmpBuffer[0], jdsp->tmpBuffer[1], (unsigned int)n);
+		return;
+	}
+	// Sections run over the whole block, keeping their coefficients and state in registers
+	for (size_t offset = 0; offset < n; offset += DDC_BLOCK)
+	{
+		size_t len = n - offset < DDC_BLOCK ? n - offset : DDC_BLOCK;
+		float *x1 = jdsp->tmpBuffer[0] + offset, *x2 = jdsp->tmpBuffer[1] + offset;
+		if (ddc->stateFloat)
+		{
+			float buf[DDC_BLOCK * 2];
+			for (size_t i = 0; i < len; i++)
+			{
+				buf[i * 2] = x1[i];
+				buf[i * 2 + 1] = x2[i];
+			}
+			SOS_TDF2_StereoBlockFloat(ddc->sosFloat, ddc->stateFloat, buf, len, ddc->usedSOSCount);
+			for (size_t i = 0; i < len; i++)
+			{
+				x1[i] = buf[i * 2];
+				x2[i] = buf[i * 2 + 1];
+			}
+		}
+		else
 		{
-			double sampleOutL = (double)jdsp->tmpBuffer[0][i], sampleOutR = (double)jdsp->tmpBuffer[1][i];
-			for (int j = 0; j < jdsp->vdcFl.usedSOSCount; j++)
-				SOS_DF2_StereoProcess(jdsp->vdcFl.sosPointer[j], sampleOutL, sampleOutR, &sampleOutL, &sampleOutR);
-			jdsp->tmpBuffer[0][i] = (float)sampleOutL;
-			jdsp->tmpBuffer[1][i] = (float)sampleOutR;
+			double buf[DDC_BLOCK * 2];
+			for (size_t i = 0; i < len; i++)
+			{
+				buf[i * 2] = (double)x1[i];
+				buf[i * 2 + 1] = (double)x2[i];
+			}
+			SOS_TDF2_StereoBlock(ddc->sos, ddc->state, buf, len, ddc->usedSOSCount);
+			for (size_t i = 0; i < len; i++)
+			{
+				x1[i] = (float)buf[i * 2];
+				x2[i] = (float)buf[i * 2 + 1];
+			}
 		}
 	}
 }
@@ -160,8 +160,9 @@ float *ArbitraryEqLinearPhase(ArbitraryEq *arbEq, float fs)
 }
 unsigned int InitArbitraryEq(ArbitraryEq* arbEq, int isLinearPhase)
 {
-	fhtbitReversalTbl(arbEq->mBitRev, MUL2FILTERLEN);
-	fhtsinHalfTblFloat(arbEq->mSineTab, MUL2FILTERLEN);
+	arbEq->plan = FHTPlanAcquire(MUL2FILTERLEN);
+	arbEq->mBitRev = arbEq->plan->bit;
+	arbEq->mSineTab = arbEq->plan->sine;
 	arbEq->nodesCount = 0;
 	if (!isLinearPhase)
 	{
@@ -182,6 +183,14 @@ void EqNodesFree(ArbitraryEq *arbEq)
 	arbEq->nodes = 0;
 	arbEq->nodesCount = 0;
 }
+void FreeArbitraryEq(ArbitraryEq *arbEq)
+{
+	EqNodesFree(arbEq);
+	FHTPlanRelease(arbEq->plan);
+	arbEq->plan = 0;
+	arbEq->mBitRev = 0;
+	arbEq->mSineTab = 0;
+}
 void NodesSorter(ArbitraryEq *arbEq)
 {
 	unsigned int i, numOfNodes = arbEq->nodesCount;
@@ -1,5 +1,6 @@
 #ifndef ARBFIRGEN_H
 #define ARBFIRGEN_H
+#include "../Effects/eel2/numericSys/FHTPlan.h"
 typedef struct
 {
 	float freq;
@@ -14,12 +15,14 @@ typedef struct str_ArbitraryEq
 	unsigned int nodesCount;
 	float timeData[MUL2FILTERLEN];
 	float freqData[MUL2FILTERLEN];
-	unsigned int mBitRev[MUL2FILTERLEN];
-	float mSineTab[MUL2FILTERLEN];
+	const FHTPlan *plan;
+	unsigned int *mBitRev;
+	float *mSineTab;
 	float impulseResponse[MUL2FILTERLEN];
 	float* (*GetFilter)(struct str_ArbitraryEq*, float);
 } ArbitraryEq;
 extern void EqNodesFree(ArbitraryEq *arbEq);
+extern void FreeArbitraryEq(ArbitraryEq *arbEq);
 extern unsigned int InitArbitraryEq(ArbitraryEq* arbEq, int isLinearPhase);
 extern void ArbitraryEqString2SortedNodes(ArbitraryEq *arbEq, char *frArbitraryEqString);
 extern float *InterpolatingEqMinimumPhase(ArbitraryEq *arbEq, float fs, void *lerper);
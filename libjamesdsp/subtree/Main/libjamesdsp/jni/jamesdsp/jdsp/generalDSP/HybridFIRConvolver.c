@@ -0,0 +1,266 @@
+#include "HybridFIRConvolver.h"
+#include <stdlib.h>
+#include <string.h>
+#if defined(THREAD) && !defined(_WIN32)
+#include <unistd.h>
+#endif
+void HybridFIRConvolver2x2Init(HybridFIRConvolver2x2 *conv)
+{
+	conv->_headLen = 0;
+	conv->_tailActive = 0;
+	conv->_headIr[0] = conv->_headIr[1] = 0;
+	conv->_history[0] = conv->_history[1] = 0;
+	conv->_tailOutput[0] = conv->_tailOutput[1] = 0;
+	conv->_tailPrecalculated[0] = conv->_tailPrecalculated[1] = 0;
+	conv->_backgroundProcessingInput[0] = conv->_backgroundProcessingInput[1] = 0;
+	conv->_blockFill = 0;
+	FFTConvolver2x2Init(&conv->_tailConvolver);
+#ifdef THREAD
+	conv->shared_info.state = NOTHING;
+#endif
+}
+#ifdef THREAD
+// The worker only pays off when it can run beside the calling thread
+static int HybridFIRSpareCore(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 1;
+#else
+	return sysconf(_SC_NPROCESSORS_ONLN) > 1;
+#endif
+}
+static void HybridFIRTaskWait(HybridFIRConvolver2x2 *conv)
+{
+	pt_info2x2 *info = &conv->shared_info;
+	while (1)
+	{
+		pthread_cond_wait(&(info->boss_cond), &(info->boss_mtx));
+		if (IDLE == info->state)
+			break;
+	}
+}
+static void HybridFIRTaskStart(HybridFIRConvolver2x2 *conv)
+{
+	pt_info2x2 *info = &conv->shared_info;
+	// ensure worker is waiting
+	pthread_mutex_lock(&(info->work_mtx));
+	info->state = WORKING;
+	// wake-up signal
+	pthread_cond_signal(&(info->work_cond));
+	pthread_mutex_unlock(&(info->work_mtx));
+}
+static void HybridFIRThreadInit(HybridFIRConvolver2x2 *conv)
+{
+	pt_info2x2 *info = &conv->shared_info;
+	info->state = SETUP;
+	pthread_cond_init(&(info->work_cond), NULL);
+	pthread_mutex_init(&(info->work_mtx), NULL);
+	pthread_cond_init(&(info->boss_cond), NULL);
+	pthread_mutex_init(&(info->boss_mtx), NULL);
+	pthread_mutex_lock(&(info->boss_mtx));
+	info->_tailConvolver = &conv->_tailConvolver;
+	info->_backgroundProcessingInput[0] = conv->_backgroundProcessingInput[0];
+	info->_backgroundProcessingInput[1] = conv->_backgroundProcessingInput[1];
+	info->_tailOutput[0] = conv->_tailOutput[0];
+	info->_tailOutput[1] = conv->_tailOutput[1];
+	info->_tailBlockSize = HYBRIDFIR_TAILBLOCK;
+	pthread_create(&conv->threads, NULL, task_type22x2, (void *)info);
+	HybridFIRTaskWait(conv);
+}
+static void HybridFIRThreadExit(HybridFIRConvolver2x2 *conv)
+{
+	pt_info2x2 *info = &conv->shared_info;
+	if (info->state == NOTHING)
+		return;
+	if (info->state == WORKING)
+		HybridFIRTaskWait(conv);
+	// ensure the worker is waiting
+	pthread_mutex_lock(&(info->work_mtx));
+	info->state = GET_OFF_FROM_WORK;
+	// wake-up signal
+	pthread_cond_signal(&(info->work_cond));
+	pthread_mutex_unlock(&(info->work_mtx));
+	// wait for thread to exit
+	pthread_join(conv->threads, NULL);
+	pthread_mutex_destroy(&(info->work_mtx));
+	pthread_cond_destroy(&(info->work_cond));
+	pthread_mutex_unlock(&(info->boss_mtx));
+	pthread_mutex_destroy(&(info->boss_mtx));
+	pthread_cond_destroy(&(info->boss_cond));
+	info->state = NOTHING;
+}
+#endif
+void HybridFIRConvolver2x2Free(HybridFIRConvolver2x2 *conv)
+{
+#ifdef THREAD
+	HybridFIRThreadExit(conv);
+#endif
+	for (int i = 0; i < 2; i++)
+	{
+		free(conv->_headIr[i]);
+		free(conv->_history[i]);
+		free(conv->_tailOutput[i]);
+		free(conv->_tailPrecalculated[i]);
+		free(conv->_backgroundProcessingInput[i]);
+	}
+	FFTConvolver2x2Free(&conv->_tailConvolver);
+	HybridFIRConvolver2x2Init(conv);
+}
+static void HybridFIRConvolverCopyHead(HybridFIRConvolver2x2 *conv, const float* irL, const float* irR, unsigned int irLen)
+{
+	const unsigned int copyLen = irLen < conv->_headLen ? irLen : conv->_headLen;
+	memcpy(conv->_headIr[0], irL, copyLen * sizeof(float));
+	memcpy(conv->_headIr[1], irR, copyLen * sizeof(float));
+	memset(conv->_headIr[0] + copyLen, 0, (conv->_headLen - copyLen) * sizeof(float));
+	memset(conv->_headIr[1] + copyLen, 0, (conv->_headLen - copyLen) * sizeof(float));
+}
+int HybridFIRConvolver2x2LoadImpulseResponse(HybridFIRConvolver2x2 *conv, unsigned int blockSize, const float* irL, const float* irR, unsigned int irLen)
+{
+	if (blockSize == 0)
+		return 0;
+	if (irLen == 0)
+		return 0;
+	if (conv->_headLen || conv->_tailConvolver.slot)
+		HybridFIRConvolver2x2Free(conv);
+	if (blockSize > HYBRIDFIR_MAXQUANTUM)
+		return FFTConvolver2x2LoadImpulseResponse(&conv->_tailConvolver, blockSize, irL, irR, irLen);
+	const unsigned int headLen = HYBRIDFIR_HEADLEN;
+	for (int i = 0; i < 2; i++)
+	{
+		conv->_headIr[i] = (float*)malloc(headLen * sizeof(float));
+		conv->_history[i] = (float*)calloc(headLen - 1 + HYBRIDFIR_TAILBLOCK, sizeof(float));
+		conv->_tailOutput[i] = (float*)calloc(HYBRIDFIR_TAILBLOCK, sizeof(float));
+		conv->_tailPrecalculated[i] = (float*)calloc(HYBRIDFIR_TAILBLOCK, sizeof(float));
+		conv->_backgroundProcessingInput[i] = (float*)malloc(HYBRIDFIR_TAILBLOCK * sizeof(float));
+		if (!conv->_headIr[i] || !conv->_history[i] || !conv->_tailOutput[i] || !conv->_tailPrecalculated[i] || !conv->_backgroundProcessingInput[i])
+		{
+			HybridFIRConvolver2x2Free(conv);
+			return 0;
+		}
+	}
+	conv->_headLen = headLen;
+	HybridFIRConvolverCopyHead(conv, irL, irR, irLen);
+	conv->_tailActive = irLen > headLen;
+	if (conv->_tailActive && !FFTConvolver2x2LoadImpulseResponse(&conv->_tailConvolver, HYBRIDFIR_TAILBLOCK, irL + headLen, irR + headLen, irLen - headLen))
+	{
+		HybridFIRConvolver2x2Free(conv);
+		return 0;
+	}
+#ifdef THREAD
+	if (conv->_tailActive && HybridFIRSpareCore())
+		HybridFIRThreadInit(conv);
+#endif
+	return 1;
+}
+int HybridFIRConvolver2x2RefreshImpulseResponse(HybridFIRConvolver2x2 *conv, unsigned int blockSize, const float* irL, const float* irR, unsigned int irLen)
+{
+	if (blockSize == 0)
+		return 0;
+	if (irLen == 0)
+		return 0;
+	if (!conv->_headLen)
+		return FFTConvolver2x2RefreshImpulseResponse(&conv->_tailConvolver, blockSize, irL, irR, irLen);
+	HybridFIRConvolverCopyHead(conv, irL, irR, irLen);
+	if (conv->_tailActive)
+	{
+#ifdef THREAD
+		// The worker may still be reading the tail spectra
+		if (conv->shared_info.state == WORKING)
+			HybridFIRTaskWait(conv);
+#endif
+		return FFTConvolver2x2RefreshImpulseResponse(&conv->_tailConvolver, HYBRIDFIR_TAILBLOCK, irL + conv->_headLen, irR + conv->_headLen, irLen - conv->_headLen);
+	}
+	return 1;
+}
+// Collects the tail result due next and hands the block just completed to the tail convolver
+static void HybridFIRConvolverTailBlock(HybridFIRConvolver2x2 *conv)
+{
+#ifdef THREAD
+	if (conv->shared_info.state == WORKING)
+		HybridFIRTaskWait(conv);
+#endif
+	float *tmp = conv->_tailOutput[0];
+	conv->_tailOutput[0] = conv->_tailPrecalculated[0];
+	conv->_tailPrecalculated[0] = tmp;
+	tmp = conv->_tailOutput[1];
+	conv->_tailOutput[1] = conv->_tailPrecalculated[1];
+	conv->_tailPrecalculated[1] = tmp;
+	memcpy(conv->_backgroundProcessingInput[0], conv->_history[0] + conv->_headLen - 1, HYBRIDFIR_TAILBLOCK * sizeof(float));
+	memcpy(conv->_backgroundProcessingInput[1], conv->_history[1] + conv->_headLen - 1, HYBRIDFIR_TAILBLOCK * sizeof(float));
+#ifdef THREAD
+	if (conv->shared_info.state != NOTHING)
+	{
+		conv->shared_info._tailOutput[0] = conv->_tailOutput[0];
+		conv->shared_info._tailOutput[1] = conv->_tailOutput[1];
+		HybridFIRTaskStart(conv);
+		return;
+	}
+#endif
+	FFTConvolver2x2Process(&conv->_tailConvolver, conv->_backgroundProcessingInput[0], conv->_backgroundProcessingInput[1], conv->_tailOutput[0], conv->_tailOutput[1], HYBRIDFIR_TAILBLOCK);
+}
+void HybridFIRConvolver2x2Process(HybridFIRConvolver2x2 *conv, const float* x1, const float* x2, float* y1, float* y2, unsigned int len)
+{
+	if (!conv->_headLen)
+	{
+		FFTConvolver2x2Process(&conv->_tailConvolver, x1, x2, y1, y2, len);
+		return;
+	}
+	const unsigned int headLen = conv->_headLen;
+	float accL[HYBRIDFIR_MAXQUANTUM], accR[HYBRIDFIR_MAXQUANTUM];
+	unsigned int processed = 0;
+	while (processed < len)
+	{
+		unsigned int n = len - processed;
+		if (n > HYBRIDFIR_TAILBLOCK - conv->_blockFill)
+			n = HYBRIDFIR_TAILBLOCK - conv->_blockFill;
+		if (n > HYBRIDFIR_MAXQUANTUM)
+			n = HYBRIDFIR_MAXQUANTUM;
+		const unsigned int end4 = n & ~3u;
+		float *bufL = conv->_history[0] + headLen - 1 + conv->_blockFill;
+		float *bufR = conv->_history[1] + headLen - 1 + conv->_blockFill;
+		memcpy(bufL, x1 + processed, n * sizeof(float));
+		memcpy(bufR, x2 + processed, n * sizeof(float));
+		// Tail computed from the block before last, the tail convolution starts headLen samples late
+		memcpy(accL, conv->_tailPrecalculated[0] + conv->_blockFill, n * sizeof(float));
+		memcpy(accR, conv->_tailPrecalculated[1] + conv->_blockFill, n * sizeof(float));
+		// Direct form head, taps outer so both channels accumulate over contiguous history
+		for (unsigned int k = 0; k < headLen; k++)
+		{
+			const float hL = conv->_headIr[0][k];
+			const float hR = conv->_headIr[1][k];
+			const float *sL = bufL - k;
+			const float *sR = bufR - k;
+			unsigned int i;
+			for (i = 0; i < end4; i += 4)
+			{
+				accL[i + 0] += hL * sL[i + 0];
+				accL[i + 1] += hL * sL[i + 1];
+				accL[i + 2] += hL * sL[i + 2];
+				accL[i + 3] += hL * sL[i + 3];
+				accR[i + 0] += hR * sR[i + 0];
+				accR[i + 1] += hR * sR[i + 1];
+				accR[i + 2] += hR * sR[i + 2];
+				accR[i + 3] += hR * sR[i + 3];
+			}
+			for (; i < n; i++)
+			{
+				accL[i] += hL * sL[i];
+				accR[i] += hR * sR[i];
+			}
+		}
+		memcpy(y1 + processed, accL, n * sizeof(float));
+		memcpy(y2 + processed, accR, n * sizeof(float));
+		processed += n;
+		conv->_blockFill += n;
+		if (conv->_blockFill == HYBRIDFIR_TAILBLOCK)
+		{
+			if (conv->_tailActive)
+				HybridFIRConvolverTailBlock(conv);
+			memmove(conv->_history[0], conv->_history[0] + HYBRIDFIR_TAILBLOCK, (headLen - 1) * sizeof(float));
+			memmove(conv->_history[1], conv->_history[1] + HYBRIDFIR_TAILBLOCK, (headLen - 1) * sizeof(float));
+			conv->_blockFill = 0;
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef _FFTCONVOLVER_HYBRIDFIRCONVOLVER_H
+#define _FFTCONVOLVER_HYBRIDFIRCONVOLVER_H
+
+#include "TwoStageFFTConvolver.h"
+// Largest host block size that gets a direct form head, above it the FFT convolver runs alone
+#define HYBRIDFIR_MAXQUANTUM 64
+// Direct form taps
+#define HYBRIDFIR_HEADLEN 256
+// Partition of the tail convolver, half the head so every tail block is due one block after it's complete
+#define HYBRIDFIR_TAILBLOCK (HYBRIDFIR_HEADLEN / 2)
+typedef struct
+{
+	unsigned int _headLen;
+	unsigned int _tailActive;
+	float *_headIr[2];
+	float *_history[2]; // _headLen - 1 past samples followed by the current tail block
+	float *_tailOutput[2]; // Tail of the next block, written in the background
+	float *_tailPrecalculated[2]; // Tail of the current block
+	float *_backgroundProcessingInput[2];
+	unsigned int _blockFill;
+	FFTConvolver2x2 _tailConvolver;
+#ifdef THREAD
+	pthread_t threads;
+	pt_info2x2 shared_info;
+#endif
+} HybridFIRConvolver2x2;
+/**
+* @class HybridFIRConvolver2x2
+* @brief Zero latency convolver for tiny block sizes
+*
+* With block sizes of a few dozen samples a partitioned FFT convolver runs a
+* transform pair and a full spectral accumulation on every call. This convolver
+* processes the first HYBRIDFIR_HEADLEN taps as a direct form FIR on both
+* channels, the rest of the impulse response is delayed by the head length so
+* the tail convolver only ever sees complete HYBRIDFIR_TAILBLOCK blocks.
+*
+* A tail block is needed one block after it has been collected, so the tail
+* convolution runs on a background thread like the TwoStageFFTConvolver tail and
+* the calling thread only runs the direct form head. On a single CPU the thread
+* could only preempt the caller, the tail then runs inline. The head is plain C written
+* for auto-vectorisation, there are no intrinsics.
+*
+* Block sizes above HYBRIDFIR_MAXQUANTUM skip the direct form head and behave
+* exactly like FFTConvolver2x2.
+*/
+extern void HybridFIRConvolver2x2Init(HybridFIRConvolver2x2 *conv);
+
+/**
+* @brief Initializes the convolver
+* @param blockSize Host block size
+* @param irL, irR The impulse responses
+* @param irLen Length of the impulse responses
+* @return 1: Success - 0: Failed
+*/
+extern int HybridFIRConvolver2x2LoadImpulseResponse(HybridFIRConvolver2x2 *conv, unsigned int blockSize, const float* irL, const float* irR, unsigned int irLen);
+
+/**
+* @brief Convolves the the given input samples and immediately outputs the result
+*/
+extern void HybridFIRConvolver2x2Process(HybridFIRConvolver2x2 *conv, const float* x1, const float* x2, float* y1, float* y2, unsigned int len);
+
+/**
+* @brief Resets the convolver and discards the set impulse response
+*/
+extern void HybridFIRConvolver2x2Free(HybridFIRConvolver2x2 *conv);
+
+/**
+* @brief Refreshs the convolver without modify memory pointers
+* blockSize, irLen must be the same as the one in initialization
+*/
+extern int HybridFIRConvolver2x2RefreshImpulseResponse(HybridFIRConvolver2x2 *conv, unsigned int blockSize, const float* irL, const float* irR, unsigned int irLen);
+#endif
@@ -477,9 +477,9 @@ void TwoStageFFTConvolver1x1Free(TwoStageFFTConvolver1x1 *conv)
 #endif
 	conv->_headBlockSize = 0;
 	conv->_tailBlockSize = 0;
-	if (conv->_headConvolver.bit)
+	if (conv->_headConvolver.slot)
 		FFTConvolver1x1Free(&conv->_headConvolver);
-	if (conv->_tailConvolver0.bit)
+	if (conv->_tailConvolver0.slot)
 	FFTConvolver1x1Free(&conv->_tailConvolver0);
 	if (conv->_tailOutput0)
 	{
@@ -511,7 +511,7 @@ void TwoStageFFTConvolver1x1Free(TwoStageFFTConvolver1x1 *conv)
 		free(conv->_backgroundProcessingInput);
 		conv->_backgroundProcessingInput = 0;
 	}
-	if (conv->_tailConvolver.bit)
+	if (conv->_tailConvolver.slot)
 	FFTConvolver1x1Free(&conv->_tailConvolver);
 	conv->_tailInputFill = 0;
 	conv->_tailInputFill = 0;
@@ -533,9 +533,9 @@ void TwoStageFFTConvolver2x4x2Free(TwoStageFFTConvolver2x4x2 *conv)
 #endif
 	conv->_headBlockSize = 0;
 	conv->_tailBlockSize = 0;
-	if (conv->_headConvolver.bit)
+	if (conv->_headConvolver.slot)
 		FFTConvolver2x4x2Free(&conv->_headConvolver);
-	if (conv->_tailConvolver0.bit)
+	if (conv->_tailConvolver0.slot)
 		FFTConvolver2x4x2Free(&conv->_tailConvolver0);
 	if (conv->_tailOutput0[0])
 	{
@@ -573,7 +573,7 @@ void TwoStageFFTConvolver2x4x2Free(TwoStageFFTConvolver2x4x2 *conv)
 		free(conv->_backgroundProcessingInput[1]);
 		conv->_backgroundProcessingInput[0] = 0;
 	}
-	if (conv->_tailConvolver.bit)
+	if (conv->_tailConvolver.slot)
 	FFTConvolver2x4x2Free(&conv->_tailConvolver);
 	conv->_tailInputFill = 0;
 	conv->_tailInputFill = 0;
@@ -595,9 +595,9 @@ void TwoStageFFTConvolver2x2Free(TwoStageFFTConvolver2x2 *conv)
 #endif
 	conv->_headBlockSize = 0;
 	conv->_tailBlockSize = 0;
-	if (conv->_headConvolver.bit)
+	if (conv->_headConvolver.slot)
 		FFTConvolver2x2Free(&conv->_headConvolver);
-	if (conv->_tailConvolver0.bit)
+	if (conv->_tailConvolver0.slot)
 		FFTConvolver2x2Free(&conv->_tailConvolver0);
 	if (conv->_tailOutput0[0])
 	{
@@ -635,7 +635,7 @@ void TwoStageFFTConvolver2x2Free(TwoStageFFTConvolver2x2 *conv)
 		free(conv->_backgroundProcessingInput[1]);
 		conv->_backgroundProcessingInput[0] = 0;
 	}
-	if (conv->_tailConvolver.bit)
+	if (conv->_tailConvolver.slot)
 		FFTConvolver2x2Free(&conv->_tailConvolver);
 	conv->_tailInputFill = 0;
 	conv->_tailInputFill = 0;
@@ -657,9 +657,9 @@ void TwoStageFFTConvolver1x2Free(TwoStageFFTConvolver1x2 *conv)
 #endif
 	conv->_headBlockSize = 0;
 	conv->_tailBlockSize = 0;
-	if (conv->_headConvolver.bit)
+	if (conv->_headConvolver.slot)
 		FFTConvolver1x2Free(&conv->_headConvolver);
-	if (conv->_tailConvolver0.bit)
+	if (conv->_tailConvolver0.slot)
 		FFTConvolver1x2Free(&conv->_tailConvolver0);
 	if (conv->_tailOutput0[0])
 	{
@@ -695,7 +695,7 @@ void TwoStageFFTConvolver1x2Free(TwoStageFFTConvolver1x2 *conv)
 		free(conv->_backgroundProcessingInput);
 		conv->_backgroundProcessingInput = 0;
 	}
-	if (conv->_tailConvolver.bit)
+	if (conv->_tailConvolver.slot)
 		FFTConvolver1x2Free(&conv->_tailConvolver);
 	conv->_tailInputFill = 0;
 	conv->_tailInputFill = 0;
@@ -719,15 +719,16 @@ int TwoStageFFTConvolver1x1LoadImpulseResponse(TwoStageFFTConvolver1x1 *conv, un
 		--irLen;
 	if (irLen == 0)
 		return 1;
-	if (conv->_headConvolver.bit)
+	if (conv->_headConvolver.slot)
 		TwoStageFFTConvolver1x1Free(conv);
 
-	conv->_headBlockSize = upper_power_of_two(headBlockSize);
-	conv->_tailBlockSize = upper_power_of_two(tailBlockSize);
+	conv->_headBlockSize = FHTPlanBlockSize(headBlockSize);
 	if (conv->_headBlockSize > 524288)
 		conv->_headBlockSize = 524288;
-	if (conv->_tailBlockSize > 524288)
-		conv->_tailBlockSize = 524288;
+	// Tail partition has to be a power of 2 multiple of the head partition
+	conv->_tailBlockSize = conv->_headBlockSize * upper_power_of_two((tailBlockSize + conv->_headBlockSize - 1) / conv->_headBlockSize);
+	while (conv->_tailBlockSize > 524288 && conv->_tailBlockSize > conv->_headBlockSize)
+		conv->_tailBlockSize >>= 1;
 	const unsigned int headIrLen = min(irLen, conv->_tailBlockSize);
 	FFTConvolver1x1LoadImpulseResponse(&conv->_headConvolver, conv->_headBlockSize, ir, headIrLen);
 	if (irLen > conv->_tailBlockSize)
@@ -777,15 +778,16 @@ int TwoStageFFTConvolver2x4x2LoadImpulseResponse(TwoStageFFTConvolver2x4x2 *conv
 	if (irLen == 0)
 		return 1;
 
-	if (conv->_headConvolver.bit)
+	if (conv->_headConvolver.slot)
 		TwoStageFFTConvolver2x4x2Free(conv);
 
-	conv->_headBlockSize = upper_power_of_two(headBlockSize);
-	conv->_tailBlockSize = upper_power_of_two(tailBlockSize);
+	conv->_headBlockSize = FHTPlanBlockSize(headBlockSize);
 	if (conv->_headBlockSize > 524288)
 		conv->_headBlockSize = 524288;
-	if (conv->_tailBlockSize > 524288)
-		conv->_tailBlockSize = 524288;
+	// Tail partition has to be a power of 2 multiple of the head partition
+	conv->_tailBlockSize = conv->_headBlockSize * upper_power_of_two((tailBlockSize + conv->_headBlockSize - 1) / conv->_headBlockSize);
+	while (conv->_tailBlockSize > 524288 && conv->_tailBlockSize > conv->_headBlockSize)
+		conv->_tailBlockSize >>= 1;
 	const unsigned int headIrLen = min(irLen, conv->_tailBlockSize);
 	FFTConvolver2x4x2LoadImpulseResponse(&conv->_headConvolver, conv->_headBlockSize, irLL, irLR, irRL, irRR, headIrLen);
 	if (irLen > conv->_tailBlockSize)
@@ -802,6 +804,10 @@ int TwoStageFFTConvolver2x4x2LoadImpulseResponse(TwoStageFFTConvolver2x4x2 *conv
 	if (irLen > 2 * conv->_tailBlockSize)
 	{
 		const unsigned int tailIrLen = irLen - (2 * conv->_tailBlockSize);
+#ifdef THREAD
+		// Runs on the worker thread, so very long IR spectra may be streamed from disk
+		conv->_tailConvolver._stream.enabled = 1;
+#endif
 		FFTConvolver2x4x2LoadImpulseResponse(&conv->_tailConvolver, conv->_tailBlockSize, irLL + (2 * conv->_tailBlockSize), irLR + (2 * conv->_tailBlockSize), irRL + (2 * conv->_tailBlockSize), irRR + (2 * conv->_tailBlockSize), tailIrLen);
 		conv->_tailOutput[0] = (float*)malloc(conv->_tailBlockSize * sizeof(float));
 		conv->_tailOutput[1] = (float*)malloc(conv->_tailBlockSize * sizeof(float));
@@ -844,15 +850,16 @@ int TwoStageFFTConvolver2x2LoadImpulseResponse(TwoStageFFTConvolver2x2 *conv, un
 	if (irLen == 0)
 		return 1;
 
-	if (conv->_headConvolver.bit)
+	if (conv->_headConvolver.slot)
 		TwoStageFFTConvolver2x2Free(conv);
 
-	conv->_headBlockSize = upper_power_of_two(headBlockSize);
-	conv->_tailBlockSize = upper_power_of_two(tailBlockSize);
+	conv->_headBlockSize = FHTPlanBlockSize(headBlockSize);
 	if (conv->_headBlockSize > 524288)
 		conv->_headBlockSize = 524288;
-	if (conv->_tailBlockSize > 524288)
-		conv->_tailBlockSize = 524288;
+	// Tail partition has to be a power of 2 multiple of the head partition
+	conv->_tailBlockSize = conv->_headBlockSize * upper_power_of_two((tailBlockSize + conv->_headBlockSize - 1) / conv->_headBlockSize);
+	while (conv->_tailBlockSize > 524288 && conv->_tailBlockSize > conv->_headBlockSize)
+		conv->_tailBlockSize >>= 1;
 	const unsigned int headIrLen = min(irLen, conv->_tailBlockSize);
 	FFTConvolver2x2LoadImpulseResponse(&conv->_headConvolver, conv->_headBlockSize, irL, irR, headIrLen);
 	if (irLen > conv->_tailBlockSize)
@@ -869,6 +876,10 @@ int TwoStageFFTConvolver2x2LoadImpulseResponse(TwoStageFFTConvolver2x2 *conv, un
 	if (irLen > 2 * conv->_tailBlockSize)
 	{
 		const unsigned int tailIrLen = irLen - (2 * conv->_tailBlockSize);
+#ifdef THREAD
+		// Runs on the worker thread, so very long IR spectra may be streamed from disk
+		conv->_tailConvolver._stream.enabled = 1;
+#endif
 		FFTConvolver2x2LoadImpulseResponse(&conv->_tailConvolver, conv->_tailBlockSize, irL + (2 * conv->_tailBlockSize), irR + (2 * conv->_tailBlockSize), tailIrLen);
 		conv->_tailOutput[0] = (float*)malloc(conv->_tailBlockSize * sizeof(float));
 		conv->_tailOutput[1] = (float*)malloc(conv->_tailBlockSize * sizeof(float));
@@ -911,15 +922,16 @@ int TwoStageFFTConvolver1x2LoadImpulseResponse(TwoStageFFTConvolver1x2 *conv, un
 	if (irLen == 0)
 		return 1;
 
-	if (conv->_headConvolver.bit)
+	if (conv->_headConvolver.slot)
 		TwoStageFFTConvolver1x2Free(conv);
 
-	conv->_headBlockSize = upper_power_of_two(headBlockSize);
-	conv->_tailBlockSize = upper_power_of_two(tailBlockSize);
+	conv->_headBlockSize = FHTPlanBlockSize(headBlockSize);
 	if (conv->_headBlockSize > 524288)
 		conv->_headBlockSize = 524288;
-	if (conv->_tailBlockSize > 524288)
-		conv->_tailBlockSize = 524288;
+	// Tail partition has to be a power of 2 multiple of the head partition
+	conv->_tailBlockSize = conv->_headBlockSize * upper_power_of_two((tailBlockSize + conv->_headBlockSize - 1) / conv->_headBlockSize);
+	while (conv->_tailBlockSize > 524288 && conv->_tailBlockSize > conv->_headBlockSize)
+		conv->_tailBlockSize >>= 1;
 	const unsigned int headIrLen = min(irLen, conv->_tailBlockSize);
 	FFTConvolver1x2LoadImpulseResponse(&conv->_headConvolver, conv->_headBlockSize, irL, irR, headIrLen);
 	if (irLen > conv->_tailBlockSize)
@@ -962,7 +974,7 @@ void TwoStageFFTConvolver1x1Process(TwoStageFFTConvolver1x1 *conv, const float*
 {
 	if (conv->_tailInput)
 	{
-		unsigned int i, j, symIdx, processed = 0;
+		unsigned int i, j, processed = 0;
 		while (processed < len)
 		{
 			const unsigned int remaining = len - processed;
@@ -975,25 +987,14 @@ void TwoStageFFTConvolver1x1Process(TwoStageFFTConvolver1x1 *conv, const float*
 			conv->_tailInputFill += processing;
 
 			// Forward FFT
-			for (j = 0; j < conv->_headConvolver._blockSize; j++)
-				conv->_headConvolver._fftBuffer[conv->_headConvolver.bit[j]] = conv->_headConvolver._inputBuffer[j];
-			for (j = conv->_headConvolver._blockSize; j < conv->_headConvolver._segSize; j++)
-				conv->_headConvolver._fftBuffer[conv->_headConvolver.bit[j]] = 0.0f;
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer, conv->_headConvolver.sine);
-			conv->_headConvolver._segmentsRe[conv->_headConvolver._current][0] = conv->_headConvolver._fftBuffer[0];
-			for (j = 1; j < conv->_headConvolver._fftComplexSize; j++)
-			{
-				symIdx = conv->_headConvolver._segSize - j;
-				conv->_headConvolver._segmentsRe[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[j] + conv->_headConvolver._fftBuffer[symIdx];
-				conv->_headConvolver._segmentsIm[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[j] - conv->_headConvolver._fftBuffer[symIdx];
-			}
+			fhtPartitionSpectrum(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer, conv->_headConvolver._inputBuffer, conv->_headConvolver._blockSize, conv->_headConvolver._segmentsRe[conv->_headConvolver._current], conv->_headConvolver._segmentsIm[conv->_headConvolver._current]);
 
 			// Complex multiplication
 			const float *reA;
 			const float *imA;
 			const float *reB;
 			const float *imB;
-			unsigned int end4 = conv->_headConvolver._fftComplexSize - 1;
+			unsigned int end4 = (conv->_headConvolver._fftComplexSize - 1) & ~3u;
 			if (inputBufferWasEmpty)
 			{
 				unsigned int segFrameIndex = (conv->_headConvolver._current + 1) % conv->_headConvolver._segCount;
@@ -1016,8 +1017,11 @@ void TwoStageFFTConvolver1x1Process(TwoStageFFTConvolver1x1 *conv, const float*
 						im[j + 2] = reA[j + 2] * imB[j + 2] + imA[j + 2] * reB[j + 2];
 						im[j + 3] = reA[j + 3] * imB[j + 3] + imA[j + 3] * reB[j + 3];
 					}
-					re[end4] = reA[end4] * reB[end4] - imA[end4] * imB[end4];
-					im[end4] = reA[end4] * imB[end4] + imA[end4] * reB[end4];
+					for (j = end4; j < conv->_headConvolver._fftComplexSize; j++)
+					{
+						re[j] = reA[j] * reB[j] - imA[j] * imB[j];
+						im[j] = reA[j] * imB[j] + imA[j] * reB[j];
+					}
 					for (i = 2; i < conv->_headConvolver._segCount; ++i)
 					{
 						segFrameIndex = (conv->_headConvolver._current + i) % conv->_headConvolver._segCount;
@@ -1038,8 +1042,11 @@ void TwoStageFFTConvolver1x1Process(TwoStageFFTConvolver1x1 *conv, const float*
 							im[j + 2] += reA[j + 2] * imB[j + 2] + imA[j + 2] * reB[j + 2];
 							im[j + 3] += reA[j + 3] * imB[j + 3] + imA[j + 3] * reB[j + 3];
 						}
-						re[end4] += reA[end4] * reB[end4] - imA[end4] * imB[end4];
-						im[end4] += reA[end4] * imB[end4] + imA[end4] * reB[end4];
+						for (j = end4; j < conv->_headConvolver._fftComplexSize; j++)
+						{
+							re[j] += reA[j] * reB[j] - imA[j] * imB[j];
+							im[j] += reA[j] * imB[j] + imA[j] * reB[j];
+						}
 					}
 				}
 			}
@@ -1053,14 +1060,13 @@ void TwoStageFFTConvolver1x1Process(TwoStageFFTConvolver1x1 *conv, const float*
 			conv->_headConvolver._fftBuffer[0] = reB[0] * reA[0] + srcRe[0];
 			for (j = 1; j < conv->_headConvolver._fftComplexSize; ++j)
 			{
-				symIdx = conv->_headConvolver._segSize - j;
 				real = reB[j] * reA[j] - imB[j] * imA[j] + srcRe[j];
 				imag = reB[j] * imA[j] + imB[j] * reA[j] + srcIm[j];
-				conv->_headConvolver._fftBuffer[conv->_headConvolver.bit[j]] = (real + imag) * 0.5f;
-				conv->_headConvolver._fftBuffer[conv->_headConvolver.bit[symIdx]] = (real - imag) * 0.5f;
+				conv->_headConvolver._fftBuffer[conv->_headConvolver.slot[j << 1]] = (real + imag) * 0.5f;
+				conv->_headConvolver._fftBuffer[conv->_headConvolver.slot[(j << 1) + 1]] = (real - imag) * 0.5f;
 			}
 			// Backward FFT
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer, conv->_headConvolver.sine);
+			FHTPlanInverse(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer);
 
 			// Add overlap
 			float *result = output + processed;
@@ -1167,7 +1173,7 @@ void TwoStageFFTConvolver2x4x2Process(TwoStageFFTConvolver2x4x2 *conv, const flo
 {
 	if (conv->_tailInput[0])
 	{
-		unsigned int i, j, symIdx;
+		unsigned int i, j;
 		unsigned int processed = 0, processed2 = 0;
 		while (processed < len)
 		{
@@ -1182,28 +1188,8 @@ void TwoStageFFTConvolver2x4x2Process(TwoStageFFTConvolver2x4x2 *conv, const flo
 			conv->_tailInputFill += processing;
 
 			// Forward FFT
-			for (j = 0; j < conv->_headConvolver._blockSize; j++)
-			{
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[j]] = conv->_headConvolver._inputBuffer[0][j];
-				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.bit[j]] = conv->_headConvolver._inputBuffer[1][j];
-			}
-			for (j = conv->_headConvolver._blockSize; j < conv->_headConvolver._segSize; j++)
-			{
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[j]] = 0.0f;
-				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.bit[j]] = 0.0f;
-			}
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[0], conv->_headConvolver.sine);
-			conv->_headConvolver._segmentsReLeft[conv->_headConvolver._current][0] = conv->_headConvolver._fftBuffer[0][0];
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[1], conv->_headConvolver.sine);
-			conv->_headConvolver._segmentsReRight[conv->_headConvolver._current][0] = conv->_headConvolver._fftBuffer[1][0];
-			for (j = 1; j < conv->_headConvolver._fftComplexSize; j++)
-			{
-				symIdx = conv->_headConvolver._segSize - j;
-				conv->_headConvolver._segmentsReLeft[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[0][j] + conv->_headConvolver._fftBuffer[0][symIdx];
-				conv->_headConvolver._segmentsImLeft[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[0][j] - conv->_headConvolver._fftBuffer[0][symIdx];
-				conv->_headConvolver._segmentsReRight[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[1][j] + conv->_headConvolver._fftBuffer[1][symIdx];
-				conv->_headConvolver._segmentsImRight[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[1][j] - conv->_headConvolver._fftBuffer[1][symIdx];
-			}
+			fhtPartitionSpectrum(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[0], conv->_headConvolver._inputBuffer[0], conv->_headConvolver._blockSize, conv->_headConvolver._segmentsReLeft[conv->_headConvolver._current], conv->_headConvolver._segmentsImLeft[conv->_headConvolver._current]);
+			fhtPartitionSpectrum(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[1], conv->_headConvolver._inputBuffer[1], conv->_headConvolver._blockSize, conv->_headConvolver._segmentsReRight[conv->_headConvolver._current], conv->_headConvolver._segmentsImRight[conv->_headConvolver._current]);
 
 			// Complex multiplication
 			const float *reALL, *imALL, *reALR, *imALR, *reARL, *imARL, *reARR, *imARR;
@@ -1211,7 +1197,7 @@ void TwoStageFFTConvolver2x4x2Process(TwoStageFFTConvolver2x4x2 *conv, const flo
 			const float *imBLeft;
 			const float *reBRight;
 			const float *imBRight;
-			unsigned int end4 = conv->_headConvolver._fftComplexSize - 1;
+			unsigned int end4 = (conv->_headConvolver._fftComplexSize - 1) & ~3u;
 			if (inputBufferWasEmpty)
 			{
 				unsigned int segFrameIndex = (conv->_headConvolver._current + 1) % conv->_headConvolver._segCount;
@@ -1252,10 +1238,13 @@ void TwoStageFFTConvolver2x4x2Process(TwoStageFFTConvolver2x4x2 *conv, const flo
 						imRight[j + 2] = (imALR[j + 2] * reBLeft[j + 2] + reALR[j + 2] * imBLeft[j + 2]) + (reARR[j + 2] * imBRight[j + 2] + imARR[j + 2] * reBRight[j + 2]);
 						imRight[j + 3] = (imALR[j + 3] * reBLeft[j + 3] + reALR[j + 3] * imBLeft[j + 3]) + (reARR[j + 3] * imBRight[j + 3] + imARR[j + 3] * reBRight[j + 3]);
 					}
-					reLeft[end4] = (reARL[end4] * reBRight[end4] - imARL[end4] * imBRight[end4]) + (reALL[end4] * reBLeft[end4] - imALL[end4] * imBLeft[end4]);
-					imLeft[end4] = (imARL[end4] * reBRight[end4] + reARL[end4] * imBRight[end4]) + (reALL[end4] * imBLeft[end4] + imALL[end4] * reBLeft[end4]);
-					reRight[end4] = (reALR[end4] * reBLeft[end4] - imALR[end4] * imBLeft[end4]) + (reARR[end4] * reBRight[end4] - imARR[end4] * imBRight[end4]);
-					imRight[end4] = (imALR[end4] * reBLeft[end4] + reALR[end4] * imBLeft[end4]) + (reARR[end4] * imBRight[end4] + imARR[end4] * reBRight[end4]);
+					for (j = end4; j < conv->_headConvolver._fftComplexSize; j++)
+					{
+						reLeft[j] = (reARL[j] * reBRight[j] - imARL[j] * imBRight[j]) + (reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j]);
+						imLeft[j] = (imARL[j] * reBRight[j] + reARL[j] * imBRight[j]) + (reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j]);
+						reRight[j] = (reALR[j] * reBLeft[j] - imALR[j] * imBLeft[j]) + (reARR[j] * reBRight[j] - imARR[j] * imBRight[j]);
+						imRight[j] = (imALR[j] * reBLeft[j] + reALR[j] * imBLeft[j]) + (reARR[j] * imBRight[j] + imARR[j] * reBRight[j]);
+					}
 					for (unsigned int i = 2; i < conv->_headConvolver._segCount; ++i)
 					{
 						segFrameIndex = (conv->_headConvolver._current + i) % conv->_headConvolver._segCount;
@@ -1294,10 +1283,13 @@ void TwoStageFFTConvolver2x4x2Process(TwoStageFFTConvolver2x4x2 *conv, const flo
 							imRight[j + 2] += (imALR[j + 2] * reBLeft[j + 2] + reALR[j + 2] * imBLeft[j + 2]) + (reARR[j + 2] * imBRight[j + 2] + imARR[j + 2] * reBRight[j + 2]);
 							imRight[j + 3] += (imALR[j + 3] * reBLeft[j + 3] + reALR[j + 3] * imBLeft[j + 3]) + (reARR[j + 3] * imBRight[j + 3] + imARR[j + 3] * reBRight[j + 3]);
 						}
-						reLeft[end4] += (reARL[end4] * reBRight[end4] - imARL[end4] * imBRight[end4]) + (reALL[end4] * reBLeft[end4] - imALL[end4] * imBLeft[end4]);
-						imLeft[end4] += (imARL[end4] * reBRight[end4] + reARL[end4] * imBRight[end4]) + (reALL[end4] * imBLeft[end4] + imALL[end4] * reBLeft[end4]);
-						reRight[end4] += (reALR[end4] * reBLeft[end4] - imALR[end4] * imBLeft[end4]) + (reARR[end4] * reBRight[end4] - imARR[end4] * imBRight[end4]);
-						imRight[end4] += (imALR[end4] * reBLeft[end4] + reALR[end4] * imBLeft[end4]) + (reARR[end4] * imBRight[end4] + imARR[end4] * reBRight[end4]);
+						for (j = end4; j < conv->_headConvolver._fftComplexSize; j++)
+						{
+							reLeft[j] += (reARL[j] * reBRight[j] - imARL[j] * imBRight[j]) + (reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j]);
+							imLeft[j] += (imARL[j] * reBRight[j] + reARL[j] * imBRight[j]) + (reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j]);
+							reRight[j] += (reALR[j] * reBLeft[j] - imALR[j] * imBLeft[j]) + (reARR[j] * reBRight[j] - imARR[j] * imBRight[j]);
+							imRight[j] += (imALR[j] * reBLeft[j] + reALR[j] * imBLeft[j]) + (reARR[j] * imBRight[j] + imARR[j] * reBRight[j]);
+						}
 					}
 				}
 			}
@@ -1322,19 +1314,18 @@ void TwoStageFFTConvolver2x4x2Process(TwoStageFFTConvolver2x4x2 *conv, const flo
 			conv->_headConvolver._fftBuffer[1][0] = (reALR[0] * reBLeft[0]) + (reARR[0] * reBRight[0]) + src2Re[0];
 			for (j = 1; j < conv->_headConvolver._fftComplexSize; ++j)
 			{
-				symIdx = conv->_headConvolver._segSize - j;
 				realL = (reARL[j] * reBRight[j] - imARL[j] * imBRight[j]) + (reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j]) + src1Re[j];
 				imagL = (imARL[j] * reBRight[j] + reARL[j] * imBRight[j]) + (reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j]) + src1Im[j];
 				realR = (reALR[j] * reBLeft[j] - imALR[j] * imBLeft[j]) + (reARR[j] * reBRight[j] - imARR[j] * imBRight[j]) + src2Re[j];
 				imagR = (imALR[j] * reBLeft[j] + reALR[j] * imBLeft[j]) + (reARR[j] * imBRight[j] + imARR[j] * reBRight[j]) + src2Im[j];
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[j]] = (realL + imagL) * 0.5f;
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[symIdx]] = (realL - imagL) * 0.5f;
-				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.bit[j]] = (realR + imagR) * 0.5f;
-				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.bit[symIdx]] = (realR - imagR) * 0.5f;
+				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.slot[j << 1]] = (realL + imagL) * 0.5f;
+				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.slot[(j << 1) + 1]] = (realL - imagL) * 0.5f;
+				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.slot[j << 1]] = (realR + imagR) * 0.5f;
+				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.slot[(j << 1) + 1]] = (realR - imagR) * 0.5f;
 			}
 			// Backward FFT
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[0], conv->_headConvolver.sine);
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[1], conv->_headConvolver.sine);
+			FHTPlanInverse(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[0]);
+			FHTPlanInverse(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[1]);
 
 			// Add overlap
 			float *result1 = y1 + processed;
@@ -1466,7 +1457,7 @@ void TwoStageFFTConvolver2x2Process(TwoStageFFTConvolver2x2 *conv, const float*
 {
 	if (conv->_tailInput[0])
 	{
-		unsigned int i, j, symIdx, processed = 0;
+		unsigned int i, j, processed = 0;
 		while (processed < len)
 		{
 			const unsigned int remaining = len - processed;
@@ -1481,28 +1472,8 @@ void TwoStageFFTConvolver2x2Process(TwoStageFFTConvolver2x2 *conv, const float*
 			conv->_tailInputFill += processing;
 
 			// Forward FFT
-			for (j = 0; j < conv->_headConvolver._blockSize; j++)
-			{
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[j]] = conv->_headConvolver._inputBuffer[0][j];
-				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.bit[j]] = conv->_headConvolver._inputBuffer[1][j];
-			}
-			for (j = conv->_headConvolver._blockSize; j < conv->_headConvolver._segSize; j++)
-			{
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[j]] = 0.0f;
-				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.bit[j]] = 0.0f;
-			}
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[0], conv->_headConvolver.sine);
-			conv->_headConvolver._segmentsReLeft[conv->_headConvolver._current][0] = conv->_headConvolver._fftBuffer[0][0];
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[1], conv->_headConvolver.sine);
-			conv->_headConvolver._segmentsReRight[conv->_headConvolver._current][0] = conv->_headConvolver._fftBuffer[1][0];
-			for (j = 1; j < conv->_headConvolver._fftComplexSize; j++)
-			{
-				symIdx = conv->_headConvolver._segSize - j;
-				conv->_headConvolver._segmentsReLeft[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[0][j] + conv->_headConvolver._fftBuffer[0][symIdx];
-				conv->_headConvolver._segmentsImLeft[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[0][j] - conv->_headConvolver._fftBuffer[0][symIdx];
-				conv->_headConvolver._segmentsReRight[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[1][j] + conv->_headConvolver._fftBuffer[1][symIdx];
-				conv->_headConvolver._segmentsImRight[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[1][j] - conv->_headConvolver._fftBuffer[1][symIdx];
-			}
+			fhtPartitionSpectrum(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[0], conv->_headConvolver._inputBuffer[0], conv->_headConvolver._blockSize, conv->_headConvolver._segmentsReLeft[conv->_headConvolver._current], conv->_headConvolver._segmentsImLeft[conv->_headConvolver._current]);
+			fhtPartitionSpectrum(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[1], conv->_headConvolver._inputBuffer[1], conv->_headConvolver._blockSize, conv->_headConvolver._segmentsReRight[conv->_headConvolver._current], conv->_headConvolver._segmentsImRight[conv->_headConvolver._current]);
 
 			// Complex multiplication
 			const float *reALL, *imALL, *reARR, *imARR;
@@ -1510,7 +1481,7 @@ void TwoStageFFTConvolver2x2Process(TwoStageFFTConvolver2x2 *conv, const float*
 			const float *imBLeft;
 			const float *reBRight;
 			const float *imBRight;
-			unsigned int end4 = conv->_headConvolver._fftComplexSize - 1;
+			unsigned int end4 = (conv->_headConvolver._fftComplexSize - 1) & ~3u;
 			if (inputBufferWasEmpty)
 			{
 				unsigned int segFrameIndex = (conv->_headConvolver._current + 1) % conv->_headConvolver._segCount;
@@ -1547,10 +1518,13 @@ void TwoStageFFTConvolver2x2Process(TwoStageFFTConvolver2x2 *conv, const float*
 						imRight[j + 2] = reARR[j + 2] * imBRight[j + 2] + imARR[j + 2] * reBRight[j + 2];
 						imRight[j + 3] = reARR[j + 3] * imBRight[j + 3] + imARR[j + 3] * reBRight[j + 3];
 					}
-					reLeft[end4] = reALL[end4] * reBLeft[end4] - imALL[end4] * imBLeft[end4];
-					imLeft[end4] = reALL[end4] * imBLeft[end4] + imALL[end4] * reBLeft[end4];
-					reRight[end4] = reARR[end4] * reBRight[end4] - imARR[end4] * imBRight[end4];
-					imRight[end4] = reARR[end4] * imBRight[end4] + imARR[end4] * reBRight[end4];
+					for (j = end4; j < conv->_headConvolver._fftComplexSize; j++)
+					{
+						reLeft[j] = reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j];
+						imLeft[j] = reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j];
+						reRight[j] = reARR[j] * reBRight[j] - imARR[j] * imBRight[j];
+						imRight[j] = reARR[j] * imBRight[j] + imARR[j] * reBRight[j];
+					}
 					for (unsigned int i = 2; i < conv->_headConvolver._segCount; ++i)
 					{
 						segFrameIndex = (conv->_headConvolver._current + i) % conv->_headConvolver._segCount;
@@ -1585,10 +1559,13 @@ void TwoStageFFTConvolver2x2Process(TwoStageFFTConvolver2x2 *conv, const float*
 							imRight[j + 2] += reARR[j + 2] * imBRight[j + 2] + imARR[j + 2] * reBRight[j + 2];
 							imRight[j + 3] += reARR[j + 3] * imBRight[j + 3] + imARR[j + 3] * reBRight[j + 3];
 						}
-						reLeft[end4] += reALL[end4] * reBLeft[end4] - imALL[end4] * imBLeft[end4];
-						imLeft[end4] += reALL[end4] * imBLeft[end4] + imALL[end4] * reBLeft[end4];
-						reRight[end4] += reARR[end4] * reBRight[end4] - imARR[end4] * imBRight[end4];
-						imRight[end4] += reARR[end4] * imBRight[end4] + imARR[end4] * reBRight[end4];
+						for (j = end4; j < conv->_headConvolver._fftComplexSize; j++)
+						{
+							reLeft[j] += reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j];
+							imLeft[j] += reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j];
+							reRight[j] += reARR[j] * reBRight[j] - imARR[j] * imBRight[j];
+							imRight[j] += reARR[j] * imBRight[j] + imARR[j] * reBRight[j];
+						}
 					}
 				}
 			}
@@ -1609,19 +1586,18 @@ void TwoStageFFTConvolver2x2Process(TwoStageFFTConvolver2x2 *conv, const float*
 			conv->_headConvolver._fftBuffer[1][0] = (reARR[0] * reBRight[0]) + src2Re[0];
 			for (j = 1; j < conv->_headConvolver._fftComplexSize; ++j)
 			{
-				symIdx = conv->_headConvolver._segSize - j;
 				realL = (reALL[j] * reBLeft[j] - imALL[j] * imBLeft[j]) + src1Re[j];
 				imagL = (reALL[j] * imBLeft[j] + imALL[j] * reBLeft[j]) + src1Im[j];
 				realR = (reARR[j] * reBRight[j] - imARR[j] * imBRight[j]) + src2Re[j];
 				imagR = (reARR[j] * imBRight[j] + imARR[j] * reBRight[j]) + src2Im[j];
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[j]] = (realL + imagL) * 0.5f;
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[symIdx]] = (realL - imagL) * 0.5f;
-				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.bit[j]] = (realR + imagR) * 0.5f;
-				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.bit[symIdx]] = (realR - imagR) * 0.5f;
+				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.slot[j << 1]] = (realL + imagL) * 0.5f;
+				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.slot[(j << 1) + 1]] = (realL - imagL) * 0.5f;
+				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.slot[j << 1]] = (realR + imagR) * 0.5f;
+				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.slot[(j << 1) + 1]] = (realR - imagR) * 0.5f;
 			}
 			// Backward FFT
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[0], conv->_headConvolver.sine);
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[1], conv->_headConvolver.sine);
+			FHTPlanInverse(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[0]);
+			FHTPlanInverse(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[1]);
 
 			// Add overlap
 			float *result1 = y1 + processed;
@@ -1752,7 +1728,7 @@ void TwoStageFFTConvolver1x2Process(TwoStageFFTConvolver1x2 *conv, const float*
 {
 	if (conv->_tailInput)
 	{
-		unsigned int i, j, symIdx, processed = 0;
+		unsigned int i, j, processed = 0;
 		while (processed < len)
 		{
 			const unsigned int remaining = len - processed;
@@ -1765,24 +1741,13 @@ void TwoStageFFTConvolver1x2Process(TwoStageFFTConvolver1x2 *conv, const float*
 			conv->_tailInputFill += processing;
 
 			// Forward FFT
-			for (j = 0; j < conv->_headConvolver._blockSize; j++)
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[j]] = conv->_headConvolver._inputBuffer[j];
-			for (j = conv->_headConvolver._blockSize; j < conv->_headConvolver._segSize; j++)
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[j]] = 0.0f;
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[0], conv->_headConvolver.sine);
-			conv->_headConvolver._segmentsRe[conv->_headConvolver._current][0] = conv->_headConvolver._fftBuffer[0][0];
-			for (j = 1; j < conv->_headConvolver._fftComplexSize; j++)
-			{
-				symIdx = conv->_headConvolver._segSize - j;
-				conv->_headConvolver._segmentsRe[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[0][j] + conv->_headConvolver._fftBuffer[0][symIdx];
-				conv->_headConvolver._segmentsIm[conv->_headConvolver._current][j] = conv->_headConvolver._fftBuffer[0][j] - conv->_headConvolver._fftBuffer[0][symIdx];
-			}
+			fhtPartitionSpectrum(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[0], conv->_headConvolver._inputBuffer, conv->_headConvolver._blockSize, conv->_headConvolver._segmentsRe[conv->_headConvolver._current], conv->_headConvolver._segmentsIm[conv->_headConvolver._current]);
 
 			// Complex multiplication
 			const float *reALL, *imALL, *reARR, *imARR;
 			const float *reB;
 			const float *imB;
-			unsigned int end4 = conv->_headConvolver._fftComplexSize - 1;
+			unsigned int end4 = (conv->_headConvolver._fftComplexSize - 1) & ~3u;
 			if (inputBufferWasEmpty)
 			{
 				unsigned int segFrameIndex = (conv->_headConvolver._current + 1) % conv->_headConvolver._segCount;
@@ -1817,10 +1782,13 @@ void TwoStageFFTConvolver1x2Process(TwoStageFFTConvolver1x2 *conv, const float*
 						imRight[j + 2] = reARR[j + 2] * imB[j + 2] + imARR[j + 2] * reB[j + 2];
 						imRight[j + 3] = reARR[j + 3] * imB[j + 3] + imARR[j + 3] * reB[j + 3];
 					}
-					reLeft[end4] = reALL[end4] * reB[end4] - imALL[end4] * imB[end4];
-					imLeft[end4] = reALL[end4] * imB[end4] + imALL[end4] * reB[end4];
-					reRight[end4] = reARR[end4] * reB[end4] - imARR[end4] * imB[end4];
-					imRight[end4] = reARR[end4] * imB[end4] + imARR[end4] * reB[end4];
+					for (j = end4; j < conv->_headConvolver._fftComplexSize; j++)
+					{
+						reLeft[j] = reALL[j] * reB[j] - imALL[j] * imB[j];
+						imLeft[j] = reALL[j] * imB[j] + imALL[j] * reB[j];
+						reRight[j] = reARR[j] * reB[j] - imARR[j] * imB[j];
+						imRight[j] = reARR[j] * imB[j] + imARR[j] * reB[j];
+					}
 					for (unsigned int i = 2; i < conv->_headConvolver._segCount; ++i)
 					{
 						segFrameIndex = (conv->_headConvolver._current + i) % conv->_headConvolver._segCount;
@@ -1853,10 +1821,13 @@ void TwoStageFFTConvolver1x2Process(TwoStageFFTConvolver1x2 *conv, const float*
 							imRight[j + 2] += reARR[j + 2] * imB[j + 2] + imARR[j + 2] * reB[j + 2];
 							imRight[j + 3] += reARR[j + 3] * imB[j + 3] + imARR[j + 3] * reB[j + 3];
 						}
-						reLeft[end4] += reALL[end4] * reB[end4] - imALL[end4] * imB[end4];
-						imLeft[end4] += reALL[end4] * imB[end4] + imALL[end4] * reB[end4];
-						reRight[end4] += reARR[end4] * reB[end4] - imARR[end4] * imB[end4];
-						imRight[end4] += reARR[end4] * imB[end4] + imARR[end4] * reB[end4];
+						for (j = end4; j < conv->_headConvolver._fftComplexSize; j++)
+						{
+							reLeft[j] += reALL[j] * reB[j] - imALL[j] * imB[j];
+							imLeft[j] += reALL[j] * imB[j] + imALL[j] * reB[j];
+							reRight[j] += reARR[j] * reB[j] - imARR[j] * imB[j];
+							imRight[j] += reARR[j] * imB[j] + imARR[j] * reB[j];
+						}
 					}
 				}
 			}
@@ -1875,19 +1846,18 @@ void TwoStageFFTConvolver1x2Process(TwoStageFFTConvolver1x2 *conv, const float*
 			conv->_headConvolver._fftBuffer[1][0] = (reARR[0] * reB[0]) + src2Re[0];
 			for (j = 1; j < conv->_headConvolver._fftComplexSize; ++j)
 			{
-				symIdx = conv->_headConvolver._segSize - j;
 				realL = (reALL[j] * reB[j] - imALL[j] * imB[j]) + src1Re[j];
 				imagL = (reALL[j] * imB[j] + imALL[j] * reB[j]) + src1Im[j];
 				realR = (reARR[j] * reB[j] - imARR[j] * imB[j]) + src2Re[j];
 				imagR = (reARR[j] * imB[j] + imARR[j] * reB[j]) + src2Im[j];
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[j]] = (realL + imagL) * 0.5f;
-				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.bit[symIdx]] = (realL - imagL) * 0.5f;
-				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.bit[j]] = (realR + imagR) * 0.5f;
-				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.bit[symIdx]] = (realR - imagR) * 0.5f;
+				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.slot[j << 1]] = (realL + imagL) * 0.5f;
+				conv->_headConvolver._fftBuffer[0][conv->_headConvolver.slot[(j << 1) + 1]] = (realL - imagL) * 0.5f;
+				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.slot[j << 1]] = (realR + imagR) * 0.5f;
+				conv->_headConvolver._fftBuffer[1][conv->_headConvolver.slot[(j << 1) + 1]] = (realR - imagR) * 0.5f;
 			}
 			// Backward FFT
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[0], conv->_headConvolver.sine);
-			conv->_headConvolver.fft(conv->_headConvolver._fftBuffer[1], conv->_headConvolver.sine);
+			FHTPlanInverse(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[0]);
+			FHTPlanInverse(conv->_headConvolver.plan, conv->_headConvolver._fftBuffer[1]);
 
 			// Add overlap
 			float *result1 = y1 + processed;
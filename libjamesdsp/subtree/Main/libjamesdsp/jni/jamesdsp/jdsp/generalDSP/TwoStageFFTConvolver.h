@@ -61,6 +61,8 @@ typedef struct
 	float *_tailOutput[2];
 	unsigned int _tailBlockSize;
 } pt_info1x2;
+// Worker loop running the 2x2 tail convolver, HybridFIRConvolver2x2 shares it
+extern void *task_type22x2(void *arg);
 #endif
 typedef struct
 {
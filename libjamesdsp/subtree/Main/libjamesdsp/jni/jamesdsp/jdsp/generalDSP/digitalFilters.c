@@ -111,6 +111,114 @@ double iirSOSProcessorProcessBiquadSampleBySampleInterpolation(iirSOS *state, co
 	state->_xn1 = 0.0;
 	return yn[M1STAGE];
 }
+// Stereo block version, x holding n interleaved L/R samples which are replaced by the output. Runs one stage at
+// a time over the whole block, the two channels side by side
+#define SOS_CHANNEL_STEP(c) \
+	{ \
+		double in = x[t + c]; \
+		double y = in + 2.0 * in1[c] + in2[c] + a1 * y1[c] + a2 * y2[c]; \
+		in2[c] = in1[c]; \
+		in1[c] = in; \
+		y2[c] = y1[c]; \
+		y1[c] = y; \
+		x[t + c] = y; \
+	}
+void iirSOSProcessorProcessBiquadStereo(iirSOS *state1, iirSOS *state2, const LPFCoeffs *coeffs, double *x, size_t n)
+{
+	iirSOS *state[2] = { state1, state2 };
+	// Input history of a stage is the output history the stage before had before this block
+	double xn1[2] = { state1->_xn1, state2->_xn1 }, xn2[2] = { state1->_xn2, state2->_xn2 };
+	for (int i = 0; i < STAGE; i++)
+	{
+		double a1 = coeffs[i].a1, a2 = coeffs[i].a2;
+		double in1[2] = { xn1[0], xn1[1] }, in2[2] = { xn2[0], xn2[1] };
+		double y1[2] = { state1->_yn1[i], state2->_yn1[i] }, y2[2] = { state1->_yn2[i], state2->_yn2[i] };
+		for (int c = 0; c < 2; c++)
+		{
+			xn1[c] = y1[c];
+			xn2[c] = y2[c];
+		}
+		for (size_t t = 0; t < 2 * n; t += 2)
+		{
+			SOS_CHANNEL_STEP(0)
+			SOS_CHANNEL_STEP(1)
+		}
+		for (int c = 0; c < 2; c++)
+		{
+			if (!i)
+			{
+				state[c]->_xn1 = in1[c];
+				state[c]->_xn2 = in2[c];
+			}
+			state[c]->_yn[i] = y1[c];
+			state[c]->_yn1[i] = y1[c];
+			state[c]->_yn2[i] = y2[c];
+		}
+	}
+}
+// Block version, x holding n samples which are replaced by the output. Four neighbouring stages run together,
+// stage g lagging g samples behind the first, so that their recursions overlap
+#define SOS_SKEWED_STEP(g, k) \
+	{ \
+		double in = x[k]; \
+		double y = in + 2.0 * in1[g] + in2[g] + a1[g] * y1[g] + a2[g] * y2[g]; \
+		in2[g] = in1[g]; \
+		in1[g] = in; \
+		y2[g] = y1[g]; \
+		y1[g] = y; \
+		x[k] = y; \
+	}
+void iirSOSProcessorProcessBiquadBlock(iirSOS *state, const LPFCoeffs *coeffs, double *x, size_t n)
+{
+	double xn1 = state->_xn1, xn2 = state->_xn2;
+	for (int i0 = 0; i0 < STAGE; i0 += 4)
+	{
+		double a1[4], a2[4], in1[4], in2[4], y1[4], y2[4];
+		for (int g = 0; g < 4; g++)
+		{
+			a1[g] = coeffs[i0 + g].a1;
+			a2[g] = coeffs[i0 + g].a2;
+			in1[g] = g ? state->_yn1[i0 + g - 1] : xn1;
+			in2[g] = g ? state->_yn2[i0 + g - 1] : xn2;
+			y1[g] = state->_yn1[i0 + g];
+			y2[g] = state->_yn2[i0 + g];
+		}
+		xn1 = y1[3];
+		xn2 = y2[3];
+		for (size_t t = 0; t < n + 3; t++)
+		{
+			if (t >= 3 && t < n)
+			{
+				SOS_SKEWED_STEP(0, t)
+				SOS_SKEWED_STEP(1, t - 1)
+				SOS_SKEWED_STEP(2, t - 2)
+				SOS_SKEWED_STEP(3, t - 3)
+			}
+			else
+			{
+				if (t < n)
+					SOS_SKEWED_STEP(0, t)
+				if (t >= 1 && t - 1 < n)
+					SOS_SKEWED_STEP(1, t - 1)
+				if (t >= 2 && t - 2 < n)
+					SOS_SKEWED_STEP(2, t - 2)
+				if (t >= 3 && t - 3 < n)
+					SOS_SKEWED_STEP(3, t - 3)
+			}
+		}
+		if (!i0)
+		{
+			state->_xn1 = in1[0];
+			state->_xn2 = in2[0];
+		}
+		for (int g = 0; g < 4; g++)
+		{
+			state->_yn[i0 + g] = y1[g];
+			state->_yn1[i0 + g] = y1[g];
+			state->_yn2[i0 + g] = y2[g];
+		}
+	}
+}
 typedef struct
 {
 	double re, im;
@@ -225,3 +333,36 @@ float oversample_stepdownSmpFloat(samplerateTool *oversample, float *input)
 		out = iirSOSProcessorProcessBiquadSampleBySample(&oversample->lpfD, &input[i], oversample->coeffs) * oversample->gain;
 	return (float)out;
 }
+// Decimator fed one sample at a time, the value returned on every factor-th call is the decimated sample
+float oversample_pushdownSmpFloat(samplerateTool *oversample, float input)
+{
+	return (float)(iirSOSProcessorProcessBiquadSampleBySample(&oversample->lpfD, &input, oversample->coeffs) * oversample->gain);
+}
+// Stereo block versions, y holding n * factor interleaved L/R samples
+void oversample_stepupSmpStereo(samplerateTool *oversample1, samplerateTool *oversample2, const float *x1, const float *x2, double *y, size_t n)
+{
+	int factor = oversample1->factor;
+	for (size_t i = 0; i < n; i++)
+	{
+		double *frame = y + 2 * i * factor;
+		frame[0] = (double)(x1[i] * factor);
+		frame[1] = (double)(x2[i] * factor);
+		for (int j = 2; j < 2 * factor; j++)
+			frame[j] = 0.0;
+	}
+	iirSOSProcessorProcessBiquadStereo(&oversample1->lpfU, &oversample2->lpfU, oversample1->coeffs, y, n * factor);
+	for (size_t i = 0; i < 2 * n * factor; i++)
+		y[i] = (double)((float)y[i] * oversample1->gain);
+}
+// x is overwritten
+void oversample_stepdownSmpStereo(samplerateTool *oversample1, samplerateTool *oversample2, double *x, float *y1, float *y2, size_t n)
+{
+	int factor = oversample1->factor;
+	iirSOSProcessorProcessBiquadStereo(&oversample1->lpfD, &oversample2->lpfD, oversample1->coeffs, x, n * factor);
+	for (size_t i = 0; i < n; i++)
+	{
+		const double *last = x + 2 * ((i + 1) * factor - 1);
+		y1[i] = (float)(last[0] * oversample1->gain);
+		y2[i] = (float)(last[1] * oversample1->gain);
+	}
+}
@@ -1,7 +1,7 @@
 #ifndef M_PI
 #define M_PI 3.14159265358979323846264338327950288
 #endif
-#define ORDER 16 // Must be even
+#define ORDER 16 // Must be a multiple of 8, the block filter runs the stages in groups of four
 #define ORDERPLUS1 (ORDER + 1)
 #define ORDERMULT2 (ORDER << 1)
 #define STAGE (ORDER >> 1)
@@ -37,3 +37,8 @@ void oversample_makeSmp(samplerateTool *oversample, int factor);
 void oversample_stepupSmp(samplerateTool *oversample, float input, float *output);
 double oversample_stepdownSmpDouble(samplerateTool *oversample, double *input);
 float oversample_stepdownSmpFloat(samplerateTool *oversample, float *input);
+float oversample_pushdownSmpFloat(samplerateTool *oversample, float input);
+void iirSOSProcessorProcessBiquadBlock(iirSOS *state, const LPFCoeffs *coeffs, double *x, size_t n);
+void iirSOSProcessorProcessBiquadStereo(iirSOS *state1, iirSOS *state2, const LPFCoeffs *coeffs, double *x, size_t n);
+void oversample_stepupSmpStereo(samplerateTool *oversample1, samplerateTool *oversample2, const float *x1, const float *x2, double *y, size_t n);
+void oversample_stepdownSmpStereo(samplerateTool *oversample1, samplerateTool *oversample2, double *x, float *y1, float *y2, size_t n);
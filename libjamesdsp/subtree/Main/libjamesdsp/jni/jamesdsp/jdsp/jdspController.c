@@ -570,10 +570,11 @@ void JamesDSPInit(JamesDSPLib *jdsp, int n, float sample_rate)
 	jdsp->postGain = 1.0f;
 	// Init effect
 	LiveProgConstructor(jdsp);
-	CompressorReset(jdsp);
+	CompressorConstructor(jdsp);
 	CompressorDisable(jdsp);
 	BassBoostConstructor(jdsp);
 	BassBoostDisable(jdsp);
+	ReverbConstructor(jdsp);
 	ReverbDisable(jdsp);
 	StereoEnhancementDisable(jdsp);
 	VacuumTubeDisable(jdsp);
@@ -667,9 +668,25 @@ void JamesDSPSetSampleRate(JamesDSPLib *jdsp, float new_sample_rate, int forceRe
 		jdsp->equalizerForceRefresh = 1;
 	}
 }
+unsigned int JamesDSPGetLatency(JamesDSPLib *jdsp)
+{
+	unsigned int latency = 0;
+	if (jdsp->compEnabled)
+		latency += CompressorGetLatency(jdsp);
+	if (jdsp->bassBoostEnabled)
+		latency += BassBoostGetLatency(jdsp);
+	return (unsigned int)((double)latency * jdsp->trueSampleRate / jdsp->fs + 0.5);
+}
+void JamesDSPReclaim(JamesDSPLib *jdsp)
+{
+	CrossfeedReclaim(jdsp);
+	LiveProgReclaim(jdsp);
+}
 void JamesDSPFree(JamesDSPLib *jdsp)
 {
 	StereoEnhancementDestructor(jdsp);
+	CompressorDestructor(jdsp);
+	ReverbDestructor(jdsp);
 	LiveProgDestructor(jdsp);
 	DDCDestructor(jdsp);
 	CrossfeedDestructor(jdsp);
@@ -5,6 +5,7 @@
 #include "generalDSP/interpolation.h"
 #include "Effects/eel2/numericSys/libsamplerate/samplerate.h"
 #include "generalDSP/TwoStageFFTConvolver.h"
+#include "generalDSP/HybridFIRConvolver.h"
 #include "generalDSP/digitalFilters.h"
 #include "Effects/eel2/numericSys/FilterDesign/fdesign.h"
 #include "Effects/eel2/eelCommon.h"
@@ -64,20 +65,25 @@ typedef struct
 #define ANALYSIS_OVERLAP_DRS 4
 #define OVPSIZE_DRS (FFTSIZE_DRS / ANALYSIS_OVERLAP_DRS)
 #define HALFWNDLEN_DRS ((FFTSIZE_DRS >> 1) + 1)
-#define MAX_OUTPUT_BUFFERS_DRS 2
+#define MAX_OUTPUT_BUFFERS_DRS 4
+// Steps of one analysis/synthesis frame, see FFTDynamicRangeSquasherProcessSamples
+#define FRAME_STAGES_DRS 7
 typedef struct
 {
 	// Constant
 	unsigned int fftLen, minus_fftLen, ovpLen, halfLen, smpShift, procUpTo;
 	void(*fft)(float*, const float*);
-	unsigned int mBitRev[FFTSIZE_DRS];
-	float 	mSineTab[FFTSIZE_DRS >> 1];
+	const FHTPlan *plan;
+	unsigned int *mBitRev;
+	float 	*mSineTab;
 	float analysisWnd[FFTSIZE_DRS];
 	float synthesisWnd[FFTSIZE_DRS];
 	// Shared variable between all FFT length and modes and channel config
 	int  mOutputReadSampleOffset;
 	int  mOutputBufferCount; // How many buffers are actually in use
 	unsigned int mInputSamplesNeeded;
+	unsigned int amortise; // Frames finish over the following hop instead of at once, one hop more latency
+	unsigned int frameStage; // Next stage of the pending frame, FRAME_STAGES_DRS when there is none
 	float 	*mOutputBuffer[MAX_OUTPUT_BUFFERS_DRS];
 	float buffer[MAX_OUTPUT_BUFFERS_DRS][OVPSIZE_DRS * 2];
 	unsigned int mInputPos;
@@ -93,21 +99,39 @@ typedef struct
 	char octaveSmooth[sizeof(unsigned int) + sizeof(float) + sizeof(unsigned int) + ((HALFWNDLEN_DRS + 1) << 1) * sizeof(unsigned int) + (HALFWNDLEN_DRS + 1) * sizeof(float) + ((HALFWNDLEN_DRS + 1) + 3) * 2 * sizeof(float)];
 	float finalGain[HALFWNDLEN_DRS];
 	// Global parameter
-	float fgt_fac, spectralRate, metaMaxAttackTime, metaMaxReleaseTime;
+	float fgt_fac, spectralRate, metaMaxAttackTime, metaMaxReleaseTime, attackCoeff, releaseCoeff;
 	// Subband parameter
 	float metaAdaptCoeff[HALFWNDLEN_DRS];
+	float bandWeight[HALFWNDLEN_DRS]; // Share of each bin this instance outputs, see FFTDynamicRangeSquasherSetBand
 	// Subband states
 	float adaptiveRelease[HALFWNDLEN_DRS], adaptiveAttack[HALFWNDLEN_DRS], smoothLogGain[HALFWNDLEN_DRS], logThreshold[HALFWNDLEN_DRS];
 } FFTDynamicRangeSquasher;
 void FFTDynamicRangeSquasherSetavgBW(FFTDynamicRangeSquasher *cm, double avgBW);
-void FFTDynamicRangeSquasherInit(FFTDynamicRangeSquasher *msr, float fs);
+// fftLen 0 picks the frame length from the sample rate, output trails input by exactly 2 * ovpLen samples, 3 * ovpLen when amortised
+void FFTDynamicRangeSquasherInit(FFTDynamicRangeSquasher *msr, float fs, unsigned int fftLen, int amortise);
+unsigned int FFTDynamicRangeSquasherGetLatency(FFTDynamicRangeSquasher *msr);
+// Restricts the output to the bins above (upper) or below the crossover, the two sides sum to unity
+void FFTDynamicRangeSquasherSetBand(FFTDynamicRangeSquasher *msr, float fs, float crossover, int upper);
 int FFTDynamicRangeSquasherProcessSamples(FFTDynamicRangeSquasher *msr, const float *inLeft, const float *inRight, unsigned int inSampleCount, float *outL, float *outR);
+// Multi resolution compressor, short frames above the crossover
+#define COMP_MULTIRES_CROSSOVER 1000.0f
+typedef struct
+{
+	FFTDynamicRangeSquasher comp;
+	float out[2][OVPSIZE_DRS];
+	float delay[2][OVPSIZE_DRS * 3]; // Aligns the short frames with the latency of the long ones
+	unsigned int delayLen, delayPos;
+} CompressorHighBand;
+// Input samples per pass of the vacuum tube, oversampled by up to VT_MAXFACTOR
+#define VT_BLOCK 32
+#define VT_MAXFACTOR 5
 typedef struct
 {
 	int needOversample;
 	samplerateTool smp[2];
 	SixBandsCrossover subband[2];
 	float pregain, postgain;
+	double band[6][VT_BLOCK * VT_MAXFACTOR * 2]; // Crossover outputs, interleaved L/R
 } VacuumTube;
 typedef struct
 {
@@ -125,13 +149,16 @@ typedef struct
 	float precomputeCoeff1, precomputeCoeff2, precomputeCoeff3, precomputeCoeff4;
 	float z1_A, z2_A; // state variables (z^-1)
 } StateVariable2ndOrder;
+// Input samples per pass of the bass boost's decimation filter
+#define DBB_BLOCK 128
 typedef struct
 {
 	float maxGain;
-	float originalBuf[960];
 	int downsamplerPos;
 	samplerateTool downsampler;
-	float delayLine[16];
+	double decimationBuf[DBB_BLOCK];
+	float delayLine[16]; // Circular, newest decimated sample at delayLinePos
+	unsigned int delayLinePos;
 	float fftBuf[16];
 	float smoothFFTBuffer[9];
 	float freq[9];
@@ -143,18 +170,29 @@ typedef struct
 	StateVariable2ndOrder svf[2];
 	integerDelayLine dL[2];
 } DBB;
-//   sf_reverb_state_st rv;
+//   sf_reverb_state_st rv; // zero initialised
 //   sf_presetreverb(&rv, 44100, SF_REVERB_PRESET_DEFAULT);
 //
-//   for each abitrary length sample:
-//   float outputL, outputR;
-//   sf_reverb_process(&rv, inputL, inputR, &outputL, &outputR);
+//   for each abitrary length block:
+//   sf_reverb_process(&rv, inputL, inputR, outputL, outputR, n);
+//   ...
+//   sf_reverb_free(&rv);
+//
+// Every stage runs on both channels at once, L and R being the two lanes of each element. Delay lines
+// live in one arena sized to the configured room and are interleaved L/R, all of them advancing with a
+// single write index.
+// Longest run of oversampled samples a stage processes before handing over to the next one
+#define SF_REVERB_CHUNK     128
+typedef struct
+{
+	float *buf;        // interleaved L/R pairs
+	unsigned int mask; // capacity in pairs minus 1, covers the longest lag plus one chunk
+} sf_rv_ring_st;
 #define SF_REVERB_DS        3000
 typedef struct
 {
-	int pos;                 // current write position
-	int size;                // delay size
-	float buf[SF_REVERB_DS]; // delay buffer
+	sf_rv_ring_st ring;
+	int size[2];       // delay size
 } sf_rv_delay_st;
 // 1st order IIR filter
 typedef struct
@@ -162,11 +200,9 @@ typedef struct
 	float a2; // coefficients
 	float b1;
 	float b2;
-	float y1; // state
+	float y1[2]; // state
 } sf_rv_iir1_st;
 // biquad
-// note: we don't use biquad.c because we want to step through the sound one sample at a time, one
-//       channel at a time
 typedef struct
 {
 	float b0; // biquad coefficients
@@ -174,22 +210,23 @@ typedef struct
 	float b2;
 	float a1;
 	float a2;
-	float xn1; // input[n - 1]
-	float xn2; // input[n - 2]
-	float yn1; // output[n - 1]
-	float yn2; // output[n - 2]
+	float xn1[2]; // input[n - 1]
+	float xn2[2]; // input[n - 2]
+	float yn1[2]; // output[n - 1]
+	float yn2[2]; // output[n - 2]
 } sf_rv_biquad_st;
 // early reflection
 typedef struct
 {
-	int             delaytblL[18], delaytblR[18];
-	sf_rv_delay_st  delayPWL, delayPWR;
-	sf_rv_delay_st  delayRL, delayLR;
-	sf_rv_biquad_st allpassXL, allpassXR;
-	sf_rv_biquad_st allpassL, allpassR;
-	sf_rv_iir1_st   lpfL, lpfR;
-	sf_rv_iir1_st   hpfL, hpfR;
+	int             delaytbl[2][18];
+	sf_rv_delay_st  delayPW;
+	sf_rv_delay_st  delayX; // R into L on the left lane, L into R on the right one
+	sf_rv_biquad_st allpassX;
+	sf_rv_biquad_st allpass;
+	sf_rv_iir1_st   lpf;
+	sf_rv_iir1_st   hpf;
 	float wet1, wet2;
+	unsigned int pos; // write index of the delay lines above
 } sf_rv_earlyref_st;
 // oversampling
 // maximum oversampling factor
@@ -198,14 +235,13 @@ typedef struct
 {
 	int factor;           // oversampling factor [1 to SF_REVERB_OF]
 	sf_rv_biquad_st lpfU; // lowpass filter used for upsampling
-	sf_rv_biquad_st lpfD; // lowpass filter used for downsampling
 } sf_rv_oversample_st;
 // dc cut
 typedef struct
 {
 	float gain;
-	float y1;
-	float y2;
+	float y1[2];
+	float y2[2];
 } sf_rv_dccut_st;
 // fractal noise cache
 // noise buffer size; must be a power of 2 because it's generated via fractal generator
@@ -229,11 +265,10 @@ typedef struct
 #define SF_REVERB_APS       3400
 typedef struct
 {
-	int pos;
-	int size;
+	sf_rv_ring_st ring;
+	int size[2];
 	float feedback;
 	float decay;
-	float buf[SF_REVERB_APS];
 } sf_rv_allpass_st;
 // 2nd order all-pass filter
 // maximum sizes of the two buffers
@@ -241,12 +276,11 @@ typedef struct
 #define SF_REVERB_AP2S2     3000
 typedef struct
 {
-	//    line 1                 line 2
-	int   pos1, pos2;
-	int   size1, size2;
-	float feedback1, feedback2;
-	float decay1, decay2;
-	float buf1[SF_REVERB_AP2S1], buf2[SF_REVERB_AP2S2];
+	//            line 1        line 2
+	sf_rv_ring_st ring1,        ring2;
+	int           size1[2],     size2[2];
+	float         feedback1,    feedback2;
+	float         decay1,       decay2;
 } sf_rv_allpass2_st;
 // 3rd order all-pass filter with modulation
 // maximum sizes of the three buffers and maximum mod size of the first line
@@ -256,12 +290,11 @@ typedef struct
 #define SF_REVERB_AP3S3     3000
 typedef struct
 {
-	//    line 1 (with modulation)                 line 2                 line 3
-	int   rpos1, wpos1, pos2, pos3;
-	int   size1, msize1, size2, size3;
-	float feedback1, feedback2, feedback3;
-	float decay1, decay2, decay3;
-	float buf1[SF_REVERB_AP3S1 + SF_REVERB_AP3M1], buf2[SF_REVERB_AP3S2], buf3[SF_REVERB_AP3S3];
+	//            line 1 (with modulation)     line 2        line 3
+	sf_rv_ring_st ring1,                       ring2,        ring3;
+	int           size1[2], msize1[2],         size2[2],     size3[2];
+	float         feedback1,                   feedback2,    feedback3;
+	float         decay1,                      decay2,       decay3;
 } sf_rv_allpass3_st;
 // modulated all-pass filter
 // maximum size and maximum mod size
@@ -269,55 +302,63 @@ typedef struct
 #define SF_REVERB_APMM      137
 typedef struct
 {
-	int rpos, wpos;
-	int size, msize;
+	sf_rv_ring_st ring;
+	int size[2], msize[2];
 	float feedback;
 	float decay;
-	float z1;
-	float buf[SF_REVERB_APMS + SF_REVERB_APMM];
+	float z1[2];
 } sf_rv_allpassm_st;
 // comb filter
 // maximum size of the buffer
 #define SF_REVERB_CS        1500
 typedef struct
 {
-	int pos;
-	int size;
-	float buf[SF_REVERB_CS];
+	sf_rv_ring_st ring;
+	int size[2];
 } sf_rv_comb_st;
+// output tap, read back from one lane of a line once the whole chunk is written
+typedef struct
+{
+	const float *buf;
+	unsigned int mask;
+	int lane;
+	int back; // 1 is the last written sample
+} sf_rv_tap_st;
 //
 // the final reverb state structure
 //
-// note: this struct is about 1Mb
 typedef struct
 {
 	sf_rv_earlyref_st   earlyref;
-	sf_rv_oversample_st oversampleL, oversampleR;
-	sf_rv_dccut_st      dccutL, dccutR;
+	sf_rv_oversample_st oversample;
+	sf_rv_dccut_st      dccut;
 	sf_rv_noise_st      noise;
 	sf_rv_lfo_st        lfo1;
 	sf_rv_iir1_st       lfo1_lpf;
-	sf_rv_allpassm_st   diffL[10], diffR[10];
-	sf_rv_allpass_st    crossL[4], crossR[4];
-	sf_rv_iir1_st       clpfL, clpfR; // cross LPF
-	sf_rv_delay_st      cdelayL, cdelayR; // cross delay
-	sf_rv_biquad_st     bassapL, bassapR; // bass all-pass
-	sf_rv_biquad_st     basslpL, basslpR; // bass lowpass
-	sf_rv_iir1_st       damplpL, damplpR; // dampening lowpass
-	sf_rv_allpassm_st   dampap1L, dampap1R; // dampening all-pass (1)
-	sf_rv_delay_st      dampdL, dampdR; // dampening delay
-	sf_rv_allpassm_st   dampap2L, dampap2R; // dampening all-pass (2)
-	sf_rv_delay_st      cbassd1L, cbassd1R; // cross-fade bass delay (1)
-	sf_rv_allpass2_st   cbassap1L, cbassap1R; // cross-fade bass allpass (1)
-	sf_rv_delay_st      cbassd2L, cbassd2R; // cross-fade bass delay (2)
-	sf_rv_allpass3_st   cbassap2L, cbassap2R; // cross-fade bass allpass (2)
+	sf_rv_allpassm_st   diff[10];
+	sf_rv_allpass_st    cross[4];
+	sf_rv_iir1_st       clpf; // cross LPF
+	sf_rv_delay_st      cdelay; // cross delay
+	sf_rv_biquad_st     bassap; // bass all-pass
+	sf_rv_biquad_st     basslp; // bass lowpass
+	sf_rv_iir1_st       damplp; // dampening lowpass
+	sf_rv_allpassm_st   dampap1; // dampening all-pass (1)
+	sf_rv_delay_st      dampd; // dampening delay
+	sf_rv_allpassm_st   dampap2; // dampening all-pass (2)
+	sf_rv_delay_st      cbassd1; // cross-fade bass delay (1)
+	sf_rv_allpass2_st   cbassap1; // cross-fade bass allpass (1)
+	sf_rv_delay_st      cbassd2; // cross-fade bass delay (2)
+	sf_rv_allpass3_st   cbassap2; // cross-fade bass allpass (2)
 	sf_rv_lfo_st        lfo2;
 	sf_rv_iir1_st       lfo2_lpf;
-	sf_rv_comb_st       combL, combR;
-	sf_rv_biquad_st     lastlpfL, lastlpfR;
-	sf_rv_delay_st      lastdelayL, lastdelayR;
-	sf_rv_delay_st      inpdelayL, inpdelayR;
-	int outco[32];
+	sf_rv_comb_st       comb;
+	sf_rv_biquad_st     lastlpf;
+	sf_rv_delay_st      lastdelay;
+	sf_rv_delay_st      inpdelay;
+	sf_rv_tap_st tap[32];
+	unsigned int pos; // oversampled write index shared by every line above
+	int chunk; // no longer than cross-fade bass delay (1), the only loop closed inside a chunk
+	float *arena; // backing store of every line, 0 until configured
 	float loopdecay;
 	float wet1, wet2;
 	float wander;
@@ -349,33 +390,55 @@ typedef enum
 	SF_REVERB_PRESET_LONGREVERB2
 } sf_reverb_preset;
 extern void sf_advancereverb(sf_reverb_state_st *rv, int rate, int oversamplefactor, float ertolate, float erefwet, float dry, float ereffactor, float erefwidth, float width, float wet, float wander, float bassb, float spin, float inputlpf, float basslpf, float damplpf, float outputlpf, float rt60, float delay);
+extern void sf_presetreverb(sf_reverb_state_st *rv, int rate, sf_reverb_preset preset);
+extern void sf_reverb_process(sf_reverb_state_st *rv, const float *inputL, const float *inputR, float *outputL, float *outputR, size_t n);
+extern void sf_reverb_free(sf_reverb_state_st *rv);
 
+// Samples per pass of the widener's warping networks
+#define STEREOENH_BLOCK 64
 typedef struct
 {
 	char *subband[2];
+	float *work;
 	float emaAlpha[5];
 	float sumStates[5];
 	float diffStates[5];
 	float mix, minusMix, gain;
 } stereoEnhancement;
-typedef struct
+typedef struct LiveProg_s
 {
 	NSEEL_VMCTX vm;
-	NSEEL_CODEHANDLE codehandleInit, codehandleProcess;
+	NSEEL_CODEHANDLE codehandleInit, codehandleBlock, codehandleProcess;
 	float *vmFs, *input1, *input2;
+	float *vmFrames, *block1, *block2; // nframes and the RAM offsets of both channels for @block
 	int compileSucessfully;
     int active;
+	// Script replaced by the last reload, run once more to crossfade into the new one, then freed by LiveProgReclaim
+	struct LiveProg_s *retired;
+	float *fadeBuf; // Output of the retired script, 2 * fadeLen samples, fadeLen drops to 0 once the crossfade is done
+	size_t fadeLen;
 } LiveProg;
+#define DDC_RATE_CACHE 4
 typedef struct
 {
-	double b0, b1, b2, a1, a2;
-	double v1L, v2L, v1R, v2R; // State
-} DirectForm2;
+	double fs;
+	int sosCount;
+	double *sos;
+} DDCRate;
 typedef struct
 {
 	char *oldFile;
+	double *table[2]; // sections of the SR_44100 and SR_48000 tables, parsed once per file
+	int tableCount[2];
+	DDCRate rates[DDC_RATE_CACHE]; // sections remapped to other sample rates
+	int nextRate;
 	int usedSOSCount;
-	DirectForm2 **sosPointer;
+	double *sos; // b0, b1, b2, a1, a2 of every section, back to back, owned by the tables or the rate cache
+	double *state; // transposed direct form II, z1L, z1R, z2L, z2R of every section
+	float *sosFloat, *stateFloat; // same layout when running in single precision
+	int useFloat;
+	int firSections; // cascades of at least this many sections run as their impulse response, 0 never
+	TwoStageFFTConvolver2x2 *fir;
 } DDC;
 /* Minimum/maximum cut frequency (Hz) */
 /* bs2b_set_level_fcut() */
@@ -407,17 +470,29 @@ int BS2BCalculateflevel(unsigned int fcut, unsigned int gain);
 void BS2BInit(t_bs2bdp *bs2bdp, unsigned int samplerate, int flevel);
 /* sample poits to double floats native endians */
 void BS2BProcess(t_bs2bdp *bs2bdp, double *sampleL, double *sampleR);
+/* Whole buffers in place, the float version keeps coefficients and arithmetic in single precision */
+void BS2BProcessBlock(t_bs2bdp *bs2bdp, float *x1, float *x2, size_t n);
+void BS2BProcessBlockFloat(t_bs2bdp *bs2bdp, float *x1, float *x2, size_t n);
 typedef struct
 {
 	int mode; // 0: BS2B Lv 1, 1: BS2B Lv 2, 2: HRTF crossfeed, 2: HRTF surround 1, 2: HRTF surround 2, 2: HRTF surround 3
 	t_bs2bdp bs2b[2];
-	FFTConvolver2x4x2 *conv[3];
+	// Modes 0 and 1 glide to new coefficients instead of restarting, see CrossfeedSetBS2BLevel
+	int bs2bLevel[2];
+	t_bs2bdp bs2bTarget[2];
+	unsigned int bs2bGlide[2]; // Samples left until bs2b[] reaches bs2bTarget[]
+	int bs2bUseFloat;
+	FFTConvolver2x4x2 *conv[3]; // Built on demand, see CrossfeedPrepare
 	TwoStageFFTConvolver2x4x2 *convLong;
+	unsigned long long clock; // Processed samples
+	unsigned long long lastUsed[4]; // Clock when each HRTF mode last ran
+	int prevMode; // Mode faded out after a switch
+	unsigned int fadePos, fadeLen;
 } Crossfeed;
 typedef struct dspsys dspsys;
 typedef struct
 {
-	FFTConvolver2x2 *conv1d2x2_S_S;
+	HybridFIRConvolver2x2 *conv1d2x2_S_S;
 	TwoStageFFTConvolver2x2 *conv1d2x2_T_S;
 	FFTConvolver2x4x2 *conv1d2x4x2_S_S;
 	TwoStageFFTConvolver2x4x2 *conv1d2x4x2_T_S;
@@ -427,7 +502,7 @@ typedef struct
 {
 	ArbitraryEq coeffGen;
 	unsigned int filterLen;
-	FFTConvolver2x2 convState;
+	HybridFIRConvolver2x2 convState;
 } ArbEqConv;
 #define NUMPTS 15
 typedef struct
@@ -448,6 +523,11 @@ typedef struct dspsys
 	// Compressor
 	int compEnabled;
 	FFTDynamicRangeSquasher comp;
+	CompressorHighBand *compHigh; // NULL unless multi resolution is on
+	unsigned int compResolution; // Frame length, 0 picks one from the sample rate
+	int compMultiRes;
+	int compAmortise; // Spread each frame over the following hop
+	float compParam[3]; // Max attack, max release, adapt
 	// Bass boost
 	int bassBoostEnabled;
 	DBB dbb;
@@ -515,12 +595,23 @@ extern void JamesDSPInit(JamesDSPLib *jdsp, int blockSizeMax, float sample_rate)
 extern void JamesDSPSetPostGain(JamesDSPLib *jdsp, double pGaindB);
 extern int JamesDSPGetMutexStatus(JamesDSPLib *jdsp);
 extern void JamesDSPSetSampleRate(JamesDSPLib *jdsp, float new_sample_rate, int forceRefresh);
+// Delay between input and output of the enabled effects, in samples at the stream sample rate
+extern unsigned int JamesDSPGetLatency(JamesDSPLib *jdsp);
+// Frees what effects keep alive past their use, like idle crossfeed engines. Call periodically from a control thread
+extern void JamesDSPReclaim(JamesDSPLib *jdsp);
 // Limiter
 extern void JLimiterSetCoefficients(JamesDSPLib *jdsp, double thresholddB, double msRelease);
 extern void JLimiterInit(JamesDSPLib *jdsp);
 // Compressor
+extern void CompressorConstructor(JamesDSPLib *jdsp);
 extern void CompressorReset(JamesDSPLib *jdsp);
+extern void CompressorDestructor(JamesDSPLib *jdsp);
 extern void CompressorSetParam(JamesDSPLib *jdsp, float maxAtk, float maxRel, float adapt);
+// fftLen 0 picks the frame length from the sample rate, multiRes adds a high band with quarter length frames,
+// amortise spreads every frame over the following hop so no single block pays for a whole frame
+extern void CompressorSetResolution(JamesDSPLib *jdsp, unsigned int fftLen, int multiRes, int amortise);
+// Latency in samples at the processing sample rate
+extern unsigned int CompressorGetLatency(JamesDSPLib *jdsp);
 extern void CompressorEnable(JamesDSPLib *jdsp);
 extern void CompressorDisable(JamesDSPLib *jdsp);
 extern void CompressorProcess(JamesDSPLib *jdsp, size_t n);
@@ -529,9 +620,15 @@ extern void BassBoostEnable(JamesDSPLib *jdsp);
 extern void BassBoostDisable(JamesDSPLib *jdsp);
 extern void BassBoostConstructor(JamesDSPLib *jdsp);
 extern void BassBoostSetParam(JamesDSPLib *jdsp, float maxG);
+// Latency in samples at the processing sample rate
+extern unsigned int BassBoostGetLatency(JamesDSPLib *jdsp);
 extern void BassBoostProcess(JamesDSPLib *jdsp, size_t n);
 // Reverb
+extern void ReverbConstructor(JamesDSPLib *jdsp);
+extern void ReverbDestructor(JamesDSPLib *jdsp);
 extern void Reverb_SetParam(JamesDSPLib *jdsp, int presets);
+// Same parameters as sf_advancereverb, at the current sample rate. Safe while the DSP is running
+extern void Reverb_SetAdvancedParam(JamesDSPLib *jdsp, int oversamplefactor, float ertolate, float erefwet, float dry, float ereffactor, float erefwidth, float width, float wet, float wander, float bassb, float spin, float inputlpf, float basslpf, float damplpf, float outputlpf, float rt60, float delay);
 extern void ReverbEnable(JamesDSPLib *jdsp);
 extern void ReverbDisable(JamesDSPLib *jdsp);
 extern void ReverbProcess(JamesDSPLib *jdsp, size_t n);
@@ -555,12 +652,16 @@ extern int LiveProgStringParser(JamesDSPLib *jdsp, char *eelCode);
 extern void LiveProgEnable(JamesDSPLib *jdsp);
 extern void LiveProgDisable(JamesDSPLib *jdsp);
 extern void LiveProgProcess(JamesDSPLib *jdsp, size_t n);
+extern void LiveProgReclaim(JamesDSPLib *jdsp);
 // DDC
 extern void DDCConstructor(JamesDSPLib *jdsp);
 extern void DDCDestructor(JamesDSPLib *jdsp);
 extern int DDCEnable(JamesDSPLib *jdsp);
 extern void DDCDisable(JamesDSPLib *jdsp);
 extern int DDCStringParser(JamesDSPLib *jdsp, char *newStr);
+// useFloat runs the cascade in single precision, firSections moves cascades of at least that many sections to a
+// partitioned convolution of their impulse response (0 keeps every cascade recursive)
+extern void DDCSetEngine(JamesDSPLib *jdsp, int useFloat, int firSections);
 extern void DDCProcess(JamesDSPLib *jdsp, size_t n);
 // Crossfeed
 extern void CrossfeedConstructor(JamesDSPLib *jdsp);
@@ -568,6 +669,9 @@ extern void CrossfeedDestructor(JamesDSPLib *jdsp);
 extern void CrossfeedEnable(JamesDSPLib *jdsp);
 extern void CrossfeedDisable(JamesDSPLib *jdsp);
 extern void CrossfeedChangeMode(JamesDSPLib *jdsp, int nMode);
+extern void CrossfeedReclaim(JamesDSPLib *jdsp);
+extern void CrossfeedSetBS2BLevel(JamesDSPLib *jdsp, int nMode, int flevel);
+extern void CrossfeedSetBS2BPrecision(JamesDSPLib *jdsp, int useFloat);
 extern void CrossfeedProcess(JamesDSPLib *jdsp, size_t n);
 // Convolver
 extern void Convolver1DEnable(JamesDSPLib *jdsp);
@@ -634,6 +634,9 @@ void MainWindow::loadConfig()
     ui->comp_maxattack->setValueA(DspConfig::instance().get<int>(DspConfig::compression_maxatk));
     ui->comp_maxrelease->setValueA(DspConfig::instance().get<int>(DspConfig::compression_maxrel));
     ui->comp_aggressiveness->setValueA(DspConfig::instance().get<int>(DspConfig::compression_aggressiveness));
+    ui->comp_resolution->setCurrentIndex(DspConfig::instance().get<int>(DspConfig::compression_resolution));
+    ui->comp_multires->setChecked(DspConfig::instance().get<bool>(DspConfig::compression_multires));
+    ui->comp_amortise->setChecked(DspConfig::instance().get<bool>(DspConfig::compression_amortise));
 
     ui->limthreshold->setValueA(DspConfig::instance().get<int>(DspConfig::master_limthreshold));
     ui->limrelease->setValueA(DspConfig::instance().get<int>(DspConfig::master_limrelease));
@@ -785,6 +788,9 @@ void MainWindow::applyConfig()
     DspConfig::instance().set(DspConfig::compression_maxatk,         QVariant(ui->comp_maxattack->valueA()));
     DspConfig::instance().set(DspConfig::compression_maxrel,         QVariant(ui->comp_maxrelease->valueA()));
     DspConfig::instance().set(DspConfig::compression_aggressiveness, QVariant(ui->comp_aggressiveness->valueA()));
+    DspConfig::instance().set(DspConfig::compression_resolution,     QVariant(ui->comp_resolution->currentIndex()));
+    DspConfig::instance().set(DspConfig::compression_multires,       QVariant(ui->comp_multires->isChecked()));
+    DspConfig::instance().set(DspConfig::compression_amortise,       QVariant(ui->comp_amortise->isChecked()));
 
     DspConfig::instance().set(DspConfig::tone_enable,                QVariant(ui->enable_eq->isChecked()));
     DspConfig::instance().set(DspConfig::tone_filtertype,            QVariant(ui->eqfiltertype->currentIndex()));
@@ -1202,7 +1208,7 @@ void MainWindow::connectActions()
 
     QList<QWidget*> registerClick({
                               ui->bassboost, ui->bs2b, ui->stereowidener, ui->analog, ui->reverb, ui->enable_eq, ui->enable_comp, ui->ddc_enable, ui->conv_enable,
-                              ui->graphicEq->chk_enable
+                              ui->graphicEq->chk_enable, ui->comp_multires, ui->comp_amortise
                           });
 
     foreach(QAnimatedSlider* w, sliders)
@@ -1225,6 +1231,7 @@ void MainWindow::connectActions()
     connect(ui->eqfiltertype,       qOverload<int>(&QComboBox::currentIndexChanged), this, &MainWindow::applyConfig);
     connect(ui->eqinterpolator,     qOverload<int>(&QComboBox::currentIndexChanged), this, &MainWindow::applyConfig);
     connect(ui->conv_ir_opt,        qOverload<int>(&QComboBox::currentIndexChanged), this, &MainWindow::applyConfig);
+    connect(ui->comp_resolution,    qOverload<int>(&QComboBox::currentIndexChanged), this, &MainWindow::applyConfig);
 
     connect(ui->crossfeed_mode,     qOverload<int>(&QComboBox::currentIndexChanged), this, &MainWindow::onBs2bPresetUpdated);
     connect(ui->eqpreset,           qOverload<int>(&QComboBox::currentIndexChanged), this, &MainWindow::onEqPresetUpdated);
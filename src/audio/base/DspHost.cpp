@@ -70,10 +70,21 @@ DspHost::DspHost(void* dspPtr, MessageHandlerFunc&& extraHandler) : _extraFunc(s
 
     _dsp = dsp;
     _cache = new DspConfig();
+
+    // Idle effect resources such as unused crossfeed engines are freed once a second. The timer runs on
+    // the thread that constructs the host, normally the GUI thread, never on the audio thread
+    _reclaimTimer = new QTimer();
+    _reclaimTimer->setInterval(1000);
+    QObject::connect(_reclaimTimer, &QTimer::timeout, [this]{
+        JamesDSPReclaim(cast(this->_dsp));
+    });
+    _reclaimTimer->start();
 }
 
 DspHost::~DspHost()
 {
+    _reclaimTimer->stop();
+    delete _reclaimTimer;
     setStdOutHandler(NULL, NULL);
 }
 
@@ -218,6 +229,33 @@ void DspHost::updateCompressor(DspConfig *config)
     CompressorSetParam(cast(this->_dsp), maxAttack, maxRelease, adaptSpeed);
 }
 
+void DspHost::updateCompressorResolution(DspConfig *config)
+{
+    bool resolutionExists;
+    bool multiResExists;
+    bool amortiseExists;
+
+    int resolution = config->get<int>(DspConfig::compression_resolution, &resolutionExists);
+    bool multiRes = config->get<bool>(DspConfig::compression_multires, &multiResExists);
+    bool amortise = config->get<bool>(DspConfig::compression_amortise, &amortiseExists);
+
+    if(!resolutionExists || !multiResExists || !amortiseExists)
+    {
+        util::warning("DspHost::updateCompressorResolution: Compressor resolution, multi-resolution or load balancing switch unset. Using defaults.");
+
+        if(!resolutionExists) resolution = 0;
+        if(!multiResExists) multiRes = false;
+        if(!amortiseExists) amortise = false;
+    }
+
+    // Index 0 lets the library choose from the sample rate, 1 to 6 select frames of 256 to 8192 samples
+    unsigned int fftLen = (resolution >= 1 && resolution <= 6) ? (128u << resolution) : 0;
+    CompressorSetResolution(cast(this->_dsp), fftLen, multiRes, amortise);
+
+    util::debug("DspHost::updateCompressorResolution: Compressor latency is " +
+                std::to_string(CompressorGetLatency(cast(this->_dsp)) * 1000.0 / cast(this->_dsp)->fs) + "ms");
+}
+
 void DspHost::updateReverb(DspConfig* config)
 {
 #define GET_PARAM(key,type,defaults,msg) \
@@ -249,9 +287,9 @@ void DspHost::updateReverb(DspConfig* config)
     GET_PARAM(wet, float, 0, msg);
     GET_PARAM(width, float, 1.0, msg);
 
-    sf_advancereverb(&cast(this->_dsp)->reverb, cast(this->_dsp)->fs, osf, reflection_amount, finalwet, finaldry,
-                     reflection_factor, reflection_width, width, wet, lfo_wander, bassboost, lfo_spin,
-                     lpf_input, lpf_bass, lpf_damp, lpf_output, decay, delay / 1000.0f);
+    Reverb_SetAdvancedParam(cast(this->_dsp), osf, reflection_amount, finalwet, finaldry,
+                            reflection_factor, reflection_width, width, wet, lfo_wander, bassboost, lfo_spin,
+                            lpf_input, lpf_bass, lpf_damp, lpf_output, decay, delay / 1000.0f);
 #undef GET_PARAM
 }
 
@@ -325,7 +363,7 @@ void DspHost::updateConvolver(DspConfig *config)
 
     int success = 1;
 
-    int* impInfo = new int[2];
+    int* impInfo = new int[4];
     float* impulse = ReadImpulseResponseToFloat(file.toLocal8Bit().constData(), cast(this->_dsp)->fs, impInfo, optMode, param);
 
     if(impulse == nullptr)
@@ -356,6 +394,12 @@ void DspHost::updateConvolver(DspConfig *config)
         }
 
         util::debug("DspHost::updateConvolver: Impulse response loaded: channels=" + std::to_string(impInfo[0]) + ", frames=" + std::to_string(impInfo[1]));
+        if(optMode == 3 && impInfo[2] > 0)
+        {
+            util::debug("DspHost::updateConvolver: Energy based truncation: frames " + std::to_string(impInfo[2]) + " -> " + std::to_string(impInfo[1]) +
+                        " (" + std::to_string(100 - (int)(100.0 * impInfo[1] / impInfo[2])) + "% less convolution work), removed energy " +
+                        std::to_string(impInfo[3] / 100.0f) + " dB");
+        }
 
         Convolver1DDisable(cast(this->_dsp));
         success = Convolver1DLoadImpulseResponse(cast(this->_dsp), impulse, impInfo[0], impInfo[1]);
@@ -440,9 +484,8 @@ void DspHost::updateCrossfeed(DspConfig* config)
             feed = 95;
         }
 
-        memset(&cast(this->_dsp)->advXF.bs2b, 0, sizeof(cast(this->_dsp)->advXF.bs2b));
-        BS2BInit(&cast(this->_dsp)->advXF.bs2b[1], (unsigned int)cast(this->_dsp)->fs, ((unsigned int)fcut | ((unsigned int)feed << 16)));
-        cast(this->_dsp)->advXF.mode = 1;
+        CrossfeedChangeMode(cast(this->_dsp), 1);
+        CrossfeedSetBS2BLevel(cast(this->_dsp), 1, BS2BCalculateflevel(fcut, feed));
     }
     else
     {
@@ -467,6 +510,7 @@ bool DspHost::update(DspConfig *config, bool ignoreCache)
     QMetaEnum e = QMetaEnum::fromType<DspConfig::Key>();
 
     bool refreshReverb = false;
+    bool refreshCompressorResolution = false;
     bool refreshCrossfeed = false;
     bool refreshConvolver = false;
     bool refreshLiveprog = false;
@@ -519,6 +563,11 @@ bool DspHost::update(DspConfig *config, bool ignoreCache)
         case DspConfig::compression_maxrel:
             updateCompressor(config);
             break;
+        case DspConfig::compression_amortise:
+        case DspConfig::compression_multires:
+        case DspConfig::compression_resolution:
+            refreshCompressorResolution = true;
+            break;
         case DspConfig::convolver_enable:
         case DspConfig::convolver_file:
         case DspConfig::convolver_optimization_mode:
@@ -622,6 +671,11 @@ bool DspHost::update(DspConfig *config, bool ignoreCache)
         updateReverb(config);
     }
 
+    if(refreshCompressorResolution)
+    {
+        updateCompressorResolution(config);
+    }
+
     if(refreshConvolver)
     {
         updateConvolver(config);
@@ -692,16 +746,13 @@ void DspHost::reloadLiveprog(DspConfig* config)
     QTextStream in(&f);
 
 
-    LiveProgDisable(cast(this->_dsp));
+    // The running script keeps playing while the new one compiles and is crossfaded in by the library
     dispatch(EelCompilerStart, f.fileName());
 
     QElapsedTimer timer;
     timer.start();
     int ret = LiveProgStringParser(cast(this->_dsp), in.readAll().toLocal8Bit().data());
 
-    // Workaround due to library bug
-    jdsp_unlock(cast(this->_dsp));
-
     float msecs = timer.nsecsElapsed() / 1000000.0;
 
     const char* errorString = NSEEL_code_getcodeerror(cast(this->_dsp)->eel.vm);
@@ -45,11 +45,13 @@ private:
        due to #defines and other global definitons that may conflict */
     void* _dsp; // JamesDSPLib*
     DspConfig* _cache;
+    QTimer* _reclaimTimer;
 
     void updateLimiter(DspConfig *config);
     void updateFirEqualizer(DspConfig *config);
     void updateVdc(DspConfig *config);
     void updateCompressor(DspConfig *config);
+    void updateCompressorResolution(DspConfig *config);
     void updateReverb(DspConfig *config);
     void updateConvolver(DspConfig *config);
     void updateGraphicEq(DspConfig *config);
@@ -6,6 +6,7 @@
 typedef struct {
     std::string AudioFormat;
     std::string SamplingRate;
+    std::string Latency;
     bool IsProcessing;
 } DspStatus;
 
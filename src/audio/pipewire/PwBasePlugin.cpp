@@ -21,8 +21,14 @@
 
 #include "Utils.h"
 
+#include <array>
 #include <thread>
 
+#if PW_CHECK_VERSION(0, 3, 48)
+#include <spa/param/latency.h>
+#include <spa/pod/builder.h>
+#endif
+
 namespace {
 
 void on_process(void* userdata, spa_io_position* position) {
@@ -73,6 +79,26 @@ void on_process(void* userdata, spa_io_position* position) {
 
 const struct pw_filter_events filter_events = {.process = on_process};
 
+#if PW_CHECK_VERSION(0, 3, 48)
+// Runs on the main thread loop, publishes the plugin delay so the graph can compensate it
+auto on_update_latency(spa_loop* loop, bool async, uint32_t seq, const void* data, size_t size, void* user_data) -> int {
+  auto* pb = static_cast<PwPluginBase*>(user_data);
+  const auto samples = *static_cast<const uint*>(data);
+
+  std::array<uint8_t, 256U> buffer{};
+  spa_pod_builder b = SPA_POD_BUILDER_INIT(buffer.data(), static_cast<uint32_t>(buffer.size()));
+
+  std::array<const spa_pod*, 1U> params{};
+  params[0] = static_cast<const spa_pod*>(spa_pod_builder_add_object(
+      &b, SPA_TYPE_OBJECT_ParamProcessLatency, SPA_PARAM_ProcessLatency,
+      SPA_PARAM_PROCESS_LATENCY_rate, SPA_POD_Int(static_cast<int32_t>(samples))));
+
+  pw_filter_update_params(pb->filter, nullptr, params.data(), params.size());
+
+  return 0;
+}
+#endif
+
 }  // namespace
 
 PwPluginBase::PwPluginBase(std::string tag,
@@ -182,6 +208,8 @@ auto PwPluginBase::connect_to_pw() -> bool {
 
   pm->lock();
 
+  reported_latency = 0U;
+
   if (pw_filter_connect(filter, PW_FILTER_FLAG_RT_PROCESS, nullptr, 0) == 0) {
     connected_to_pw = true;
   }
@@ -219,6 +247,17 @@ void PwPluginBase::set_active(const bool& state) const {
   pw_filter_set_active(filter, state);
 }
 
+// Called from the processing thread, the parameter update itself is handed to the main thread loop
+void PwPluginBase::report_latency(uint samples) {
+  if (reported_latency.exchange(samples) == samples) {
+    return;
+  }
+
+#if PW_CHECK_VERSION(0, 3, 48)
+  pw_loop_invoke(pw_thread_loop_get_loop(pm->thread_loop), on_update_latency, 0, &samples, sizeof(samples), false, this);
+#endif
+}
+
 void PwPluginBase::disconnect_from_pw() {
   pm->lock();
 
@@ -23,6 +23,7 @@
 #include <giomm.h>
 #include <pipewire/filter.h>
 // #include <spa/param/latency-utils.h> // unavailable on Ubuntu 21.04 >:(
+#include <atomic>
 #include <mutex>
 
 #include "PwPipelineManager.h"
@@ -83,6 +84,8 @@ class PwPluginBase {
 
   void set_active(const bool& state) const;
 
+  void report_latency(uint samples);
+
   auto connect_to_pw() -> bool;
 
   void disconnect_from_pw();
@@ -136,6 +139,9 @@ class PwPluginBase {
  private:
   uint node_id = 0U;
 
+  // Written by connect_to_pw on the main thread and by report_latency on the processing thread
+  std::atomic<uint> reported_latency{0U};
+
   float input_peak_left = util::minimum_linear_level, input_peak_right = util::minimum_linear_level;
   float output_peak_left = util::minimum_linear_level, output_peak_right = util::minimum_linear_level;
 };
@@ -44,6 +44,9 @@ void PwJamesDspPlugin::process(float* left_in,
                                float* right_out,
                                size_t length)
 {
+  // Follows compressor resolution and sample rate changes, nothing is sent while it stays the same
+  report_latency(bypass ? 0U : JamesDSPGetLatency(this->dsp));
+
   if (bypass)
   {
       memcpy(left_out, left_in, length * sizeof (float));
@@ -71,6 +74,7 @@ DspStatus PwJamesDspPlugin::status()
     DspStatus status;
     status.AudioFormat = "32-bit floating point samples, little endian";
     status.SamplingRate = std::to_string(rate);
+    status.Latency = std::to_string(JamesDSPGetLatency(this->dsp));
     status.IsProcessing = !bypass;
     return status;
 }
@@ -34,11 +34,14 @@ DspStatus JamesDspElement::status()
     DspStatus status;
     char* format = NULL;
     char* srate = NULL;
+    gint latency = 0;
 
     this->getValues("dsp_format", &format, NULL);
     this->getValues("dsp_srate", &srate, NULL);
+    this->getValues("dsp_latency", &latency, NULL);
 
     status.SamplingRate = srate;
+    status.Latency = std::to_string(latency);
     status.AudioFormat = format;
     status.IsProcessing = _state;
 
@@ -23,7 +23,8 @@ enum {
     /* Read-only */
     PROP_DSP_PTR,
     PROP_DSP_SRATE,
-    PROP_DSP_FORMAT
+    PROP_DSP_FORMAT,
+    PROP_DSP_LATENCY
 };
 
 #define gst_jamesdsp_parent_class parent_class
@@ -43,6 +44,9 @@ static gboolean gst_jamesdsp_setup(GstAudioFilter *self,
 
 static gboolean gst_jamesdsp_stop(GstBaseTransform *base);
 
+static gboolean gst_jamesdsp_query(GstBaseTransform *base, GstPadDirection direction,
+                                   GstQuery *query);
+
 static GstFlowReturn gst_jamesdsp_transform_ip(GstBaseTransform *base,
                                                GstBuffer *outbuf);
 
@@ -83,6 +87,10 @@ gst_jamesdsp_class_init(GstjamesdspClass *klass) {
                                     g_param_spec_string("dsp_format", "StreamFormat", "Current audio format",
                                                         "Unknown", G_PARAM_READABLE));
 
+    g_object_class_install_property(gobject_class, PROP_DSP_LATENCY,
+                                    g_param_spec_int("dsp_latency", "Latency", "Processing latency in samples",
+                                                     0, G_MAXINT, 0, G_PARAM_READABLE));
+
     gst_element_class_set_static_metadata(gstelement_class,
                                           "jamesdsp",
                                           "Filter/Effect/Audio",
@@ -98,6 +106,7 @@ gst_jamesdsp_class_init(GstjamesdspClass *klass) {
             GST_DEBUG_FUNCPTR (gst_jamesdsp_transform_ip);
     basetransform_class->transform_ip_on_passthrough = FALSE;
     basetransform_class->stop = GST_DEBUG_FUNCPTR (gst_jamesdsp_stop);
+    basetransform_class->query = GST_DEBUG_FUNCPTR (gst_jamesdsp_query);
 }
 
 /* initialize the new element
@@ -118,6 +127,7 @@ gst_jamesdsp_init(Gstjamesdsp *self) {
     self->enable = FALSE;
     self->samplerate = 48000;
     self->format = -1;
+    self->latency = 0;
 
     g_mutex_init(&self->lock);
 }
@@ -190,6 +200,9 @@ gst_jamesdsp_get_property(GObject *object, guint prop_id,
                     break;
             }
             break;
+        case PROP_DSP_LATENCY:
+            g_value_set_int(value, (gint)JamesDSPGetLatency(self->dsp));
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
             break;
@@ -230,6 +243,39 @@ gst_jamesdsp_stop(GstBaseTransform *base) {
     return TRUE;
 }
 
+/* adds the processing latency to the upstream latency
+ */
+static gboolean
+gst_jamesdsp_query(GstBaseTransform *base, GstPadDirection direction, GstQuery *query) {
+    Gstjamesdsp *self = GST_JAMESDSP (base);
+
+    if (direction == GST_PAD_SRC && GST_QUERY_TYPE (query) == GST_QUERY_LATENCY) {
+        gboolean live;
+        GstClockTime min, max;
+
+        if (!gst_pad_peer_query(base->sinkpad, query))
+            return FALSE;
+
+        gst_query_parse_latency(query, &live, &min, &max);
+
+        g_mutex_lock(&self->lock);
+        GstClockTime latency = 0;
+        if (self->samplerate > 0)
+            latency = gst_util_uint64_scale_round(self->latency, GST_SECOND, self->samplerate);
+        g_mutex_unlock(&self->lock);
+
+        GST_DEBUG_OBJECT (self, "processing latency %" GST_TIME_FORMAT, GST_TIME_ARGS (latency));
+
+        min += latency;
+        if (max != GST_CLOCK_TIME_NONE)
+            max += latency;
+        gst_query_set_latency(query, live, min, max);
+        return TRUE;
+    }
+
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->query(base, direction, query);
+}
+
 /* this function does the actual processing
  */
 static GstFlowReturn
@@ -310,6 +356,16 @@ gst_jamesdsp_transform_ip(GstBaseTransform *base, GstBuffer *buf) {
         gst_buffer_unmap(buf, &map);
     }
 
+    g_mutex_lock(&filter->lock);
+    guint latency = filter->enable ? JamesDSPGetLatency(filter->dsp) : 0;
+    gboolean latencyChanged = latency != filter->latency;
+    filter->latency = latency;
+    g_mutex_unlock(&filter->lock);
+
+    /* let the pipeline redistribute latency, the query picks up the new value */
+    if (latencyChanged)
+        gst_element_post_message(GST_ELEMENT (filter), gst_message_new_latency(GST_OBJECT (filter)));
+
     return GST_FLOW_OK;
 }
 
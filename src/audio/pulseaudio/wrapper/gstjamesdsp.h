@@ -37,6 +37,7 @@ struct _Gstjamesdsp {
     GMutex lock;
     int samplerate;
     int format;
+    guint latency; /* Samples, last value announced to the pipeline */
 };
 
 struct _GstjamesdspClass {
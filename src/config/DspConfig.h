@@ -36,9 +36,12 @@ public:
         bass_enable,
         bass_maxgain,
         compression_aggressiveness,
+        compression_amortise,
         compression_enable,
         compression_maxatk,
         compression_maxrel,
+        compression_multires,
+        compression_resolution,
         convolver_enable,
         convolver_file,
         convolver_optimization_mode,
@@ -18,6 +18,7 @@ void StatusFragment::updateStatus(const DspStatus &status)
     ui->proc->setText(status.IsProcessing ? tr("Processing") : tr("Not processing"));
     ui->format->setText(QString::fromStdString(status.AudioFormat));
     ui->samplerate->setText(QString::fromStdString(status.SamplingRate) + "Hz");
+    ui->latency->setText(QString::fromStdString(status.Latency) + " " + tr("samples"));
 }
 
 StatusFragment::~StatusFragment()